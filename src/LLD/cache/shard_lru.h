@@ -0,0 +1,224 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLD_CACHE_SHARD_LRU_H
+#define NEXUS_LLD_CACHE_SHARD_LRU_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+
+namespace LLD
+{
+    class SectorKey;
+
+
+    /** CacheShard
+     *
+     *  One independently locked segment of the sharded cache.
+     *
+     **/
+    struct CacheShard;
+
+
+    /** ShardLRU
+    *
+    *   Segmented LRU split into shards that are each behind their own lock,
+    *   so that threads only contend when they hit the same shard.
+    *
+    *   New records enter a probation segment and are promoted into a protected
+    *   segment when they are read again, so one pass over cold records can't
+    *   flush out the hot ones. The size of each record is accounted in bytes,
+    *   including its key and node overhead.
+    *
+    *   Records too large for a shard, such as blocks, are kept in an overflow
+    *   shard that takes a quarter of the cache and is shared by all keys.
+    *
+    *   This class has no types, all objects are in binary forms.
+    *
+    **/
+    class ShardLRU
+    {
+        /* The Maximum Size of the Cache. */
+        uint64_t MAX_CACHE_SIZE;
+
+
+        /* The Maximum Size of each shard. */
+        uint64_t MAX_SHARD_SIZE;
+
+
+        /* The Maximum Size of the overflow shard. */
+        uint64_t MAX_OVERFLOW_SIZE;
+
+
+        /* The shards of the cache. */
+        std::vector<CacheShard*> vShards;
+
+
+        /* The shard for records too large for the others. */
+        CacheShard* pOverflow;
+
+
+        /* The records in the overflow shard, so lookups can skip it while it is empty. */
+        std::atomic<uint64_t> nOverflow;
+
+
+    public:
+
+
+        /** Default Constructor. **/
+        ShardLRU()                                  = delete;
+
+
+        /** Copy Constructor. **/
+        ShardLRU(const ShardLRU& cache)            = delete;
+
+
+        /** Move Constructor. **/
+        ShardLRU(ShardLRU&& cache)                 = delete;
+
+
+        /** Copy assignment. **/
+        ShardLRU& operator=(const ShardLRU& cache) = delete;
+
+
+        /** Move assignment. **/
+        ShardLRU& operator=(ShardLRU&& cache)      = delete;
+
+
+        /** Class Destructor. **/
+        ~ShardLRU();
+
+
+        /** Cache Size Constructor
+         *
+         *  @param[in] nCacheSizeIn The maximum size of this Cache Pool in bytes
+         *
+         **/
+        ShardLRU(const uint32_t nCacheSizeIn);
+
+
+        /** Has
+         *
+         *  Check if data exists.
+         *
+         *  @param[in] vKey The binary data of the key.
+         *
+         *  @return True/False whether pool contains data by index.
+         *
+         **/
+        bool Has(const std::vector<uint8_t>& vKey) const;
+
+
+        /** Get
+         *
+         *  Get the data by index
+         *
+         *  @param[in] vKey The binary data of the key.
+         *  @param[out] vData The binary data of the cached record.
+         *
+         *  @return True if object was found, false if none found by index.
+         *
+         **/
+        bool Get(const std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData);
+
+
+        /** Put
+         *
+         *  Add data in the Pool
+         *
+         *  @param[in] key The sector key of the record.
+         *  @param[in] vKey The key in binary form.
+         *  @param[in] vData The input data in binary form.
+         *  @param[in] fReserve Flag for if item should be saved from cache eviction.
+         *
+         **/
+        void Put(const SectorKey& key, const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData, bool fReserve = false);
+
+
+        /** Reserve
+         *
+         *  Reserve this item in the cache permanently if true, unreserve if false
+         *
+         *  @param[in] vKey The key to flag as reserved true/false
+         *  @param[in] fReserve If this object is to be reserved for disk.
+         *
+         **/
+        void Reserve(const std::vector<uint8_t>& vKey, bool fReserve = true);
+
+
+        /** Remove
+         *
+         *  Force Remove Object by Index
+         *
+         *  @param[in] vKey Binary Data of the Key
+         *
+         *  @return True on successful removal, false if it fails
+         *
+         **/
+        bool Remove(const std::vector<uint8_t>& vKey);
+
+
+        /** Size
+         *
+         *  Get the total bytes held by the cache.
+         *
+         **/
+        uint64_t Size() const;
+
+
+        /** Hits
+         *
+         *  Get the total reads that were found in the cache.
+         *
+         **/
+        uint64_t Hits() const;
+
+
+        /** Misses
+         *
+         *  Get the total reads that were not found in the cache.
+         *
+         **/
+        uint64_t Misses() const;
+
+
+    private:
+
+
+        /** Shard
+         *
+         *  Find the shard for a key hash.
+         *
+         *  @param[in] hashKey The 64-bit hash of the key.
+         *
+         **/
+        CacheShard* Shard(const uint64_t hashKey) const;
+
+
+        /** RemoveOverflow
+         *
+         *  Remove a record from the overflow shard.
+         *
+         *  @param[in] hashKey The 64-bit hash of the key.
+         *  @param[in] vKey The binary data of the key.
+         *
+         *  @return True if the record was removed.
+         *
+         **/
+        bool RemoveOverflow(const uint64_t hashKey, const std::vector<uint8_t>& vKey);
+    };
+}
+
+#endif
@@ -22,7 +22,7 @@ namespace LLD
 {
 
     /** The Database Constructor. To determine file location and the Bytes per Record. **/
-    ClientDB::ClientDB(const uint8_t nFlagsIn, const uint32_t nBucketsIn, const uint32_t nCacheIn)
+    ClientDB::ClientDB(const uint16_t nFlagsIn, const uint32_t nBucketsIn, const uint32_t nCacheIn)
     : SectorDatabase(std::string("_CLIENT")
     , nFlagsIn
     , nBucketsIn
@@ -20,7 +20,7 @@ ________________________________________________________________________________
 namespace LLD
 {
     /** The Database Constructor.  **/
-    ContractDB::ContractDB(const uint8_t nFlagsIn, const uint32_t nBucketsIn, const uint32_t nCacheIn)
+    ContractDB::ContractDB(const uint16_t nFlagsIn, const uint32_t nBucketsIn, const uint32_t nCacheIn)
     : SectorDatabase(std::string("_CONTRACT")
     , nFlagsIn
     , nBucketsIn
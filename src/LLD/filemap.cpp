@@ -25,7 +25,7 @@ namespace LLD
 {
 
     /* The Database Constructor. */
-    BinaryFileMap::BinaryFileMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn)
+    BinaryFileMap::BinaryFileMap(const std::string& strBaseLocationIn, const uint16_t nFlagsIn)
     : KEY_MUTEX        ( )
     , strBaseLocation  (strBaseLocationIn)
     , nCacheSize       (0)
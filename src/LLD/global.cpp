@@ -14,6 +14,9 @@ ________________________________________________________________________________
 #include <LLD/include/global.h>
 
 #include <TAO/Ledger/include/enum.h> //for internal flags
+#include <TAO/Ledger/types/verify_cache.h>
+
+#include <Util/include/filesystem.h>
 
 namespace LLD
 {
@@ -28,6 +31,9 @@ namespace LLD
     TrustDB*      Trust;
     LegacyDB*     Legacy;
 
+    /* The journal shared by all LLD instances in a transaction. */
+    TxnJournal*   Journal;
+
 
     /*  Initialize the global LLD instances. */
     void Initialize()
@@ -38,17 +44,31 @@ namespace LLD
         Contract = new ContractDB(
                         FLAGS::CREATE | FLAGS::FORCE);
 
+        /* Check for memory mapped reads on our larger databases. */
+        const uint16_t nMapFlags = config::GetBoolArg("-lldmmap", false) ? FLAGS::MMAP : 0;
+
+        /* Check for the sharded or ordered keychain on the register and ledger databases. */
+        const std::string strRegisterKeys = config::GetArg("-registerkeychain", "hashmap");
+        const std::string strLedgerKeys   = config::GetArg("-ledgerkeychain",   "hashmap");
+
+        const uint16_t nRegisterKeys = (strRegisterKeys == "shard") ? FLAGS::SHARDED : (strRegisterKeys == "tree") ? FLAGS::ORDERED : 0;
+        const uint16_t nLedgerKeys   = (strLedgerKeys   == "shard") ? FLAGS::SHARDED : (strLedgerKeys   == "tree") ? FLAGS::ORDERED : 0;
+
+        /* Check for compressed records on the ledger and legacy databases. */
+        const uint16_t nLedgerCompress = config::GetBoolArg("-ledgercompress", false) ? FLAGS::COMPRESS : 0;
+        const uint16_t nLegacyCompress = config::GetBoolArg("-legacycompress", false) ? FLAGS::COMPRESS : 0;
+
         /* Create the contract database instance. */
         uint32_t nRegisterCacheSize = config::GetArg("-registercache", 2);
         Register = new RegisterDB(
-                        FLAGS::CREATE | FLAGS::FORCE,
+                        FLAGS::CREATE | FLAGS::FORCE | nMapFlags | nRegisterKeys,
                         77773,
                         nRegisterCacheSize * 1024 * 1024);
 
         /* Create the ledger database instance. */
         uint32_t nLedgerCacheSize = config::GetArg("-ledgercache", 2);
         Ledger    = new LedgerDB(
-                        FLAGS::CREATE | FLAGS::FORCE,
+                        FLAGS::CREATE | FLAGS::FORCE | nMapFlags | nLedgerKeys | nLedgerCompress,
                         config::fClient.load() ? 77773 : (256 * 256 * 64),
                         nLedgerCacheSize * 1024 * 1024);
 
@@ -56,7 +76,7 @@ namespace LLD
         /* Create the legacy database instance. */
         uint32_t nLegacyCacheSize = config::GetArg("-legacycache", 1);
         Legacy = new LegacyDB(
-                        FLAGS::CREATE | FLAGS::FORCE,
+                        FLAGS::CREATE | FLAGS::FORCE | nMapFlags | nLegacyCompress,
                         config::fClient.load() ? 77773 : 256 * 256 * 64,
                         nLegacyCacheSize * 1024 * 1024);
 
@@ -79,8 +99,14 @@ namespace LLD
                             77773);
         }
 
+        /* Create the shared transaction journal. */
+        Journal = new TxnJournal(config::GetDataDir() + "journal.dat");
+
         /* Handle database recovery mode. */
         TxnRecovery();
+
+        /* Check the register indexes once recovery is complete, rebuilding them if requested. */
+        Register->InitializeIndexes(config::GetBoolArg("-reindex-registers", false));
     }
 
 
@@ -142,41 +168,180 @@ namespace LLD
             debug::log(2, FUNCTION, "Shutting down TrustDB");
             delete Trust;
         }
+
+
+        /* Cleanup the transaction journal. */
+        if(Journal)
+        {
+            debug::log(2, FUNCTION, "Shutting down TxnJournal");
+            delete Journal;
+        }
+    }
+
+
+    /* Read a journal written by an older version into the database directory. */
+    template<typename DatabaseType>
+    void ReadLegacyJournal(DatabaseType* pDatabase, std::map<std::string, std::vector<uint8_t>>& mapLegacy)
+    {
+        /* Open the journal file. */
+        std::ifstream stream(config::GetDataDir() + pDatabase->GetName() + "/journal.dat", std::ios::in | std::ios::binary | std::ios::ate);
+        if(!stream.is_open())
+            return;
+
+        /* Check journal size for 0. */
+        uint64_t nSize = static_cast<uint64_t>(stream.tellg());
+        if(nSize == 0)
+            return;
+
+        /* Read the journal file. */
+        std::vector<uint8_t> vJournal(nSize, 0);
+        stream.seekg(0, std::ios::beg);
+        stream.read((char*)&vJournal[0], vJournal.size());
+
+        mapLegacy[pDatabase->GetName()] = vJournal;
+    }
+
+
+    /* Move the journals written by older versions into the shared journal. */
+    void MigrateJournals()
+    {
+        /* Read the journal of each database. */
+        std::map<std::string, std::vector<uint8_t>> mapLegacy;
+        std::vector<std::string> vNames;
+
+        /* Check the contract DB journal. */
+        if(Contract)
+        {
+            ReadLegacyJournal(Contract, mapLegacy);
+            vNames.push_back(Contract->GetName());
+        }
+
+        /* Check the register DB journal. */
+        if(Register)
+        {
+            ReadLegacyJournal(Register, mapLegacy);
+            vNames.push_back(Register->GetName());
+        }
+
+        /* Check the ledger DB journal. */
+        if(Ledger)
+        {
+            ReadLegacyJournal(Ledger, mapLegacy);
+            vNames.push_back(Ledger->GetName());
+        }
+
+        /* Check the local DB journal. */
+        if(Local)
+        {
+            ReadLegacyJournal(Local, mapLegacy);
+            vNames.push_back(Local->GetName());
+        }
+
+        /* Check the client DB journal. */
+        if(Client)
+        {
+            ReadLegacyJournal(Client, mapLegacy);
+            vNames.push_back(Client->GetName());
+        }
+
+        /* Check the trust DB journal. */
+        if(Trust)
+        {
+            ReadLegacyJournal(Trust, mapLegacy);
+            vNames.push_back(Trust->GetName());
+        }
+
+        /* Check the legacy DB journal. */
+        if(Legacy)
+        {
+            ReadLegacyJournal(Legacy, mapLegacy);
+            vNames.push_back(Legacy->GetName());
+        }
+
+        /* Nothing to migrate. */
+        if(mapLegacy.empty())
+            return;
+
+        /* Older versions wrote a journal for every database, so a missing one means the transaction never completed. */
+        if(mapLegacy.size() == vNames.size())
+        {
+            debug::log(0, FUNCTION, "moving ", mapLegacy.size(), " database journals into the shared journal");
+
+            /* Write them as one group to the shared journal. */
+            for(const auto& journal : mapLegacy)
+                Journal->Append(journal.first, journal.second);
+
+            /* Keep the old journals if they couldn't be moved. */
+            if(!Journal->Commit())
+                return;
+        }
+        else
+            debug::log(0, FUNCTION, "discarding ", mapLegacy.size(), " of ", vNames.size(), " database journals that never reached commit");
+
+        /* Remove the old journal files. */
+        for(const auto& strName : vNames)
+            filesystem::remove(config::GetDataDir() + strName + "/journal.dat");
+    }
+
+
+    /* Load the records of a database from the recovered journal group. */
+    template<typename DatabaseType>
+    bool RecoverJournal(DatabaseType* pDatabase, const std::map<std::string, std::vector<uint8_t>>& mapJournals)
+    {
+        /* Databases without records in the group have nothing to recover. */
+        auto it = mapJournals.find(pDatabase->GetName());
+        if(it == mapJournals.end())
+            return true;
+
+        return pDatabase->TxnRecovery(it->second);
     }
 
 
     /* Check the transactions for recovery. */
     void TxnRecovery()
     {
+        /* Move journals left by older versions into the shared journal. */
+        MigrateJournals();
+
+        /* Read the last committed group from the shared journal. */
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        if(!Journal->Recover(mapJournals))
+        {
+            /* Release anything that was left incomplete. */
+            TxnAbort();
+
+            return;
+        }
+
         /* Flag to determine if there are any failures. */
         bool fRecovery = true;
 
         /* Check the contract DB journal. */
-        if(Contract && !Contract->TxnRecovery())
+        if(Contract && !RecoverJournal(Contract, mapJournals))
             fRecovery = false;
 
         /* Check the register DB journal. */
-        if(Register && !Register->TxnRecovery())
+        if(Register && !RecoverJournal(Register, mapJournals))
             fRecovery = false;
 
         /* Check the ledger DB journal. */
-        if(Ledger && !Ledger->TxnRecovery())
+        if(Ledger && !RecoverJournal(Ledger, mapJournals))
             fRecovery = false;
 
         /* Check the local DB journal. */
-        if(Local && !Local->TxnRecovery())
+        if(Local && !RecoverJournal(Local, mapJournals))
             fRecovery = false;
 
         /* Check the client DB journal. */
-        if(Client && !Client->TxnRecovery())
+        if(Client && !RecoverJournal(Client, mapJournals))
             fRecovery = false;
 
-        /* Check the ledger DB journal. */
-        if(Trust && !Trust->TxnRecovery())
+        /* Check the trust DB journal. */
+        if(Trust && !RecoverJournal(Trust, mapJournals))
             fRecovery = false;
 
-        /* Check the ledger DB journal. */
-        if(Legacy && !Legacy->TxnRecovery())
+        /* Check the legacy DB journal. */
+        if(Legacy && !RecoverJournal(Legacy, mapJournals))
             fRecovery = false;
 
         /* Commit the transactions if journals are recovered. */
@@ -185,32 +350,60 @@ namespace LLD
             debug::log(0, FUNCTION, "all transactions are complete, recovering...");
 
             /* Commit contract DB transaction. */
-            if(Contract)
-                Contract->TxnCommit();
+            if(Contract && !Contract->TxnCommit())
+                fRecovery = false;
 
             /* Commit register DB transaction. */
-            if(Register)
-                Register->TxnCommit();
+            if(Register && !Register->TxnCommit())
+                fRecovery = false;
 
             /* Commit ledger DB transaction. */
-            if(Ledger)
-                Ledger->TxnCommit();
+            if(Ledger && !Ledger->TxnCommit())
+                fRecovery = false;
 
             /* Commit the local DB transaction. */
-            if(Local)
-                Local->TxnCommit();
+            if(Local && !Local->TxnCommit())
+                fRecovery = false;
 
             /* Commit the client DB transaction. */
-            if(Client)
-                Client->TxnCommit();
+            if(Client && !Client->TxnCommit())
+                fRecovery = false;
 
             /* Commit the trust DB transaction. */
-            if(Trust)
-                Trust->TxnCommit();
+            if(Trust && !Trust->TxnCommit())
+                fRecovery = false;
 
             /* Commit the legacy DB transaction. */
-            if(Legacy)
-                Legacy->TxnCommit();
+            if(Legacy && !Legacy->TxnCommit())
+                fRecovery = false;
+
+            /* Sync the replayed records to disk. */
+            if(Contract && !Contract->TxnSync())
+                fRecovery = false;
+
+            if(Register && !Register->TxnSync())
+                fRecovery = false;
+
+            if(Ledger && !Ledger->TxnSync())
+                fRecovery = false;
+
+            if(Local && !Local->TxnSync())
+                fRecovery = false;
+
+            if(Client && !Client->TxnSync())
+                fRecovery = false;
+
+            if(Trust && !Trust->TxnSync())
+                fRecovery = false;
+
+            if(Legacy && !Legacy->TxnSync())
+                fRecovery = false;
+
+            /* Release the journal once the replay is durable, otherwise it is replayed again on the next start. */
+            if(fRecovery)
+                Journal->Release();
+            else
+                debug::error(FUNCTION, "failed to restore transaction journal, kept for recovery");
         }
 
         /* Abort all the transactions. */
@@ -294,6 +487,9 @@ namespace LLD
         if(Register)
             Register->TxnRelease();
 
+        /* Transactions may have been verified against the register states that were aborted. */
+        TAO::Ledger::verifycache.Clear();
+
         /* Abort the ledger DB transaction. */
         if(Ledger)
             Ledger->TxnRelease();
@@ -313,11 +509,15 @@ namespace LLD
         /* Abort the legacy DB transaction. */
         if(Legacy)
             Legacy->TxnRelease();
+
+        /* Start a new journal group, the group on disk was either released or is kept for recovery. */
+        if(Journal)
+            Journal->Reset();
     }
 
 
-    /* Global handler for all LLD instances. */
-    void TxnCommit(const uint8_t nFlags)
+    /* Apply the memory states of the databases that keep them. */
+    void MemoryCommit()
     {
         /* Commit the contract DB transaction. */
         if(Contract)
@@ -330,38 +530,56 @@ namespace LLD
         /* Commit the ledger DB transaction. */
         if(Ledger)
             Ledger->MemoryCommit();
+    }
+
 
+    /* Global handler for all LLD instances. */
+    bool TxnCommit(const uint8_t nFlags)
+    {
         /* Handle memory commits if in memory mode. */
         if(nFlags == TAO::Ledger::FLAGS::MEMPOOL)
-            return;
+        {
+            MemoryCommit();
+            return true;
+        }
 
         /* Set a checkpoint for contract DB. */
         if(Contract)
-            Contract->TxnCheckpoint();
+            Contract->TxnCheckpoint(*Journal);
 
         /* Set a checkpoint for register DB. */
         if(Register)
-            Register->TxnCheckpoint();
+            Register->TxnCheckpoint(*Journal);
 
         /* Set a checkpoint for ledger DB. */
         if(Ledger)
-            Ledger->TxnCheckpoint();
+            Ledger->TxnCheckpoint(*Journal);
 
         /* Set a checkpoint for local DB. */
         if(Local)
-            Local->TxnCheckpoint();
+            Local->TxnCheckpoint(*Journal);
 
         /* Set a checkpoint for client DB. */
         if(Client)
-            Client->TxnCheckpoint();
+            Client->TxnCheckpoint(*Journal);
 
         /* Set a checkpoint for trust DB. */
         if(Trust)
-            Trust->TxnCheckpoint();
+            Trust->TxnCheckpoint(*Journal);
 
         /* Set a checkpoint for legacy DB. */
         if(Legacy)
-            Legacy->TxnCheckpoint();
+            Legacy->TxnCheckpoint(*Journal);
+
+        /* Write the journal for all databases with a single sync, nothing is applied unless it is durable. */
+        if(!Journal->Commit())
+        {
+            TxnAbort(nFlags);
+            return debug::error(FUNCTION, "failed to commit transaction journal");
+        }
+
+        /* Commit the memory states now the journal holds the transaction. */
+        MemoryCommit();
 
 
         /* Commit contract DB transaction. */
@@ -420,5 +638,40 @@ namespace LLD
         /* Abort the legacy DB transaction. */
         if(Legacy)
             Legacy->TxnRelease();
+
+        /* Sync the sector files written by the transaction, the journal is only released once they are durable. */
+        bool fSynced = true;
+        if(Contract && !Contract->TxnSync())
+            fSynced = false;
+
+        if(Register && !Register->TxnSync())
+            fSynced = false;
+
+        if(Ledger && !Ledger->TxnSync())
+            fSynced = false;
+
+        if(Local && !Local->TxnSync())
+            fSynced = false;
+
+        if(Client && !Client->TxnSync())
+            fSynced = false;
+
+        if(Trust && !Trust->TxnSync())
+            fSynced = false;
+
+        if(Legacy && !Legacy->TxnSync())
+            fSynced = false;
+
+        /* Keep the group on disk so it is replayed on the next start. */
+        if(!fSynced)
+        {
+            Journal->Reset();
+            return debug::error(FUNCTION, "failed to sync databases, transaction journal kept for recovery");
+        }
+
+        /* Start a new journal group. */
+        Journal->Release();
+
+        return true;
     }
 }
@@ -20,14 +20,23 @@ ________________________________________________________________________________
 #include <Util/include/filesystem.h>
 #include <Util/include/debug.h>
 #include <Util/include/hex.h>
+#include <Util/include/runtime.h>
 
 #include <iomanip>
+#include <cstring>
+#include <functional>
+#include <algorithm>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace LLD
 {
 
     /* The Database Constructor. To determine file location and the Bytes per Record. */
-    BinaryHashMap::BinaryHashMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn, const uint64_t nBucketsIn)
+    BinaryHashMap::BinaryHashMap(const std::string& strBaseLocationIn, const uint16_t nFlagsIn, const uint64_t nBucketsIn)
     : KEY_MUTEX              ( )
     , strBaseLocation        (strBaseLocationIn)
     , fileCache              (new TemplateLRU<uint16_t, std::fstream*>(8))
@@ -38,6 +47,13 @@ namespace LLD
     , HASHMAP_KEY_ALLOCATION (static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
     , nFlags                 (nFlagsIn)
     , RECORD_MUTEX           (1024)
+    , FILE_MUTEX             ( )
+    , vDescriptors           (HASHMAP_MAX_FILES)
+    , vFilters               (HASHMAP_MAX_FILES)
+    , nStartupFiles          (0)
+    , nFiltered              (0)
+    , FilterThread           ( )
+    , fDestruct              (false)
     {
         Initialize();
     }
@@ -55,6 +71,13 @@ namespace LLD
     , HASHMAP_KEY_ALLOCATION (map.HASHMAP_KEY_ALLOCATION)
     , nFlags                 (map.nFlags)
     , RECORD_MUTEX           (map.RECORD_MUTEX.size())
+    , FILE_MUTEX             ( )
+    , vDescriptors           (HASHMAP_MAX_FILES)
+    , vFilters               (HASHMAP_MAX_FILES)
+    , nStartupFiles          (0)
+    , nFiltered              (0)
+    , FilterThread           ( )
+    , fDestruct              (false)
     {
         Initialize();
     }
@@ -72,6 +95,13 @@ namespace LLD
     , HASHMAP_KEY_ALLOCATION (std::move(map.HASHMAP_KEY_ALLOCATION))
     , nFlags                 (std::move(map.nFlags))
     , RECORD_MUTEX           (map.RECORD_MUTEX.size())
+    , FILE_MUTEX             ( )
+    , vDescriptors           (HASHMAP_MAX_FILES)
+    , vFilters               (HASHMAP_MAX_FILES)
+    , nStartupFiles          (0)
+    , nFiltered              (0)
+    , FilterThread           ( )
+    , fDestruct              (false)
     {
         Initialize();
     }
@@ -116,11 +146,30 @@ namespace LLD
     /* Default Destructor */
     BinaryHashMap::~BinaryHashMap()
     {
+        /* Stop building filters. */
+        fDestruct = true;
+        if(FilterThread.joinable())
+            FilterThread.join();
+
         if(fileCache)
             delete fileCache;
 
         if(pindex)
             delete pindex;
+
+        /* Free the filters. */
+        for(auto& pFilter : vFilters)
+            if(pFilter.load())
+                delete[] pFilter.load();
+
+        #ifndef WIN32
+
+        /* Close the read descriptors. */
+        for(auto& nFD : vDescriptors)
+            if(nFD.load() >= 0)
+                close(nFD.load());
+
+        #endif
     }
 
 
@@ -196,6 +245,9 @@ namespace LLD
                 std::copy((uint8_t *)&vIndex[nBucket * 2], (uint8_t *)&vIndex[nBucket * 2] + 2, (uint8_t *)&hashmap[nBucket]);
 
                 nTotalKeys += hashmap[nBucket];
+
+                /* Track the total files that have keys in them. */
+                nStartupFiles = std::max(nStartupFiles, uint32_t(hashmap[nBucket]));
             }
 
             /* Debug output showing loading of disk index. */
@@ -223,17 +275,194 @@ namespace LLD
 
         /* Load the stream object into the stream LRU cache. */
         fileCache->Put(0, new std::fstream(file, std::ios::in | std::ios::out | std::ios::binary));
+
+        /* Set the descriptors to closed state. */
+        for(auto& nFD : vDescriptors)
+            nFD.store(-1);
+
+        /* Build the filters for existing files without holding up startup. */
+        if(!FilterThread.joinable())
+            FilterThread = std::thread(std::bind(&BinaryHashMap::BuildFilters, this));
     }
 
 
-    /* Read a key index from the disk hashmaps. */
-    bool BinaryHashMap::Get(const std::vector<uint8_t>& vKey, SectorKey &cKey)
+    /* Calculates the one byte fingerprint of a compressed key for the file filters. */
+    uint8_t BinaryHashMap::Fingerprint(const uint8_t* pKey, const uint16_t nSize) const
+    {
+        /* Use the high bits since the low bits are correlated with the bucket. */
+        uint8_t nFingerprint = static_cast<uint8_t>(XXH64(pKey, nSize, 0) >> 56);
+
+        return (nFingerprint == 0) ? 1 : nFingerprint;
+    }
+
+
+    /* Build the in-memory filters for the hashmap files found on startup. */
+    void BinaryHashMap::BuildFilters()
+    {
+        /* Scan a batch of buckets at a time so writers are only held up briefly. */
+        const uint32_t nBatch = 4096;
+
+        runtime::timer timer;
+        timer.Start();
+
+        /* Build the filters in order so that readers can use them as they complete. */
+        for(uint32_t nFile = 0; nFile < nStartupFiles; ++nFile)
+        {
+            /* Open a stream local to this thread. */
+            std::ifstream stream(debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile), std::ios::in | std::ios::binary);
+            if(!stream)
+            {
+                debug::error(FUNCTION, "couldn't open hashmap file ", nFile, " filters disabled");
+                return;
+            }
+
+            /* Publish the empty filter so that writers update it while it's built. */
+            {
+                LOCK(KEY_MUTEX);
+                vFilters[nFile].store(new uint8_t[HASHMAP_TOTAL_BUCKETS](), std::memory_order_release);
+            }
+
+            uint8_t* pFilter = vFilters[nFile].load();
+            std::vector<uint8_t> vBuckets(nBatch * HASHMAP_KEY_ALLOCATION, 0);
+            for(uint32_t nBegin = 0; nBegin < HASHMAP_TOTAL_BUCKETS; nBegin += nBatch)
+            {
+                /* Check for shutdown. */
+                if(fDestruct.load())
+                    return;
+
+                const uint32_t nEnd = std::min(nBegin + nBatch, HASHMAP_TOTAL_BUCKETS);
+                {
+                    LOCK(KEY_MUTEX);
+
+                    /* Read the batch of buckets. */
+                    stream.seekg(uint64_t(nBegin) * HASHMAP_KEY_ALLOCATION, std::ios::beg);
+                    stream.read((char*)&vBuckets[0], (nEnd - nBegin) * HASHMAP_KEY_ALLOCATION);
+
+                    /* Fingerprint every bucket with a key in it. */
+                    for(uint32_t nBucket = nBegin; nBucket < nEnd; ++nBucket)
+                    {
+                        const uint8_t* pBucket = &vBuckets[(nBucket - nBegin) * HASHMAP_KEY_ALLOCATION];
+                        if(pBucket[0] == STATE::EMPTY)
+                            continue;
+
+                        /* Get the length of the key stored in this bucket. */
+                        uint16_t nLength = 0;
+                        std::copy(pBucket + 1, pBucket + 3, (uint8_t*)&nLength);
+
+                        /* Get the compressed size the same way as CompressKey. */
+                        uint16_t nSize = nLength;
+                        while(nSize > HASHMAP_MAX_KEY_SIZE)
+                            nSize = std::max(uint16_t(nSize >> 1), HASHMAP_MAX_KEY_SIZE);
+
+                        pFilter[nBucket] = Fingerprint(pBucket + 13, nSize);
+                    }
+                }
+            }
+
+            /* Readers can use this filter now. */
+            nFiltered.store(nFile + 1);
+        }
+
+        if(nStartupFiles > 0)
+            debug::log(0, FUNCTION, "Built filters for ", nStartupFiles, " hashmap files in ", timer.ElapsedMilliseconds(), " ms");
+    }
+
+
+    /* Open a read-only descriptor for a hashmap file if it is not opened already. */
+    int32_t BinaryHashMap::OpenFile(const uint16_t nFile)
+    {
+        /* Check the descriptor table without locking. */
+        int32_t nFD = vDescriptors[nFile].load(std::memory_order_acquire);
+        if(nFD >= 0)
+            return nFD;
+
+        #ifndef WIN32
+        LOCK(FILE_MUTEX);
+
+        /* Check if another thread opened this file before we obtained the lock. */
+        nFD = vDescriptors[nFile].load(std::memory_order_acquire);
+        if(nFD >= 0)
+            return nFD;
+
+        /* Open the file for reading only, writes still go through the streams. */
+        const std::string strFile = debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile);
+        nFD = open(strFile.c_str(), O_RDONLY);
+        if(nFD < 0)
+            return -1;
+
+        /* Publish the descriptor for other readers. */
+        vDescriptors[nFile].store(nFD, std::memory_order_release);
+        #endif
+
+        return nFD;
+    }
+
+
+    /* Read a bucket from a hashmap file with a positional read. */
+    bool BinaryHashMap::ReadBucket(const uint16_t nFile, const uint32_t nFilePos, std::vector<uint8_t>& vBucket)
     {
+        #ifndef WIN32
+
+        /* Get the file descriptor. */
+        int32_t nFD = OpenFile(nFile);
+        if(nFD < 0)
+            return false;
+
+        /* Read until the whole bucket is in, pread can return short counts. */
+        uint32_t nRead = 0;
+        while(nRead < vBucket.size())
+        {
+            ssize_t nBytes = pread(nFD, &vBucket[nRead], vBucket.size() - nRead, uint64_t(nFilePos) + nRead);
+            if(nBytes < 0 && errno == EINTR)
+                continue;
+
+            if(nBytes <= 0)
+                return false;
+
+            nRead += static_cast<uint32_t>(nBytes);
+        }
+
+        return true;
+
+        #else
         LOCK(KEY_MUTEX);
 
+        /* Find the file stream for LRU cache. */
+        std::fstream *pstream;
+        if(!fileCache->Get(nFile, pstream))
+        {
+            /* Set the new stream pointer. */
+            std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile);
+
+            pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
+            if(!pstream->is_open())
+            {
+                delete pstream;
+                return false;
+            }
+
+            /* If file not found add to LRU cache. */
+            fileCache->Put(nFile, pstream);
+        }
+
+        /* Seek to the hashmap index in file. */
+        pstream->seekg(nFilePos, std::ios::beg);
+
+        /* Read the bucket binary data from file stream */
+        return !!pstream->read((char*) &vBucket[0], vBucket.size());
+        #endif
+    }
+
+
+    /* Read a key index from the disk hashmaps. */
+    bool BinaryHashMap::Get(const std::vector<uint8_t>& vKey, SectorKey &cKey)
+    {
         /* Get the assigned bucket for the hashmap. */
         uint32_t nBucket = GetBucket(vKey);
 
+        /* Only writers to this bucket can block us. */
+        LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
@@ -244,33 +473,25 @@ namespace LLD
         std::vector<uint8_t> vKeyCompressed = vKey;
         CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
 
+        /* Get the fingerprint to check against the filters. */
+        const uint8_t nFingerprint = Fingerprint(&vKeyCompressed[0], vKeyCompressed.size());
+        const uint32_t nFiltered   = this->nFiltered.load();
+
         /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
         std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
         for(int16_t i = hashmap[nBucket] - 1; i >= 0; --i)
         {
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(i, pstream))
+            /* Skip files that we know don't have this key in this bucket. */
+            if(uint32_t(i) < nFiltered || uint32_t(i) >= nStartupFiles)
             {
-                /* Set the new stream pointer. */
-                std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), i);
-
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
+                const uint8_t* pFilter = vFilters[i].load(std::memory_order_acquire);
+                if(pFilter && pFilter[nBucket] != nFingerprint)
                     continue;
-                }
-
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
             }
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg(nFilePos, std::ios::beg);
-
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+            /* Read the bucket binary data from file. */
+            if(!ReadBucket(i, nFilePos, vBucket))
+                continue;
 
             /* Check if this bucket has the key */
             if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
@@ -306,11 +527,13 @@ namespace LLD
     /* Write a key to the disk hashmaps. */
     bool BinaryHashMap::Put(const SectorKey& cKey)
     {
-        LOCK(KEY_MUTEX);
-
         /* Get the assigned bucket for the hashmap. */
         uint32_t nBucket = GetBucket(cKey.vKey);
 
+        /* Lock the bucket before the keychain to keep lock order with readers. */
+        LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+        LOCK2(KEY_MUTEX);
+
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
@@ -385,6 +608,11 @@ namespace LLD
                     pstream->write((char*)&ssKey.Bytes()[0], ssKey.size());
                     pstream->flush();
 
+                    /* Update the file filter. */
+                    uint8_t* pFilter = vFilters[i].load();
+                    if(pFilter)
+                        pFilter[nBucket] = Fingerprint(&vKeyCompressed[0], vKeyCompressed.size());
+
 
                     /* Debug Output of Sector Key Information. */
                     if(config::nVerbose >= 4)
@@ -450,6 +678,18 @@ namespace LLD
         pstream->write((char*)&ssKey.Bytes()[0], ssKey.size());
         pstream->flush();
 
+        /* Files created after startup aren't scanned, so their filters start out empty. */
+        uint8_t* pFilter = vFilters[hashmap[nBucket]].load();
+        if(!pFilter && hashmap[nBucket] >= nStartupFiles)
+        {
+            pFilter = new uint8_t[HASHMAP_TOTAL_BUCKETS]();
+            vFilters[hashmap[nBucket]].store(pFilter, std::memory_order_release);
+        }
+
+        /* Update the file filter before the bucket is visible to readers. */
+        if(pFilter)
+            pFilter[nBucket] = Fingerprint(&vKeyCompressed[0], vKeyCompressed.size());
+
         /* Seek to the index position. */
         pindex->seekp((nBucket * 2), std::ios::beg);
 
@@ -488,7 +728,7 @@ namespace LLD
 
         /* Iterate the linked list until end. */
         TemplateNode<uint16_t, std::fstream*>* pnode = fileCache->pfirst;
-        while(pnode && pnode->pnext)
+        while(pnode)
         {
             /* Flush to disk. */
             pnode->Data->flush();
@@ -499,15 +739,45 @@ namespace LLD
     }
 
 
+    /* Flush all buffers and sync the index and every hashmap file to disk. */
+    bool BinaryHashMap::Sync()
+    {
+        /* Get the total hashmap files with the streams flushed. */
+        uint16_t nFiles = 0;
+        {
+            LOCK(KEY_MUTEX);
+
+            Flush();
+            nFiles = *std::max_element(hashmap.begin(), hashmap.end());
+        }
+
+        /* Sync the index file. */
+        if(!filesystem::sync(debug::safe_printstr(strBaseLocation, "_hashmap.index")))
+            return debug::error(FUNCTION, "failed to sync hashmap index (", strerror(errno), ")");
+
+        /* Sync the hashmap files. */
+        for(uint16_t nFile = 0; nFile < nFiles; ++nFile)
+        {
+            const std::string strFile = debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile);
+            if(!filesystem::sync(strFile))
+                return debug::error(FUNCTION, "failed to sync hashmap file ", nFile, " (", strerror(errno), ")");
+        }
+
+        return true;
+    }
+
+
     /*  Erase a key from the disk hashmaps.
      *  TODO: This should be optimized further. */
     bool BinaryHashMap::Erase(const std::vector<uint8_t> &vKey)
     {
-        LOCK(KEY_MUTEX);
-
         /* Get the assigned bucket for the hashmap. */
         uint32_t nBucket = GetBucket(vKey);
 
+        /* Lock the bucket before the keychain to keep lock order with readers. */
+        LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+        LOCK2(KEY_MUTEX);
+
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
@@ -554,6 +824,11 @@ namespace LLD
                 pstream->write((char*) &vEmpty[0], vEmpty.size());
                 pstream->flush();
 
+                /* Clear the file filter. */
+                uint8_t* pFilter = vFilters[i].load();
+                if(pFilter)
+                    pFilter[nBucket] = 0;
+
                 /* Debug Output of Sector Key Information. */
                 if(config::nVerbose >= 4)
                     debug::log(4, FUNCTION, "Erased State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
@@ -577,11 +852,13 @@ namespace LLD
     /* Restore an index in the hashmap if it is found. */
     bool BinaryHashMap::Restore(const std::vector<uint8_t> &vKey)
     {
-        LOCK(KEY_MUTEX);
-
         /* Get the assigned bucket for the hashmap. */
         uint32_t nBucket = GetBucket(vKey);
 
+        /* Lock the bucket before the keychain to keep lock order with readers. */
+        LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+        LOCK2(KEY_MUTEX);
+
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
@@ -650,4 +927,149 @@ namespace LLD
 
         return false;
     }
+
+
+    /* Visit every ready key in the hashmap files. */
+    void BinaryHashMap::Iterate(const std::function<void(const SectorKey&, const uint64_t)>& xVisit)
+    {
+        /* Scan a batch of buckets at a time so writers are only held up briefly. */
+        const uint32_t nBatch = 4096;
+
+        std::vector<uint8_t> vBuckets(nBatch * HASHMAP_KEY_ALLOCATION, 0);
+        std::vector<std::pair<SectorKey, uint64_t>> vKeys;
+        for(uint32_t nBegin = 0; nBegin < HASHMAP_TOTAL_BUCKETS; nBegin += nBatch)
+        {
+            /* Check for shutdown. */
+            if(fDestruct.load())
+                return;
+
+            const uint32_t nEnd = std::min(nBegin + nBatch, HASHMAP_TOTAL_BUCKETS);
+            {
+                LOCK(KEY_MUTEX);
+
+                /* Read the batch from every file that any of its buckets are linked into. */
+                const uint16_t nFiles = *std::max_element(hashmap.begin() + nBegin, hashmap.begin() + nEnd);
+                for(uint16_t nFile = 0; nFile < nFiles; ++nFile)
+                {
+                    /* Find the file stream for LRU cache. */
+                    std::fstream* pstream = GetStream(nFile);
+                    if(!pstream)
+                        continue;
+
+                    /* Read the batch of buckets. */
+                    pstream->seekg(uint64_t(nBegin) * HASHMAP_KEY_ALLOCATION, std::ios::beg);
+                    if(!pstream->read((char*)&vBuckets[0], (nEnd - nBegin) * HASHMAP_KEY_ALLOCATION))
+                    {
+                        pstream->clear();
+                        continue;
+                    }
+
+                    /* Collect every bucket with a ready key in it. */
+                    for(uint32_t nBucket = nBegin; nBucket < nEnd; ++nBucket)
+                    {
+                        const uint8_t* pBucket = &vBuckets[(nBucket - nBegin) * HASHMAP_KEY_ALLOCATION];
+                        if(nFile >= hashmap[nBucket] || pBucket[0] != STATE::READY)
+                            continue;
+
+                        /* Deserialize the key header. */
+                        DataStream ssKey(std::vector<uint8_t>(pBucket, pBucket + 13), SER_LLD, DATABASE_VERSION);
+                        SectorKey cKey;
+                        ssKey >> cKey;
+
+                        /* Get the compressed size the same way as CompressKey. */
+                        uint16_t nSize = cKey.nLength;
+                        while(nSize > HASHMAP_MAX_KEY_SIZE)
+                            nSize = std::max(uint16_t(nSize >> 1), HASHMAP_MAX_KEY_SIZE);
+
+                        cKey.vKey.assign(pBucket + 13, pBucket + 13 + nSize);
+                        vKeys.push_back(std::make_pair(cKey, (uint64_t(nFile) << 32) | nBucket));
+                    }
+                }
+            }
+
+            /* Visit the keys without holding up writers. */
+            for(const auto& item : vKeys)
+                xVisit(item.first, item.second);
+
+            vKeys.clear();
+        }
+    }
+
+
+    /* Point a key found by Iterate to a new sector position. */
+    bool BinaryHashMap::Relocate(const uint64_t nSlot, const SectorKey& cOld, const SectorKey& cNew)
+    {
+        /* Get the file and bucket of the slot. */
+        const uint16_t nFile   = static_cast<uint16_t>(nSlot >> 32);
+        const uint32_t nBucket = static_cast<uint32_t>(nSlot);
+        if(nBucket >= HASHMAP_TOTAL_BUCKETS || cOld.vKey.size() > HASHMAP_MAX_KEY_SIZE)
+            return false;
+
+        /* Lock the bucket before the keychain to keep lock order with readers. */
+        LOCK(RECORD_MUTEX[nBucket % RECORD_MUTEX.size()]);
+        LOCK2(KEY_MUTEX);
+
+        /* Find the file stream for LRU cache. */
+        std::fstream* pstream = GetStream(nFile);
+        if(!pstream)
+            return false;
+
+        /* Get the file binary position. */
+        uint64_t nFilePos = uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+
+        /* Read the bucket binary data from file stream */
+        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
+        pstream->seekg(nFilePos, std::ios::beg);
+        if(!pstream->read((char*) &vBucket[0], vBucket.size()))
+        {
+            pstream->clear();
+            return false;
+        }
+
+        /* Deserialize the key in the bucket. */
+        DataStream ssKey(vBucket, SER_LLD, DATABASE_VERSION);
+        SectorKey cKey;
+        ssKey >> cKey;
+
+        /* Check the bucket wasn't written to since it was visited. */
+        if(!cKey.Ready() || cKey.nSectorFile != cOld.nSectorFile || cKey.nSectorStart != cOld.nSectorStart
+        || cKey.nSectorSize != cOld.nSectorSize || !std::equal(cOld.vKey.begin(), cOld.vKey.end(), vBucket.begin() + 13))
+            return false;
+
+        /* Only the header changes, the compressed key stays in place. */
+        DataStream ssNew(SER_LLD, DATABASE_VERSION);
+        ssNew << cNew;
+
+        /* Write the new header over the old one. */
+        pstream->seekp(nFilePos, std::ios::beg);
+        pstream->write((char*)&ssNew.Bytes()[0], ssNew.size());
+        pstream->flush();
+
+        return true;
+    }
+
+
+    /* Get the stream object for a hashmap file. */
+    std::fstream* BinaryHashMap::GetStream(const uint16_t nFile)
+    {
+        /* Check the stream cache. */
+        std::fstream* pstream;
+        if(fileCache->Get(nFile, pstream))
+            return pstream;
+
+        /* Set the new stream pointer. */
+        std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile);
+
+        pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
+        if(!pstream->is_open())
+        {
+            delete pstream;
+            return nullptr;
+        }
+
+        /* If file not found add to LRU cache. */
+        fileCache->Put(nFile, pstream);
+
+        return pstream;
+    }
 }
@@ -20,589 +20,515 @@ ________________________________________________________________________________
 #include <Util/include/filesystem.h>
 #include <Util/include/debug.h>
 #include <Util/include/hex.h>
+#include <Util/include/runtime.h>
+
+#include <iomanip>
+#include <cstring>
+#include <algorithm>
 
 namespace LLD
 {
 
-    /** Default Constructor **/
-    BinaryHashTree::BinaryHashTree()
-    : KEY_MUTEX()
-    , strBaseLocation()
-    , fileCache(new TemplateLRU<uint32_t, std::fstream*>(8))
-    , pindex(nullptr)
-    , hashmap(256 * 256 * 24)
-    , HASHMAP_TOTAL_BUCKETS(256 * 256 * 24)
-    , HASHMAP_MAX_CACHE_SIZE(10 * 1024)
-    , HASHMAP_MAX_KEY_SIZE(32)
-    , HASHMAP_KEY_ALLOCATION(static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
-    , nFlags(FLAGS::APPEND)
-    {
-    }
-
-
-    /** The Database Constructor. To determine file location and the Bytes per Record. **/
-    BinaryHashTree::BinaryHashTree(const std::string& strBaseLocationIn, uint8_t nFlagsIn)
-    : KEY_MUTEX()
-    , strBaseLocation(strBaseLocationIn)
-    , fileCache(new TemplateLRU<uint32_t, std::fstream*>(8))
-    , pindex(nullptr)
-    , hashmap(256 * 256 * 24)
-    , HASHMAP_TOTAL_BUCKETS(256 * 256 * 24)
-    , HASHMAP_MAX_CACHE_SIZE(10 * 1024)
-    , HASHMAP_MAX_KEY_SIZE(32)
-    , HASHMAP_KEY_ALLOCATION(static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
-    , nFlags(nFlagsIn)
+    /* The superseded log entries allowed before the log is rewritten. */
+    const uint64_t HASHTREE_MIN_REWRITE = 1024 * 64;
+
+
+    /* The keys copied out of the tree at a time while iterating. */
+    const uint32_t HASHTREE_ITERATE_BATCH = 4096;
+
+
+    /* The Database Constructor. To determine file location. */
+    BinaryHashTree::BinaryHashTree(const std::string& strBaseLocationIn, const uint16_t nFlagsIn, const uint64_t nBucketsIn)
+    : KEY_MUTEX       ( )
+    , strBaseLocation (strBaseLocationIn)
+    , mapKeys         ( )
+    , plog            (nullptr)
+    , nEntries        (0)
+    , nReady          (0)
+    , nFlags          (nFlagsIn)
+    , nLogSize        (0)
+    , CONDITION_MUTEX ( )
+    , CONDITION       ( )
+    , fRewrite        (false)
+    , fDestruct       (false)
+    , RewriteThread   ( )
     {
         Initialize();
-    }
-
 
-    /** Default Constructor **/
-    BinaryHashTree::BinaryHashTree(const std::string& strBaseLocationIn, const uint32_t nTotalBuckets, const uint32_t nMaxCacheSize,  const uint8_t nFlagsIn)
-    : KEY_MUTEX()
-    , strBaseLocation(strBaseLocationIn)
-    , fileCache(new TemplateLRU<uint32_t, std::fstream*>(8))
-    , pindex(nullptr)
-    , hashmap(nTotalBuckets)
-    , HASHMAP_TOTAL_BUCKETS(nTotalBuckets)
-    , HASHMAP_MAX_CACHE_SIZE(nMaxCacheSize)
-    , HASHMAP_MAX_KEY_SIZE(32)
-    , HASHMAP_KEY_ALLOCATION(static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
-    , nFlags(nFlagsIn)
-    {
-        Initialize();
+        RewriteThread = std::thread(std::bind(&BinaryHashTree::Rewriter, this));
     }
 
 
-    /** Copy Assignment Operator **/
-    BinaryHashTree& BinaryHashTree::operator=(const BinaryHashTree& map)
-    {
-        strBaseLocation       = map.strBaseLocation;
-        fileCache             = map.fileCache;
-
-        return *this;
-    }
-
-
-    /** Copy Constructor **/
-    BinaryHashTree::BinaryHashTree(const BinaryHashTree& map)
-    {
-        strBaseLocation    = map.strBaseLocation;
-        fileCache          = map.fileCache;
-    }
-
-
-    /** Default Destructor **/
+    /* Default Destructor */
     BinaryHashTree::~BinaryHashTree()
     {
-        delete fileCache;
-        delete pindex;
-    }
-
-
-    /*  Compresses a given key until it matches size criteria.
-     *  This function is one way and efficient for reducing key sizes. */
-    void BinaryHashTree::CompressKey(std::vector<uint8_t>& vData, uint16_t nSize)
-    {
-        /* Loop until key is of desired size. */
-        while(vData.size() > nSize)
+        /* Stop the rewrite thread. */
         {
-            /* Loop half of the key to XOR elements. */
-            for(uint64_t i = 0; i < vData.size() / 2; ++i)
-                if(i * 2 < vData.size())
-                    vData[i] = vData[i] ^ vData[i * 2];
-
-            /* Resize the container to half its size. */
-            vData.resize(std::max(uint16_t(vData.size() / 2), nSize));
+            LOCK(CONDITION_MUTEX);
+            fDestruct = true;
         }
-    }
+        CONDITION.notify_all();
 
+        if(RewriteThread.joinable())
+            RewriteThread.join();
 
-    /*  Placeholder. */
-    std::vector< std::vector<uint8_t> > BinaryHashTree::GetKeys()
-    {
-        std::vector< std::vector<uint8_t> > vKeys;
-
-        return vKeys;
+        if(plog)
+            delete plog;
     }
 
 
-    /*  Calculates a bucket to be used for the hashmap allocation. */
-    uint32_t BinaryHashTree::GetBucket(const std::vector<uint8_t>& vKey)
-    {
-        /* Get an xxHash. */
-        uint64_t nBucket = XXH64(&vKey[0], vKey.size(), 0);
-
-        return static_cast<uint32_t>(nBucket % HASHMAP_TOTAL_BUCKETS);
-    }
-
-
-    /*  Read a key index from the disk hashmaps. */
+    /* Initialize the keychain by replaying its log file. */
     void BinaryHashTree::Initialize()
     {
         /* Create directories if they don't exist yet. */
         if(!filesystem::exists(strBaseLocation) && filesystem::create_directories(strBaseLocation))
             debug::log(0, FUNCTION, "Generated Path ", strBaseLocation);
 
-        /* Build the hashmap indexes. */
-        std::string index = debug::safe_printstr(strBaseLocation, "_hashtree.index");
-        if(!filesystem::exists(index))
+        /* Check for a new log. */
+        const std::string strLog = debug::safe_printstr(strBaseLocation, "_hashtree.log");
+        if(!filesystem::exists(strLog))
         {
-            /* Generate empty space for new file. */
-            std::vector<uint8_t> vSpace(HASHMAP_TOTAL_BUCKETS * 4, 0);
+            /* Hashmaps only keep compressed keys, so they can't be ordered. */
+            if(filesystem::exists(debug::safe_printstr(strBaseLocation, "_hashmap.index"))
+            || filesystem::exists(debug::safe_printstr(strBaseLocation, "_index.000")))
+                throw debug::exception(FUNCTION, "keychain ", strBaseLocation, " was built by a hashmap, its keys can't be ordered without a resync");
 
-            /* Write the new disk index .*/
-            std::fstream stream(index, std::ios::out | std::ios::binary | std::ios::trunc);
-            stream.write((char*)&vSpace[0], vSpace.size());
+            /* Create the empty log. */
+            std::ofstream stream(strLog, std::ios::out | std::ios::binary | std::ios::trunc);
             stream.close();
 
-            /* Debug output showing generation of disk index. */
-            debug::log(0, FUNCTION, "Generated Disk Index of ", vSpace.size(), " bytes");
+            debug::log(0, FUNCTION, "Generated Tree Log ", strLog);
         }
 
-        /* Read the hashmap indexes. */
+        /* Replay the log. */
         else
         {
-            /* Build a vector to read the disk index. */
-            std::vector<uint8_t> vIndex(HASHMAP_TOTAL_BUCKETS * 4, 0);
-
-            /* Read the disk index bytes. */
-            std::fstream stream(index, std::ios::in | std::ios::binary);
-            stream.read((char*)&vIndex[0], vIndex.size());
-            stream.close();
-
-            /* Deserialize the values into memory index. */
-            uint32_t nTotalKeys = 0;
-            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
+            /* Read the whole log into memory. */
+            DataStream ssLog(SER_LLD, DATABASE_VERSION);
             {
-                std::copy((uint8_t *)&vIndex[nBucket * 4], (uint8_t *)&vIndex[nBucket * 4] + 4, (uint8_t *)&hashmap[nBucket]);
+                std::ifstream stream(strLog, std::ios::in | std::ios::binary | std::ios::ate);
+                ssLog.resize(static_cast<uint64_t>(stream.tellg()));
 
-                nTotalKeys += hashmap[nBucket];
+                stream.seekg(0, std::ios::beg);
+                if(ssLog.size() > 0 && !stream.read((char*)&ssLog.Bytes()[0], ssLog.size()))
+                    throw debug::exception(FUNCTION, "failed to read ", strLog);
             }
 
-            /* Debug output showing loading of disk index. */
-            debug::log(0, FUNCTION, "Loaded Disk Index of ", vIndex.size(), " bytes and ", nTotalKeys, " keys");
-        }
+            /* Apply every entry in the order they were written. */
+            bool fTorn = false;
+            while(!ssLog.End())
+            {
+                const uint64_t nStart = ssLog.GetPos();
+                try
+                {
+                    /* Deserialize the entry. */
+                    SectorKey cKey;
+                    std::vector<uint8_t> vKey;
+                    ssLog >> cKey;
+                    ssLog >> vKey;
 
-        /* Build the first hashmap index file if it doesn't exist. */
-        std::string file = debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), 1u);
-        if(!filesystem::exists(file))
-        {
-            /* Build a vector with empty bytes to flush to disk. */
-            std::vector<uint8_t> vSpace(HASHMAP_TOTAL_BUCKETS * HASHMAP_KEY_ALLOCATION, 0xff);
+                    /* Check the entry was completely written. */
+                    const uint64_t nEnd = ssLog.GetPos();
 
-            /* Flush the empty keychain file to disk. */
-            std::fstream stream(file, std::ios::out | std::ios::binary | std::ios::trunc);
-            stream.write((char*)&vSpace[0], vSpace.size());
-            stream.close();
+                    uint64_t nChecksum = 0;
+                    ssLog >> nChecksum;
 
-            /* Debug output showing generating of the hashmap file. */
-            debug::log(0, FUNCTION, "Generated Disk Hash Map 0 of ", vSpace.size(), " bytes");
-        }
+                    if(nChecksum != XXH64(&ssLog.Bytes()[nStart], nEnd - nStart, 0))
+                    {
+                        fTorn = true;
+                        break;
+                    }
 
-        /* Create the stream index object. */
-        pindex = new std::fstream(index, std::ios::in | std::ios::out | std::ios::binary);
+                    /* Apply the entry to the tree. */
+                    mapKeys[vKey] = cKey;
+                    ++nEntries;
 
-        /* Load the stream object into the stream LRU cache. */
-        fileCache->Put(0, new std::fstream(file, std::ios::in | std::ios::out | std::ios::binary));
-    }
+                    nLogSize = ssLog.GetPos();
+                }
+                catch(const std::exception& e)
+                {
+                    fTorn = true;
+                    break;
+                }
+            }
 
+            /* Count the keys that are ready. */
+            for(const auto& item : mapKeys)
+                if(item.second.Ready())
+                    ++nReady;
 
-    template< typename Iter1, typename Iter2 >
-    int32_t compare(Iter1 begin1, Iter1 end1, Iter2 begin2, Iter2 end2)
-    {
-        while(begin1 != end1 && begin2 != end2)
-        {
-            if(*begin1 != *begin2)
+            /* Debug output showing loading of tree. */
+            debug::log(0, FUNCTION, "Loaded Tree Log of ", ssLog.size(), " bytes and ", nReady, " keys");
+
+            /* Drop a partly written entry, or superseded entries, by rewriting the log. */
+            if(fTorn || nEntries > nReady * 2 + HASHTREE_MIN_REWRITE)
             {
-                return *begin1 - *begin2;
+                if(fTorn)
+                    debug::log(0, FUNCTION, "Dropping torn entry at end of ", strLog);
+
+                if(!Rewrite())
+                    throw debug::exception(FUNCTION, "failed to rewrite ", strLog);
+
+                return;
             }
-            ++begin1;
-            ++begin2;
         }
 
-        return 0;
+        /* Open the log for appending. */
+        plog = new std::fstream(strLog, std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
+        if(!plog->is_open())
+            throw debug::exception(FUNCTION, "failed to open ", strLog);
     }
 
 
-    /*  Read a key index from the disk hashmaps. */
+    /* Read a key index from the tree. */
     bool BinaryHashTree::Get(const std::vector<uint8_t>& vKey, SectorKey &cKey)
     {
         LOCK(KEY_MUTEX);
 
-        static const std::vector<uint8_t> vBlank(HASHMAP_KEY_ALLOCATION, 0xff);
+        /* Check the key is ready. */
+        auto it = mapKeys.find(vKey);
+        if(it == mapKeys.end() || !it->second.Ready())
+            return false;
 
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nBucket = GetBucket(vKey);
+        /* Set the cKey return value with the full key. */
+        cKey      = it->second;
+        cKey.vKey = vKey;
 
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
+        /* Debug Output of Sector Key Information. */
+        if(config::nVerbose >= 4)
+            debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
+                " | Length: ", cKey.nLength,
+                " | Sector File: ", cKey.nSectorFile,
+                " | Sector Size: ", cKey.nSectorSize,
+                " | Sector Start: ", cKey.nSectorStart, "\n",
+                HexStr(vKey.begin(), vKey.end(), true));
+
+        return true;
+    }
 
-        /* Set the cKey return value non compressed. */
-        cKey.vKey = vKey;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+    /* Write a key to the tree and its log. */
+    bool BinaryHashTree::Put(const SectorKey& cKey)
+    {
+        LOCK(KEY_MUTEX);
 
-        //PrintHex(vKey.begin(), vKey.end());
+        /* Keep the ready count for new keys and erased keys. */
+        SectorKey& cTree = mapKeys[cKey.vKey];
+        if(cTree.Ready() != cKey.Ready())
+            nReady = cKey.Ready() ? nReady + 1 : nReady - 1;
 
-        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
+        /* The key bytes are held by the tree. */
+        cTree      = cKey;
+        cTree.vKey.clear();
 
-        uint32_t i = 1;
-        while(true)
-        {
-            /* Set the new stream pointer. */
-            std::string filename = debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), i);
+        return Append(cKey.vKey, cTree);
+    }
 
-            /* Check for file. */
-            if(!filesystem::exists(filename))
-                return false;
 
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(i, pstream))
-            {
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    return false;
-                }
+    /* Flush all buffers to disk if using ACID transaction. */
+    void BinaryHashTree::Flush()
+    {
+        LOCK(KEY_MUTEX);
 
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
-            }
+        plog->flush();
+    }
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg(nFilePos, std::ios::beg);
 
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+    /* Flush all buffers and sync the log to disk. */
+    bool BinaryHashTree::Sync()
+    {
+        LOCK(KEY_MUTEX);
 
-            /* Check if this bucket has the key */
-            //if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-            //if(compare(vBucket, vKeyCompressed) == 0)
-            int32_t nCompare = compare(vBucket.begin() + 13, vBucket.end(), vKeyCompressed.begin(), vKeyCompressed.end());
-            if(nCompare == 0)
-            {
-                /* Deserialie key and return if found. */
-                DataStream ssKey(vBucket, SER_LLD, DATABASE_VERSION);
-                ssKey >> cKey;
-
-                /* Check if the key is ready. */
-                if(!cKey.Ready())
-                    return false;
-
-                /* Debug Output of Sector Key Information. */
-                if(config::nVerbose >= 4)
-                    debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
-                        " | Length: ", cKey.nLength,
-                        " | Bucket ", nBucket,
-                        " | Location: ", nFilePos,
-                        " | File: ", hashmap[nBucket] - 1,
-                        " | Sector File: ", cKey.nSectorFile,
-                        " | Sector Size: ", cKey.nSectorSize,
-                        " | Sector Start: ", cKey.nSectorStart, "\n",
-                        HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
-
-                return true;
-            }
-            else if(compare(vBucket.begin(), vBucket.end(), vBlank.begin(), vBlank.end()) == 0)
-                return false;
-
-            //++i;
-            //i += 2;
-            i <<= 1;
-            if(nCompare > 0)
-                i |= 1;
-            //i  |= (nCompare < 0);
-        }
+        plog->flush();
+        if(!filesystem::sync(debug::safe_printstr(strBaseLocation, "_hashtree.log")))
+            return debug::error(FUNCTION, "failed to sync hashtree log (", strerror(errno), ")");
 
-        return false;
+        return true;
     }
 
 
-    /*  Write a key to the disk hashmaps. */
-    bool BinaryHashTree::Put(const SectorKey& cKey)
+    /* Restore an erased key from keychain. */
+    bool BinaryHashTree::Restore(const std::vector<uint8_t> &vKey)
     {
         LOCK(KEY_MUTEX);
 
-        static const std::vector<uint8_t> vBlank(HASHMAP_KEY_ALLOCATION, 0xff);
+        /* Erased keys are only kept until the log is rewritten. */
+        auto it = mapKeys.find(vKey);
+        if(it == mapKeys.end())
+            return false;
 
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nBucket = GetBucket(cKey.vKey);
+        /* Skip over keys that are already ready. */
+        if(it->second.Ready())
+            return true;
 
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
+        /* Set the key as ready. */
+        it->second.nState = STATE::READY;
+        ++nReady;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = cKey.vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+        return Append(vKey, it->second);
+    }
+
+
+    /* Erase a key from the tree. */
+    bool BinaryHashTree::Erase(const std::vector<uint8_t> &vKey)
+    {
+        LOCK(KEY_MUTEX);
+
+        /* Check the key is ready. */
+        auto it = mapKeys.find(vKey);
+        if(it == mapKeys.end() || !it->second.Ready())
+            return false;
+
+        /* Set the key as empty, so it can be restored. */
+        it->second.nState = STATE::EMPTY;
+        --nReady;
+
+        return Append(vKey, it->second);
+    }
 
-        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
 
-        uint32_t i = 1;
+    /* Visit every ready key in order. */
+    void BinaryHashTree::Iterate(const std::function<void(const SectorKey&, const uint64_t)>& xVisit)
+    {
+        /* Copy a batch of keys at a time so writers are only held up briefly. */
+        std::vector<SectorKey> vKeys;
         while(true)
         {
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(i, pstream))
             {
-                /* Set the new stream pointer. */
-                std::string filename = debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), i);
+                LOCK(KEY_MUTEX);
+
+                /* Start after the last key of the previous batch. */
+                auto it = vKeys.empty() ? mapKeys.begin() : mapKeys.upper_bound(vKeys.back().vKey);
 
-                /* Check for file. */
-                if(!filesystem::exists(filename))
+                vKeys.clear();
+                for( ; it != mapKeys.end() && vKeys.size() < HASHTREE_ITERATE_BATCH; ++it)
                 {
-                    /* Blank vector to write empty space in new disk file. */
-                    static const std::vector<uint8_t> vSpace(HASHMAP_TOTAL_BUCKETS * HASHMAP_KEY_ALLOCATION, 0xff);
+                    if(!it->second.Ready())
+                        continue;
 
-                    /* Write the blank data to the new file handle. */
-                    std::fstream stream(filename, std::ios::out | std::ios::binary | std::ios::trunc);
-                    if(!stream)
-                        return debug::error(FUNCTION, strerror(errno));
+                    vKeys.push_back(it->second);
+                    vKeys.back().vKey = it->first;
+                }
+            }
 
-                    stream.write((char*)&vSpace[0], vSpace.size());
-                    stream.flush();
-                    stream.close();
+            /* Visit the batch. */
+            for(const auto& cKey : vKeys)
+                xVisit(cKey, 0);
 
-                    /* Debug output for monitoring new disk maps. */
-                    debug::log(0, FUNCTION, "Generated Disk Hash Map ", i, " of ", vSpace.size(), " bytes");
-                }
+            /* Check for the end of the tree. */
+            if(vKeys.size() < HASHTREE_ITERATE_BATCH)
+                return;
+        }
+    }
 
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    return false;
-                }
 
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
-            }
+    /* Point a key found by Iterate to a new sector position. */
+    bool BinaryHashTree::Relocate(const uint64_t nSlot, const SectorKey& cOld, const SectorKey& cNew)
+    {
+        LOCK(KEY_MUTEX);
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg(nFilePos, std::ios::beg);
+        /* Check the key still points to the old position. */
+        auto it = mapKeys.find(cOld.vKey);
+        if(it == mapKeys.end() || !it->second.Ready()
+        || it->second.nSectorFile != cOld.nSectorFile || it->second.nSectorStart != cOld.nSectorStart)
+            return false;
 
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+        /* Set the new sector position. */
+        it->second.nSectorFile  = cNew.nSectorFile;
+        it->second.nSectorStart = cNew.nSectorStart;
+        it->second.nSectorSize  = cNew.nSectorSize;
 
-            /* Check if this bucket has the key */
-            //if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-            //if(compare(vBucket, vKeyCompressed) == 0)
-            int32_t nCompare = compare(vBucket.begin() + 13, vBucket.end(), vKeyCompressed.begin(), vKeyCompressed.end());
-            if(nCompare == 0 || compare(vBucket.begin(), vBucket.end(), vBlank.begin(), vBlank.end()) == 0)
-            {
-                /* Read the State and Size of Sector Header. */
-                DataStream ssKey(SER_LLD, DATABASE_VERSION);
-                ssKey << cKey;
-
-                /* Serialize the key into the end of the vector. */
-                ssKey.write((char*)&vKeyCompressed[0], vKeyCompressed.size());
-
-                /* Flush the key file to disk. */
-                pstream->seekp (nFilePos, std::ios::beg);
-                pstream->write((char*)&ssKey.Bytes()[0], ssKey.size());
-                pstream->flush();
-
-                /* Debug Output of Sector Key Information. */
-                if(config::nVerbose >= 4)
-                    debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
-                        " | Length: ", cKey.nLength,
-                        " | Bucket ", nBucket,
-                        " | Location: ", nFilePos,
-                        " | File: ", i,
-                        " | Sector File: ", cKey.nSectorFile,
-                        " | Sector Size: ", cKey.nSectorSize,
-                        " | Sector Start: ", cKey.nSectorStart, "\n",
-                        HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
-
-                return true;
-            }
+        return Append(cOld.vKey, it->second);
+    }
 
-            //++i;
-            //i += 2;
-            //i <<= 1;
-            //i  |= (nCompare < 0);
 
-            i <<= 1;
-            if(nCompare > 0)
-                i |= 1;
+    /* Get the next ready keys in order that start with a prefix. */
+    bool BinaryHashTree::Seek(const std::vector<uint8_t>& vPrefix, const std::vector<uint8_t>& vAfter,
+                              std::vector<std::vector<uint8_t>>& vKeys, const uint32_t nLimit)
+    {
+        LOCK(KEY_MUTEX);
+
+        /* Start at the prefix, or after the last key seen. */
+        auto it = vAfter.empty() ? mapKeys.lower_bound(vPrefix) : mapKeys.upper_bound(vAfter);
+        for( ; it != mapKeys.end() && vKeys.size() < nLimit; ++it)
+        {
+            /* Keys are ordered, so the first key without the prefix ends the range. */
+            if(it->first.size() < vPrefix.size() || !std::equal(vPrefix.begin(), vPrefix.end(), it->first.begin()))
+                break;
+
+            if(it->second.Ready())
+                vKeys.push_back(it->first);
         }
 
         return true;
     }
 
 
-    /*  Erase a key from the disk hashmaps.
-     *  TODO: This should be optimized further. */
-    bool BinaryHashTree::Erase(const std::vector<uint8_t> &vKey)
+    /* Append the current state of a key to the log. */
+    bool BinaryHashTree::Append(const std::vector<uint8_t>& vKey, const SectorKey& cKey)
     {
-        LOCK(KEY_MUTEX);
+        /* Serialize the entry. */
+        DataStream ssEntry(SER_LLD, DATABASE_VERSION);
+        ssEntry << cKey;
+        ssEntry << vKey;
 
-        static const std::vector<uint8_t> vBlank(HASHMAP_KEY_ALLOCATION, 0xff);
+        /* Add the checksum so a partly written entry is found on startup. */
+        const uint64_t nChecksum = XXH64(&ssEntry.Bytes()[0], ssEntry.size(), 0);
+        ssEntry << nChecksum;
 
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nBucket = GetBucket(vKey);
+        /* Write the entry to the log. */
+        if(!plog->write((char*)&ssEntry.Bytes()[0], ssEntry.size()))
+            return debug::error(FUNCTION, "failed to write to ", strBaseLocation, "_hashtree.log");
 
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
+        plog->flush();
+        ++nEntries;
+        nLogSize += ssEntry.size();
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+        /* Wake the rewrite thread once most of the log is superseded. */
+        if(nEntries > nReady * 2 + HASHTREE_MIN_REWRITE && !fRewrite.load())
+        {
+            {
+                LOCK(CONDITION_MUTEX);
+                fRewrite = true;
+            }
+            CONDITION.notify_one();
+        }
 
-        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
+        return true;
+    }
 
-        uint32_t i = 1;
+
+    /* Thread to rewrite the log when most of its entries are superseded. */
+    void BinaryHashTree::Rewriter()
+    {
         while(true)
         {
-            /* Set the new stream pointer. */
-            std::string filename = debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), i);
+            /* Wait for the log to need a rewrite. */
+            {
+                std::unique_lock<std::mutex> CONDITION_LOCK(CONDITION_MUTEX);
+                CONDITION.wait(CONDITION_LOCK, [this]{ return fDestruct.load() || fRewrite.load(); });
+            }
 
-            /* Check for file. */
-            if(!filesystem::exists(filename))
-                return debug::error(filename, " not found");
+            if(fDestruct.load())
+                return;
 
-            /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(i, pstream))
-            {
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    return false;
-                }
+            /* Back off before the next attempt if the log couldn't be rewritten. */
+            if(!Rewrite())
+                runtime::sleep(1000);
 
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
-            }
+            fRewrite = false;
+        }
+    }
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg(nFilePos, std::ios::beg);
 
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+    /* Rewrite the log with only the ready keys. */
+    bool BinaryHashTree::Rewrite()
+    {
+        const std::string strLog  = debug::safe_printstr(strBaseLocation, "_hashtree.log");
+        const std::string strTemp = debug::safe_printstr(strBaseLocation, "_hashtree.tmp");
 
+        /* Copy the ready keys, so the new log is written without holding up reads and writes. */
+        std::vector<std::pair<std::vector<uint8_t>, SectorKey>> vKeys;
+        uint64_t nSnapshot = 0;
+        uint64_t nSnapshotEntries = 0;
+        {
+            LOCK(KEY_MUTEX);
 
-            /* Check if this bucket has the key */
-            //if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-            //if(compare(vBucket, vKeyCompressed) == 0)
-            int32_t nCompare = compare(vBucket.begin() + 13, vBucket.end(), vKeyCompressed.begin(), vKeyCompressed.end());
-            if(nCompare == 0)
+            vKeys.reserve(nReady);
+            for(auto it = mapKeys.begin(); it != mapKeys.end(); )
             {
-                /* Set the key state to  empty. */
-                vBucket[0] = STATE::EMPTY;
-
-                /* Flush the key file to disk. */
-                pstream->seekp (nFilePos, std::ios::beg);
-                pstream->write((char*)&vBucket[0], vBucket.size());
-                pstream->flush();
-
-                /* Debug Output of Sector Key Information. */
-                if(config::nVerbose >= 4)
-                    debug::log(4, FUNCTION,
-                        " | Bucket ", nBucket,
-                        " | Location: ", nFilePos,
-                        " | File: ", i, "\n",
-                        HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
-
-                return true;
+                /* Drop erased keys from the tree. */
+                if(!it->second.Ready())
+                {
+                    it = mapKeys.erase(it);
+                    continue;
+                }
+
+                vKeys.push_back(*it);
+                ++it;
             }
-            else if(compare(vBucket.begin(), vBucket.end(), vBlank.begin(), vBlank.end()) == 0)
-                return false;
 
-            //++i;
-            //i += 2;
-            i <<= 1;
-            i  |= (nCompare < 0);
+            /* Entries appended after this point are copied to the new log once it is written. */
+            nSnapshot        = nLogSize;
+            nSnapshotEntries = nEntries;
         }
 
-        return false;
-    }
+        /* Write the ready keys to a new log. */
+        std::ofstream stream(strTemp, std::ios::out | std::ios::binary | std::ios::trunc);
+        uint64_t nBytes = 0;
+        for(const auto& item : vKeys)
+        {
+            /* Serialize the entry. */
+            DataStream ssEntry(SER_LLD, DATABASE_VERSION);
+            ssEntry << item.second;
+            ssEntry << item.first;
 
+            const uint64_t nChecksum = XXH64(&ssEntry.Bytes()[0], ssEntry.size(), 0);
+            ssEntry << nChecksum;
 
-    /*  Restore an index in the hashmap if it is found. */
-    bool BinaryHashTree::Restore(const std::vector<uint8_t> &vKey)
-    {
-        LOCK(KEY_MUTEX);
+            stream.write((char*)&ssEntry.Bytes()[0], ssEntry.size());
+            nBytes += ssEntry.size();
+        }
 
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nBucket = GetBucket(vKey);
+        const uint64_t nKeys = vKeys.size();
+        vKeys.clear();
+        vKeys.shrink_to_fit();
 
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
+        LOCK(KEY_MUTEX);
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+        /* Copy the entries appended while the new log was written. */
+        if(plog)
+            plog->flush();
 
-        /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
-        for(int i = hashmap[nBucket] - 1; i >= 0; --i)
+        if(nLogSize > nSnapshot)
         {
-            /* Find the file stream for LRU cache. */
-            std::fstream* pstream;
-            if(!fileCache->Get(i, pstream))
-            {
-                /* Set the new stream pointer. */
-                pstream = new std::fstream(
-                  debug::safe_printstr(strBaseLocation, "_hashtree.", std::setfill('0'), std::setw(5), i),
-                  std::ios::in | std::ios::out | std::ios::binary);
+            std::vector<uint8_t> vTail(nLogSize - nSnapshot, 0);
 
-                /* If file not found add to LRU cache. */
-                fileCache->Put(i, pstream);
-            }
+            std::ifstream old(strLog, std::ios::in | std::ios::binary);
+            old.seekg(nSnapshot, std::ios::beg);
+            if(!old.read((char*)&vTail[0], vTail.size()))
+                return debug::error(FUNCTION, "failed to read ", vTail.size(), " bytes from ", strLog);
 
-            /* Seek to the hashmap index in file. */
-            pstream->seekg (nFilePos, std::ios::beg);
+            stream.write((char*)&vTail[0], vTail.size());
+            nBytes += vTail.size();
+        }
 
-            /* Read the bucket binary data from file stream */
-            pstream->read((char*) &vBucket[0], vBucket.size());
+        /* Check the new log was completely written. */
+        stream.flush();
+        if(!stream)
+            return debug::error(FUNCTION, "failed to write ", strTemp);
 
-            /* Check if this bucket has the key */
-            if(std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-            {
-                /* Deserialize key and return if found. */
-                DataStream ssKey(vBucket, SER_LLD, DATABASE_VERSION);
-                SectorKey cKey;
-                ssKey >> cKey;
-
-                /* Skip over keys that are already erased. */
-                if(cKey.Ready())
-                    return true;
-
-                /* Seek to the hashmap index in file. */
-                pstream->seekp (nFilePos, std::ios::beg);
-
-                /* Read the bucket binary data from file stream */
-                std::vector<uint8_t> vReady(STATE::READY);
-                pstream->write((char*) &vReady[0], vReady.size());
-                pstream->flush();
-
-                /* Debug Output of Sector Key Information. */
-                if(config::nVerbose >= 4)
-                    debug::log(4, FUNCTION, "Restored State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
-                        " | Length: ", cKey.nLength,
-                        " | Bucket ", nBucket,
-                        " | Location: ", nFilePos,
-                        " | File: ", hashmap[nBucket] - 1,
-                        " | Sector File: ", cKey.nSectorFile,
-                        " | Sector Size: ", cKey.nSectorSize,
-                        " | Sector Start: ", cKey.nSectorStart,
-                        " | Key: ", HexStr(vKeyCompressed.begin(), vKeyCompressed.end()));
-
-                return true;
-            }
-        }
+        stream.close();
 
-        return false;
-    }
+        /* The new log and its directory entry must be on disk before it replaces the old log. */
+        if(!filesystem::sync(strTemp) || !filesystem::sync(strBaseLocation))
+            return debug::error(FUNCTION, "failed to sync ", strTemp, " (", strerror(errno), ")");
+
+        /* Close the old log so it can be replaced. */
+        if(plog)
+            delete plog;
+
+        /* Replace the old log, keeping it if it can't be replaced. */
+        const bool fReplaced = filesystem::rename(strTemp, strLog);
+
+        /* Reopen the log for appending. */
+        plog = new std::fstream(strLog, std::ios::in | std::ios::out | std::ios::binary | std::ios::app);
+        if(!plog->is_open())
+            throw debug::exception(FUNCTION, "failed to open ", strLog);
+
+        /* Superseded entries are still in the old log. */
+        if(!fReplaced)
+            return debug::error(FUNCTION, "failed to replace ", strLog);
 
+        /* Make the rename durable, the old log is still complete if the node stops before this. */
+        if(!filesystem::sync(strBaseLocation))
+            debug::error(FUNCTION, "failed to sync ", strBaseLocation, " (", strerror(errno), ")");
 
+        debug::log(2, FUNCTION, "Rewrote Tree Log with ", nKeys, " keys, dropped ", nSnapshotEntries - nKeys, " entries");
+
+        nEntries = nKeys + (nEntries - nSnapshotEntries);
+        nLogSize = nBytes;
+
+        return true;
+    }
 }
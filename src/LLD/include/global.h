@@ -81,8 +81,10 @@ namespace LLD
      *
      *  Global handler for all LLD instances.
      *
+     *  @return True if the transaction was journaled, applied and synced to disk.
+     *
      */
-    void TxnCommit(const uint8_t nFlags = 0);
+    bool TxnCommit(const uint8_t nFlags = 0);
 }
 
 #endif
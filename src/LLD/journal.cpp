@@ -0,0 +1,354 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+
+#include <LLD/templates/journal.h>
+#include <LLD/include/version.h>
+#include <LLD/hash/xxh3.h>
+
+#include <Util/templates/datastream.h>
+#include <Util/include/filesystem.h>
+#include <Util/include/debug.h>
+#include <Util/include/mutex.h>
+
+#include <cstring>
+
+#ifndef WIN32
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace LLD
+{
+
+    /* Journal Constructor. */
+    TxnJournal::TxnJournal(const std::string& strFilenameIn, const uint64_t nPreallocate)
+    : JOURNAL_MUTEX()
+    , strFilename(strFilenameIn)
+    , vBuffer()
+    , nSequence(1)
+    , nOffset(0)
+    , fCommitted(false)
+    {
+    #ifndef WIN32
+
+        /* Open the journal file descriptor. */
+        nDescriptor = ::open(strFilename.c_str(), O_RDWR | O_CREAT, 0644);
+        if(nDescriptor < 0)
+            throw debug::exception(FUNCTION, "failed to open journal ", strFilename, ": ", strerror(errno));
+
+        /* Preallocate the journal so commits don't have to grow the file. */
+        struct stat st;
+        if(fstat(nDescriptor, &st) == 0 && static_cast<uint64_t>(st.st_size) < nPreallocate)
+        {
+        #if defined(__linux__)
+            if(posix_fallocate(nDescriptor, 0, nPreallocate) != 0)
+        #else
+            if(ftruncate(nDescriptor, nPreallocate) != 0)
+        #endif
+                debug::error(FUNCTION, "failed to preallocate ", nPreallocate, " bytes for journal");
+            else
+                debug::log(0, FUNCTION, "Generated Journal of ", nPreallocate, " bytes");
+        }
+
+    #else
+
+        /* Create the journal file if it doesn't exist. */
+        if(!filesystem::exists(strFilename))
+        {
+            std::vector<uint8_t> vSpace(nPreallocate, 0);
+
+            std::ofstream stream(strFilename, std::ios::out | std::ios::binary | std::ios::trunc);
+            stream.write((char*)&vSpace[0], vSpace.size());
+            stream.close();
+
+            debug::log(0, FUNCTION, "Generated Journal of ", nPreallocate, " bytes");
+        }
+
+        /* Open the journal file stream. */
+        pstream = new std::fstream(strFilename, std::ios::in | std::ios::out | std::ios::binary);
+        if(!pstream->is_open())
+            throw debug::exception(FUNCTION, "failed to open journal ", strFilename);
+
+    #endif
+
+        /* Continue the sequence from the last group, even if it was already released. */
+        std::vector<uint8_t> vHeader(JOURNAL_HEADER_SIZE, 0);
+        if(ReadAt(0, vHeader))
+        {
+            uint64_t nLast = 0;
+            std::copy((uint8_t*)&vHeader[8], (uint8_t*)&vHeader[8] + 8, (uint8_t*)&nLast);
+
+            nSequence = nLast + 1;
+        }
+    }
+
+
+    /* Default Destructor. */
+    TxnJournal::~TxnJournal()
+    {
+    #ifndef WIN32
+        if(nDescriptor >= 0)
+            ::close(nDescriptor);
+    #else
+        if(pstream)
+            delete pstream;
+    #endif
+    }
+
+
+    /* Add the journal of a database to the current group. */
+    void TxnJournal::Append(const std::string& strName, const std::vector<uint8_t>& vData)
+    {
+        LOCK(JOURNAL_MUTEX);
+
+        WriteRecord(DATA, strName, vData);
+    }
+
+
+    /* Write the current group with its commit record and sync it to disk. */
+    bool TxnJournal::Commit()
+    {
+        LOCK(JOURNAL_MUTEX);
+
+        /* Close the group with the commit record. */
+        WriteRecord(COMMIT, "", std::vector<uint8_t>());
+
+        /* Write the whole group at once after the groups kept for recovery. */
+        if(!WriteAt(nOffset, vBuffer) || !Sync())
+        {
+            const std::string strError = strerror(errno);
+
+            /* The group is aborted, so clear its magic in case any of it reached the disk. */
+            const std::vector<uint8_t> vEmpty(4, 0);
+            WriteAt(nOffset, vEmpty);
+
+            return debug::error(FUNCTION, "failed to write ", vBuffer.size(), " bytes to journal: ", strError);
+        }
+
+        fCommitted = true;
+
+        return true;
+    }
+
+
+    /* Mark the current group as applied and start the next group. */
+    void TxnJournal::Release()
+    {
+        LOCK(JOURNAL_MUTEX);
+
+        /* Clear the magic of the first group so no group is replayed, and keep the last sequence for the next start. */
+        std::vector<uint8_t> vEmpty(16, 0);
+        std::copy((uint8_t*)&nSequence, (uint8_t*)&nSequence + 8, &vEmpty[8]);
+        if(!WriteAt(0, vEmpty))
+            debug::error(FUNCTION, "failed to release journal: ", strerror(errno));
+
+        /* Start the next group from the beginning. */
+        vBuffer.clear();
+        nOffset    = 0;
+        fCommitted = false;
+        ++nSequence;
+    }
+
+
+    /* Start the next group without releasing the last one on disk. */
+    void TxnJournal::Reset()
+    {
+        LOCK(JOURNAL_MUTEX);
+
+        /* Keep the group on disk by starting the next one after it. */
+        if(fCommitted)
+            nOffset += vBuffer.size();
+
+        /* Start the next group. */
+        vBuffer.clear();
+        fCommitted = false;
+        ++nSequence;
+    }
+
+
+    /* Read the groups kept in the journal that reached their commit records. */
+    bool TxnJournal::Recover(std::map<std::string, std::vector<uint8_t>>& mapJournals)
+    {
+        LOCK(JOURNAL_MUTEX);
+
+        /* Read the records from the start of the journal. */
+        uint64_t nPosition = 0;
+        uint64_t nGroup    = 0;
+        uint64_t nGroups   = 0;
+        std::map<std::string, std::vector<uint8_t>> mapGroup;
+        std::vector<uint8_t> vHeader(JOURNAL_HEADER_SIZE, 0);
+        while(ReadAt(nPosition, vHeader))
+        {
+            /* Deserialize the record header. */
+            uint32_t nMagic = 0, nLength = 0;
+            uint64_t nRecord = 0, nChecksum = 0;
+            std::copy((uint8_t*)&vHeader[0],  (uint8_t*)&vHeader[0]  + 4, (uint8_t*)&nMagic);
+            std::copy((uint8_t*)&vHeader[4],  (uint8_t*)&vHeader[4]  + 4, (uint8_t*)&nLength);
+            std::copy((uint8_t*)&vHeader[8],  (uint8_t*)&vHeader[8]  + 8, (uint8_t*)&nRecord);
+            std::copy((uint8_t*)&vHeader[16], (uint8_t*)&vHeader[16] + 8, (uint8_t*)&nChecksum);
+
+            /* A released journal has nothing to recover. */
+            if(nPosition == 0 && nMagic != JOURNAL_MAGIC)
+                return false;
+
+            /* A group starts with a newer sequence than the group before it. */
+            if(mapGroup.empty() && nMagic == JOURNAL_MAGIC && nRecord > nGroup)
+            {
+                nGroup = nRecord;
+                debug::log(0, FUNCTION, "transaction journal detected for group ", nGroup);
+            }
+
+            /* Stop at records that belong to an older group. */
+            if(nMagic != JOURNAL_MAGIC || nRecord != nGroup || nLength == 0)
+                break;
+
+            /* Read and check the record data. */
+            std::vector<uint8_t> vRecord(nLength, 0);
+            if(!ReadAt(nPosition + JOURNAL_HEADER_SIZE, vRecord)
+            || XXH64(&vRecord[0], vRecord.size(), nRecord) != nChecksum)
+                break;
+
+            /* Deserialize the record. */
+            const DataStream ssRecord(vRecord, SER_LLD, DATABASE_VERSION);
+
+            uint8_t nType = 0;
+            std::string strName;
+            std::vector<uint8_t> vData;
+            ssRecord >> nType >> strName >> vData;
+
+            nPosition += JOURNAL_HEADER_SIZE + nLength;
+
+            /* The group is complete once the commit record is reached. */
+            if(nType == COMMIT)
+            {
+                /* Add the database journals after the ones of the groups before. */
+                for(const auto& group : mapGroup)
+                    mapJournals[group.first].insert(mapJournals[group.first].end(), group.second.begin(), group.second.end());
+
+                mapGroup.clear();
+                ++nGroups;
+
+                /* New groups are written after the ones that are recovered, with a newer sequence. */
+                nOffset    = nPosition;
+                fCommitted = false;
+                if(nSequence <= nGroup)
+                    nSequence = nGroup + 1;
+
+                continue;
+            }
+
+            /* Add the database journal. */
+            mapGroup[strName] = vData;
+        }
+
+        /* Groups without a commit record are discarded as a whole. */
+        if(nGroups == 0)
+        {
+            mapJournals.clear();
+
+            return debug::error(FUNCTION, "transaction journal never reached commit");
+        }
+
+        debug::log(0, FUNCTION, "transaction journal ready to restore ", mapJournals.size(), " databases from ", nGroups, " groups");
+
+        return true;
+    }
+
+
+    /* Serialize a record with its header into the group buffer. */
+    void TxnJournal::WriteRecord(const uint8_t nType, const std::string& strName, const std::vector<uint8_t>& vData)
+    {
+        /* Serialize the record data. */
+        DataStream ssRecord(SER_LLD, DATABASE_VERSION);
+        ssRecord << nType << strName << vData;
+
+        /* Build the record header. */
+        const std::vector<uint8_t>& vRecord = ssRecord.Bytes();
+        const uint32_t nLength   = static_cast<uint32_t>(vRecord.size());
+        const uint64_t nChecksum = XXH64(&vRecord[0], vRecord.size(), nSequence);
+
+        /* Add the header and record to the group. */
+        vBuffer.insert(vBuffer.end(), (uint8_t*)&JOURNAL_MAGIC, (uint8_t*)&JOURNAL_MAGIC + 4);
+        vBuffer.insert(vBuffer.end(), (uint8_t*)&nLength,   (uint8_t*)&nLength   + 4);
+        vBuffer.insert(vBuffer.end(), (uint8_t*)&nSequence, (uint8_t*)&nSequence + 8);
+        vBuffer.insert(vBuffer.end(), (uint8_t*)&nChecksum, (uint8_t*)&nChecksum + 8);
+        vBuffer.insert(vBuffer.end(), vRecord.begin(), vRecord.end());
+    }
+
+
+    /* Read bytes from a position in the journal file. */
+    bool TxnJournal::ReadAt(const uint64_t nPosition, std::vector<uint8_t>& vData)
+    {
+    #ifndef WIN32
+        uint64_t nRead = 0;
+        while(nRead < vData.size())
+        {
+            ssize_t nBytes = pread(nDescriptor, &vData[nRead], vData.size() - nRead, nPosition + nRead);
+            if(nBytes <= 0)
+                return false;
+
+            nRead += nBytes;
+        }
+
+        return true;
+    #else
+        pstream->clear();
+        pstream->seekg(nPosition, std::ios::beg);
+        pstream->read((char*)&vData[0], vData.size());
+
+        return (static_cast<uint64_t>(pstream->gcount()) == vData.size());
+    #endif
+    }
+
+
+    /* Write bytes to a position in the journal file. */
+    bool TxnJournal::WriteAt(const uint64_t nPosition, const std::vector<uint8_t>& vData)
+    {
+    #ifndef WIN32
+        uint64_t nWritten = 0;
+        while(nWritten < vData.size())
+        {
+            ssize_t nBytes = pwrite(nDescriptor, &vData[nWritten], vData.size() - nWritten, nPosition + nWritten);
+            if(nBytes < 0)
+                return false;
+
+            nWritten += nBytes;
+        }
+
+        return true;
+    #else
+        pstream->clear();
+        pstream->seekp(nPosition, std::ios::beg);
+        pstream->write((char*)&vData[0], vData.size());
+
+        return !pstream->fail();
+    #endif
+    }
+
+
+    /* Sync the journal data to disk. */
+    bool TxnJournal::Sync()
+    {
+    #if defined(__APPLE__)
+        return (fsync(nDescriptor) == 0);
+    #elif !defined(WIN32)
+        return (fdatasync(nDescriptor) == 0);
+    #else
+        pstream->flush();
+
+        return !pstream->fail();
+    #endif
+    }
+}
@@ -0,0 +1,45 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+
+#include <LLD/keychain/keychain.h>
+#include <LLD/keychain/hashmap.h>
+#include <LLD/keychain/shard_hashmap.h>
+#include <LLD/keychain/hashtree.h>
+#include <LLD/include/enum.h>
+
+#include <Util/include/args.h>
+#include <Util/include/debug.h>
+
+namespace LLD
+{
+
+    /* Create the keychain selected by the database flags. */
+    Keychain* CreateKeychain(const std::string& strBaseLocation, const uint16_t nFlags, const uint64_t nBuckets)
+    {
+        /* Use the ordered tree if the keys need to be traversed. */
+        if(nFlags & FLAGS::ORDERED)
+            return new BinaryHashTree(strBaseLocation, nFlags, nBuckets);
+
+        /* Use the binary hashmap unless sharding was requested. */
+        if(!(nFlags & FLAGS::SHARDED))
+            return new BinaryHashMap(strBaseLocation, nFlags, nBuckets);
+
+        /* Get the total shards to split the buckets between. */
+        uint32_t nShards = static_cast<uint32_t>(config::GetArg("-keychainshards", 16));
+        if(nShards == 0 || nShards > 999)
+            throw debug::exception(FUNCTION, "-keychainshards must be between 1 and 999");
+
+        return new ShardHashMap(strBaseLocation, nFlags, nBuckets, nShards);
+    }
+}
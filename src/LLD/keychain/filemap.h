@@ -61,7 +61,7 @@ namespace LLD
         mutable uint16_t nCurrentFile;
 
         /* The flags */
-        uint8_t nFlags;
+        uint16_t nFlags;
 
         /** Caching Flag */
         bool fMemoryCaching;
@@ -77,7 +77,7 @@ namespace LLD
 
 
         /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        BinaryFileMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn);
+        BinaryFileMap(const std::string& strBaseLocationIn, const uint16_t nFlagsIn);
 
 
         /** Copy Constructor **/
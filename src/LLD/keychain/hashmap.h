@@ -24,10 +24,16 @@ ________________________________________________________________________________
 #include <fstream>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <thread>
 
 namespace LLD
 {
 
+    /** The maximum hashmap files, bounded by the 16-bit hashmap index. **/
+    const uint32_t HASHMAP_MAX_FILES = 65536;
+
+
     /** BinaryHashMap
      *
      *  This class is responsible for managing the keys to the sector database.
@@ -74,13 +80,41 @@ namespace LLD
 
 
         /** The keychain flags. **/
-        uint8_t nFlags;
+        uint16_t nFlags;
 
 
         /* The key level locking hashmap. */
         mutable std::vector<std::mutex> RECORD_MUTEX;
 
 
+        /** Mutex to protect opening of new descriptors. **/
+        std::mutex FILE_MUTEX;
+
+
+        /** Read only descriptors of hashmap files for positional reads. **/
+        std::vector<std::atomic<int32_t>> vDescriptors;
+
+
+        /** In-memory key fingerprints for each hashmap file, one byte per bucket. **/
+        std::vector<std::atomic<uint8_t*>> vFilters;
+
+
+        /** The total hashmap files found on startup, whose filters are built in the background. **/
+        uint32_t nStartupFiles;
+
+
+        /** The number of startup files with completed filters. **/
+        std::atomic<uint32_t> nFiltered;
+
+
+        /** Thread to build the filters for files found on startup. **/
+        std::thread FilterThread;
+
+
+        /** Flag to stop the filter thread. **/
+        std::atomic<bool> fDestruct;
+
+
     public:
 
 
@@ -89,7 +123,7 @@ namespace LLD
 
 
         /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        BinaryHashMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn = FLAGS::APPEND, const uint64_t nBucketsIn = 256 * 256 * 64);
+        BinaryHashMap(const std::string& strBaseLocationIn, const uint16_t nFlagsIn = FLAGS::APPEND, const uint64_t nBucketsIn = 256 * 256 * 64);
 
 
         /** Copy Constructor **/
@@ -144,6 +178,29 @@ namespace LLD
         void Initialize();
 
 
+        /** Fingerprint
+         *
+         *  Calculates the one byte fingerprint of a compressed key for the file filters.
+         *  Zero is reserved for empty buckets.
+         *
+         *  @param[in] pKey The beginning of the compressed key.
+         *  @param[in] nSize The size of the compressed key.
+         *
+         *  @return The fingerprint of the key.
+         *
+         **/
+        uint8_t Fingerprint(const uint8_t* pKey, const uint16_t nSize) const;
+
+
+        /** BuildFilters
+         *
+         *  Build the in-memory filters for the hashmap files found on startup.
+         *  Misses can then be answered without reading the disk.
+         *
+         **/
+        void BuildFilters();
+
+
         /** Get
          *
          *  Read a key index from the disk hashmaps.
@@ -177,6 +234,16 @@ namespace LLD
         void Flush();
 
 
+        /** Sync
+         *
+         *  Flush all buffers and sync the index and every hashmap file to disk.
+         *
+         *  @return True if every keychain file was synced.
+         *
+         **/
+        bool Sync();
+
+
         /** Restore
          *
          *  Restore an erased key from keychain.
@@ -189,6 +256,32 @@ namespace LLD
         bool Restore(const std::vector<uint8_t> &vKey);
 
 
+        /** OpenFile
+         *
+         *  Open a read-only descriptor for a hashmap file if it is not opened already.
+         *
+         *  @param[in] nFile The hashmap file number to open.
+         *
+         *  @return The file descriptor, -1 on failure.
+         *
+         **/
+        int32_t OpenFile(const uint16_t nFile);
+
+
+        /** ReadBucket
+         *
+         *  Read a bucket from a hashmap file with a positional read.
+         *
+         *  @param[in] nFile The hashmap file to read from.
+         *  @param[in] nFilePos The binary position of the bucket.
+         *  @param[out] vBucket The bucket data to read into.
+         *
+         *  @return True if the bucket was read.
+         *
+         **/
+        bool ReadBucket(const uint16_t nFile, const uint32_t nFilePos, std::vector<uint8_t>& vBucket);
+
+
         /** Erase
          *
          *  Erase a key from the disk hashmaps.
@@ -200,6 +293,46 @@ namespace LLD
          *
          **/
         bool Erase(const std::vector<uint8_t> &vKey);
+
+
+        /** Iterate
+         *
+         *  Visit every ready key in the hashmap files. Slots are numbered by file and bucket.
+         *
+         *  @param[in] xVisit The function called with each key and the slot it was found in.
+         *
+         **/
+        void Iterate(const std::function<void(const SectorKey&, const uint64_t)>& xVisit);
+
+
+        /** Relocate
+         *
+         *  Point a key found by Iterate to a new sector position.
+         *
+         *  @param[in] nSlot The slot the key was found in.
+         *  @param[in] cOld The key as it was visited.
+         *  @param[in] cNew The key with its new sector position.
+         *
+         *  @return True if the key was relocated.
+         *
+         **/
+        bool Relocate(const uint64_t nSlot, const SectorKey& cOld, const SectorKey& cNew);
+
+
+    private:
+
+
+        /** GetStream
+         *
+         *  Get the stream object for a hashmap file.
+         *  Must be called while holding the keychain lock.
+         *
+         *  @param[in] nFile The hashmap file to get.
+         *
+         *  @return The stream object, nullptr if the file couldn't be opened.
+         *
+         **/
+        std::fstream* GetStream(const uint16_t nFile);
     };
 }
 
@@ -16,16 +16,19 @@ ________________________________________________________________________________
 #define NEXUS_LLD_TEMPLATES_HASHTREE_H
 
 #include <LLD/templates/key.h>
-#include <LLD/cache/template_lru.h>
 #include <LLD/include/enum.h>
+#include <LLD/keychain/keychain.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdint>
 #include <string>
 #include <fstream>
 #include <vector>
+#include <map>
 #include <mutex>
+#include <thread>
 
-//TODO: Abstract base class for all keychains
 namespace LLD
 {
 
@@ -33,12 +36,14 @@ namespace LLD
      *
      *  This class is responsible for managing the keys to the sector database.
      *
-     *  It contains a Binary Hash Map with a minimum complexity of O(1).
-     *  It uses a linked file list based on index to iterate trhough files and binary Positions
-     *  when there is a collision that is found.
+     *  It holds the full keys in an ordered tree in memory, so that keys can be traversed
+     *  in order or by prefix, with a complexity of O(log n) for lookups.
+     *
+     *  Every change to a key is appended to a log file, which is replayed on startup
+     *  and rewritten in the background once most of its entries are superseded.
      *
      **/
-    class BinaryHashTree
+    class BinaryHashTree : public Keychain
     {
     protected:
 
@@ -50,99 +55,78 @@ namespace LLD
         std::string strBaseLocation;
 
 
-        /** Keychain stream object. **/
-        TemplateLRU<uint32_t, std::fstream*> *fileCache;
-
-
-        /** Keychain index stream. **/
-        std::fstream* pindex;
-
-
-        /** Total elements in hashmap for quick inserts. **/
-        std::vector<uint32_t> hashmap;
+        /** The ordered keys, with the sector keys they map to. Erased keys are kept as empty until the log is rewritten. **/
+        std::map<std::vector<uint8_t>, SectorKey> mapKeys;
 
 
-        /** The Maximum buckets allowed in the hashmap. */
-        uint32_t HASHMAP_TOTAL_BUCKETS;
+        /** Keychain log stream. **/
+        std::fstream* plog;
 
 
-        /** The Maximum cache size for allocated keys. **/
-        uint32_t HASHMAP_MAX_CACHE_SIZE;
+        /** The total entries in the log file. **/
+        uint64_t nEntries;
 
 
-        /** The Maximum key size for static key sectors. **/
-        uint16_t HASHMAP_MAX_KEY_SIZE;
-
-
-        /** The total space that a key consumes. */
-        uint16_t HASHMAP_KEY_ALLOCATION;
+        /** The total ready keys in the tree. **/
+        uint64_t nReady;
 
 
         /** The keychain flags. **/
-        uint8_t nFlags;
+        uint16_t nFlags;
 
 
-    public:
+        /** The bytes of complete entries in the log file. **/
+        uint64_t nLogSize;
 
-        /** Default Constructor **/
-        BinaryHashTree();
 
+        /** Mutex for the rewrite condition. **/
+        std::mutex CONDITION_MUTEX;
 
-        /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        BinaryHashTree(const std::string& strBaseLocationIn, const uint8_t nFlagsIn = FLAGS::APPEND);
 
+        /** The condition to wake the rewrite thread. **/
+        std::condition_variable CONDITION;
 
-        /** Default Constructor **/
-        BinaryHashTree(const std::string& strBaseLocationIn, const uint32_t nTotalBuckets, const uint32_t nMaxCacheSize, const uint8_t nFlagsIn = FLAGS::APPEND);
 
+        /** Flag to tell the rewrite thread that most of the log is superseded. **/
+        std::atomic<bool> fRewrite;
 
-        /** Copy Assignment Operator **/
-        BinaryHashTree& operator=(const BinaryHashTree& map);
 
+        /** Flag to stop the rewrite thread. **/
+        std::atomic<bool> fDestruct;
 
-        /** Copy Constructor **/
-        BinaryHashTree(const BinaryHashTree& map);
 
+        /** Thread to rewrite the log without holding up reads and writes. **/
+        std::thread RewriteThread;
 
-        /** Default Destructor **/
-        ~BinaryHashTree();
 
+    public:
 
-        /** CompressKey
-         *
-         *  Compresses a given key until it matches size criteria.
-         *  This function is one way and efficient for reducing key sizes.
+
+        /** The Database Constructor. To determine file location.
          *
-         *  @param[out] vData The binary data of key to compress.
-         *  @param[in] nSize The desired size of key after compression.
+         *  @param[in] strBaseLocationIn The directory holding the keychain files.
+         *  @param[in] nFlagsIn The keychain flags.
+         *  @param[in] nBucketsIn Unused, the tree has no buckets.
          *
          **/
-        void CompressKey(std::vector<uint8_t>& vData, uint16_t nSize = 32);
+        BinaryHashTree(const std::string& strBaseLocationIn, const uint16_t nFlagsIn = FLAGS::APPEND, const uint64_t nBucketsIn = 0);
 
 
-        /** GetKeys
-         *
-         *  Placeholder.
-         *
-         **/
-         std::vector< std::vector<uint8_t> > GetKeys();
+        /** Copy Assignment Operator **/
+        BinaryHashTree& operator=(const BinaryHashTree& map) = delete;
 
 
-        /** GetBucket
-         *
-         *  Calculates a bucket to be used for the hashmap allocation.
-         *
-         *  @param[in] vKey The key object to calculate with.
-         *
-         *  @return The bucket assigned to the key.
-         *
-         **/
-        uint32_t GetBucket(const std::vector<uint8_t>& vKey);
+        /** Copy Constructor **/
+        BinaryHashTree(const BinaryHashTree& map) = delete;
+
+
+        /** Default Destructor **/
+        virtual ~BinaryHashTree();
 
 
         /** Initialize
          *
-         *  Initialize the binary hash map keychain.
+         *  Initialize the keychain by replaying its log file.
          *
          **/
         void Initialize();
@@ -150,7 +134,7 @@ namespace LLD
 
         /** Get
          *
-         *  Read a key index from the disk hashmaps.
+         *  Read a key index from the tree.
          *
          *  @param[in] vKey The binary data of key.
          *  @param[out] cKey The key object to return.
@@ -163,7 +147,7 @@ namespace LLD
 
         /** Put
          *
-         *  Write a key to the disk hashmaps.
+         *  Write a key to the tree and its log.
          *
          *  @param[in] cKey The key object to write.
          *
@@ -173,6 +157,24 @@ namespace LLD
         bool Put(const SectorKey& cKey);
 
 
+        /** Flush
+         *
+         *  Flush all buffers to disk if using ACID transaction.
+         *
+         **/
+        void Flush();
+
+
+        /** Sync
+         *
+         *  Flush all buffers and sync the log to disk.
+         *
+         *  @return True if every keychain file was synced.
+         *
+         **/
+        bool Sync();
+
+
         /** Restore
          *
          *  Restore an erased key from keychain.
@@ -187,8 +189,7 @@ namespace LLD
 
         /** Erase
          *
-         *  Erase a key from the disk hashmaps.
-         *  TODO: This should be optimized further.
+         *  Erase a key from the tree.
          *
          *  @param[in] vKey the key to erase.
          *
@@ -196,6 +197,82 @@ namespace LLD
          *
          **/
         bool Erase(const std::vector<uint8_t> &vKey);
+
+
+        /** Iterate
+         *
+         *  Visit every ready key in order. The visited keys hold the full key bytes, in slot 0.
+         *
+         *  @param[in] xVisit The function called with each key and the slot it was found in.
+         *
+         **/
+        void Iterate(const std::function<void(const SectorKey&, const uint64_t)>& xVisit);
+
+
+        /** Relocate
+         *
+         *  Point a key found by Iterate to a new sector position.
+         *
+         *  @param[in] nSlot Unused, keys are found by their full bytes.
+         *  @param[in] cOld The key as it was visited.
+         *  @param[in] cNew The key with its new sector position.
+         *
+         *  @return True if the key was relocated.
+         *
+         **/
+        bool Relocate(const uint64_t nSlot, const SectorKey& cOld, const SectorKey& cNew);
+
+
+        /** Seek
+         *
+         *  Get the next ready keys in order that start with a prefix.
+         *
+         *  @param[in] vPrefix The prefix the keys must start with.
+         *  @param[in] vAfter The last key already seen, empty to start at the prefix.
+         *  @param[out] vKeys The keys found.
+         *  @param[in] nLimit The maximum keys to return.
+         *
+         *  @return True, the tree is ordered.
+         *
+         **/
+        bool Seek(const std::vector<uint8_t>& vPrefix, const std::vector<uint8_t>& vAfter,
+                  std::vector<std::vector<uint8_t>>& vKeys, const uint32_t nLimit);
+
+
+    private:
+
+
+        /** Append
+         *
+         *  Append the current state of a key to the log.
+         *  Must be called while holding the keychain lock.
+         *
+         *  @param[in] vKey The binary data of key.
+         *  @param[in] cKey The sector key it maps to.
+         *
+         *  @return True if the entry was written.
+         *
+         **/
+        bool Append(const std::vector<uint8_t>& vKey, const SectorKey& cKey);
+
+
+        /** Rewriter
+         *
+         *  Thread to rewrite the log when most of its entries are superseded.
+         *
+         **/
+        void Rewriter();
+
+
+        /** Rewrite
+         *
+         *  Rewrite the log with only the ready keys, dropping erased keys from the tree.
+         *  The keychain lock is only held to copy the keys and to replace the log.
+         *
+         *  @return True if the log was rewritten.
+         *
+         **/
+        bool Rewrite();
     };
 }
 
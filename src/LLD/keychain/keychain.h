@@ -17,6 +17,8 @@ ________________________________________________________________________________
 
 #include <LLD/templates/key.h>
 
+#include <functional>
+
 namespace LLD
 {
 
@@ -67,6 +69,16 @@ namespace LLD
         virtual void Flush() = 0;
 
 
+        /** Sync
+         *
+         *  Flush all buffers and sync the keychain files to disk.
+         *
+         *  @return True if every keychain file was synced.
+         *
+         **/
+        virtual bool Sync() = 0;
+
+
         /** Restore
          *
          *  Restore an erased key from keychain.
@@ -89,7 +101,69 @@ namespace LLD
          *
          **/
         virtual bool Erase(const std::vector<uint8_t>& vKey) = 0;
+
+
+        /** Iterate
+         *
+         *  Visit every ready key in the keychain. The visited keys of hashmaps hold the compressed
+         *  key bytes as found on disk, since the full keys can't be recovered from them.
+         *
+         *  @param[in] xVisit The function called with each key and the slot it was found in.
+         *
+         **/
+        virtual void Iterate(const std::function<void(const SectorKey&, const uint64_t)>& xVisit) = 0;
+
+
+        /** Relocate
+         *
+         *  Point a key found by Iterate to a new sector position. The slot is only
+         *  changed if it still holds the same key at the old sector position.
+         *
+         *  @param[in] nSlot The slot the key was found in.
+         *  @param[in] cOld The key as it was visited.
+         *  @param[in] cNew The key with its new sector position.
+         *
+         *  @return True if the key was relocated.
+         *
+         **/
+        virtual bool Relocate(const uint64_t nSlot, const SectorKey& cOld, const SectorKey& cNew) = 0;
+
+
+        /** Seek
+         *
+         *  Get the next ready keys in order that start with a prefix.
+         *  Only ordered keychains support this, the keys of hashmaps are scattered by their hash.
+         *
+         *  @param[in] vPrefix The prefix the keys must start with.
+         *  @param[in] vAfter The last key already seen, empty to start at the prefix.
+         *  @param[out] vKeys The keys found.
+         *  @param[in] nLimit The maximum keys to return.
+         *
+         *  @return True if the keychain is ordered, false otherwise.
+         *
+         **/
+        virtual bool Seek(const std::vector<uint8_t>& vPrefix, const std::vector<uint8_t>& vAfter,
+                          std::vector<std::vector<uint8_t>>& vKeys, const uint32_t nLimit)
+        {
+            return false;
+        }
     };
+
+
+    /** CreateKeychain
+     *
+     *  Create the keychain selected by the database flags.
+     *  FLAGS::ORDERED selects a BinaryHashTree, FLAGS::SHARDED selects a ShardHashMap,
+     *  otherwise a BinaryHashMap is used.
+     *
+     *  @param[in] strBaseLocation The directory holding the keychain files.
+     *  @param[in] nFlags The database flags.
+     *  @param[in] nBuckets The total buckets of the keychain.
+     *
+     *  @return The new keychain object.
+     *
+     **/
+    Keychain* CreateKeychain(const std::string& strBaseLocation, const uint16_t nFlags, const uint64_t nBuckets);
 }
 
 #endif
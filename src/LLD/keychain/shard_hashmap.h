@@ -18,6 +18,8 @@ ________________________________________________________________________________
 #include <LLD/templates/key.h>
 #include <LLD/cache/template_lru.h>
 #include <LLD/include/enum.h>
+#include <LLD/keychain/keychain.h>
+#include <LLD/keychain/hashmap.h>
 
 #include <cstdint>
 #include <string>
@@ -25,7 +27,6 @@ ________________________________________________________________________________
 #include <vector>
 #include <mutex>
 
-//TODO: Abstract base class for all keychains
 namespace LLD
 {
 
@@ -33,36 +34,43 @@ namespace LLD
      *
      *  This class is responsible for managing the keys to the sector database.
      *
-     *  It contains a Binary Hash Map with a minimum complexity of O(1).
+     *  It contains a Binary Hash Map with a minimum complexity of O(1), split into shards
+     *  that each own their index, hashmap files, and lock, so that keys in different
+     *  shards never contend with one another.
+     *
      *  It uses a linked file list based on index to iterate trhough files and binary Positions
      *  when there is a collision that is found.
      *
+     *  Buckets are found from the compressed key, the same bytes that are stored in the bucket, so
+     *  the keys of a binary hashmap keychain can be moved into the shards when it is first opened.
+     *  The shard and bucket split is kept on disk, and the keychain refuses to open with another.
+     *
      **/
-    class ShardHashMap
+    class ShardHashMap : public Keychain
     {
     protected:
 
-        /** Mutex for Thread Synchronization. **/
-        mutable std::mutex KEY_MUTEX;
+        /** Mutex for each shard, so operations on different shards run in parallel. **/
+        mutable std::vector<std::mutex> SHARD_MUTEX;
 
 
         /** The string to hold the database location. **/
         std::string strBaseLocation;
 
 
-        /** Keychain stream object. **/
-        TemplateLRU<std::pair<uint16_t, uint16_t>, std::fstream*>* fileCache;
+        /** Keychain stream objects for each shard. **/
+        std::vector<TemplateLRU<uint16_t, std::fstream*>*> vFileCache;
 
 
-        /** Disk index shard LRU cache **/
-        TemplateLRU<uint16_t, std::vector<uint16_t>*>* diskShards;
+        /** Keychain index streams for each shard. **/
+        std::vector<std::fstream*> vIndexStreams;
 
 
-        /** Keychain index stream. **/
-        TemplateLRU<uint16_t, std::fstream*>* indexCache;
+        /** Memory indexes for each shard. **/
+        std::vector<std::vector<uint16_t>> vHashmaps;
 
 
-        /** The Maximum buckets allowed in the hashmap. */
+        /** The Maximum buckets allowed in each shard. */
         uint32_t HASHMAP_TOTAL_BUCKETS;
 
 
@@ -79,31 +87,34 @@ namespace LLD
 
 
         /** The keychain flags. **/
-        uint8_t nFlags;
-
-
-        /* The key level locking hashmap. */
-        mutable std::vector<std::mutex> RECORD_MUTEX;
+        uint16_t nFlags;
 
 
     public:
 
 
-        /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        ShardHashMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn = FLAGS::APPEND,
-            const uint64_t nBucketsIn = 256 * 256 * 64, const uint32_t nShardsIn = 4);
+        /** The Database Constructor. To determine file location and the Bytes per Record.
+         *
+         *  @param[in] strBaseLocationIn The directory holding the keychain files.
+         *  @param[in] nFlagsIn The keychain flags.
+         *  @param[in] nBucketsIn The total buckets, divided evenly between the shards.
+         *  @param[in] nShardsIn The total number of shards.
+         *
+         **/
+        ShardHashMap(const std::string& strBaseLocationIn, const uint16_t nFlagsIn = FLAGS::APPEND,
+            const uint64_t nBucketsIn = 256 * 256 * 64, const uint32_t nShardsIn = 16);
 
 
         /** Copy Assignment Operator **/
-        ShardHashMap& operator=(const ShardHashMap& map);
+        ShardHashMap& operator=(const ShardHashMap& map) = delete;
 
 
         /** Copy Constructor **/
-        ShardHashMap(const ShardHashMap& map);
+        ShardHashMap(const ShardHashMap& map) = delete;
 
 
         /** Default Destructor **/
-        ~ShardHashMap();
+        virtual ~ShardHashMap();
 
 
         /** CompressKey
@@ -121,24 +132,27 @@ namespace LLD
         /** GetBucket
          *
          *  Calculates a bucket to be used for the hashmap allocation.
+         *  The shard is taken from the upper bits of the hash, so buckets are spread evenly in every shard.
          *
-         *  @param[in] vKey The key object to calculate with.
-         *  @param[in] nShard The shard assigned to hashmap object.
+         *  @param[in] vKey The compressed key to calculate with.
+         *  @param[out] nShard The shard assigned to hashmap object.
          *
          *  @return The bucket assigned to the key.
          *
          **/
-        uint32_t GetBucket(const std::vector<uint8_t>& vKey, uint32_t& nShard);
+        uint32_t GetBucket(const std::vector<uint8_t>& vKey, uint32_t& nShard) const;
 
 
         /** LoadShardIndex
          *
          *  Loads a disk index containing shard data into memory.
          *
-         *  @param[in] The shard to load index for.
+         *  @param[in] nShard The shard to load index for.
+         *
+         *  @return The total keys allocated in the shard.
          *
          **/
-        void LoadShardIndex(const uint32_t nShard);
+        uint64_t LoadShardIndex(const uint32_t nShard);
 
 
         /** Initialize
@@ -149,6 +163,26 @@ namespace LLD
         void Initialize();
 
 
+        /** CheckParams
+         *
+         *  Check the shard and bucket split against the one the keychain was built with, writing it
+         *  for a new keychain. Throws if they don't match, the keys couldn't be found otherwise.
+         *
+         **/
+        void CheckParams();
+
+
+        /** Migrate
+         *
+         *  Move every key of a binary hashmap keychain in the same location into the shards,
+         *  then remove its files so it isn't probed again.
+         *
+         *  @param[in] nBucketsIn The total buckets of the binary hashmap keychain.
+         *
+         **/
+        void Migrate(const uint64_t nBucketsIn);
+
+
         /** Get
          *
          *  Read a key index from the disk hashmaps.
@@ -188,6 +222,24 @@ namespace LLD
         bool Put(const SectorKey& cKey);
 
 
+        /** Flush
+         *
+         *  Flush all buffers to disk if using ACID transaction.
+         *
+         **/
+        void Flush();
+
+
+        /** Sync
+         *
+         *  Flush all buffers and sync the index and hashmap files of every shard to disk.
+         *
+         *  @return True if every keychain file was synced.
+         *
+         **/
+        bool Sync();
+
+
         /** Restore
          *
          *  Restore an erased key from keychain.
@@ -203,7 +255,6 @@ namespace LLD
         /** Erase
          *
          *  Erase a key from the disk hashmaps.
-         *  TODO: This should be optimized further.
          *
          *  @param[in] vKey the key to erase.
          *
@@ -211,6 +262,63 @@ namespace LLD
          *
          **/
         bool Erase(const std::vector<uint8_t> &vKey);
+
+
+        /** Iterate
+         *
+         *  Visit every ready key in the shards.
+         *  Slots are numbered by shard, file and bucket.
+         *
+         *  @param[in] xVisit The function called with each key and the slot it was found in.
+         *
+         **/
+        void Iterate(const std::function<void(const SectorKey&, const uint64_t)>& xVisit);
+
+
+        /** Relocate
+         *
+         *  Point a key found by Iterate to a new sector position.
+         *
+         *  @param[in] nSlot The slot the key was found in.
+         *  @param[in] cOld The key as it was visited.
+         *  @param[in] cNew The key with its new sector position.
+         *
+         *  @return True if the key was relocated.
+         *
+         **/
+        bool Relocate(const uint64_t nSlot, const SectorKey& cOld, const SectorKey& cNew);
+
+
+    private:
+
+
+        /** GetStream
+         *
+         *  Get the stream object for a hashmap file in a shard.
+         *  Must be called while holding the shard lock.
+         *
+         *  @param[in] nShard The shard the file belongs to.
+         *  @param[in] nFile The hashmap file in the shard.
+         *
+         *  @return The stream object, nullptr if the file couldn't be opened.
+         *
+         **/
+        std::fstream* GetStream(const uint32_t nShard, const uint16_t nFile);
+
+
+        /** PutKey
+         *
+         *  Write a key to a shard.
+         *  Must be called while holding the shard lock.
+         *
+         *  @param[in] cKey The key object to write.
+         *  @param[in] nShard The shard assigned to the key.
+         *  @param[in] nBucket The bucket assigned to the key.
+         *
+         *  @return True if the key was written, false otherwise.
+         *
+         **/
+        bool PutKey(const SectorKey& cKey, const uint32_t nShard, const uint32_t nBucket);
     };
 }
 
@@ -17,13 +17,16 @@ ________________________________________________________________________________
 
 #include <LLD/types/register.h>
 
+#include <TAO/Ledger/types/verify_cache.h>
+
 #include <TAO/Register/include/enum.h>
+#include <TAO/Register/types/object.h>
 
 namespace LLD
 {
 
     /** The Database Constructor. To determine file location and the Bytes per Record. **/
-    RegisterDB::RegisterDB(const uint8_t nFlagsIn, const uint32_t nBucketsIn, const uint32_t nCacheIn)
+    RegisterDB::RegisterDB(const uint16_t nFlagsIn, const uint32_t nBucketsIn, const uint32_t nCacheIn)
     : SectorDatabase(std::string("_REGISTER")
     , nFlagsIn
     , nBucketsIn
@@ -33,6 +36,7 @@ namespace LLD
     , pMemory(nullptr)
     , pMiner(nullptr)
     , pCommit(new RegisterTransaction())
+    , fIndexes(false)
     {
     }
 
@@ -164,8 +168,18 @@ namespace LLD
                 strType = "NONE";
         }
 
+        /* Update the secondary indexes in the same transaction as the state. */
+        if(fIndexes.load() && !UpdateIndexes(hashRegister, &state))
+            return debug::error(FUNCTION, "failed to update indexes for ", hashRegister.SubString());
+
         /* Write the state to the register database */
-        return Write(std::make_pair(std::string("state"), hashRegister), state, strType);
+        if(!Write(std::make_pair(std::string("state"), hashRegister), state, strType))
+            return false;
+
+        /* Transactions verified against the previous state need verifying again. */
+        TAO::Ledger::verifycache.Written(hashRegister);
+
+        return true;
     }
 
 
@@ -305,7 +319,18 @@ namespace LLD
                 return true;
         }
 
-        return Erase(std::make_pair(std::string("state"), hashRegister));
+        /* Remove the secondary indexes in the same transaction as the state. */
+        if(fIndexes.load() && !UpdateIndexes(hashRegister, nullptr))
+            return debug::error(FUNCTION, "failed to update indexes for ", hashRegister.SubString());
+
+        /* Erase the state from the register database */
+        if(!Erase(std::make_pair(std::string("state"), hashRegister)))
+            return false;
+
+        /* Transactions verified against the previous state need verifying again. */
+        TAO::Ledger::verifycache.Written(hashRegister);
+
+        return true;
     }
 
 
@@ -430,6 +455,190 @@ namespace LLD
         return Exists(std::make_pair(std::string("state"), hashRegister));
     }
 
+
+    /* Check the secondary indexes are complete, rebuilding them if requested. */
+    bool RegisterDB::InitializeIndexes(const bool fReindex)
+    {
+        /* Indexes are walked by prefix, so hashmap keychains can't use them. */
+        if(!Seek(std::string("indexes")).Ordered())
+        {
+            if(fReindex)
+                return debug::error(FUNCTION, "-reindex-registers requires -registerkeychain=tree");
+
+            debug::log(0, FUNCTION, "Register indexes are disabled, they require -registerkeychain=tree");
+            return false;
+        }
+
+        /* Rebuild the indexes from every state register. */
+        if(fReindex)
+        {
+            debug::log(0, FUNCTION, "Rebuilding register indexes...");
+
+            /* Mark the indexes as incomplete until they are rebuilt. */
+            Erase(std::string("indexes"));
+
+            /* Remove the old indexes. */
+            const std::vector<std::string> vIndexes = { "owner", "standard", "token" };
+            for(const auto& strIndex : vIndexes)
+            {
+                Cursor cursor = Seek(strIndex);
+
+                std::vector<uint8_t> vKey;
+                while(cursor.NextKey(vKey))
+                    Delete(vKey);
+            }
+
+            /* Index every state register. */
+            Cursor cursor = Seek(std::string("state"));
+
+            uint64_t nTotal = 0;
+            std::pair<std::string, uint256_t> pairState;
+            TAO::Register::State state;
+            while(cursor.Next(pairState, state))
+            {
+                if(!WriteIndexes(pairState.second, state, false))
+                    return debug::error(FUNCTION, "failed to index ", pairState.second.SubString());
+
+                /* Show progress of large databases. */
+                if(++nTotal % 100000 == 0)
+                    debug::log(0, FUNCTION, "Indexed ", nTotal, " registers");
+            }
+
+            debug::log(0, FUNCTION, "Rebuilt register indexes for ", nTotal, " registers");
+        }
+
+        /* Check for complete indexes. */
+        else if(!Exists(std::string("indexes")))
+        {
+            /* A database without states can start its indexes now. */
+            std::vector<uint8_t> vKey;
+            if(Seek(std::string("state")).NextKey(vKey))
+            {
+                debug::log(0, FUNCTION, "Register indexes are incomplete, start with -reindex-registers to rebuild them");
+                return false;
+            }
+        }
+
+        /* Mark the indexes as complete. */
+        if(!Write(std::string("indexes"), uint32_t(1)))
+            return debug::error(FUNCTION, "failed to write index marker");
+
+        fIndexes.store(true);
+
+        return true;
+    }
+
+
+    /* List the registers owned by a genesis or a register, from the owner index. */
+    bool RegisterDB::ListOwner(const uint256_t& hashOwner, std::vector<uint256_t>& vRegisters)
+    {
+        return ListIndex(std::string("owner"), hashOwner, vRegisters);
+    }
+
+
+    /* List the object registers of an object standard, from the standard index. */
+    bool RegisterDB::ListStandard(const uint8_t nStandard, std::vector<uint256_t>& vRegisters)
+    {
+        return ListIndex(std::string("standard"), nStandard, vRegisters);
+    }
+
+
+    /* List the accounts of a token, from the token index. */
+    bool RegisterDB::ListToken(const uint256_t& hashToken, std::vector<uint256_t>& vRegisters)
+    {
+        return ListIndex(std::string("token"), hashToken, vRegisters);
+    }
+
+
+    /* Update the secondary indexes of a register to a new state, or remove them if it is erased. */
+    bool RegisterDB::UpdateIndexes(const uint256_t& hashRegister, const TAO::Register::State* pstate)
+    {
+        /* Get the previous state, including one written earlier in this transaction. */
+        TAO::Register::State statePrev;
+        if(!Read(std::make_pair(std::string("state"), hashRegister), statePrev))
+        {
+            /* New registers get all of their indexes. */
+            if(pstate)
+                return WriteIndexes(hashRegister, *pstate, false);
+
+            return true;
+        }
+
+        /* Erased registers lose all of their indexes. */
+        if(!pstate)
+            return WriteIndexes(hashRegister, statePrev, true);
+
+        /* Object fields are fixed when created, so only a transfer or claim changes the indexes. */
+        if(statePrev.hashOwner == pstate->hashOwner)
+            return true;
+
+        /* Move the owner index to the new owner. */
+        Erase(std::make_tuple(std::string("owner"), statePrev.hashOwner, hashRegister));
+
+        return Write(std::make_tuple(std::string("owner"), pstate->hashOwner, hashRegister));
+    }
+
+
+    /* Write or erase every secondary index of a state register. */
+    bool RegisterDB::WriteIndexes(const uint256_t& hashRegister, const TAO::Register::State& state, const bool fErase)
+    {
+        /* Index every register by its owner. */
+        const auto tupleOwner = std::make_tuple(std::string("owner"), state.hashOwner, hashRegister);
+        if(fErase)
+            Erase(tupleOwner);
+        else if(!Write(tupleOwner))
+            return false;
+
+        /* Only object registers have a standard. */
+        if(state.nType != TAO::Register::REGISTER::OBJECT)
+            return true;
+
+        /* Skip objects that fail to parse. */
+        TAO::Register::Object object = TAO::Register::Object(state);
+        if(!object.Parse())
+            return true;
+
+        /* Index objects by their standard. */
+        const auto tupleStandard = std::make_tuple(std::string("standard"), object.Standard(), hashRegister);
+        if(fErase)
+            Erase(tupleStandard);
+        else if(!Write(tupleStandard))
+            return false;
+
+        /* Only accounts, trust accounts and tokens have a token identifier. */
+        if(object.Base() != TAO::Register::OBJECTS::ACCOUNT)
+            return true;
+
+        /* Index accounts by their token. */
+        const auto tupleToken = std::make_tuple(std::string("token"), object.get<uint256_t>("token"), hashRegister);
+        if(fErase)
+            Erase(tupleToken);
+        else if(!Write(tupleToken))
+            return false;
+
+        return true;
+    }
+
+
+    /* List the registers of one value of a secondary index. */
+    template<typename Type>
+    bool RegisterDB::ListIndex(const std::string& strIndex, const Type& value, std::vector<uint256_t>& vRegisters)
+    {
+        /* Check the indexes are complete, callers fall back to scanning the ledger. */
+        if(!fIndexes.load())
+            return debug::error(FUNCTION, strIndex, " index is unavailable, it requires -registerkeychain=tree and complete indexes");
+
+        /* Walk the keys of this value in address order. */
+        Cursor cursor = Seek(std::make_pair(strIndex, value));
+
+        std::tuple<std::string, Type, uint256_t> tupleIndex;
+        while(cursor.NextKey(tupleIndex))
+            vRegisters.push_back(std::get<2>(tupleIndex));
+
+        return true;
+    }
+
+
     /* Begin a memory transaction following ACID properties. */
     void RegisterDB::MemoryBegin(const uint8_t nFlags)
     {
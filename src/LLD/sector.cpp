@@ -15,24 +15,55 @@ ________________________________________________________________________________
 
 #include <LLD/cache/binary_lfu.h>
 #include <LLD/cache/binary_lru.h>
+#include <LLD/cache/shard_lru.h>
 
 #include <LLD/keychain/filemap.h>
 #include <LLD/keychain/hashmap.h>
 #include <LLD/keychain/shard_hashmap.h>
 #include <LLD/keychain/hashtree.h>
 
+#include <LLD/hash/xxh3.h>
+
+#include <LLD/compress/lz4.h>
+
 #include <Util/include/filesystem.h>
 #include <Util/include/hex.h>
 
+#include <cstring>
 #include <functional>
+#include <algorithm>
+#include <map>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace LLD
 {
 
+    /* Construct the keychain object for a concrete keychain type. */
+    template<class KeychainType>
+    KeychainType* NewKeychain(const std::string& strLocation, const uint16_t nFlags, const uint64_t nBuckets)
+    {
+        return new KeychainType(strLocation, nFlags, nBuckets);
+    }
+
+
+    /* The abstract keychain type is selected at runtime by the database flags. */
+    template<>
+    Keychain* NewKeychain<Keychain>(const std::string& strLocation, const uint16_t nFlags, const uint64_t nBuckets)
+    {
+        return CreateKeychain(strLocation, nFlags, nBuckets);
+    }
+
+
     /* The Database Constructor. To determine file location and the Bytes per Record. */
     template<class KeychainType, class CacheType>
     SectorDatabase<KeychainType, CacheType>::SectorDatabase(const std::string& strNameIn,
-                                                            const uint8_t nFlagsIn, const uint64_t nBucketsIn,
+                                                            const uint16_t nFlagsIn, const uint64_t nBucketsIn,
                                                             const uint32_t nCacheIn)
     : CONDITION_MUTEX()
     , CONDITION()
@@ -43,22 +74,37 @@ namespace LLD
     , strName(strNameIn)
     , runtime()
     , pTransaction(nullptr)
-    , pSectorKeys(new KeychainType((config::GetDataDir() + strName + "/keychain/"), nFlagsIn, nBucketsIn))
+    , pSectorKeys(NewKeychain<KeychainType>((config::GetDataDir() + strName + "/keychain/"), nFlagsIn, nBucketsIn))
     , cachePool(new CacheType(nCacheIn))
     , fileCache(new TemplateLRU<uint32_t, std::fstream*>(8))
+    , FILE_MUTEX()
+    , RECORD_MUTEX(1024)
+    , vMapped((nFlagsIn & FLAGS::MMAP) ? MAX_SECTOR_MAP_FILES : 0)
+    , vMappedSize((nFlagsIn & FLAGS::MMAP) ? MAX_SECTOR_MAP_FILES : 0)
+    , vDescriptors(MAX_SECTOR_MAP_FILES)
+    , vReaders(MAX_SECTOR_MAP_FILES)
     , nCurrentFile(0)
     , nCurrentFileSize(0)
     , CacheWriterThread()
     , MeterThread()
+    , CompactThread()
     , vDiskBuffer()
     , nBufferBytes(0)
     , nBytesRead(0)
     , nBytesWrote(0)
     , nRecordsFlushed(0)
+    , nBytesReclaimed(0)
+    , nRelocations(0)
+    , nBytesSaved(0)
     , fDestruct(false)
     , fInitialized(false)
     , nFlags(nFlagsIn)
+    , nCompressMin(static_cast<uint32_t>(std::max(config::GetArg("-lldcompressmin", 256), int64_t(SECTOR_COMPRESSED_HEADER + 1))))
     {
+        /* Set the descriptors to closed state. */
+        for(auto& nFD : vDescriptors)
+            nFD.store(-1);
+
         /* Set readonly flag if write or append are not specified. */
         if(!(nFlags & FLAGS::FORCE) && !(nFlags & FLAGS::WRITE) && !(nFlags & FLAGS::APPEND))
             nFlags |= FLAGS::READONLY;
@@ -74,6 +120,7 @@ namespace LLD
 
         CacheWriterThread = std::thread(std::bind(&SectorDatabase::CacheWriter, this));
         MeterThread = std::thread(std::bind(&SectorDatabase::Meter, this));
+        CompactThread = std::thread(std::bind(&SectorDatabase::Compactor, this));
     }
 
 
@@ -90,6 +137,9 @@ namespace LLD
         if(MeterThread.joinable())
             MeterThread.join();
 
+        if(CompactThread.joinable())
+            CompactThread.join();
+
         if(pTransaction)
             delete pTransaction;
 
@@ -99,6 +149,20 @@ namespace LLD
         if(fileCache)
             delete fileCache;
 
+        #ifndef WIN32
+
+        /* Release the memory maps. */
+        for(auto& pMapped : vMapped)
+            if(pMapped.load())
+                munmap(pMapped.load(), MAX_SECTOR_MAP_SIZE);
+
+        /* Close the read descriptors. */
+        for(auto& nFD : vDescriptors)
+            if(nFD.load() >= 0)
+                close(nFD.load());
+
+        #endif
+
         if(pSectorKeys)
             delete pSectorKeys;
     }
@@ -144,6 +208,10 @@ namespace LLD
             ++nCurrentFile;
         }
 
+        /* Map the current file for reading if enabled. */
+        if(nFlags & FLAGS::MMAP)
+            MapFile(nCurrentFile);
+
         pTransaction = nullptr;
         fInitialized = true;
     }
@@ -152,6 +220,19 @@ namespace LLD
     /*  Get a record from cache or from disk */
     template<class KeychainType, class CacheType>
     bool SectorDatabase<KeychainType, CacheType>::Get(const std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData)
+    {
+        /* Get the record of this key. */
+        if(!GetRecord(vKey, vData))
+            return false;
+
+        /* Follow it to the indexed record if it is a link. */
+        return ReadLink(vData);
+    }
+
+
+    /*  Get the record of a key from cache or from disk, without following links. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::GetRecord(const std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData)
     {
         /* Iterate if meters are enabled. */
         nBytesRead += static_cast<uint32_t>(vKey.size() + vData.size());
@@ -164,48 +245,24 @@ namespace LLD
         SectorKey cKey;
         if(pSectorKeys->Get(vKey, cKey))
         {
+            /* Read the record from the sector file. */
+            if(!ReadSector(cKey, vData))
             {
-                LOCK(SECTOR_MUTEX);
-
-                /* Find the file stream for LRU cache. */
-                std::fstream* pstream;
-                if(!fileCache->Get(cKey.nSectorFile, pstream))
-                {
-                    /* Set the new stream pointer. */
-                    pstream = new std::fstream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), cKey.nSectorFile), std::ios::in | std::ios::out | std::ios::binary);
-                    if(!pstream->is_open())
-                    {
-                        delete pstream;
-                        return debug::error(FUNCTION, "couldn't create stream file");
-                    }
-
-                    /* If file not found add to LRU cache. */
-                    fileCache->Put(cKey.nSectorFile, pstream);
-                }
-
-                /* Get compact size from record. */
-                uint64_t nSize = GetSizeOfCompactSize(cKey.nSectorSize);
-
-                /* Seek to the Sector Position on Disk. */
-                pstream->seekg(cKey.nSectorStart + nSize, std::ios::beg);
-
-                /* Resize for proper record length. */
-                vData.resize(cKey.nSectorSize - nSize);
-
-                /* Read the State and Size of Sector Header. */
-                if(!pstream->read((char*) &vData[0], vData.size()))
-                    return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes read");
+                /* The compactor may have moved the record after we read its key. */
+                SectorKey cMoved;
+                if(!pSectorKeys->Get(vKey, cMoved)
+                || (cMoved.nSectorFile == cKey.nSectorFile && cMoved.nSectorStart == cKey.nSectorStart))
+                    return false;
 
+                /* Read the record from its new position. */
+                cKey = cMoved;
+                if(!ReadSector(cKey, vData))
+                    return false;
             }
 
             /* Add to cache */
             cachePool->Put(cKey, vKey, vData);
 
-            /* Verbose Debug Logging. */
-            if(config::nVerbose >= 5)
-                debug::log(5, FUNCTION, "Current File: ", cKey.nSectorFile,
-                    " | Current File Size: ", cKey.nSectorStart, "\n", HexStr(vData.begin(), vData.end(), true));
-
             return true;
         }
 
@@ -213,22 +270,91 @@ namespace LLD
     }
 
 
+    /*  Read the record an index key links to. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::ReadLink(std::vector<uint8_t>& vData)
+    {
+        /* Records that aren't links are used as they are. */
+        if(vData.empty() || vData[0] != SECTOR_LINK)
+            return true;
+
+        /* Get the record of the indexed key. */
+        const std::vector<uint8_t> vIndex(vData.begin() + 1, vData.end());
+        if(!GetRecord(vIndex, vData))
+            return false;
+
+        /* Links are always written to the indexed record, never to another link. */
+        if(!vData.empty() && vData[0] == SECTOR_LINK)
+            return debug::error(FUNCTION, "index key links to another link");
+
+        return true;
+    }
+
+
     /*  Get a record from from disk if the sector key
      *  is already read from the keychain. */
     template<class KeychainType, class CacheType>
     bool SectorDatabase<KeychainType, CacheType>::Get(const SectorKey& cKey, std::vector<uint8_t>& vData)
     {
+        nBytesRead += static_cast<uint32_t>(cKey.vKey.size() + vData.size());
+
+        /* Check the cache pool for key first. */
+        if(cachePool->Get(cKey.vKey, vData))
+            return true;
+
+        return ReadSector(cKey, vData);
+    }
+
+
+    /*  Read a record from its sector file. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::ReadSector(const SectorKey& cKey, std::vector<uint8_t>& vData)
+    {
+        /* Share the record lock with other readers, only writers updating this record in place block us. */
+        SLOCK(RecordMutex(cKey));
+
+        /* Let the compactor know that this file is being read. */
+        std::atomic<uint32_t>& nReaders = vReaders[cKey.nSectorFile];
+        ++nReaders;
+
+        /* Read the record from its sector file. */
+        const bool fRead = ReadRecord(cKey, vData);
+        --nReaders;
+
+        /* Decompress the record outside of the file, it was read whole. */
+        return fRead && Decompress(vData);
+    }
+
+
+    /*  Read a record from its sector file without taking the record lock. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::ReadRecord(const SectorKey& cKey, std::vector<uint8_t>& vData)
+    {
+        /* Check for files that were retired by the compactor. */
+        if(vDescriptors[cKey.nSectorFile].load() == -2)
+            return false;
+
+        /* Read from memory mapped file if enabled. */
+        if((nFlags & FLAGS::MMAP) && GetMapped(cKey, vData))
+            return true;
+
+        #ifndef WIN32
+
+        /* Positional reads don't depend on stream position, so they don't need the sector lock. */
+        if(GetPositional(cKey, vData))
+            return true;
+
+        #endif
+
         {
             LOCK(SECTOR_MUTEX);
 
-            nBytesRead += static_cast<uint32_t>(cKey.vKey.size() + vData.size());
-
-            /* Check the cache pool for key first. */
-            if(cachePool->Get(cKey.vKey, vData))
-                return true;
+            /* Don't reopen a stream to a file that was retired since we checked. */
+            if(vDescriptors[cKey.nSectorFile].load() == -2)
+                return false;
 
             /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
+            std::fstream* pstream;
             if(!fileCache->Get(cKey.nSectorFile, pstream))
             {
                 /* Set the new stream pointer. */
@@ -236,7 +362,7 @@ namespace LLD
                 if(!pstream->is_open())
                 {
                     delete pstream;
-                    return false;
+                    return debug::error(FUNCTION, "couldn't create stream file");
                 }
 
                 /* If file not found add to LRU cache. */
@@ -255,38 +381,275 @@ namespace LLD
             /* Read the State and Size of Sector Header. */
             if(!pstream->read((char*) &vData[0], vData.size()))
                 return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes read");
-
-            /* Verboe output. */
-            if(config::nVerbose >= 5)
-                debug::log(5, FUNCTION, "Current File: ", cKey.nSectorFile,
-                    " | Current File Size: ", cKey.nSectorStart, "\n", HexStr(vData.begin(), vData.end(), true));
         }
 
+        /* Verbose Debug Logging. */
+        if(config::nVerbose >= 5)
+            debug::log(5, FUNCTION, "Current File: ", cKey.nSectorFile,
+                " | Current File Size: ", cKey.nSectorStart, "\n", HexStr(vData.begin(), vData.end(), true));
+
         return true;
     }
 
 
-    /*  Update a record on disk. */
+    /*  Read a record by pointer arithmetic from a memory mapped sector file. */
     template<class KeychainType, class CacheType>
-    bool SectorDatabase<KeychainType, CacheType>::Update(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData)
+    bool SectorDatabase<KeychainType, CacheType>::GetMapped(const SectorKey& cKey, std::vector<uint8_t>& vData)
     {
-        /* Check the keychain for key. */
-        SectorKey key;
-        if(!pSectorKeys->Get(vKey, key))
+        /* Check that the sector fits inside of our reserved address space. */
+        const uint64_t nEnd = static_cast<uint64_t>(cKey.nSectorStart) + cKey.nSectorSize;
+        if(nEnd > MAX_SECTOR_MAP_SIZE)
             return false;
 
-        /* Get current size */
-        uint64_t nSize = vData.size() + GetSizeOfCompactSize(vData.size());
+        /* Get the mapped file, mapping it if it's the first read. */
+        uint8_t* pBegin = vMapped[cKey.nSectorFile].load(std::memory_order_acquire);
+        if(!pBegin)
+            pBegin = MapFile(cKey.nSectorFile);
+
+        /* Check for failed maps. */
+        if(!pBegin)
+            return false;
 
-        /* Check data size constraints. */
-        if(nSize != key.nSectorSize)
+        /* Stale or corrupt keys past the end of the file are left to the positional read, which fails cleanly. */
+        if(nEnd > vMappedSize[cKey.nSectorFile].load(std::memory_order_acquire))
             return false;
 
-        /* Write the data into the memory cache. */
-        cachePool->Put(key, vKey, vData, false);
+        /* Get compact size from record. */
+        uint64_t nSize = GetSizeOfCompactSize(cKey.nSectorSize);
 
+        /* Copy the record out of the mapped region. */
+        const uint8_t* pRecord = pBegin + cKey.nSectorStart + nSize;
+        vData.assign(pRecord, pRecord + (cKey.nSectorSize - nSize));
+
+        /* Verbose Debug Logging. */
+        if(config::nVerbose >= 5)
+            debug::log(5, FUNCTION, "Mapped File: ", cKey.nSectorFile,
+                " | Current File Size: ", cKey.nSectorStart, "\n", HexStr(vData.begin(), vData.end(), true));
+
+        return true;
+    }
+
+
+    /*  Read a record with a positional read from a shared read-only descriptor. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::GetPositional(const SectorKey& cKey, std::vector<uint8_t>& vData)
+    {
+        #ifndef WIN32
+
+        /* Get the file descriptor, opening it if it's the first read. */
+        int32_t nFD = OpenFile(cKey.nSectorFile);
+        if(nFD < 0)
+            return false;
+
+        /* Get compact size from record. */
+        uint64_t nSize = GetSizeOfCompactSize(cKey.nSectorSize);
+
+        /* Resize for proper record length. */
+        vData.resize(cKey.nSectorSize - nSize);
+
+        /* Read until the whole record is in, pread can return short counts. */
+        uint64_t nRead = 0;
+        while(nRead < vData.size())
         {
-            LOCK(SECTOR_MUTEX);
+            ssize_t nBytes = pread(nFD, &vData[nRead], vData.size() - nRead, cKey.nSectorStart + nSize + nRead);
+            if(nBytes < 0 && errno == EINTR)
+                continue;
+
+            if(nBytes <= 0)
+                return debug::error(FUNCTION, "only ", nRead, "/", vData.size(), " bytes read");
+
+            nRead += static_cast<uint64_t>(nBytes);
+        }
+
+        /* Verbose Debug Logging. */
+        if(config::nVerbose >= 5)
+            debug::log(5, FUNCTION, "Current File: ", cKey.nSectorFile,
+                " | Current File Size: ", cKey.nSectorStart, "\n", HexStr(vData.begin(), vData.end(), true));
+
+        return true;
+        #else
+        return false;
+        #endif
+    }
+
+
+    /*  Get the striped lock protecting a record from in place updates. */
+    template<class KeychainType, class CacheType>
+    shared_mutex& SectorDatabase<KeychainType, CacheType>::RecordMutex(const SectorKey& cKey) const
+    {
+        /* Mix the file into the position so records at the same offset in different files don't collide. */
+        const uint64_t nPosition = (static_cast<uint64_t>(cKey.nSectorFile) << 32) | cKey.nSectorStart;
+
+        return RECORD_MUTEX[XXH64(&nPosition, sizeof(nPosition), 0) % RECORD_MUTEX.size()];
+    }
+
+
+    /*  Memory map a sector file read-only if it is not mapped already. */
+    template<class KeychainType, class CacheType>
+    uint8_t* SectorDatabase<KeychainType, CacheType>::MapFile(const uint32_t nFile)
+    {
+        /* Check that we are within our map table. */
+        if(nFile >= vMapped.size())
+            return nullptr;
+
+        #ifndef WIN32
+        LOCK(FILE_MUTEX);
+
+        /* Check if another thread mapped this file before we obtained the lock. */
+        uint8_t* pBegin = vMapped[nFile].load(std::memory_order_acquire);
+        if(pBegin)
+            return pBegin;
+
+        /* Don't map files that were retired by the compactor. */
+        if(vDescriptors[nFile].load() == -2)
+            return nullptr;
+
+        /* Open the file descriptor for the map. */
+        const std::string strFile = debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nFile);
+        int32_t nFD = open(strFile.c_str(), O_RDONLY);
+        if(nFD < 0)
+        {
+            debug::error(FUNCTION, "couldn't open ", strFile, " (", strerror(errno), ")");
+            return nullptr;
+        }
+
+        /* Get the size of the file, only this much of the map is backed until records are appended. */
+        struct stat stFile;
+        if(fstat(nFD, &stFile) != 0)
+        {
+            debug::error(FUNCTION, "couldn't stat ", strFile, " (", strerror(errno), ")");
+            close(nFD);
+
+            return nullptr;
+        }
+
+        /* Reserve the full address space so that the map is valid as the file grows. */
+        void* pMap = mmap(nullptr, MAX_SECTOR_MAP_SIZE, PROT_READ, MAP_SHARED, nFD, 0);
+        close(nFD);
+
+        /* Check for map failures. */
+        if(pMap == MAP_FAILED)
+        {
+            debug::error(FUNCTION, "couldn't map ", strFile, " (", strerror(errno), ")");
+            return nullptr;
+        }
+
+        /* Let the kernel know we will be reading records randomly. */
+        madvise(pMap, MAX_SECTOR_MAP_SIZE, MADV_RANDOM);
+
+        /* Publish the backed size before the map, so readers never see a map without its size. */
+        ExtendMapped(nFile, static_cast<uint64_t>(stFile.st_size));
+
+        /* Publish the map for lock free readers. */
+        pBegin = static_cast<uint8_t*>(pMap);
+        vMapped[nFile].store(pBegin, std::memory_order_release);
+
+        debug::log(3, FUNCTION, "mapped sector file ", nFile, " for ", strName);
+
+        return pBegin;
+        #else
+        return nullptr;
+        #endif
+    }
+
+
+    /*  Raise the backed size of a mapped sector file, never lowering it. */
+    template<class KeychainType, class CacheType>
+    void SectorDatabase<KeychainType, CacheType>::ExtendMapped(const uint32_t nFile, const uint64_t nSize)
+    {
+        /* Check that we are within our map table. */
+        if(nFile >= vMappedSize.size())
+            return;
+
+        /* An append and a new map can race, so keep whichever size is larger. */
+        uint64_t nKnown = vMappedSize[nFile].load(std::memory_order_acquire);
+        while(nKnown < nSize && !vMappedSize[nFile].compare_exchange_weak(nKnown, nSize, std::memory_order_acq_rel))
+            ;
+    }
+
+
+    /*  Open a read-only descriptor for a sector file if it is not opened already. */
+    template<class KeychainType, class CacheType>
+    int32_t SectorDatabase<KeychainType, CacheType>::OpenFile(const uint32_t nFile)
+    {
+        /* Check that we are within our descriptor table. */
+        if(nFile >= vDescriptors.size())
+            return -1;
+
+        /* Check the descriptor table without locking. */
+        int32_t nFD = vDescriptors[nFile].load(std::memory_order_acquire);
+        if(nFD >= 0)
+            return nFD;
+
+        #ifndef WIN32
+        LOCK(FILE_MUTEX);
+
+        /* Check if another thread opened this file before we obtained the lock. */
+        nFD = vDescriptors[nFile].load(std::memory_order_acquire);
+        if(nFD >= 0)
+            return nFD;
+
+        /* Don't reopen files that were retired by the compactor. */
+        if(nFD == -2)
+            return -1;
+
+        /* Open the file for reading only, writes still go through the append streams. */
+        const std::string strFile = debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nFile);
+        nFD = open(strFile.c_str(), O_RDONLY);
+        if(nFD < 0)
+        {
+            debug::error(FUNCTION, "couldn't open ", strFile, " (", strerror(errno), ")");
+            return -1;
+        }
+
+        /* Publish the descriptor for lock free readers. */
+        vDescriptors[nFile].store(nFD, std::memory_order_release);
+        #endif
+
+        return nFD;
+    }
+
+
+    /*  Update a record on disk. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::Update(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData,
+                                                         const std::vector<uint8_t>& vSector)
+    {
+        /* The compactor can move the record between reading its key and locking it, so retry until the key is current. */
+        while(true)
+        {
+            /* Track records moved by the compactor while we work on the key. */
+            const uint64_t nMoved = nRelocations.load();
+
+            /* Check the keychain for key. */
+            SectorKey key;
+            if(!pSectorKeys->Get(vKey, key))
+                return false;
+
+            /* Check data size constraints, compressed records are padded out to fill their sector. */
+            std::vector<uint8_t> vPadded;
+            const std::vector<uint8_t>* pSector = FitSector(key, vData, vSector, vPadded);
+            if(!pSector)
+                return false;
+
+            /* Hold the record lock so readers never see a partially updated record. */
+            WLOCK(RecordMutex(key));
+
+            /* Read the key again if records were moved, positions are never reused so an unchanged one is current. */
+            if(nRelocations.load() != nMoved)
+            {
+                SectorKey cCurrent;
+                if(!pSectorKeys->Get(vKey, cCurrent))
+                    return false;
+
+                if(cCurrent.nSectorFile != key.nSectorFile || cCurrent.nSectorStart != key.nSectorStart)
+                    continue;
+            }
+
+            /* Write the data into the memory cache. */
+            cachePool->Put(key, vKey, vData, false);
+
+            LOCK2(SECTOR_MUTEX);
 
             /* Find the file stream for LRU cache. */
             std::fstream* pstream;
@@ -308,96 +671,159 @@ namespace LLD
             pstream->seekp(key.nSectorStart, std::ios::beg);
 
             /* Write the size of record. */
-            WriteCompactSize(*pstream, vData.size());
+            WriteCompactSize(*pstream, pSector->size());
 
             /* Write the data record. */
-            if(!pstream->write((char*) &vData[0], vData.size()))
-                return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes written");
+            if(!pstream->write((char*) &(*pSector)[0], pSector->size()))
+                return debug::error(FUNCTION, "only ", pstream->gcount(), "/", pSector->size(), " bytes written");
 
             pstream->flush();
 
+            /* The record needs syncing before the journal of its transaction is released. */
+            setUnsynced.insert(key.nSectorFile);
+
             /* Records flushed indicator. */
             ++nRecordsFlushed;
-            nBytesWrote += static_cast<uint32_t>(vData.size());
+            nBytesWrote += static_cast<uint32_t>(pSector->size());
 
             /* Verbose output. */
             if(config::nVerbose >= 5)
                 debug::log(5, FUNCTION, "Current File: ", key.nSectorFile,
                     " | Current File Size: ", key.nSectorStart, "\n", HexStr(vData.begin(), vData.end(), true));
+
+            return true;
         }
+    }
 
-        return true;
+
+    /*  Get the bytes to write a record into an existing sector in place. */
+    template<class KeychainType, class CacheType>
+    const std::vector<uint8_t>* SectorDatabase<KeychainType, CacheType>::FitSector(const SectorKey& key,
+        const std::vector<uint8_t>& vData, const std::vector<uint8_t>& vSector, std::vector<uint8_t>& vPadded) const
+    {
+        /* Check for a sector the same size. */
+        if(vSector.size() + GetSizeOfCompactSize(vSector.size()) == key.nSectorSize)
+            return &vSector;
+
+        /* Sectors that were written uncompressed can take the record as is. */
+        if(vData.size() + GetSizeOfCompactSize(vData.size()) == key.nSectorSize)
+            return &vData;
+
+        /* Only compressed records can be padded, uncompressed ones are read back whole. */
+        if(vSector.empty() || vSector[0] != SECTOR_COMPRESSED || key.nSectorSize <= SECTOR_COMPRESSED_HEADER)
+            return nullptr;
+
+        /* Find the size of the data after the compact size of the sector. */
+        uint64_t nPayload = key.nSectorSize - 1;
+        while(nPayload + GetSizeOfCompactSize(nPayload) > key.nSectorSize)
+            --nPayload;
+
+        /* Check that the compressed record fits. */
+        if(nPayload + GetSizeOfCompactSize(nPayload) != key.nSectorSize || nPayload < vSector.size())
+            return nullptr;
+
+        /* Pad the record with zeros past the compressed data. */
+        vPadded = vSector;
+        vPadded.resize(nPayload, 0);
+
+        return &vPadded;
     }
 
 
-    /*  Force a write to disk immediately bypassing write buffers. */
+    /*  LZ4 compress a record if the database is in COMPRESS mode and the record is large enough. */
     template<class KeychainType, class CacheType>
-    bool SectorDatabase<KeychainType, CacheType>::Force(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData)
+    bool SectorDatabase<KeychainType, CacheType>::Compress(const std::vector<uint8_t>& vData, std::vector<uint8_t>& vSector)
     {
-        if(nFlags & FLAGS::APPEND || !Update(vKey, vData))
+        /* Check that compression is enabled and worth it for this record. */
+        if(!(nFlags & FLAGS::COMPRESS) || vData.size() < nCompressMin)
+            return false;
+
+        /* Compress the record behind the header. */
+        const int32_t nBound = LZ4_compressBound(static_cast<int32_t>(vData.size()));
+        vSector.resize(SECTOR_COMPRESSED_HEADER + nBound);
+
+        const int32_t nCompressed = LZ4_compress_default((const char*)&vData[0], (char*)&vSector[SECTOR_COMPRESSED_HEADER],
+            static_cast<int32_t>(vData.size()), nBound);
+
+        /* Write the record as is if it doesn't get any smaller. */
+        if(nCompressed <= 0 || SECTOR_COMPRESSED_HEADER + nCompressed >= vData.size())
+            return false;
+
+        vSector.resize(SECTOR_COMPRESSED_HEADER + nCompressed);
+
+        /* Write the header with the sizes of the record and its compressed data. */
+        const uint32_t nSize = static_cast<uint32_t>(vData.size());
+        vSector[0] = SECTOR_COMPRESSED;
+        for(uint32_t i = 0; i < 4; ++i)
         {
+            vSector[i + 1] = static_cast<uint8_t>(nSize >> (i * 8));
+            vSector[i + 5] = static_cast<uint8_t>(static_cast<uint32_t>(nCompressed) >> (i * 8));
+        }
 
-            {
-                LOCK(SECTOR_MUTEX);
+        nBytesSaved += (vData.size() - vSector.size());
 
-                /* Create new file if above current file size. */
-                if(nCurrentFileSize > MAX_SECTOR_FILE_SIZE)
-                {
-                    debug::log(4, FUNCTION, "allocating new sector file ", nCurrentFile + 1);
+        return true;
+    }
 
-                    ++nCurrentFile;
-                    nCurrentFileSize = 0;
 
-                    std::ofstream stream
-                    (
-                        debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile),
-                        std::ios::out | std::ios::binary | std::ios::trunc
-                    );
-                    stream.close();
-                }
+    /*  Decompress a sector in place if it was written compressed. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::Decompress(std::vector<uint8_t>& vData) const
+    {
+        /* Records written uncompressed are used as they are. */
+        if(vData.empty() || vData[0] != SECTOR_COMPRESSED)
+            return true;
 
-                /* Find the file stream for LRU cache. */
-                std::fstream* pstream;
-                if(!fileCache->Get(nCurrentFile, pstream))
-                {
-                    /* Set the new stream pointer. */
-                    pstream = new std::fstream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile), std::ios::in | std::ios::out | std::ios::binary);
-                    if(!pstream->is_open())
-                    {
-                        delete pstream;
-                        return false;
-                    }
-
-                    /* If file not found add to LRU cache. */
-                    fileCache->Put(nCurrentFile, pstream);
-                }
+        /* Check that the header is all there. */
+        if(vData.size() <= SECTOR_COMPRESSED_HEADER)
+            return debug::error(FUNCTION, "compressed sector too small ", vData.size());
 
-                /* If it is a New Sector, Assign a Binary Position. */
-                pstream->seekp(nCurrentFileSize, std::ios::beg);
+        /* Get the sizes of the record and its compressed data, which can be followed by padding. */
+        uint32_t nSize = 0, nCompressed = 0;
+        for(uint32_t i = 0; i < 4; ++i)
+        {
+            nSize       |= (static_cast<uint32_t>(vData[i + 1]) << (i * 8));
+            nCompressed |= (static_cast<uint32_t>(vData[i + 5]) << (i * 8));
+        }
 
-                /* Write the size of record. */
-                WriteCompactSize(*pstream, vData.size());
+        /* Records are only compressed when they get smaller, and never grow past the size of a sector file. */
+        if(nCompressed > vData.size() - SECTOR_COMPRESSED_HEADER || nSize <= nCompressed || nSize > MAX_SECTOR_MAP_SIZE)
+            return debug::error(FUNCTION, "invalid compressed sector ", nCompressed, "/", nSize, " bytes");
 
-                /* Write the data record. */
-                if(!pstream->write((char*) &vData[0], vData.size()))
-                    return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes written");
+        /* Decompress into a new buffer, the sizes have to match exactly. */
+        std::vector<uint8_t> vRecord(nSize);
+        const int32_t nDecompressed = LZ4_decompress_safe((const char*)&vData[SECTOR_COMPRESSED_HEADER], (char*)&vRecord[0],
+            static_cast<int32_t>(nCompressed), static_cast<int32_t>(nSize));
 
-                pstream->flush();
-            }
+        if(nDecompressed != static_cast<int32_t>(nSize))
+            return debug::error(FUNCTION, "failed to decompress sector ", nDecompressed, "/", nSize, " bytes");
 
-            /* Get current size */
-            uint64_t nSize = vData.size() + GetSizeOfCompactSize(vData.size());
+        vData.swap(vRecord);
 
+        return true;
+    }
+
+
+    /*  Force a write to disk immediately bypassing write buffers. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::Force(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData)
+    {
+        /* Compress the record once for either an update or an append. */
+        std::vector<uint8_t> vCompressed;
+        const std::vector<uint8_t>& vSector = Compress(vData, vCompressed) ? vCompressed : vData;
+
+        if(nFlags & FLAGS::APPEND || !Update(vKey, vData, vSector))
+        {
             /* Create a new Sector Key. */
-            SectorKey key(STATE::READY, vKey, static_cast<uint16_t>(nCurrentFile),
-                            nCurrentFileSize, static_cast<uint32_t>(nSize));
+            SectorKey key(STATE::READY, vKey, 0, 0, 0);
 
-            /* Increment the current filesize */
-            nCurrentFileSize += static_cast<uint32_t>(nSize);
+            /* Write the record to the end of the current file. */
+            if(!AppendSector(vSector, key))
+                return false;
 
             /* Records flushed indicator. */
             ++nRecordsFlushed;
-            nBytesWrote += static_cast<uint32_t>(nSize);
+            nBytesWrote += key.nSectorSize;
 
             /* Assign the Key to Keychain. */
             if(!pSectorKeys->Put(key))
@@ -416,6 +842,82 @@ namespace LLD
     }
 
 
+    /*  Append a record to the end of the current sector file. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::AppendSector(const std::vector<uint8_t>& vData, SectorKey& key)
+    {
+        LOCK(SECTOR_MUTEX);
+
+        /* Create new file if above current file size. */
+        if(nCurrentFileSize > MAX_SECTOR_FILE_SIZE)
+        {
+            debug::log(4, FUNCTION, "allocating new sector file ", nCurrentFile + 1);
+
+            ++nCurrentFile;
+            nCurrentFileSize = 0;
+
+            std::ofstream stream
+            (
+                debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile),
+                std::ios::out | std::ios::binary | std::ios::trunc
+            );
+            stream.close();
+
+            /* Map the new file for readers. */
+            if(nFlags & FLAGS::MMAP)
+                MapFile(nCurrentFile);
+        }
+
+        /* Find the file stream for LRU cache. */
+        std::fstream* pstream;
+        if(!fileCache->Get(nCurrentFile, pstream))
+        {
+            /* Set the new stream pointer. */
+            pstream = new std::fstream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile), std::ios::in | std::ios::out | std::ios::binary);
+            if(!pstream->is_open())
+            {
+                delete pstream;
+                return false;
+            }
+
+            /* If file not found add to LRU cache. */
+            fileCache->Put(nCurrentFile, pstream);
+        }
+
+        /* If it is a New Sector, Assign a Binary Position. */
+        pstream->seekp(nCurrentFileSize, std::ios::beg);
+
+        /* Write the size of record. */
+        WriteCompactSize(*pstream, vData.size());
+
+        /* Write the data record. */
+        if(!pstream->write((char*) &vData[0], vData.size()))
+            return debug::error(FUNCTION, "only ", pstream->gcount(), "/", vData.size(), " bytes written");
+
+        pstream->flush();
+
+        /* The record needs syncing before the journal of its transaction is released. */
+        setUnsynced.insert(nCurrentFile);
+
+        /* Get current size */
+        uint64_t nSize = vData.size() + GetSizeOfCompactSize(vData.size());
+
+        /* Set the position of the record while we still hold the tail. */
+        key.nSectorFile  = static_cast<uint16_t>(nCurrentFile);
+        key.nSectorStart = nCurrentFileSize;
+        key.nSectorSize  = static_cast<uint32_t>(nSize);
+
+        /* Increment the current filesize */
+        nCurrentFileSize += static_cast<uint32_t>(nSize);
+
+        /* The record was flushed to the file, so mapped readers can reach it. */
+        if(nFlags & FLAGS::MMAP)
+            ExtendMapped(nCurrentFile, nCurrentFileSize);
+
+        return true;
+    }
+
+
     /*  Write a record into the cache and disk buffer for flushing to disk. */
     template<class KeychainType, class CacheType>
     bool SectorDatabase<KeychainType, CacheType>::Put(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData)
@@ -464,7 +966,13 @@ namespace LLD
             return true;
 
         {
-            LOCK(SECTOR_MUTEX);
+            /* Hold the record lock so readers never see a partially deleted record. */
+            WLOCK(RecordMutex(key));
+            LOCK2(SECTOR_MUTEX);
+
+            /* Nothing to blank if the compactor moved the record and retired its file. */
+            if(vDescriptors[key.nSectorFile].load() == -2)
+                return true;
 
             /* Find the file stream for LRU cache. */
             std::fstream* pstream;
@@ -546,21 +1054,7 @@ namespace LLD
                 nBufferBytes = 0;
             }
 
-            /* Create a new file if the sector file size is over file size limits. */
-            if(nCurrentFileSize > MAX_SECTOR_FILE_SIZE)
-            {
-                debug::log(0, FUNCTION, "allocating new sector file ", nCurrentFile + 1);
-
-                /* Iterate the current file and reset current file sie. */
-                ++nCurrentFile;
-                nCurrentFileSize = 0;
-
-                /* Create a new file for next writes. */
-                std::fstream stream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nCurrentFile), std::ios::out | std::ios::binary | std::ios::trunc);
-                stream.close();
-            }
-
-            /* Iterate through buffer to queue disk writes. */
+            /* Iterate through buffer to queue disk writes, Force allocates new sector files as they fill. */
             for(const auto& vObj : vIndexes)
             {
                 /* Force write data. */
@@ -608,7 +1102,7 @@ namespace LLD
             double RPS = nBytesRead.load() / (TIMER.Elapsed() * 1024.0);
 
             /* Check for zero values. */
-            if(WPS == 0 && RPS == 0 && nRecordsFlushed.load() == 0)
+            if(WPS == 0 && RPS == 0 && nRecordsFlushed.load() == 0 && nBytesReclaimed.load() == 0 && nBytesSaved.load() == 0)
                 continue;
 
             /* Debug output. */
@@ -616,12 +1110,321 @@ namespace LLD
                 ANSI_COLOR_FUNCTION, strName, " LLD : ", ANSI_COLOR_RESET,
                 "Writing ", WPS, " Kb/s | ",
                 "Reading ", RPS, " Kb/s | ",
-                "Records ", nRecordsFlushed.load());
+                "Records ", nRecordsFlushed.load(), " | ",
+                "Reclaimed ", nBytesReclaimed.load() / 1024, " Kb | ",
+                "Saved ", nBytesSaved.load() / 1024, " Kb");
 
             TIMER.Reset();
             nBytesWrote.store(0);
             nBytesRead.store(0);
             nRecordsFlushed.store(0);
+            nBytesReclaimed.store(0);
+            nBytesSaved.store(0);
+        }
+    }
+
+
+    /*  LLD Compactor Thread. Periodically compacts the sector files. */
+    template<class KeychainType, class CacheType>
+    void SectorDatabase<KeychainType, CacheType>::Compactor()
+    {
+        if(!config::GetBoolArg("-lldcompact", false))
+            return;
+
+        /* Compacting writes records, so it is disabled in read-only mode. */
+        if(nFlags & FLAGS::READONLY)
+            return;
+
+        /* Get the interval in seconds and dead space percentage to compact at. */
+        const uint64_t nInterval = std::max(config::GetArg("-lldcompactinterval", 600), int64_t(1));
+        const uint32_t nRatio    = static_cast<uint32_t>(std::min(std::max(config::GetArg("-lldcompactratio", 50), int64_t(0)), int64_t(100)));
+
+        runtime::timer TIMER;
+        TIMER.Start();
+
+        while(!fDestruct.load())
+        {
+            runtime::sleep(100);
+            if(TIMER.Elapsed() < nInterval)
+                continue;
+
+            Compact(nRatio);
+            TIMER.Reset();
+        }
+    }
+
+
+    /*  Rewrite the live records of sector files with too much dead space and retire the old files. */
+    template<class KeychainType, class CacheType>
+    uint64_t SectorDatabase<KeychainType, CacheType>::Compact(const uint32_t nRatio)
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        /* Only files behind the append tail are compacted. */
+        uint32_t nLastFile = 0;
+        {
+            LOCK(SECTOR_MUTEX);
+            nLastFile = nCurrentFile;
+        }
+
+        /* Collect the position of every record in those files, keychain only keys have no record. */
+        std::vector<std::pair<uint64_t, uint32_t>> vRecords;
+        pSectorKeys->Iterate([&](const SectorKey& cKey, const uint64_t nSlot)
+        {
+            if(cKey.nSectorSize > 0 && cKey.nSectorFile < nLastFile)
+                vRecords.push_back(std::make_pair((uint64_t(cKey.nSectorFile) << 32) | cKey.nSectorStart, cKey.nSectorSize));
+        });
+
+        /* Records with more than one key are only counted once. */
+        std::sort(vRecords.begin(), vRecords.end());
+        vRecords.erase(std::unique(vRecords.begin(), vRecords.end()), vRecords.end());
+
+        /* Sum up the live bytes in each file. */
+        std::vector<uint64_t> vLive(nLastFile, 0);
+        for(const auto& record : vRecords)
+            vLive[record.first >> 32] += record.second;
+
+        vRecords.clear();
+        vRecords.shrink_to_fit();
+
+        /* Find the files with enough dead space to be worth rewriting. */
+        std::vector<bool> vCompact(nLastFile, false);
+        uint32_t nFiles = 0;
+        for(uint32_t nFile = 0; nFile < nLastFile; ++nFile)
+        {
+            /* Skip files that are already retired. */
+            if(vDescriptors[nFile].load() == -2)
+                continue;
+
+            /* Get the Binary Size. */
+            std::ifstream stream(debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nFile), std::ios::in | std::ios::binary | std::ios::ate);
+            if(!stream)
+                continue;
+
+            const uint64_t nSize = static_cast<uint64_t>(stream.tellg());
+            if(nSize == 0 || vLive[nFile] >= nSize)
+                continue;
+
+            /* Check the dead space against our ratio. */
+            if((nSize - vLive[nFile]) * 100 >= nSize * nRatio)
+            {
+                vCompact[nFile] = true;
+                ++nFiles;
+            }
+        }
+
+        /* Check that there is work to do. */
+        if(nFiles == 0)
+            return 0;
+
+        /* Group the keys in those files by record, ordered by position so the old files are read sequentially. */
+        std::map<uint64_t, std::vector<std::pair<SectorKey, uint64_t>>> mapRecords;
+        pSectorKeys->Iterate([&](const SectorKey& cKey, const uint64_t nSlot)
+        {
+            if(cKey.nSectorSize > 0 && cKey.nSectorFile < nLastFile && vCompact[cKey.nSectorFile])
+                mapRecords[(uint64_t(cKey.nSectorFile) << 32) | cKey.nSectorStart].push_back(std::make_pair(cKey, nSlot));
+        });
+
+        /* Move the live records to the end of the current file. */
+        uint64_t nMoved = 0;
+        for(const auto& record : mapRecords)
+        {
+            /* Check for shutdown, the old files are left as they are. */
+            if(fDestruct.load())
+                return 0;
+
+            if(MoveRecord(record.second))
+                ++nMoved;
+        }
+        mapRecords.clear();
+
+        /* The moved records and their keys must be on disk before the old copies are truncated. */
+        if(!TxnSync() || !pSectorKeys->Sync())
+        {
+            debug::error(FUNCTION, strName, " failed to sync moved records, old sector files are kept");
+
+            return 0;
+        }
+
+        /* Check that no keys were pointed into the old files while we were moving them. */
+        pSectorKeys->Iterate([&](const SectorKey& cKey, const uint64_t nSlot)
+        {
+            if(cKey.nSectorSize > 0 && cKey.nSectorFile < nLastFile)
+                vCompact[cKey.nSectorFile] = false;
+        });
+
+        /* Retire the files that no longer have any live records. */
+        uint64_t nReclaimed = 0;
+        for(uint32_t nFile = 0; nFile < nLastFile; ++nFile)
+            if(vCompact[nFile])
+                nReclaimed += RetireFile(nFile);
+
+        /* Add to the meter. */
+        nBytesReclaimed += nReclaimed;
+
+        debug::log(0, FUNCTION, strName, " compacted ", nFiles, " sector files, moved ", nMoved,
+            " records and reclaimed ", nReclaimed, " bytes in ", timer.ElapsedMilliseconds(), " ms");
+
+        return nReclaimed;
+    }
+
+
+    /*  Move a record to the end of the current sector file and point all of its keys to it. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::MoveRecord(const std::vector<std::pair<SectorKey, uint64_t>>& vKeys)
+    {
+        /* All of the keys point to the same record. */
+        const SectorKey& cOld = vKeys[0].first;
+
+        /* Hold the record lock so in place updates and deletes wait for the move. */
+        WLOCK(RecordMutex(cOld));
+
+        /* Read the record from its old position. */
+        std::vector<uint8_t> vData;
+        if(!ReadRecord(cOld, vData))
+            return debug::error(FUNCTION, "failed to read record from sector file ", cOld.nSectorFile);
+
+        /* Write the record to the end of the current file. */
+        SectorKey cNew;
+        if(!AppendSector(vData, cNew))
+            return debug::error(FUNCTION, "failed to append record");
+
+        /* Point the keys to the new position, keys written since they were visited are left alone. */
+        for(const auto& item : vKeys)
+        {
+            SectorKey cKey = item.first;
+            cKey.nSectorFile  = cNew.nSectorFile;
+            cKey.nSectorStart = cNew.nSectorStart;
+            cKey.nSectorSize  = cNew.nSectorSize;
+
+            pSectorKeys->Relocate(item.second, item.first, cKey);
+        }
+
+        /* Let writers that read a key before it moved know to read it again. */
+        ++nRelocations;
+
+        return true;
+    }
+
+
+    /*  Close a sector file that has no live records and truncate it. */
+    template<class KeychainType, class CacheType>
+    uint64_t SectorDatabase<KeychainType, CacheType>::RetireFile(const uint32_t nFile)
+    {
+        const std::string strFile = debug::safe_printstr(strBaseLocation, "_block.", std::setfill('0'), std::setw(5), nFile);
+
+        /* Get the Binary Size. */
+        uint64_t nSize = 0;
+        {
+            std::ifstream stream(strFile, std::ios::in | std::ios::binary | std::ios::ate);
+            if(!stream)
+                return 0;
+
+            nSize = static_cast<uint64_t>(stream.tellg());
+        }
+
+        /* Mark the file as retired so no new descriptors or maps are opened. */
+        int32_t nFD = -1;
+        uint8_t* pMapped = nullptr;
+        {
+            LOCK(FILE_MUTEX);
+
+            nFD = vDescriptors[nFile].exchange(-2);
+            if(nFile < vMapped.size())
+            {
+                pMapped = vMapped[nFile].exchange(nullptr);
+                vMappedSize[nFile].store(0);
+            }
+        }
+
+        /* Close the stream, Remove frees it. */
+        {
+            LOCK(SECTOR_MUTEX);
+            fileCache->Remove(nFile);
+        }
+
+        /* Wait for the readers that were already inside of this file. */
+        while(vReaders[nFile].load() > 0)
+            runtime::sleep(1);
+
+        #ifndef WIN32
+
+        /* Release the map and descriptor now that nobody can be using them. */
+        if(pMapped)
+            munmap(pMapped, MAX_SECTOR_MAP_SIZE);
+
+        if(nFD >= 0)
+            close(nFD);
+
+        #endif
+
+        /* Truncate the file rather than deleting it, since sector files are found by their numbering on startup. */
+        std::ofstream stream(strFile, std::ios::out | std::ios::binary | std::ios::trunc);
+        stream.close();
+
+        debug::log(2, FUNCTION, strName, " retired sector file ", nFile, " of ", nSize, " bytes");
+
+        return nSize;
+    }
+
+
+    /*  Write a key pointing to the same sector as an existing key. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::IndexKey(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vIndex)
+    {
+        /* Compressed records can't be updated in place when they grow, so index keys are written as links. */
+        if(nFlags & FLAGS::COMPRESS)
+        {
+            /* Check that the indexed key exists and isn't the same key. */
+            std::vector<uint8_t> vLink;
+            if(vKey == vIndex || !GetRecord(vIndex, vLink))
+                return false;
+
+            /* Link to the indexed record directly if the index is a link itself. */
+            if(vLink.empty() || vLink[0] != SECTOR_LINK)
+            {
+                vLink.assign(1, SECTOR_LINK);
+                vLink.insert(vLink.end(), vIndex.begin(), vIndex.end());
+            }
+
+            /* Always append links, a previous index key can share the sector of its record. */
+            SectorKey cKey(STATE::READY, vKey, 0, 0, 0);
+            if(!AppendSector(vLink, cKey))
+                return false;
+
+            /* Records flushed indicator. */
+            ++nRecordsFlushed;
+            nBytesWrote += cKey.nSectorSize;
+
+            /* Assign the Key to Keychain. */
+            if(!pSectorKeys->Put(cKey))
+                return debug::error(FUNCTION, "failed to write key to keychain");
+
+            /* Write the link into the memory cache. */
+            cachePool->Put(cKey, vKey, vLink, false);
+
+            return true;
+        }
+
+        while(true)
+        {
+            /* Track records moved by the compactor while we copy the key. */
+            const uint64_t nMoved = nRelocations.load();
+
+            /* Get the key. */
+            SectorKey cKey;
+            if(!pSectorKeys->Get(vIndex, cKey))
+                return false;
+
+            /* Write the new sector key. */
+            cKey.SetKey(vKey);
+            if(!pSectorKeys->Put(cKey))
+                return false;
+
+            /* Write it again if the position we copied may have been moved. */
+            if(nRelocations.load() == nMoved)
+                return true;
         }
     }
 
@@ -643,7 +1446,7 @@ namespace LLD
 
     /*  Write the transaction commitment message. */
     template<class KeychainType, class CacheType>
-    bool SectorDatabase<KeychainType, CacheType>::TxnCheckpoint()
+    bool SectorDatabase<KeychainType, CacheType>::TxnCheckpoint(TxnJournal& journal)
     {
         LOCK(TRANSACTION_MUTEX);
 
@@ -654,15 +1457,8 @@ namespace LLD
         /* Set commit message into journal. */
         pTransaction->ssJournal << std::string("commit");
 
-        /* Create an append only stream. */
-        std::ofstream stream = std::ofstream(debug::safe_printstr(config::GetDataDir(), strName, "/journal.dat"), std::ios::app | std::ios::binary);
-        if(!stream.is_open())
-            return debug::error(FUNCTION, "failed to open journal file");
-
-        /* Write to the file.  */
-        const std::vector<uint8_t>& vBytes = pTransaction->ssJournal.Bytes();
-        stream.write((char*)&vBytes[0], vBytes.size());
-        stream.close();
+        /* Add to the shared journal, which is synced once for all databases. */
+        journal.Append(strName, pTransaction->ssJournal.Bytes());
 
         return true;
     }
@@ -680,10 +1476,6 @@ namespace LLD
 
         /** Set the transaction pointer to null also acting like a flag **/
         pTransaction = nullptr;
-
-        /* Delete the transaction journal file. */
-        std::ofstream stream(debug::safe_printstr(config::GetDataDir(), strName, "/journal.dat"), std::ios::trunc);
-        stream.close();
     }
 
 
@@ -716,26 +1508,9 @@ namespace LLD
         }
 
         /* Commit the index data. */
-        std::map<std::vector<uint8_t>, SectorKey> mapIndex;
         for(const auto& item : pTransaction->mapIndex)
-        {
-            /* Get the key. */
-            SectorKey cKey;
-            if(mapIndex.count(item.second))
-                cKey = mapIndex[item.second];
-            else
-            {
-                if(!pSectorKeys->Get(item.second, cKey))
-                    return debug::error(FUNCTION, "failed to read indexing entry");
-
-                mapIndex[item.second] = cKey;
-            }
-
-            /* Write the new sector key. */
-            cKey.SetKey(item.first);
-            if(!pSectorKeys->Put(cKey))
+            if(!IndexKey(item.first, item.second))
                 return debug::error(FUNCTION, "failed to write indexing entry");
-        }
 
         /* Cleanup the transaction object. */
         delete pTransaction;
@@ -745,40 +1520,63 @@ namespace LLD
     }
 
 
-    /*  Recover a transaction from the journal. */
+    /*  Sync the sector files written since the last sync to disk. */
     template<class KeychainType, class CacheType>
-    bool SectorDatabase<KeychainType, CacheType>::TxnRecovery()
+    bool SectorDatabase<KeychainType, CacheType>::TxnSync()
     {
-        /* Create an append only stream. */
-        std::ifstream stream(debug::safe_printstr(config::GetDataDir(), strName, "/journal.dat"), std::ios::in | std::ios::out | std::ios::binary);
-        if(!stream.is_open())
-            return false;
+        /* Get the files written since the last sync. */
+        std::set<uint32_t> setFiles;
+        {
+            LOCK(SECTOR_MUTEX);
+            setFiles.swap(setUnsynced);
+        }
 
-        /* Get the Binary Size. */
-        stream.ignore(std::numeric_limits<std::streamsize>::max());
+        #ifndef WIN32
+        for(auto it = setFiles.begin(); it != setFiles.end(); ++it)
+        {
+            const uint32_t nFile = *it;
+
+            /* The read only descriptor syncs the pages written through the append streams. */
+            const int32_t nFD = OpenFile(nFile);
+            #ifdef __APPLE__
+            const bool fSynced = (nFD >= 0 && fsync(nFD) == 0);
+            #else
+            const bool fSynced = (nFD >= 0 && fdatasync(nFD) == 0);
+            #endif
+
+            /* Files retired by the compactor have no live records left to sync. */
+            if(fSynced || (nFile < vDescriptors.size() && vDescriptors[nFile].load() == -2))
+                continue;
 
-        /* Get the data buffer. */
-        uint32_t nSize = static_cast<uint32_t>(stream.gcount());
+            /* Keep the files that weren't synced for the next sync. */
+            {
+                LOCK(SECTOR_MUTEX);
+                setUnsynced.insert(it, setFiles.end());
+            }
 
-        /* Check journal size for 0. */
-        if(nSize == 0)
-            return false;
+            return debug::error(FUNCTION, "failed to sync sector file ", nFile, " (", strerror(errno), ")");
+        }
+        #endif
 
-        /* Create buffer to read into. */
-        std::vector<uint8_t> vBuffer(nSize, 0);
+        return true;
+    }
 
-        /* Read the keychain file. */
-        stream.seekg (0, std::ios::beg);
-        stream.read((char*) &vBuffer[0], vBuffer.size());
-        stream.close();
 
-        debug::log(0, FUNCTION, strName, " transaction journal detected of ", nSize, " bytes");
+    /*  Recover a transaction from its records in the journal. */
+    template<class KeychainType, class CacheType>
+    bool SectorDatabase<KeychainType, CacheType>::TxnRecovery(const std::vector<uint8_t>& vJournal)
+    {
+        /* Check journal size for 0. */
+        if(vJournal.empty())
+            return false;
+
+        debug::log(0, FUNCTION, strName, " transaction journal detected of ", vJournal.size(), " bytes");
 
         /* Create the transaction object. */
         TxnBegin();
 
         /* Serialize the key. */
-        const DataStream ssJournal(vBuffer, SER_LLD, DATABASE_VERSION);
+        const DataStream ssJournal(vJournal, SER_LLD, DATABASE_VERSION);
         while(!ssJournal.End())
         {
             /* Read the data entry type. */
@@ -844,6 +1642,10 @@ namespace LLD
             }
             if(strType == "commit")
             {
+                /* The journals of groups kept for recovery follow each other, so replay all of them. */
+                if(!ssJournal.End())
+                    continue;
+
                 debug::log(0, FUNCTION, strName, " transaction journal ready to be restored");
 
                 return true;
@@ -856,7 +1658,10 @@ namespace LLD
 
     /* Explicity instantiate all template instances needed for compiler. */
     template class SectorDatabase<BinaryHashMap,  BinaryLRU>;
-    //template class SectorDatabase<ShardHashMap,   BinaryLRU>;
+    template class SectorDatabase<ShardHashMap,   BinaryLRU>;
+    template class SectorDatabase<Keychain,       BinaryLRU>;
+    template class SectorDatabase<BinaryHashMap,  ShardLRU>;
+    template class SectorDatabase<Keychain,       ShardLRU>;
     //template class SectorDatabase<BinaryHashMap,  BinaryLFU>;
     //template class SectorDatabase<BinaryHashTree, BinaryLRU>;
 
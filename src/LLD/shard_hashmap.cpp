@@ -11,6 +11,7 @@
 
 ____________________________________________________________________________________________*/
 
+
 #include <LLD/keychain/shard_hashmap.h>
 #include <LLD/include/enum.h>
 #include <LLD/include/version.h>
@@ -22,72 +23,46 @@ ________________________________________________________________________________
 #include <Util/include/hex.h>
 
 #include <iomanip>
+#include <cstring>
+#include <algorithm>
 
 namespace LLD
 {
 
     /** The Database Constructor. To determine file location and the Bytes per Record. **/
-    ShardHashMap::ShardHashMap(const std::string& strBaseLocationIn, const uint8_t nFlagsIn,
+    ShardHashMap::ShardHashMap(const std::string& strBaseLocationIn, const uint16_t nFlagsIn,
         const uint64_t nBucketsIn, const uint32_t nShardsIn)
-    : KEY_MUTEX()
+    : SHARD_MUTEX(std::max(nShardsIn, 1u))
     , strBaseLocation(strBaseLocationIn)
-    , fileCache(new TemplateLRU<std::pair<uint16_t, uint16_t>, std::fstream*>(8))
-    , diskShards(new TemplateLRU<uint16_t, std::vector<uint16_t>*>(nShardsIn))
-    , indexCache(new TemplateLRU<uint16_t, std::fstream*>(nShardsIn))
-    , HASHMAP_TOTAL_BUCKETS(nBucketsIn)
-    , HASHMAP_TOTAL_SHARDS(nShardsIn)
+    , vFileCache(std::max(nShardsIn, 1u), nullptr)
+    , vIndexStreams(std::max(nShardsIn, 1u), nullptr)
+    , vHashmaps(std::max(nShardsIn, 1u))
+    , HASHMAP_TOTAL_BUCKETS(static_cast<uint32_t>(std::max(nBucketsIn / std::max(nShardsIn, 1u), uint64_t(1))))
+    , HASHMAP_TOTAL_SHARDS(std::max(nShardsIn, 1u))
     , HASHMAP_MAX_KEY_SIZE(32)
     , HASHMAP_KEY_ALLOCATION(static_cast<uint16_t>(HASHMAP_MAX_KEY_SIZE + 13))
     , nFlags(nFlagsIn)
-    , RECORD_MUTEX(1024)
-    {
-        Initialize();
-    }
-
-
-    /* Copy Constructor */
-    ShardHashMap::ShardHashMap(const ShardHashMap& map)
-    : KEY_MUTEX()
-    , strBaseLocation(map.strBaseLocation)
-    , fileCache(map.fileCache)
-    , diskShards(map.diskShards)
-    , indexCache(map.indexCache)
-    , HASHMAP_TOTAL_BUCKETS(map.HASHMAP_TOTAL_BUCKETS)
-    , HASHMAP_TOTAL_SHARDS(map.HASHMAP_TOTAL_SHARDS)
-    , HASHMAP_MAX_KEY_SIZE(map.HASHMAP_MAX_KEY_SIZE)
-    , HASHMAP_KEY_ALLOCATION(map.HASHMAP_KEY_ALLOCATION)
-    , nFlags(map.nFlags)
-    , RECORD_MUTEX(map.RECORD_MUTEX.size())
-    {
-        Initialize();
-    }
-
-
-    /* Copy Assignment Operator */
-    ShardHashMap& ShardHashMap::operator=(const ShardHashMap& map)
     {
-        strBaseLocation        = map.strBaseLocation;
-        fileCache              = map.fileCache;
-        diskShards             = map.diskShards;
-        indexCache             = map.indexCache;
-        HASHMAP_TOTAL_BUCKETS  = map.HASHMAP_TOTAL_BUCKETS;
-        HASHMAP_TOTAL_SHARDS   = map.HASHMAP_TOTAL_SHARDS;
-        HASHMAP_MAX_KEY_SIZE   = map.HASHMAP_MAX_KEY_SIZE;
-        HASHMAP_KEY_ALLOCATION = map.HASHMAP_KEY_ALLOCATION;
-        nFlags                 = map.nFlags;
-
         Initialize();
 
-        return *this;
+        /* Move the keys of a binary hashmap keychain in the same location into the shards. */
+        if(filesystem::exists(debug::safe_printstr(strBaseLocation, "_hashmap.index")))
+            Migrate(nBucketsIn);
     }
 
 
     /** Default Destructor **/
     ShardHashMap::~ShardHashMap()
     {
-        delete fileCache;
-        delete diskShards;
-        delete indexCache;
+        /* Cleanup the shard streams. */
+        for(uint32_t nShard = 0; nShard < HASHMAP_TOTAL_SHARDS; ++nShard)
+        {
+            if(vFileCache[nShard])
+                delete vFileCache[nShard];
+
+            if(vIndexStreams[nShard])
+                delete vIndexStreams[nShard];
+        }
     }
 
 
@@ -114,31 +89,28 @@ namespace LLD
 
 
     /*  Calculates a bucket to be used for the hashmap allocation. */
-    uint32_t ShardHashMap::GetBucket(const std::vector<uint8_t>& vKey, uint32_t& nShard)
+    uint32_t ShardHashMap::GetBucket(const std::vector<uint8_t>& vKey, uint32_t& nShard) const
     {
         /* Get an xxHash. */
-        uint64_t nBucket = XXH64(&vKey[0], vKey.size(), 0) / 7;
-        nShard = static_cast<uint32_t>(nBucket % HASHMAP_TOTAL_SHARDS);
+        uint64_t nHash = XXH64(&vKey[0], vKey.size(), 0);
+
+        /* Use the upper bits for the shard so it doesn't correlate with the bucket. */
+        nShard = static_cast<uint32_t>((nHash >> 32) % HASHMAP_TOTAL_SHARDS);
 
         /* Get the hashmap bucket. */
-        return static_cast<uint32_t>(nBucket % HASHMAP_TOTAL_BUCKETS);
+        return static_cast<uint32_t>((nHash / 7) % HASHMAP_TOTAL_BUCKETS);
     }
 
 
     /* Loads a disk index containing shard data into memory.*/
-    static uint64_t TOTAL_KEYS = 0;
-    void ShardHashMap::LoadShardIndex(const uint32_t nShard)
+    uint64_t ShardHashMap::LoadShardIndex(const uint32_t nShard)
     {
-        /* Check that disk index isn't already loaded. */
-        if(diskShards->Has(nShard))
-            return;
-
         /* Build the hashmap indexes. */
         std::string index = debug::safe_printstr(strBaseLocation, "_index.", std::setfill('0'), std::setw(3), nShard);
         if(!filesystem::exists(index))
         {
             /* Generate empty space for new file. */
-            const static std::vector<uint8_t> vSpace(HASHMAP_TOTAL_BUCKETS * 2, 0);
+            std::vector<uint8_t> vSpace(HASHMAP_TOTAL_BUCKETS * 2, 0);
 
             /* Write the new disk index .*/
             std::fstream stream(index, std::ios::out | std::ios::binary | std::ios::trunc);
@@ -147,57 +119,40 @@ namespace LLD
 
             /* Debug output showing generation of disk index. */
             debug::log(0, FUNCTION, "Generated Disk Index ", nShard, " of ", vSpace.size(), " bytes");
-
-            /* Set disk index cache to blank values. */
-            std::vector<uint16_t>* hashmap = new std::vector<uint16_t>(HASHMAP_TOTAL_BUCKETS, 0);
-
-            /* Add to the LRU cache. */
-            diskShards->Put(nShard, hashmap);
         }
 
-        /* Read the hashmap indexes. */
-        else
+        /* Create the stream index object. */
+        std::fstream* pindex = new std::fstream(index, std::ios::in | std::ios::out | std::ios::binary);
+        if(!pindex->is_open())
         {
-            /* Create the stream index object. */
-            std::fstream* pstream;
-            if(!indexCache->Get(nShard, pstream))
-            {
-                pstream = new std::fstream(index, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    throw debug::exception(FUNCTION, "index cache file could not be loaded");
-                }
-
-                indexCache->Put(nShard, pstream);
-            }
-
-            /* Build a vector to read the disk index. */
-            std::vector<uint8_t> vIndex(HASHMAP_TOTAL_BUCKETS * 2, 0);
+            delete pindex;
+            throw debug::exception(FUNCTION, "index file ", index, " could not be loaded");
+        }
 
-            /* Read the entire index shard. */
-            pstream->read((char*)&vIndex[0], vIndex.size());
+        /* Build a vector to read the disk index. */
+        std::vector<uint8_t> vIndex(HASHMAP_TOTAL_BUCKETS * 2, 0);
 
-            /* Deserialize the values into memory index. */
-            uint32_t nTotalKeys = 0;
+        /* Read the entire index shard. */
+        pindex->read((char*)&vIndex[0], vIndex.size());
+        pindex->clear();
 
-            /* Create the hashmap vector. */
-            std::vector<uint16_t>* hashmap = new std::vector<uint16_t>(HASHMAP_TOTAL_BUCKETS, 0);
-            for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
-            {
-                std::copy((uint8_t *)&vIndex[nBucket * 2], (uint8_t *)&vIndex[nBucket * 2] + 2, (uint8_t *)&hashmap->at(nBucket));
+        /* Deserialize the values into memory index. */
+        uint64_t nTotalKeys = 0;
 
-                nTotalKeys += hashmap->at(nBucket);
+        /* Create the hashmap vector. */
+        std::vector<uint16_t>& hashmap = vHashmaps[nShard];
+        hashmap.assign(HASHMAP_TOTAL_BUCKETS, 0);
+        for(uint32_t nBucket = 0; nBucket < HASHMAP_TOTAL_BUCKETS; ++nBucket)
+        {
+            std::copy((uint8_t *)&vIndex[nBucket * 2], (uint8_t *)&vIndex[nBucket * 2] + 2, (uint8_t *)&hashmap[nBucket]);
 
-                TOTAL_KEYS += hashmap->at(nBucket);
-            }
+            nTotalKeys += hashmap[nBucket];
+        }
 
-            /* Debug output showing loading of disk index. */
-            //debug::log(0, FUNCTION, "Loaded Shard ", nShard, " Index of ", vIndex.size(), " bytes and ", nTotalKeys, " keys");
+        /* Set the index stream for this shard. */
+        vIndexStreams[nShard] = pindex;
 
-            /* Add to the LRU cache. */
-            diskShards->Put(nShard, hashmap);
-        }
+        return nTotalKeys;
     }
 
 
@@ -208,11 +163,18 @@ namespace LLD
         if(!filesystem::exists(strBaseLocation) && filesystem::create_directories(strBaseLocation))
             debug::log(0, FUNCTION, "Generated Path ", strBaseLocation);
 
+        /* Check the shard split before any shard files are created. */
+        CheckParams();
+
         /* Loop through the available shards. */
+        uint64_t nTotalKeys = 0;
         for(uint32_t nShard = 0; nShard < HASHMAP_TOTAL_SHARDS; ++nShard)
         {
             /* Load the hashmap shards. */
-            LoadShardIndex(nShard);
+            nTotalKeys += LoadShardIndex(nShard);
+
+            /* Each shard keeps its own file handles. */
+            vFileCache[nShard] = new TemplateLRU<uint16_t, std::fstream*>(4);
 
             /* Build the first hashmap index file if it doesn't exist. */
             std::string file = debug::safe_printstr(strBaseLocation, "_hashmap.",
@@ -230,29 +192,109 @@ namespace LLD
                 stream.close();
 
                 /* Debug output showing generating of the hashmap file. */
-                debug::log(0, FUNCTION, "Generated Disk Hash Map 0 of ", vSpace.size(), " bytes");
+                debug::log(0, FUNCTION, "Generated Disk Hash Map 0 in Shard ", nShard, " of ", vSpace.size(), " bytes");
             }
 
             /* Load the stream object into the stream LRU cache. */
-            std::fstream* pstream = new std::fstream(file, std::ios::in | std::ios::out | std::ios::binary);
-            if(!pstream->is_open())
+            if(!GetStream(nShard, 0))
                 throw debug::exception(FUNCTION, "failed to open ", file);
+        }
+
+        debug::log(0, FUNCTION, "Shard Hashmap Initialized with ", HASHMAP_TOTAL_SHARDS, " shards and ", nTotalKeys, " total keys");
+    }
+
+
+    /*  Check the shard and bucket split against the one the keychain was built with. */
+    void ShardHashMap::CheckParams()
+    {
+        /* Check the split of an existing keychain. */
+        const std::string strParams = debug::safe_printstr(strBaseLocation, "_shard.params");
+        if(filesystem::exists(strParams))
+        {
+            uint32_t nShards  = 0;
+            uint32_t nBuckets = 0;
+
+            std::ifstream stream(strParams, std::ios::in | std::ios::binary);
+            stream.read((char*)&nShards,  sizeof(nShards));
+            stream.read((char*)&nBuckets, sizeof(nBuckets));
+            if(!stream)
+                throw debug::exception(FUNCTION, "failed to read ", strParams);
+
+            /* Keys would be looked for in the wrong shard or bucket with another split. */
+            if(nShards != HASHMAP_TOTAL_SHARDS || nBuckets != HASHMAP_TOTAL_BUCKETS)
+                throw debug::exception(FUNCTION, "keychain ", strBaseLocation, " was built with ", nShards, " shards of ", nBuckets,
+                    " buckets, not ", HASHMAP_TOTAL_SHARDS, " shards of ", HASHMAP_TOTAL_BUCKETS, " buckets, start with -keychainshards=", nShards);
+
+            return;
+        }
+
+        /* Shards built before the split was kept can't be checked. */
+        if(filesystem::exists(debug::safe_printstr(strBaseLocation, "_index.000")))
+            throw debug::exception(FUNCTION, "keychain ", strBaseLocation, " has no shard parameters, its keys can't be found without a resync");
+
+        /* Keep the split of a new keychain. */
+        std::ofstream stream(strParams, std::ios::out | std::ios::binary | std::ios::trunc);
+        stream.write((char*)&HASHMAP_TOTAL_SHARDS,  sizeof(HASHMAP_TOTAL_SHARDS));
+        stream.write((char*)&HASHMAP_TOTAL_BUCKETS, sizeof(HASHMAP_TOTAL_BUCKETS));
+        if(!stream)
+            throw debug::exception(FUNCTION, "failed to write ", strParams);
+    }
+
+
+    /*  Move every key of a binary hashmap keychain into the shards, then remove its files. */
+    void ShardHashMap::Migrate(const uint64_t nBucketsIn)
+    {
+        debug::log(0, FUNCTION, "Migrating keys from binary hashmap keychain at ", strBaseLocation);
 
-            fileCache->Put(std::make_pair(nShard, 0), pstream);
+        /* Older copies of a key are visited first, so the most recent one is kept. */
+        uint64_t nMigrated = 0;
+        {
+            BinaryHashMap legacy(strBaseLocation, nFlags, nBucketsIn);
+            legacy.Iterate([&](const SectorKey& cKey, const uint64_t nSlot)
+            {
+                /* The visited key is already compressed, which is all the bucket needs. */
+                uint32_t nShard  = 0;
+                uint32_t nBucket = GetBucket(cKey.vKey, nShard);
+
+                LOCK(SHARD_MUTEX[nShard]);
+                if(!PutKey(cKey, nShard, nBucket))
+                    throw debug::exception(FUNCTION, "failed to migrate key to shard ", nShard);
+
+                /* Show progress of large keychains. */
+                if(++nMigrated % 1000000 == 0)
+                    debug::log(0, FUNCTION, "Migrated ", nMigrated, " keys");
+            });
         }
+        Flush();
+
+        /* Remove the index first, a migration that stops before this is repeated on the next start. */
+        filesystem::remove(debug::safe_printstr(strBaseLocation, "_hashmap.index"));
+        for(uint32_t nFile = 0; ; ++nFile)
+        {
+            const std::string strFile = debug::safe_printstr(strBaseLocation, "_hashmap.", std::setfill('0'), std::setw(5), nFile);
+            if(!filesystem::exists(strFile))
+                break;
 
-        debug::log(0, FUNCTION, "Shard Hashmap Initialized with ", TOTAL_KEYS, " total keys");
+            filesystem::remove(strFile);
+        }
+
+        debug::log(0, FUNCTION, "Migrated ", nMigrated, " keys into ", HASHMAP_TOTAL_SHARDS, " shards");
     }
 
 
     /*  Read a key index from the disk hashmaps. */
     bool ShardHashMap::Get(const std::vector<uint8_t>& vKey, SectorKey &cKey)
     {
-        LOCK(KEY_MUTEX);
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
 
         /* Get the assigned bucket for the hashmap. */
         uint32_t nShard  = 0;
-        uint32_t nBucket = GetBucket(vKey, nShard);
+        uint32_t nBucket = GetBucket(vKeyCompressed, nShard);
+
+        /* Only the assigned shard is locked. */
+        LOCK(SHARD_MUTEX[nShard]);
 
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
@@ -260,41 +302,15 @@ namespace LLD
         /* Set the cKey return value non compressed. */
         cKey.vKey = vKey;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
-
-        /* Get the disk index. */
-        std::vector<uint16_t>* hashmap;
-        if(!diskShards->Get(nShard, hashmap))
-        {
-            LoadShardIndex(nShard);
-            if(!diskShards->Get(nShard, hashmap))
-                return debug::error(FUNCTION, "couldn't get shard index");
-        }
-
         /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+        const std::vector<uint16_t>& hashmap = vHashmaps[nShard];
         std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
-        for(int16_t i = hashmap->at(nBucket) - 1; i >= 0; --i)
+        for(int16_t i = hashmap[nBucket] - 1; i >= 0; --i)
         {
             /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(std::make_pair(nShard, i), pstream))
-            {
-                /* Set the new stream pointer. */
-                std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.",
-                    std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), i);
-
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    continue;
-                }
-
-                /* If file not found add to LRU cache. */
-                fileCache->Put(std::make_pair(nShard, i), pstream);
-            }
+            std::fstream* pstream = GetStream(nShard, i);
+            if(!pstream)
+                continue;
 
             /* Seek to the hashmap index in file. */
             pstream->seekg(nFilePos, std::ios::beg);
@@ -319,7 +335,8 @@ namespace LLD
                         " | Length: ", cKey.nLength,
                         " | Bucket ", nBucket,
                         " | Location: ", nFilePos,
-                        " | File: ", hashmap->at(nBucket) - 1,
+                        " | File: ", hashmap[nBucket] - 1,
+                        " | Shard: ", nShard,
                         " | Sector File: ", cKey.nSectorFile,
                         " | Sector Size: ", cKey.nSectorSize,
                         " | Sector Start: ", cKey.nSectorStart, "\n",
@@ -337,50 +354,29 @@ namespace LLD
      *  This method iterates all maps to find all keys. */
     bool ShardHashMap::Get(const std::vector<uint8_t>& vKey, std::vector<SectorKey>& vKeys)
     {
-        LOCK(KEY_MUTEX);
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
 
         /* Get the assigned bucket for the hashmap. */
         uint32_t nShard  = 0;
-        uint32_t nBucket = GetBucket(vKey, nShard);
+        uint32_t nBucket = GetBucket(vKeyCompressed, nShard);
+
+        /* Only the assigned shard is locked. */
+        LOCK(SHARD_MUTEX[nShard]);
 
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
-
-        /* Get the disk index. */
-        std::vector<uint16_t>* hashmap;
-        if(!diskShards->Get(nShard, hashmap))
-        {
-            LoadShardIndex(nShard);
-            if(!diskShards->Get(nShard, hashmap))
-                return debug::error(FUNCTION, "couldn't get shard index");
-        }
-
         /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+        const std::vector<uint16_t>& hashmap = vHashmaps[nShard];
         std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
-        for(int16_t i = hashmap->at(nBucket) - 1; i >= 0; --i)
+        for(int16_t i = hashmap[nBucket] - 1; i >= 0; --i)
         {
             /* Find the file stream for LRU cache. */
-            std::fstream *pstream;
-            if(!fileCache->Get(std::make_pair(nShard, i), pstream))
-            {
-                /* Set the new stream pointer. */
-                std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.",
-                    std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), i);
-
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    continue;
-                }
-
-                /* If file not found add to LRU cache. */
-                fileCache->Put(std::make_pair(nShard, i), pstream);
-            }
+            std::fstream* pstream = GetStream(nShard, i);
+            if(!pstream)
+                continue;
 
             /* Seek to the hashmap index in file. */
             pstream->seekg (nFilePos, std::ios::beg);
@@ -412,7 +408,8 @@ namespace LLD
                         " | Length: ", cKey.nLength,
                         " | Bucket ", nBucket,
                         " | Location: ", nFilePos,
-                        " | File: ", hashmap->at(nBucket) - 1,
+                        " | File: ", hashmap[nBucket] - 1,
+                        " | Shard: ", nShard,
                         " | Sector File: ", cKey.nSectorFile,
                         " | Sector Size: ", cKey.nSectorSize,
                         " | Sector Start: ", cKey.nSectorStart, "\n",
@@ -427,248 +424,114 @@ namespace LLD
     /*  Write a key to the disk hashmaps. */
     bool ShardHashMap::Put(const SectorKey& cKey)
     {
-        LOCK(KEY_MUTEX);
-
-        /* Get the assigned bucket for the hashmap. */
-        uint32_t nShard  = 0;
-        uint32_t nBucket = GetBucket(cKey.vKey, nShard);
-
-        /* Get the file binary position. */
-        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
-
-        /* Compress any keys larger than max size. */
+        /* Get the assigned bucket for the hashmap from the compressed key. */
         std::vector<uint8_t> vKeyCompressed = cKey.vKey;
         CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
 
-        /* Get the disk index. */
-        std::vector<uint16_t>* hashmap;
-        if(!diskShards->Get(nShard, hashmap))
-        {
-            LoadShardIndex(nShard);
-            if(!diskShards->Get(nShard, hashmap))
-                return debug::error(FUNCTION, "couldn't get shard index");
-        }
-
-        /* Handle if not in append mode which will update the key. */
-        if(!(nFlags & FLAGS::APPEND))
-        {
-            /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
-            std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
-            for(int16_t i = hashmap->at(nBucket) - 1; i >= 0; --i)
-            {
-                /* Find the file stream for LRU cache. */
-                std::fstream *pstream;
-                if(!fileCache->Get(std::make_pair(nShard, i), pstream))
-                {
-                    /* Set the new stream pointer. */
-                    std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.",
-                        std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), i);
-
-                    pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                    if(!pstream->is_open())
-                    {
-                        delete pstream;
-                        continue;
-                    }
-
-                    /* If file not found add to LRU cache. */
-                    fileCache->Put(std::make_pair(nShard, i), pstream);
-                }
+        uint32_t nShard  = 0;
+        uint32_t nBucket = GetBucket(vKeyCompressed, nShard);
 
-                /* Seek to the hashmap index in file. */
-                pstream->seekg (nFilePos, std::ios::beg);
+        /* Only the assigned shard is locked. */
+        LOCK(SHARD_MUTEX[nShard]);
 
-                /* Read the bucket binary data from file stream */
-                pstream->read((char*) &vBucket[0], vBucket.size());
+        return PutKey(cKey, nShard, nBucket);
+    }
 
-                /* Check if this bucket has the key or is in an empty state. */
-                if(vBucket[0] == STATE::EMPTY || std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
-                {
-                    /* Serialize the key and return if found. */
-                    DataStream ssKey(SER_LLD, DATABASE_VERSION);
-                    ssKey << cKey;
 
-                    /* Serialize the key into the end of the vector. */
-                    ssKey.write((char*)&vKeyCompressed[0], vKeyCompressed.size());
+    /*  Flush all buffers to disk if using ACID transaction. */
+    void ShardHashMap::Flush()
+    {
+        /* Flush each shard under its own lock. */
+        for(uint32_t nShard = 0; nShard < HASHMAP_TOTAL_SHARDS; ++nShard)
+        {
+            LOCK(SHARD_MUTEX[nShard]);
 
-                    /* Handle the disk writing operations. */
-                    pstream->seekp (nFilePos, std::ios::beg);
-                    pstream->write((char*)&ssKey.Bytes()[0], ssKey.size());
-                    pstream->flush();
+            /* Flush the index file. */
+            vIndexStreams[nShard]->flush();
 
-                    /* Debug Output of Sector Key Information. */
-                    if(config::nVerbose >= 4)
-                        debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
-                            " | Length: ", cKey.nLength,
-                            " | Bucket ", nBucket,
-                            " | Location: ", nFilePos,
-                            " | File: ", hashmap->at(nBucket) - 1,
-                            " | Sector File: ", cKey.nSectorFile,
-                            " | Sector Size: ", cKey.nSectorSize,
-                            " | Sector Start: ", cKey.nSectorStart, "\n",
-                            HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
+            /* Iterate the linked list until end. */
+            TemplateNode<uint16_t, std::fstream*>* pnode = vFileCache[nShard]->pfirst;
+            while(pnode)
+            {
+                /* Flush to disk. */
+                pnode->Data->flush();
 
-                    return true;
-                }
+                /* Set to next. */
+                pnode = pnode->pnext;
             }
         }
+    }
 
-        /* Create a new disk hashmap object in linked list if it doesn't exist. */
-        std::string file = debug::safe_printstr(strBaseLocation, "_hashmap.",
-            std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), hashmap->at(nBucket));
 
-        if(!filesystem::exists(file))
+    /* Flush all buffers and sync the index and hashmap files of every shard to disk. */
+    bool ShardHashMap::Sync()
+    {
+        for(uint32_t nShard = 0; nShard < HASHMAP_TOTAL_SHARDS; ++nShard)
         {
-            /* Blank vector to write empty space in new disk file. */
-            std::vector<uint8_t> vSpace(HASHMAP_KEY_ALLOCATION, 0);
-
-            /* Write the blank data to the new file handle. */
-            std::ofstream stream(file, std::ios::out | std::ios::binary | std::ios::app);
-            if(!stream)
-                return debug::error(FUNCTION, strerror(errno));
-
-            for(uint32_t i = 0; i < HASHMAP_TOTAL_BUCKETS; ++i)
-                stream.write((char*)&vSpace[0], vSpace.size());
-
-            stream.flush();
-            stream.close();
-
-            /* Debug output for monitoring new disk maps. */
-            debug::log(0, FUNCTION, "Generated Disk Hash Map ", hashmap->at(nBucket), " in Shard ", nShard, " of ", vSpace.size(), " bytes");
-
-            //debug::log(0, FUNCTION, "Total Space Efficiency is ", (nTotalKeys * 100.0) / (hashmap.size() * nTotalHashmaps),
-            //                        " With ", nTotalKeys, " Keys");
-        }
-
-        /* Read the State and Size of Sector Header. */
-        DataStream ssKey(SER_LLD, DATABASE_VERSION);
-        ssKey << cKey;
+            /* Get the total hashmap files of the shard with its streams flushed. */
+            uint16_t nFiles = 0;
+            {
+                LOCK(SHARD_MUTEX[nShard]);
 
-        /* Serialize the key into the end of the vector. */
-        ssKey.write((char*)&vKeyCompressed[0], vKeyCompressed.size());
+                /* Flush the index file. */
+                vIndexStreams[nShard]->flush();
 
-        /* Find the file stream for LRU cache. */
-        std::fstream* pstream;
-        if(!fileCache->Get(std::make_pair(nShard, hashmap->at(nBucket)), pstream))
-        {
-            /* Set the new stream pointer. */
-            std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.",
-                std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), hashmap->at(nBucket));
+                /* Iterate the linked list until end. */
+                TemplateNode<uint16_t, std::fstream*>* pnode = vFileCache[nShard]->pfirst;
+                while(pnode)
+                {
+                    pnode->Data->flush();
+                    pnode = pnode->pnext;
+                }
 
-            /* Set the new stream pointer. */
-            pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-            if(!pstream || !pstream->is_open())
-            {
-                delete pstream;
-                return debug::error(FUNCTION, "Failed to generate file object");
+                nFiles = *std::max_element(vHashmaps[nShard].begin(), vHashmaps[nShard].end());
             }
 
-            /* If not in cache, add to the LRU. */
-            fileCache->Put(std::make_pair(nShard, hashmap->at(nBucket)), pstream);
-        }
-
-        /* Flush the key file to disk. */
-        pstream->seekp (nFilePos, std::ios::beg);
-        pstream->write((char*)&ssKey.Bytes()[0], ssKey.size());
-        pstream->flush();
-
-        /* Seek to the index position. */
-        std::fstream* pindex;
-        if(!indexCache->Get(nShard, pindex))
-        {
-            /* Build the hashmap indexes. */
-            std::string index = debug::safe_printstr(strBaseLocation, "_index.", std::setfill('0'), std::setw(3), nShard);
+            /* Sync the index file. */
+            if(!filesystem::sync(debug::safe_printstr(strBaseLocation, "_index.", std::setfill('0'), std::setw(3), nShard)))
+                return debug::error(FUNCTION, "failed to sync index of shard ", nShard, " (", strerror(errno), ")");
 
-            /* Create new index file. */
-            pindex = new std::fstream(index, std::ios::in | std::ios::out | std::ios::binary);
-            if(!pindex->is_open())
+            /* Sync the hashmap files. */
+            for(uint16_t nFile = 0; nFile < nFiles; ++nFile)
             {
-                delete pindex;
-                return debug::error(FUNCTION, "Failed to generate file object");
-            }
+                const std::string strFile = debug::safe_printstr(strBaseLocation, "_hashmap.",
+                    std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), nFile);
 
-            /* If not in cache, add to the LRU. */
-            indexCache->Put(nShard, pindex);
+                if(!filesystem::sync(strFile))
+                    return debug::error(FUNCTION, "failed to sync hashmap file ", nFile, " of shard ", nShard, " (", strerror(errno), ")");
+            }
         }
 
-        /* Seek to binary position in index file. */
-        pindex->seekp((nBucket * 2), std::ios::beg);
-
-        /* Write the index to disk. */
-        uint16_t nIndex = ++hashmap->at(nBucket);
-
-        /* Get the bucket data. */
-        std::vector<uint8_t> vBucket((uint8_t*)&nIndex, (uint8_t*)&nIndex + 2);
-
-        /* Write the index into hashmap. */
-        pindex->write((char*)&vBucket[0], vBucket.size());
-        pindex->flush();
-
-        /* Debug Output of Sector Key Information. */
-        if(config::nVerbose >= 4)
-            debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
-                " | Length: ", cKey.nLength,
-                " | Bucket ", nBucket,
-                " | Location: ", nFilePos,
-                " | File: ", hashmap->at(nBucket) - 1,
-                " | Sector File: ", cKey.nSectorFile,
-                " | Sector Size: ", cKey.nSectorSize,
-                " | Sector Start: ", cKey.nSectorStart,
-                " | Key: ",  HexStr(vKeyCompressed.begin(), vKeyCompressed.end()));
-
         return true;
     }
 
 
-    /*  Erase a key from the disk hashmaps.
-     *  TODO: This should be optimized further. */
+    /*  Erase a key from the disk hashmaps. */
     bool ShardHashMap::Erase(const std::vector<uint8_t>& vKey)
     {
-        LOCK(KEY_MUTEX);
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
 
         /* Get the assigned bucket for the hashmap. */
         uint32_t nShard  = 0;
-        uint32_t nBucket = GetBucket(vKey, nShard);
+        uint32_t nBucket = GetBucket(vKeyCompressed, nShard);
+
+        /* Only the assigned shard is locked. */
+        LOCK(SHARD_MUTEX[nShard]);
 
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
-
-        /* Get the disk index. */
-        std::vector<uint16_t>* hashmap;
-        if(!diskShards->Get(nShard, hashmap))
-        {
-            LoadShardIndex(nShard);
-            if(!diskShards->Get(nShard, hashmap))
-                return debug::error(FUNCTION, "couldn't get shard index");
-        }
-
         /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+        const std::vector<uint16_t>& hashmap = vHashmaps[nShard];
         std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
-        for(int16_t i = hashmap->at(nBucket) - 1; i >= 0; --i)
+        for(int16_t i = hashmap[nBucket] - 1; i >= 0; --i)
         {
             /* Find the file stream for LRU cache. */
-            std::fstream* pstream;
-            if(!fileCache->Get(std::make_pair(nShard, i), pstream))
-            {
-                /* Set the new stream pointer. */
-                std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.",
-                    std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), i);
-
-                /* Set the new stream pointer. */
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-                if(!pstream->is_open())
-                {
-                    delete pstream;
-                    return debug::error(FUNCTION, "Failed to generate file object");
-                }
-
-                /* If not in cache, add to the LRU. */
-                fileCache->Put(std::make_pair(nShard, i), pstream);
-            }
+            std::fstream* pstream = GetStream(nShard, i);
+            if(!pstream)
+                return debug::error(FUNCTION, "Failed to generate file object");
 
             /* Seek to the hashmap index in file. */
             pstream->seekg (nFilePos, std::ios::beg);
@@ -698,7 +561,8 @@ namespace LLD
                         " | Length: ", cKey.nLength,
                         " | Bucket ", nBucket,
                         " | Location: ", nFilePos,
-                        " | File: ", hashmap->at(nBucket) - 1,
+                        " | File: ", hashmap[nBucket] - 1,
+                        " | Shard: ", nShard,
                         " | Sector File: ", cKey.nSectorFile,
                         " | Sector Size: ", cKey.nSectorSize,
                         " | Sector Start: ", cKey.nSectorStart,
@@ -715,46 +579,29 @@ namespace LLD
     /*  Restore an index in the hashmap if it is found. */
     bool ShardHashMap::Restore(const std::vector<uint8_t> &vKey)
     {
-        LOCK(KEY_MUTEX);
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
 
         /* Get the assigned bucket for the hashmap. */
         uint32_t nShard  = 0;
-        uint32_t nBucket = GetBucket(vKey, nShard);
+        uint32_t nBucket = GetBucket(vKeyCompressed, nShard);
+
+        /* Only the assigned shard is locked. */
+        LOCK(SHARD_MUTEX[nShard]);
 
         /* Get the file binary position. */
         uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
 
-        /* Compress any keys larger than max size. */
-        std::vector<uint8_t> vKeyCompressed = vKey;
-        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
-
-        /* Get the disk index. */
-        std::vector<uint16_t>* hashmap;
-        if(!diskShards->Get(nShard, hashmap))
-        {
-            LoadShardIndex(nShard);
-            if(!diskShards->Get(nShard, hashmap))
-                return debug::error(FUNCTION, "couldn't get shard index");
-        }
-
         /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+        const std::vector<uint16_t>& hashmap = vHashmaps[nShard];
         std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
-        for(int16_t i = hashmap->at(nBucket) - 1; i >= 0; --i)
+        for(int16_t i = hashmap[nBucket] - 1; i >= 0; --i)
         {
             /* Find the file stream for LRU cache. */
-            std::fstream* pstream;
-            if(!fileCache->Get(std::make_pair(nShard, i), pstream))
-            {
-                /* Set the new stream pointer. */
-                std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.",
-                    std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), hashmap->at(nBucket));
-
-                /* Set the new stream pointer. */
-                pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
-
-                /* If file not found add to LRU cache. */
-                fileCache->Put(std::make_pair(nShard, i), pstream);
-            }
+            std::fstream* pstream = GetStream(nShard, i);
+            if(!pstream)
+                continue;
 
             /* Seek to the hashmap index in file. */
             pstream->seekg (nFilePos, std::ios::beg);
@@ -777,8 +624,8 @@ namespace LLD
                 /* Seek to the hashmap index in file. */
                 pstream->seekp (nFilePos, std::ios::beg);
 
-                /* Read the bucket binary data from file stream */
-                std::vector<uint8_t> vReady(STATE::READY);
+                /* Write the ready state into the key header. */
+                std::vector<uint8_t> vReady(1, STATE::READY);
                 pstream->write((char*) &vReady[0], vReady.size());
                 pstream->flush();
 
@@ -788,7 +635,8 @@ namespace LLD
                         " | Length: ", cKey.nLength,
                         " | Bucket ", nBucket,
                         " | Location: ", nFilePos,
-                        " | File: ", hashmap->at(nBucket) - 1,
+                        " | File: ", hashmap[nBucket] - 1,
+                        " | Shard: ", nShard,
                         " | Sector File: ", cKey.nSectorFile,
                         " | Sector Size: ", cKey.nSectorSize,
                         " | Sector Start: ", cKey.nSectorStart,
@@ -802,4 +650,285 @@ namespace LLD
     }
 
 
+    /*  Visit every ready key in the shards. */
+    void ShardHashMap::Iterate(const std::function<void(const SectorKey&, const uint64_t)>& xVisit)
+    {
+        /* Scan a batch of buckets at a time so writers are only held up briefly. */
+        const uint32_t nBatch = 4096;
+
+        std::vector<uint8_t> vBuckets(nBatch * HASHMAP_KEY_ALLOCATION, 0);
+        std::vector<std::pair<SectorKey, uint64_t>> vKeys;
+        for(uint32_t nShard = 0; nShard < HASHMAP_TOTAL_SHARDS; ++nShard)
+        {
+            for(uint32_t nBegin = 0; nBegin < HASHMAP_TOTAL_BUCKETS; nBegin += nBatch)
+            {
+                const uint32_t nEnd = std::min(nBegin + nBatch, HASHMAP_TOTAL_BUCKETS);
+                {
+                    LOCK(SHARD_MUTEX[nShard]);
+
+                    /* Read the batch from every file that any of its buckets are linked into. */
+                    const std::vector<uint16_t>& hashmap = vHashmaps[nShard];
+                    const uint16_t nFiles = *std::max_element(hashmap.begin() + nBegin, hashmap.begin() + nEnd);
+                    for(uint16_t nFile = 0; nFile < nFiles; ++nFile)
+                    {
+                        /* Find the file stream for LRU cache. */
+                        std::fstream* pstream = GetStream(nShard, nFile);
+                        if(!pstream)
+                            continue;
+
+                        /* Read the batch of buckets. */
+                        pstream->seekg(uint64_t(nBegin) * HASHMAP_KEY_ALLOCATION, std::ios::beg);
+                        if(!pstream->read((char*)&vBuckets[0], (nEnd - nBegin) * HASHMAP_KEY_ALLOCATION))
+                        {
+                            pstream->clear();
+                            continue;
+                        }
+
+                        /* Collect every bucket with a ready key in it. */
+                        for(uint32_t nBucket = nBegin; nBucket < nEnd; ++nBucket)
+                        {
+                            const uint8_t* pBucket = &vBuckets[(nBucket - nBegin) * HASHMAP_KEY_ALLOCATION];
+                            if(nFile >= hashmap[nBucket] || pBucket[0] != STATE::READY)
+                                continue;
+
+                            /* Deserialize the key header. */
+                            DataStream ssKey(std::vector<uint8_t>(pBucket, pBucket + 13), SER_LLD, DATABASE_VERSION);
+                            SectorKey cKey;
+                            ssKey >> cKey;
+
+                            /* Get the compressed size the same way as CompressKey. */
+                            uint16_t nSize = cKey.nLength;
+                            while(nSize > HASHMAP_MAX_KEY_SIZE)
+                                nSize = std::max(uint16_t(nSize >> 1), HASHMAP_MAX_KEY_SIZE);
+
+                            cKey.vKey.assign(pBucket + 13, pBucket + 13 + nSize);
+                            vKeys.push_back(std::make_pair(cKey, (uint64_t(nShard) << 48) | (uint64_t(nFile) << 32) | nBucket));
+                        }
+                    }
+                }
+
+                /* Visit the keys without holding up writers. */
+                for(const auto& item : vKeys)
+                    xVisit(item.first, item.second);
+
+                vKeys.clear();
+            }
+        }
+    }
+
+
+    /*  Point a key found by Iterate to a new sector position. */
+    bool ShardHashMap::Relocate(const uint64_t nSlot, const SectorKey& cOld, const SectorKey& cNew)
+    {
+        /* Get the shard, file, and bucket of the slot. */
+        const uint32_t nShard  = static_cast<uint32_t>(nSlot >> 48);
+        const uint16_t nFile   = static_cast<uint16_t>(nSlot >> 32);
+        const uint32_t nBucket = static_cast<uint32_t>(nSlot);
+        if(nShard >= HASHMAP_TOTAL_SHARDS || nBucket >= HASHMAP_TOTAL_BUCKETS || cOld.vKey.size() > HASHMAP_MAX_KEY_SIZE)
+            return false;
+
+        /* Only the assigned shard is locked. */
+        LOCK(SHARD_MUTEX[nShard]);
+
+        /* Find the file stream for LRU cache. */
+        std::fstream* pstream = GetStream(nShard, nFile);
+        if(!pstream)
+            return false;
+
+        /* Get the file binary position. */
+        uint64_t nFilePos = uint64_t(nBucket) * HASHMAP_KEY_ALLOCATION;
+
+        /* Read the bucket binary data from file stream */
+        std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
+        pstream->seekg(nFilePos, std::ios::beg);
+        if(!pstream->read((char*) &vBucket[0], vBucket.size()))
+        {
+            pstream->clear();
+            return false;
+        }
+
+        /* Deserialize the key in the bucket. */
+        DataStream ssKey(vBucket, SER_LLD, DATABASE_VERSION);
+        SectorKey cKey;
+        ssKey >> cKey;
+
+        /* Check the bucket wasn't written to since it was visited. */
+        if(!cKey.Ready() || cKey.nSectorFile != cOld.nSectorFile || cKey.nSectorStart != cOld.nSectorStart
+        || cKey.nSectorSize != cOld.nSectorSize || !std::equal(cOld.vKey.begin(), cOld.vKey.end(), vBucket.begin() + 13))
+            return false;
+
+        /* Only the header changes, the compressed key stays in place. */
+        DataStream ssNew(SER_LLD, DATABASE_VERSION);
+        ssNew << cNew;
+
+        /* Write the new header over the old one. */
+        pstream->seekp(nFilePos, std::ios::beg);
+        pstream->write((char*)&ssNew.Bytes()[0], ssNew.size());
+        pstream->flush();
+
+        return true;
+    }
+
+
+    /* Get the stream object for a hashmap file in a shard. */
+    std::fstream* ShardHashMap::GetStream(const uint32_t nShard, const uint16_t nFile)
+    {
+        /* Check the shard's stream cache. */
+        std::fstream* pstream;
+        if(vFileCache[nShard]->Get(nFile, pstream))
+            return pstream;
+
+        /* Set the new stream pointer. */
+        std::string filename = debug::safe_printstr(strBaseLocation, "_hashmap.",
+            std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), nFile);
+
+        pstream = new std::fstream(filename, std::ios::in | std::ios::out | std::ios::binary);
+        if(!pstream->is_open())
+        {
+            delete pstream;
+            return nullptr;
+        }
+
+        /* If file not found add to LRU cache. */
+        vFileCache[nShard]->Put(nFile, pstream);
+
+        return pstream;
+    }
+
+
+    /* Write a key to a shard. */
+    bool ShardHashMap::PutKey(const SectorKey& cKey, const uint32_t nShard, const uint32_t nBucket)
+    {
+        /* Get the file binary position. */
+        uint32_t nFilePos = nBucket * HASHMAP_KEY_ALLOCATION;
+
+        /* Compress any keys larger than max size. */
+        std::vector<uint8_t> vKeyCompressed = cKey.vKey;
+        CompressKey(vKeyCompressed, HASHMAP_MAX_KEY_SIZE);
+
+        /* Get the disk index. */
+        std::vector<uint16_t>& hashmap = vHashmaps[nShard];
+
+        /* Handle if not in append mode which will update the key. */
+        if(!(nFlags & FLAGS::APPEND))
+        {
+            /* Reverse iterate the linked file list from hashmap to get most recent keys first. */
+            std::vector<uint8_t> vBucket(HASHMAP_KEY_ALLOCATION, 0);
+            for(int16_t i = hashmap[nBucket] - 1; i >= 0; --i)
+            {
+                /* Find the file stream for LRU cache. */
+                std::fstream* pstream = GetStream(nShard, i);
+                if(!pstream)
+                    continue;
+
+                /* Seek to the hashmap index in file. */
+                pstream->seekg (nFilePos, std::ios::beg);
+
+                /* Read the bucket binary data from file stream */
+                pstream->read((char*) &vBucket[0], vBucket.size());
+
+                /* Check if this bucket has the key or is in an empty state. */
+                if(vBucket[0] == STATE::EMPTY || std::equal(vBucket.begin() + 13, vBucket.begin() + 13 + vKeyCompressed.size(), vKeyCompressed.begin()))
+                {
+                    /* Serialize the key and return if found. */
+                    DataStream ssKey(SER_LLD, DATABASE_VERSION);
+                    ssKey << cKey;
+
+                    /* Serialize the key into the end of the vector. */
+                    ssKey.write((char*)&vKeyCompressed[0], vKeyCompressed.size());
+
+                    /* Handle the disk writing operations. */
+                    pstream->seekp (nFilePos, std::ios::beg);
+                    pstream->write((char*)&ssKey.Bytes()[0], ssKey.size());
+                    pstream->flush();
+
+                    /* Debug Output of Sector Key Information. */
+                    if(config::nVerbose >= 4)
+                        debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
+                            " | Length: ", cKey.nLength,
+                            " | Bucket ", nBucket,
+                            " | Location: ", nFilePos,
+                            " | File: ", i,
+                            " | Shard: ", nShard,
+                            " | Sector File: ", cKey.nSectorFile,
+                            " | Sector Size: ", cKey.nSectorSize,
+                            " | Sector Start: ", cKey.nSectorStart, "\n",
+                            HexStr(vKeyCompressed.begin(), vKeyCompressed.end(), true));
+
+                    return true;
+                }
+            }
+        }
+
+        /* Create a new disk hashmap object in linked list if it doesn't exist. */
+        std::string file = debug::safe_printstr(strBaseLocation, "_hashmap.",
+            std::setfill('0'), std::setw(3), nShard, ".", std::setfill('0'), std::setw(5), hashmap[nBucket]);
+
+        if(!filesystem::exists(file))
+        {
+            /* Blank vector to write empty space in new disk file. */
+            std::vector<uint8_t> vSpace(HASHMAP_KEY_ALLOCATION, 0);
+
+            /* Write the blank data to the new file handle. */
+            std::ofstream stream(file, std::ios::out | std::ios::binary | std::ios::app);
+            if(!stream)
+                return debug::error(FUNCTION, strerror(errno));
+
+            for(uint32_t i = 0; i < HASHMAP_TOTAL_BUCKETS; ++i)
+                stream.write((char*)&vSpace[0], vSpace.size());
+
+            stream.flush();
+            stream.close();
+
+            /* Debug output for monitoring new disk maps. */
+            debug::log(0, FUNCTION, "Generated Disk Hash Map ", hashmap[nBucket], " in Shard ", nShard, " of ",
+                uint64_t(HASHMAP_TOTAL_BUCKETS) * vSpace.size(), " bytes");
+        }
+
+        /* Read the State and Size of Sector Header. */
+        DataStream ssKey(SER_LLD, DATABASE_VERSION);
+        ssKey << cKey;
+
+        /* Serialize the key into the end of the vector. */
+        ssKey.write((char*)&vKeyCompressed[0], vKeyCompressed.size());
+
+        /* Find the file stream for LRU cache. */
+        std::fstream* pstream = GetStream(nShard, hashmap[nBucket]);
+        if(!pstream)
+            return debug::error(FUNCTION, "Failed to generate file object");
+
+        /* Flush the key file to disk. */
+        pstream->seekp (nFilePos, std::ios::beg);
+        pstream->write((char*)&ssKey.Bytes()[0], ssKey.size());
+        pstream->flush();
+
+        /* Seek to binary position in index file. */
+        std::fstream* pindex = vIndexStreams[nShard];
+        pindex->seekp((nBucket * 2), std::ios::beg);
+
+        /* Write the index to disk. */
+        uint16_t nIndex = ++hashmap[nBucket];
+
+        /* Get the bucket data. */
+        std::vector<uint8_t> vBucket((uint8_t*)&nIndex, (uint8_t*)&nIndex + 2);
+
+        /* Write the index into hashmap. */
+        pindex->write((char*)&vBucket[0], vBucket.size());
+        pindex->flush();
+
+        /* Debug Output of Sector Key Information. */
+        if(config::nVerbose >= 4)
+            debug::log(4, FUNCTION, "State: ", cKey.nState == STATE::READY ? "Valid" : "Invalid",
+                " | Length: ", cKey.nLength,
+                " | Bucket ", nBucket,
+                " | Location: ", nFilePos,
+                " | File: ", hashmap[nBucket] - 1,
+                " | Shard: ", nShard,
+                " | Sector File: ", cKey.nSectorFile,
+                " | Sector Size: ", cKey.nSectorSize,
+                " | Sector Start: ", cKey.nSectorStart,
+                " | Key: ",  HexStr(vKeyCompressed.begin(), vKeyCompressed.end()));
+
+        return true;
+    }
 }
@@ -0,0 +1,523 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+____________________________________________________________________________________________*/
+
+#include <LLD/cache/shard_lru.h>
+#include <LLD/templates/key.h>
+#include <LLD/hash/xxh3.h>
+
+#include <Util/include/mutex.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace LLD
+{
+
+    /* The maximum shards of the cache, small caches use fewer so each shard can still hold records. */
+    const uint32_t MAX_CACHE_SHARDS = 64;
+
+
+    /* The minimum size of each shard. */
+    const uint32_t MIN_SHARD_SIZE = 1024 * 64;
+
+
+    /* The segments of each shard. */
+    enum SEGMENT
+    {
+        PROBATION = 0,
+        PROTECTED = 1,
+    };
+
+
+    /*  Node to hold the binary data of the double linked lists. */
+    struct ShardNode
+    {
+    public:
+
+        /** Linked list pointers. **/
+        ShardNode* pprev;
+        ShardNode* pnext;
+
+        /** The 64-bit hash of the key the node is mapped by. **/
+        uint64_t hashKey;
+
+        /** The full key, so that colliding hashes are never returned. **/
+        std::vector<uint8_t> vKey;
+
+        /** The data in the binary node. **/
+        std::vector<uint8_t> vData;
+
+        /** The segment this node is linked into. **/
+        uint8_t nSegment;
+
+        /** The bytes accounted for this node. **/
+        uint64_t nSize;
+
+        /** Flag for a record that is kept until it is written to disk. **/
+        bool fReserved;
+
+        /** Default constructor **/
+        ShardNode(const uint64_t hashKeyIn, const std::vector<uint8_t>& vKeyIn, const std::vector<uint8_t>& vDataIn)
+        : pprev    (nullptr)
+        , pnext    (nullptr)
+        , hashKey  (hashKeyIn)
+        , vKey     (vKeyIn)
+        , vData    (vDataIn)
+        , nSegment (PROBATION)
+        , nSize    (Cost(vKeyIn.size(), vDataIn.size()))
+        , fReserved(false)
+        {
+        }
+
+        /** The bytes used by a node, including its entry in the shard's map. **/
+        static uint64_t Cost(const uint64_t nKeySize, const uint64_t nDataSize)
+        {
+            return sizeof(ShardNode) + nKeySize + nDataSize + sizeof(std::pair<const uint64_t, ShardNode*>) + 2 * sizeof(void*);
+        }
+    };
+
+
+    /*  One independently locked segment of the sharded cache. */
+    struct CacheShard
+    {
+        /** Mutex for this shard only. **/
+        std::mutex MUTEX;
+
+        /** Map of the key hashes to their nodes. **/
+        std::unordered_map<uint64_t, ShardNode*> mapNodes;
+
+        /** The first and last nodes of each segment. **/
+        ShardNode* pfirst[2];
+        ShardNode* plast[2];
+
+        /** The bytes held by each segment. **/
+        uint64_t nSize[2];
+
+        /** The cache hits and misses of this shard. **/
+        uint64_t nHits;
+        uint64_t nMisses;
+
+        /** Default constructor **/
+        CacheShard()
+        : MUTEX    ( )
+        , mapNodes ( )
+        , pfirst   {nullptr, nullptr}
+        , plast    {nullptr, nullptr}
+        , nSize    {0, 0}
+        , nHits    (0)
+        , nMisses  (0)
+        {
+        }
+
+        /** Default destructor **/
+        ~CacheShard()
+        {
+            for(auto& item : mapNodes)
+                delete item.second;
+        }
+
+        /** Unlink a node from its segment. **/
+        void Unlink(ShardNode* pthis)
+        {
+            const uint8_t n = pthis->nSegment;
+
+            /* Relink the ends of the segment. */
+            if(pthis == pfirst[n])
+                pfirst[n] = pthis->pnext;
+
+            if(pthis == plast[n])
+                plast[n] = pthis->pprev;
+
+            /* Link the neighbours to each other. */
+            if(pthis->pnext)
+                pthis->pnext->pprev = pthis->pprev;
+
+            if(pthis->pprev)
+                pthis->pprev->pnext = pthis->pnext;
+
+            pthis->pnext = nullptr;
+            pthis->pprev = nullptr;
+
+            nSize[n] -= pthis->nSize;
+        }
+
+        /** Link a node to the front of a segment. **/
+        void PushFront(ShardNode* pthis, const uint8_t n)
+        {
+            pthis->nSegment = n;
+            pthis->pprev    = nullptr;
+            pthis->pnext    = pfirst[n];
+
+            if(pfirst[n])
+                pfirst[n]->pprev = pthis;
+
+            pfirst[n] = pthis;
+            if(!plast[n])
+                plast[n] = pthis;
+
+            nSize[n] += pthis->nSize;
+        }
+
+        /** Find the node of a key. **/
+        ShardNode* Find(const uint64_t hashKey, const std::vector<uint8_t>& vKey) const
+        {
+            /* Check the key is the one that is stored. */
+            auto it = mapNodes.find(hashKey);
+            if(it == mapNodes.end() || it->second->vKey != vKey)
+                return nullptr;
+
+            return it->second;
+        }
+
+        /** Erase a node from the shard. **/
+        void Erase(ShardNode* pthis)
+        {
+            Unlink(pthis);
+            mapNodes.erase(pthis->hashKey);
+
+            delete pthis;
+        }
+
+        /** Keep the segments within their sizes. **/
+        void Evict(const uint64_t nMaxSize)
+        {
+            /* Demote the least recently used protected nodes, the protected segment holds up to 80% of the shard. */
+            const uint64_t nMaxProtected = (nMaxSize * 4) / 5;
+            while(nSize[PROTECTED] > nMaxProtected && plast[PROTECTED])
+            {
+                ShardNode* pnode = plast[PROTECTED];
+
+                Unlink(pnode);
+                PushFront(pnode, PROBATION);
+            }
+
+            /* Evict from the back of probation first, then protected, keeping reserved nodes. */
+            for(uint8_t n = PROBATION; n <= PROTECTED; ++n)
+            {
+                ShardNode* pnode = plast[n];
+                while(pnode && nSize[PROBATION] + nSize[PROTECTED] > nMaxSize)
+                {
+                    ShardNode* pprev = pnode->pprev;
+                    if(!pnode->fReserved)
+                        Erase(pnode);
+
+                    pnode = pprev;
+                }
+            }
+        }
+
+        /** Get the data of a key, promoting it into the protected segment. **/
+        bool Get(const uint64_t hashKey, const std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData, const uint64_t nMaxSize)
+        {
+            ShardNode* pthis = Find(hashKey, vKey);
+            if(!pthis)
+                return false;
+
+            /* Get the data. */
+            vData = pthis->vData;
+
+            /* Promote into the protected segment, or move to its front. */
+            Unlink(pthis);
+            PushFront(pthis, PROTECTED);
+            Evict(nMaxSize);
+
+            ++nHits;
+
+            return true;
+        }
+
+        /** Add the data of a key, replacing its previous record or one it collides with. **/
+        void Put(const uint64_t hashKey, const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData,
+                 const bool fReserve, const uint64_t nMaxSize)
+        {
+            /* Updates to a record keep its segment. */
+            uint8_t nSegment = PROBATION;
+            auto it = mapNodes.find(hashKey);
+            if(it != mapNodes.end())
+            {
+                if(it->second->vKey == vKey)
+                    nSegment = it->second->nSegment;
+
+                Erase(it->second);
+            }
+
+            /* Add the new node to the front of its segment. */
+            ShardNode* pthis = new ShardNode(hashKey, vKey, vData);
+            pthis->fReserved = fReserve;
+
+            mapNodes[hashKey] = pthis;
+            PushFront(pthis, nSegment);
+
+            /* Remove the least recently used nodes if the shard is too large. */
+            Evict(nMaxSize);
+        }
+    };
+
+
+    /** Cache Size Constructor **/
+    ShardLRU::ShardLRU(const uint32_t nCacheSizeIn)
+    : MAX_CACHE_SIZE    (nCacheSizeIn)
+    , MAX_SHARD_SIZE    (0)
+    , MAX_OVERFLOW_SIZE (nCacheSizeIn / 4)
+    , vShards           (std::min(std::max((nCacheSizeIn - nCacheSizeIn / 4) / MIN_SHARD_SIZE, 1u), MAX_CACHE_SHARDS), nullptr)
+    , pOverflow         (new CacheShard())
+    , nOverflow         (0)
+    {
+        /* Split the rest of the size evenly between the shards. */
+        MAX_SHARD_SIZE = (MAX_CACHE_SIZE - MAX_OVERFLOW_SIZE) / vShards.size();
+
+        for(auto& pshard : vShards)
+            pshard = new CacheShard();
+    }
+
+
+    /** Class Destructor. **/
+    ShardLRU::~ShardLRU()
+    {
+        for(auto& pshard : vShards)
+            delete pshard;
+
+        delete pOverflow;
+    }
+
+
+    /*  Find the shard for a key hash. */
+    CacheShard* ShardLRU::Shard(const uint64_t hashKey) const
+    {
+        /* Use the upper bits so that the shard doesn't correlate with the map buckets. */
+        return vShards[(hashKey >> 32) % vShards.size()];
+    }
+
+
+    /*  Remove a record from the overflow shard. */
+    bool ShardLRU::RemoveOverflow(const uint64_t hashKey, const std::vector<uint8_t>& vKey)
+    {
+        /* Skip the lock while the overflow shard is empty. */
+        if(nOverflow.load() == 0)
+            return false;
+
+        LOCK(pOverflow->MUTEX);
+
+        ShardNode* pthis = pOverflow->Find(hashKey, vKey);
+        if(!pthis)
+            return false;
+
+        pOverflow->Erase(pthis);
+        nOverflow.store(pOverflow->mapNodes.size());
+
+        return true;
+    }
+
+
+    /*  Check if data exists. */
+    bool ShardLRU::Has(const std::vector<uint8_t>& vKey) const
+    {
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+        {
+            CacheShard* pshard = Shard(hashKey);
+            LOCK(pshard->MUTEX);
+
+            if(pshard->Find(hashKey, vKey))
+                return true;
+        }
+
+        /* Check the overflow shard for large records. */
+        if(nOverflow.load() == 0)
+            return false;
+
+        LOCK(pOverflow->MUTEX);
+        return (pOverflow->Find(hashKey, vKey) != nullptr);
+    }
+
+
+    /*  Get the data by index */
+    bool ShardLRU::Get(const std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData)
+    {
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+
+        CacheShard* pshard = Shard(hashKey);
+        {
+            LOCK(pshard->MUTEX);
+
+            if(pshard->Get(hashKey, vKey, vData, MAX_SHARD_SIZE))
+                return true;
+        }
+
+        /* Check the overflow shard for large records. */
+        if(nOverflow.load() > 0)
+        {
+            LOCK(pOverflow->MUTEX);
+
+            if(pOverflow->Get(hashKey, vKey, vData, MAX_OVERFLOW_SIZE))
+            {
+                nOverflow.store(pOverflow->mapNodes.size());
+                return true;
+            }
+        }
+
+        /* Count the miss in the key's shard. */
+        LOCK(pshard->MUTEX);
+        ++pshard->nMisses;
+
+        return false;
+    }
+
+
+    /*  Add data in the Pool. */
+    void ShardLRU::Put(const SectorKey& key, const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData, bool fReserve)
+    {
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+        const uint64_t nCost   = ShardNode::Cost(vKey.size(), vData.size());
+
+        /* Records that would take up too much of a shard go in the overflow shard. */
+        CacheShard* pshard = Shard(hashKey);
+        if(nCost > MAX_SHARD_SIZE / 2)
+        {
+            /* Remove the previous record from the key's shard, so it isn't found before this one. */
+            {
+                LOCK(pshard->MUTEX);
+
+                ShardNode* pthis = pshard->Find(hashKey, vKey);
+                if(pthis)
+                    pshard->Erase(pthis);
+            }
+
+            LOCK(pOverflow->MUTEX);
+
+            /* Don't cache records that would take up the whole overflow shard. */
+            if(nCost > MAX_OVERFLOW_SIZE / 2)
+            {
+                ShardNode* pthis = pOverflow->Find(hashKey, vKey);
+                if(pthis)
+                    pOverflow->Erase(pthis);
+            }
+            else
+                pOverflow->Put(hashKey, vKey, vData, fReserve, MAX_OVERFLOW_SIZE);
+
+            nOverflow.store(pOverflow->mapNodes.size());
+
+            return;
+        }
+
+        /* Remove a previous large record of this key. */
+        RemoveOverflow(hashKey, vKey);
+
+        LOCK(pshard->MUTEX);
+        pshard->Put(hashKey, vKey, vData, fReserve, MAX_SHARD_SIZE);
+    }
+
+
+    /*  Reserve this item in the cache permanently if true, unreserve if false. */
+    void ShardLRU::Reserve(const std::vector<uint8_t>& vKey, bool fReserve)
+    {
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+        {
+            CacheShard* pshard = Shard(hashKey);
+            LOCK(pshard->MUTEX);
+
+            ShardNode* pthis = pshard->Find(hashKey, vKey);
+            if(pthis)
+            {
+                pthis->fReserved = fReserve;
+
+                /* Released records can be evicted again. */
+                pshard->Evict(MAX_SHARD_SIZE);
+
+                return;
+            }
+        }
+
+        /* Check the overflow shard for large records. */
+        if(nOverflow.load() == 0)
+            return;
+
+        LOCK(pOverflow->MUTEX);
+
+        ShardNode* pthis = pOverflow->Find(hashKey, vKey);
+        if(pthis)
+        {
+            pthis->fReserved = fReserve;
+            pOverflow->Evict(MAX_OVERFLOW_SIZE);
+
+            nOverflow.store(pOverflow->mapNodes.size());
+        }
+    }
+
+
+    /*  Force Remove Object by Index. */
+    bool ShardLRU::Remove(const std::vector<uint8_t>& vKey)
+    {
+        const uint64_t hashKey = XXH64(&vKey[0], vKey.size(), 0);
+        {
+            CacheShard* pshard = Shard(hashKey);
+            LOCK(pshard->MUTEX);
+
+            /* Free the memory. */
+            ShardNode* pthis = pshard->Find(hashKey, vKey);
+            if(pthis)
+            {
+                pshard->Erase(pthis);
+                return true;
+            }
+        }
+
+        return RemoveOverflow(hashKey, vKey);
+    }
+
+
+    /*  Get the total bytes held by the cache. */
+    uint64_t ShardLRU::Size() const
+    {
+        uint64_t nTotal = 0;
+        for(const auto& pshard : vShards)
+        {
+            LOCK(pshard->MUTEX);
+            nTotal += pshard->nSize[PROBATION] + pshard->nSize[PROTECTED];
+        }
+
+        LOCK(pOverflow->MUTEX);
+        nTotal += pOverflow->nSize[PROBATION] + pOverflow->nSize[PROTECTED];
+
+        return nTotal;
+    }
+
+
+    /*  Get the total reads that were found in the cache. */
+    uint64_t ShardLRU::Hits() const
+    {
+        uint64_t nTotal = 0;
+        for(const auto& pshard : vShards)
+        {
+            LOCK(pshard->MUTEX);
+            nTotal += pshard->nHits;
+        }
+
+        LOCK(pOverflow->MUTEX);
+        nTotal += pOverflow->nHits;
+
+        return nTotal;
+    }
+
+
+    /*  Get the total reads that were not found in the cache. */
+    uint64_t ShardLRU::Misses() const
+    {
+        uint64_t nTotal = 0;
+        for(const auto& pshard : vShards)
+        {
+            LOCK(pshard->MUTEX);
+            nTotal += pshard->nMisses;
+        }
+
+        return nTotal;
+    }
+}
@@ -0,0 +1,226 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+
+#pragma once
+#ifndef NEXUS_LLD_TEMPLATES_JOURNAL_H
+#define NEXUS_LLD_TEMPLATES_JOURNAL_H
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LLD
+{
+
+    /** Magic bytes that begin every journal record. **/
+    const uint32_t JOURNAL_MAGIC = 0x4c4c444a;
+
+
+    /** Size of the journal record header: magic, length, sequence, checksum. **/
+    const uint32_t JOURNAL_HEADER_SIZE = 24;
+
+
+    /** Default space preallocated for the journal file. **/
+    const uint64_t JOURNAL_PREALLOCATE = 1024 * 1024 * 32;
+
+
+    /** TxnJournal
+     *
+     *  Write-ahead journal shared by every database in an LLD::TxnBegin scope.
+     *
+     *  Records from all databases are buffered in memory and written with a single write and a
+     *  single data sync when the group commits. The file is preallocated and reused from the start
+     *  once a group is released, so a commit never grows the file or truncates it. Groups that are
+     *  kept for recovery are appended after each other and replayed in order. Every record carries
+     *  the sequence of its group and a checksum, so stale and torn records are never replayed.
+     *
+     **/
+    class TxnJournal
+    {
+        /** Mutex for thread synchronization. **/
+        std::mutex JOURNAL_MUTEX;
+
+
+        /** The location of the journal file. **/
+        std::string strFilename;
+
+
+        /** The records buffered for the current group. **/
+        std::vector<uint8_t> vBuffer;
+
+
+        /** The sequence of the current group. **/
+        uint64_t nSequence;
+
+
+        /** The position the current group is written to. **/
+        uint64_t nOffset;
+
+
+        /** Flag to determine if the current group was written to disk. **/
+        bool fCommitted;
+
+
+    #ifndef WIN32
+
+        /** The journal file descriptor. **/
+        int32_t nDescriptor;
+
+    #else
+
+        /** The journal file stream. **/
+        std::fstream* pstream;
+
+    #endif
+
+    public:
+
+        /** Record types in the journal. **/
+        enum
+        {
+            DATA   = 1,
+            COMMIT = 2
+        };
+
+
+        /** Default Constructor. **/
+        TxnJournal() = delete;
+
+
+        /** Copy Constructor. **/
+        TxnJournal(const TxnJournal& journal) = delete;
+
+
+        /** Copy Assignment Operator. **/
+        TxnJournal& operator=(const TxnJournal& journal) = delete;
+
+
+        /** Journal Constructor.
+         *
+         *  @param[in] strFilenameIn The location of the journal file.
+         *  @param[in] nPreallocate The bytes to preallocate for the journal file.
+         *
+         **/
+        TxnJournal(const std::string& strFilenameIn, const uint64_t nPreallocate = JOURNAL_PREALLOCATE);
+
+
+        /** Default Destructor. **/
+        ~TxnJournal();
+
+
+        /** Append
+         *
+         *  Add the journal of a database to the current group.
+         *
+         *  @param[in] strName The name of the database.
+         *  @param[in] vData The serialized journal of the database.
+         *
+         **/
+        void Append(const std::string& strName, const std::vector<uint8_t>& vData);
+
+
+        /** Commit
+         *
+         *  Write the current group with its commit record and sync it to disk.
+         *
+         *  @return True if the group is durable on disk.
+         *
+         **/
+        bool Commit();
+
+
+        /** Release
+         *
+         *  Mark every group on disk as applied and start the next group from the beginning.
+         *
+         **/
+        void Release();
+
+
+        /** Reset
+         *
+         *  Start the next group after the last one on disk without releasing it, so it is still
+         *  replayed if the node stops before a later group is released.
+         *
+         **/
+        void Reset();
+
+
+        /** Recover
+         *
+         *  Read the groups kept in the journal that reached their commit records.
+         *
+         *  @param[out] mapJournals The journal of each database, in the order of the groups.
+         *
+         *  @return True if a committed group was found.
+         *
+         **/
+        bool Recover(std::map<std::string, std::vector<uint8_t>>& mapJournals);
+
+
+    private:
+
+        /** WriteRecord
+         *
+         *  Serialize a record with its header into the group buffer.
+         *
+         *  @param[in] nType The type of the record.
+         *  @param[in] strName The name of the database.
+         *  @param[in] vData The record data.
+         *
+         **/
+        void WriteRecord(const uint8_t nType, const std::string& strName, const std::vector<uint8_t>& vData);
+
+
+        /** ReadAt
+         *
+         *  Read bytes from a position in the journal file.
+         *
+         *  @param[in] nPosition The position to read from.
+         *  @param[out] vData The bytes to read, sized by the caller.
+         *
+         *  @return True if all bytes were read.
+         *
+         **/
+        bool ReadAt(const uint64_t nPosition, std::vector<uint8_t>& vData);
+
+
+        /** WriteAt
+         *
+         *  Write bytes to a position in the journal file.
+         *
+         *  @param[in] nPosition The position to write to.
+         *  @param[in] vData The bytes to write.
+         *
+         *  @return True if all bytes were written.
+         *
+         **/
+        bool WriteAt(const uint64_t nPosition, const std::vector<uint8_t>& vData);
+
+
+        /** Sync
+         *
+         *  Sync the journal data to disk.
+         *
+         *  @return True if the sync succeeded.
+         *
+         **/
+        bool Sync();
+    };
+}
+
+#endif
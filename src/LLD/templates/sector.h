@@ -20,19 +20,23 @@ ________________________________________________________________________________
 #include <LLD/include/version.h>
 #include <LLD/templates/key.h>
 #include <LLD/templates/transaction.h>
+#include <LLD/templates/journal.h>
 
 #include <LLD/cache/template_lru.h>
 
 #include <Util/templates/datastream.h>
 #include <Util/include/runtime.h>
 #include <Util/include/debug.h>
+#include <Util/include/shared_mutex.h>
 
 #include <string>
 #include <cstdint>
+#include <functional>
 #include <atomic>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <set>
 
 namespace LLD
 {
@@ -50,6 +54,33 @@ namespace LLD
     const uint32_t MAX_SECTOR_BUFFER_SIZE = 1024 * 1024 * 4; //32 MB Max Disk Buffer
 
 
+    /* The address space reserved for each memory mapped sector file. Records are appended past MAX_SECTOR_FILE_SIZE
+       before a new file is allocated, so we reserve twice the file size to cover the tail of every file. */
+    const uint64_t MAX_SECTOR_MAP_SIZE = static_cast<uint64_t>(MAX_SECTOR_FILE_SIZE) * 2; //1 GB Address Space per File
+
+
+    /* The maximum sector files that can be memory mapped, bounded by SectorKey::nSectorFile. */
+    const uint32_t MAX_SECTOR_MAP_FILES = 65536;
+
+
+    /* The first byte of an LZ4 compressed sector, followed by the record and compressed sizes as uint32_t. Records
+       written uncompressed begin with the length of their type string, which is never this large. */
+    const uint8_t SECTOR_COMPRESSED = 0xff;
+
+
+    /* The size of the header in front of the LZ4 data of a compressed sector. */
+    const uint32_t SECTOR_COMPRESSED_HEADER = 9;
+
+
+    /* The first byte of a sector linking an index key to the key it indexes, followed by that key. Compressed records
+       change size when they are updated, so in COMPRESS mode index keys can't share the sector of their record. */
+    const uint8_t SECTOR_LINK = 0xfe;
+
+
+    /* The keys a cursor copies out of the keychain at a time. */
+    const uint32_t CURSOR_BATCH_SIZE = 1024;
+
+
     /** SectorDatabase
      *
      *  Base Template Class for a Sector Database.
@@ -88,9 +119,8 @@ namespace LLD
         std::condition_variable CONDITION;
 
     protected:
-        /* Mutex for Thread Synchronization.
-            TODO: Lock Mutex based on Read / Writes on a per Sector Basis.
-            Will allow higher efficiency for thread concurrency. */
+        /* Mutex for Thread Synchronization of the sector streams and the append tail.
+            Readers of committed sectors don't use this, see RECORD_MUTEX. */
         std::mutex SECTOR_MUTEX;
         std::mutex BUFFER_MUTEX;
         std::mutex TRANSACTION_MUTEX;
@@ -121,11 +151,39 @@ namespace LLD
         mutable TemplateLRU<uint32_t, std::fstream*>* fileCache;
 
 
+        /* Mutex to protect opening of new descriptors and memory maps. */
+        std::mutex FILE_MUTEX;
+
+
+        /* Striped reader-writer locks for records. Readers share them, only in place updates hold them alone. */
+        mutable std::vector<shared_mutex> RECORD_MUTEX;
+
+
+        /* Read only memory maps of sector files, indexed by file number. Only allocated in MMAP mode. */
+        std::vector<std::atomic<uint8_t*>> vMapped;
+
+
+        /* Bytes of each mapped sector file that are backed on disk. Reads past it would fault on unbacked pages. */
+        std::vector<std::atomic<uint64_t>> vMappedSize;
+
+
+        /* Read only descriptors of sector files for positional reads, indexed by file number. */
+        std::vector<std::atomic<int32_t>> vDescriptors;
+
+
+        /* Readers inside of each sector file, so that retired files are only closed once they are drained. */
+        std::vector<std::atomic<uint32_t>> vReaders;
+
+
         /* The current File Position. */
         mutable uint32_t nCurrentFile;
         mutable uint32_t nCurrentFileSize;
 
 
+        /* Sector files written since they were last synced to disk, guarded by SECTOR_MUTEX. */
+        std::set<uint32_t> setUnsynced;
+
+
         /* Cache Writer Thread. */
         std::thread CacheWriterThread;
 
@@ -134,6 +192,10 @@ namespace LLD
         std::thread MeterThread;
 
 
+        /* The compactor thread. */
+        std::thread CompactThread;
+
+
         /* Disk Buffer Vector. */
         std::vector< std::pair< std::vector<uint8_t>, std::vector<uint8_t> > > vDiskBuffer;
 
@@ -146,6 +208,15 @@ namespace LLD
         std::atomic<uint32_t> nBytesWrote;
         std::atomic<uint32_t> nRecordsFlushed;
 
+        /* Bytes of sector files reclaimed by the compactor. */
+        std::atomic<uint64_t> nBytesReclaimed;
+
+        /* Records moved by the compactor, so writers know when a key they read may have moved. */
+        std::atomic<uint64_t> nRelocations;
+
+        /* Bytes saved by compressing records in COMPRESS mode. */
+        std::atomic<uint64_t> nBytesSaved;
+
         /* Destructor Flag. */
         std::atomic<bool> fDestruct;
 
@@ -155,14 +226,232 @@ namespace LLD
 
 
         /** Database Flags. **/
-        uint8_t nFlags;
+        uint16_t nFlags;
+
+
+        /** The smallest record that is compressed in COMPRESS mode. **/
+        uint32_t nCompressMin;
 
 
     public:
 
 
+        /** Cursor
+         *
+         *  Walks the records of every key that starts with a prefix, in key order.
+         *  Keys are copied out of the keychain in batches, so the database can be read and
+         *  written while a cursor is open. Only committed records are visited.
+         *
+         **/
+        class Cursor
+        {
+            /** The database being walked. **/
+            SectorDatabase* pdb;
+
+
+            /** The serialized prefix of the keys. **/
+            std::vector<uint8_t> vPrefix;
+
+
+            /** The current batch of keys. **/
+            std::vector<std::vector<uint8_t>> vKeys;
+
+
+            /** The next key in the batch. **/
+            uint32_t nIndex;
+
+
+            /** Flag to indicate the keychain can be walked in order. **/
+            bool fOrdered;
+
+
+            /** Flag to indicate the last batch has been copied. **/
+            bool fEnd;
+
+
+        public:
+
+            /** Prefix Constructor.
+             *
+             *  @param[in] pdbIn The database to walk.
+             *  @param[in] vPrefixIn The serialized prefix of the keys.
+             *
+             **/
+            Cursor(SectorDatabase* pdbIn, const std::vector<uint8_t>& vPrefixIn)
+            : pdb      (pdbIn)
+            , vPrefix  (vPrefixIn)
+            , vKeys    ( )
+            , nIndex   (0)
+            , fOrdered (false)
+            , fEnd     (false)
+            {
+                /* Copy the first batch of keys. */
+                fOrdered = pdb->pSectorKeys->Seek(vPrefix, std::vector<uint8_t>(), vKeys, CURSOR_BATCH_SIZE);
+                fEnd     = (vKeys.size() < CURSOR_BATCH_SIZE);
+            }
+
+
+            /** Ordered
+             *
+             *  Check that the keychain supports ordered traversal. Cursors over
+             *  hashmap keychains are always empty.
+             *
+             *  @return True if the keychain is ordered.
+             *
+             **/
+            bool Ordered() const
+            {
+                return fOrdered;
+            }
+
+
+            /** NextKey
+             *
+             *  Get the next key without reading its record, skipping keys erased since their batch was copied.
+             *
+             *  @param[out] vKey The binary data of the key.
+             *
+             *  @return True if a key was found, false at the end of the prefix.
+             *
+             **/
+            bool NextKey(std::vector<uint8_t>& vKey)
+            {
+                SectorKey cKey;
+                while(NextBatch())
+                {
+                    /* Check the key wasn't erased. */
+                    vKey = vKeys[nIndex++];
+                    if(pdb->pSectorKeys->Get(vKey, cKey))
+                        return true;
+                }
+
+                return false;
+            }
+
+
+            /** NextKey
+             *
+             *  Get and deserialize the next key without reading its record.
+             *
+             *  @param[out] key The next key.
+             *
+             *  @return True if a key was found, false at the end of the prefix.
+             *
+             **/
+            template<typename Key>
+            bool NextKey(Key& key)
+            {
+                std::vector<uint8_t> vKey;
+                if(!NextKey(vKey))
+                    return false;
+
+                /* Deserialize the key. */
+                DataStream ssKey(vKey, SER_LLD, DATABASE_VERSION);
+                ssKey >> key;
+
+                return true;
+            }
+
+
+            /** Next
+             *
+             *  Read the next key and its record, skipping keys erased since their batch was copied.
+             *
+             *  @param[out] vKey The binary data of the key.
+             *  @param[out] vData The binary data of the record.
+             *
+             *  @return True if a record was read, false at the end of the prefix.
+             *
+             **/
+            bool Next(std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData)
+            {
+                while(NextBatch())
+                {
+                    /* Read the record of the key. */
+                    vKey = vKeys[nIndex++];
+                    if(pdb->Get(vKey, vData))
+                        return true;
+                }
+
+                return false;
+            }
+
+
+            /** Next
+             *
+             *  Read and deserialize the next key and its record.
+             *
+             *  @param[out] key The key of the record.
+             *  @param[out] value The value of the record.
+             *  @param[in] strType The type specifier to read records of, empty for any type.
+             *
+             *  @return True if a record was read, false at the end of the prefix.
+             *
+             **/
+            template<typename Key, typename Type>
+            bool Next(Key& key, Type& value, const std::string& strType = "")
+            {
+                std::vector<uint8_t> vKey;
+                std::vector<uint8_t> vData;
+                while(Next(vKey, vData))
+                {
+                    /* Deserialize the type specifier. */
+                    DataStream ssValue(vData, SER_LLD, DATABASE_VERSION);
+
+                    std::string strRecord;
+                    ssValue >> strRecord;
+
+                    /* Skip records of other types. */
+                    if(!strType.empty() && strRecord != strType)
+                        continue;
+
+                    /* Deserialize the key. */
+                    DataStream ssKey(vKey, SER_LLD, DATABASE_VERSION);
+                    ssKey >> key;
+
+                    /* Deserialize the value. */
+                    ssValue >> value;
+
+                    return true;
+                }
+
+                return false;
+            }
+
+
+        private:
+
+            /** NextBatch
+             *
+             *  Copy the next batch of keys once the current one is walked.
+             *
+             *  @return True if there is a key left to walk.
+             *
+             **/
+            bool NextBatch()
+            {
+                while(nIndex >= vKeys.size())
+                {
+                    if(fEnd)
+                        return false;
+
+                    /* Continue from the last key of this batch. */
+                    const std::vector<uint8_t> vAfter = vKeys.back();
+
+                    vKeys.clear();
+                    nIndex = 0;
+
+                    pdb->pSectorKeys->Seek(vPrefix, vAfter, vKeys, CURSOR_BATCH_SIZE);
+                    fEnd = (vKeys.size() < CURSOR_BATCH_SIZE);
+                }
+
+                return true;
+            }
+        };
+
+
         /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        SectorDatabase(const std::string& strNameIn, const uint8_t nFlagsIn,
+        SectorDatabase(const std::string& strNameIn, const uint16_t nFlagsIn,
                        const uint64_t nBucketsIn = 256 * 256 * 64, const uint32_t nCacheIn = 1024 * 1024);
 
 
@@ -322,6 +611,60 @@ namespace LLD
         }
 
 
+        /** Seek
+         *
+         *  Open a cursor over the records of every key that starts with a prefix.
+         *  The prefix is serialized the same as the keys, so a prefix of std::string("state")
+         *  matches keys of std::make_pair(std::string("state"), hash).
+         *
+         *  @param[in] prefix The prefix of the keys to walk.
+         *
+         *  @return The cursor positioned before the first key.
+         *
+         **/
+        template<typename Prefix>
+        Cursor Seek(const Prefix& prefix)
+        {
+            /* Serialize Prefix into Bytes. */
+            DataStream ssPrefix(SER_LLD, DATABASE_VERSION);
+            ssPrefix << prefix;
+
+            return Cursor(this, ssPrefix.Bytes());
+        }
+
+
+        /** Iterate
+         *
+         *  Visit the records of every key that starts with a prefix, in key order.
+         *
+         *  @param[in] prefix The prefix of the keys to walk.
+         *  @param[in] xVisit The function called with each key and value, returning false to stop.
+         *  @param[in] strType The type specifier to read records of, empty for any type.
+         *
+         *  @return True if the keychain is ordered, false if it can't be iterated.
+         *
+         **/
+        template<typename Key, typename Type, typename Prefix>
+        bool Iterate(const Prefix& prefix, const std::function<bool(const Key&, const Type&)>& xVisit, const std::string& strType = "")
+        {
+            /* Check the keychain can be walked. */
+            Cursor cursor = Seek(prefix);
+            if(!cursor.Ordered())
+                return false;
+
+            /* Visit until the end of the prefix or the callback stops. */
+            Key key;
+            Type value;
+            while(cursor.Next(key, value, strType))
+            {
+                if(!xVisit(key, value))
+                    break;
+            }
+
+            return true;
+        }
+
+
         /** GetBatch
          *
          *  Sequential read from a specified binary position.
@@ -367,20 +710,16 @@ namespace LLD
                     DataStream ssData(SER_LLD, DATABASE_VERSION);
                     ssData.resize(nBufferSize);
 
-                    {
-                        LOCK(SECTOR_MUTEX);
-
-                        /* Seek stream to beginning. */
-                        stream.seekg(nStart, std::ios::beg);
+                    /* Seek stream to beginning. This stream is local so needs no sector lock. */
+                    stream.seekg(nStart, std::ios::beg);
 
-                        /* Read the data into the buffer. */
-                        stream.read((char*)ssData.data(), nBufferSize);
-                        if(!stream)
-                            ssData.resize(stream.gcount());
+                    /* Read the data into the buffer. */
+                    stream.read((char*)ssData.data(), nBufferSize);
+                    if(!stream)
+                        ssData.resize(stream.gcount());
 
-                        /* Iterate if meters are enabled. */
-                        nBytesRead += static_cast<uint32_t>(nBufferSize);
-                    }
+                    /* Iterate if meters are enabled. */
+                    nBytesRead += static_cast<uint32_t>(nBufferSize);
 
                     /* Read records. */
                     while(!ssData.End())
@@ -395,16 +734,50 @@ namespace LLD
                             if(nSize == 0) //reached end of current file
                                 break;
 
+                            /* Get the first byte of the record to check how it was written. */
+                            const uint8_t nHeader = ssData.End() ? 0 : *ssData.data(ssData.GetPos());
+
+                            /* Skip over index keys that were written as links. */
+                            if(nHeader == SECTOR_LINK)
+                            {
+                                ssData.SetPos(nPos + nSize + GetSizeOfCompactSize(nSize));
+                                nStart += nSize + GetSizeOfCompactSize(nSize);
+
+                                continue;
+                            }
+
+                            /* Compressed records are read out of the buffer and decompressed into their own stream. */
+                            const bool fCompressed = (nHeader == SECTOR_COMPRESSED);
+
+                            DataStream ssRecord(SER_LLD, DATABASE_VERSION);
+                            if(fCompressed)
+                            {
+                                ssRecord.resize(nSize);
+                                ssData.read((char*)ssRecord.data(), nSize);
+
+                                /* Skip over records that fail to decompress. */
+                                if(!Decompress(ssRecord.Bytes()))
+                                {
+                                    debug::error(FUNCTION, "failed to decompress record in file ", nFile, " at ", nStart);
+
+                                    nStart += nSize + GetSizeOfCompactSize(nSize);
+                                    continue;
+                                }
+                            }
+
+                            /* Get the stream the record is read from. */
+                            const DataStream& ssValue = fCompressed ? ssRecord : ssData;
+
                             /* Deserialize the String. */
                             std::string strThis;
-                            ssData >> strThis;
+                            ssValue >> strThis;
 
                             /* Check the type. */
                             if(strType == strThis)
                             {
                                 /* Get the value. */
                                 Type value;
-                                ssData >> value;
+                                ssValue >> value;
 
                                 /* Push next value. */
                                 vValues.push_back(value);
@@ -413,7 +786,7 @@ namespace LLD
                                 if(nLimit != -1 && --nLimit == 0)
                                     return (vValues.size() > 0);
                             }
-                            else
+                            else if(!fCompressed)
                                 ssData.SetPos(nPos + nSize + GetSizeOfCompactSize(nSize));
 
                             /* Iterate to next position. */
@@ -558,18 +931,12 @@ namespace LLD
                 }
             }
 
-            /* Get the key. */
-            SectorKey cKey;
-            if(!pSectorKeys->Get(vIndex, cKey))
-                return false;
-
             /* Remove the item from the cache pool. */
             cachePool->Remove(vIndex);
             cachePool->Remove(vKey);
 
             /* Write the new sector key. */
-            cKey.SetKey(vKey);
-            return pSectorKeys->Put(cKey);
+            return IndexKey(vKey, vIndex);
         }
 
 
@@ -699,17 +1066,240 @@ namespace LLD
         bool Get(const SectorKey& cKey, std::vector<uint8_t>& vData);
 
 
+        /** GetRecord
+         *
+         *  Get the record of a key from cache or from disk, without following links.
+         *
+         *  @param[in] vKey The binary data of the key to get.
+         *  @param[out] vData The binary data of the record to get.
+         *
+         *  @return True if the record was read successfully.
+         *
+         **/
+        bool GetRecord(const std::vector<uint8_t>& vKey, std::vector<uint8_t>& vData);
+
+
+        /** ReadLink
+         *
+         *  Read the record an index key links to, other records are left as they are.
+         *
+         *  @param[in,out] vData The binary data of the record, replaced by the linked record.
+         *
+         *  @return True if the record is ready to be used.
+         *
+         **/
+        bool ReadLink(std::vector<uint8_t>& vData);
+
+
+        /** ReadSector
+         *
+         *  Read a record from its sector file. Readers don't take the sector lock
+         *  and only wait on in place updates to the same record.
+         *
+         *  @param[in] cKey The sector key from keychain.
+         *  @param[out] vData The binary data of the record to get.
+         *
+         *  @return True if the record was read successfully.
+         *
+         **/
+        bool ReadSector(const SectorKey& cKey, std::vector<uint8_t>& vData);
+
+
+        /** GetMapped
+         *
+         *  Read a record by pointer arithmetic from a memory mapped sector file.
+         *  This requires no locks since the maps are only ever added, never moved.
+         *
+         *  @param[in] cKey The sector key from keychain.
+         *  @param[out] vData The binary data of the record to get.
+         *
+         *  @return True if the record was read successfully.
+         *
+         **/
+        bool GetMapped(const SectorKey& cKey, std::vector<uint8_t>& vData);
+
+
+        /** GetPositional
+         *
+         *  Read a record with pread on a shared read-only descriptor.
+         *  This is independent of any stream position so needs no sector lock.
+         *
+         *  @param[in] cKey The sector key from keychain.
+         *  @param[out] vData The binary data of the record to get.
+         *
+         *  @return True if the record was read successfully.
+         *
+         **/
+        bool GetPositional(const SectorKey& cKey, std::vector<uint8_t>& vData);
+
+
+        /** RecordMutex
+         *
+         *  Get the striped lock protecting a record from in place updates.
+         *
+         *  @param[in] cKey The sector key of the record.
+         *
+         *  @return Reference to the reader-writer lock for this record.
+         *
+         **/
+        shared_mutex& RecordMutex(const SectorKey& cKey) const;
+
+
+        /** ReadRecord
+         *
+         *  Read a record from its sector file without taking the record lock.
+         *
+         *  @param[in] cKey The sector key from keychain.
+         *  @param[out] vData The binary data of the record to get.
+         *
+         *  @return True if the record was read successfully.
+         *
+         **/
+        bool ReadRecord(const SectorKey& cKey, std::vector<uint8_t>& vData);
+
+
+        /** AppendSector
+         *
+         *  Append a record to the end of the current sector file, allocating a new file if it is full.
+         *
+         *  @param[in] vData The binary data of the record to append.
+         *  @param[out] key The sector key to set the file, start, and size of.
+         *
+         *  @return True if the record was appended.
+         *
+         **/
+        bool AppendSector(const std::vector<uint8_t>& vData, SectorKey& key);
+
+
+        /** MoveRecord
+         *
+         *  Move a record to the end of the current sector file and point all of its keys to it.
+         *
+         *  @param[in] vKeys The keys pointing to the record, with the slots they were found in.
+         *
+         *  @return True if the record was moved.
+         *
+         **/
+        bool MoveRecord(const std::vector<std::pair<SectorKey, uint64_t>>& vKeys);
+
+
+        /** RetireFile
+         *
+         *  Close a sector file that has no live records and truncate it, once its readers are drained.
+         *  The file is kept so that the sector files stay numbered in order.
+         *
+         *  @param[in] nFile The sector file to retire.
+         *
+         *  @return The number of bytes reclaimed.
+         *
+         **/
+        uint64_t RetireFile(const uint32_t nFile);
+
+
+        /** IndexKey
+         *
+         *  Write a key pointing to the same sector as an existing key.
+         *  This is retried if the compactor moved records while it was written.
+         *
+         *  @param[in] vKey The binary data of the key to write.
+         *  @param[in] vIndex The binary data of the key to index to.
+         *
+         *  @return True if the key was written.
+         *
+         **/
+        bool IndexKey(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vIndex);
+
+
+        /** OpenFile
+         *
+         *  Open a read-only descriptor for a sector file if it is not opened already.
+         *
+         *  @param[in] nFile The sector file number to open.
+         *
+         *  @return The file descriptor, -1 on failure.
+         *
+         **/
+        int32_t OpenFile(const uint32_t nFile);
+
+
+        /** MapFile
+         *
+         *  Memory map a sector file read-only if it is not mapped already.
+         *
+         *  @param[in] nFile The sector file number to map.
+         *
+         *  @return The base pointer of the mapped file, nullptr on failure.
+         *
+         **/
+        uint8_t* MapFile(const uint32_t nFile);
+
+
+        /** ExtendMapped
+         *
+         *  Raise the backed size of a mapped sector file, never lowering it.
+         *
+         *  @param[in] nFile The sector file number.
+         *  @param[in] nSize The new size of the file in bytes.
+         *
+         **/
+        void ExtendMapped(const uint32_t nFile, const uint64_t nSize);
+
+
         /** Update
          *
          *  Update a record on disk.
          *
          *  @param[in] vKey The binary data of the key to flush
          *  @param[in] vData The binary data of the record to flush
+         *  @param[in] vSector The binary data of the record as it is written to disk.
          *
          *  @return True if the flush was successful.
          *
          **/
-        bool Update(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData);
+        bool Update(const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData, const std::vector<uint8_t>& vSector);
+
+
+        /** FitSector
+         *
+         *  Get the bytes to write a record into an existing sector in place, so that keys indexed to the
+         *  sector stay valid. Compressed records are padded out to the size of the sector.
+         *
+         *  @param[in] key The sector key of the existing record.
+         *  @param[in] vData The binary data of the record.
+         *  @param[in] vSector The binary data of the record as it would be appended.
+         *  @param[out] vPadded The padded sector, if it was needed.
+         *
+         *  @return Pointer to the bytes to write, nullptr if the record doesn't fit the sector.
+         *
+         **/
+        const std::vector<uint8_t>* FitSector(const SectorKey& key, const std::vector<uint8_t>& vData,
+            const std::vector<uint8_t>& vSector, std::vector<uint8_t>& vPadded) const;
+
+
+        /** Compress
+         *
+         *  LZ4 compress a record if the database is in COMPRESS mode and the record is large enough.
+         *
+         *  @param[in] vData The binary data of the record.
+         *  @param[out] vSector The compressed sector, including its header.
+         *
+         *  @return True if the record was compressed, false if it is to be written as is.
+         *
+         **/
+        bool Compress(const std::vector<uint8_t>& vData, std::vector<uint8_t>& vSector);
+
+
+        /** Decompress
+         *
+         *  Decompress a sector in place if it was written compressed, other sectors are left as they are.
+         *  This doesn't depend on the COMPRESS flag so that sector files with mixed records stay readable.
+         *
+         *  @param[in,out] vData The binary data of the sector.
+         *
+         *  @return True if the record is ready to be used, false if it failed to decompress.
+         *
+         **/
+        bool Decompress(std::vector<uint8_t>& vData) const;
 
 
         /** Force
@@ -767,6 +1357,27 @@ namespace LLD
         void Meter();
 
 
+        /** Compactor
+         *
+         *  LLD Compactor Thread. Periodically compacts the sector files when enabled by -lldcompact.
+         *
+         **/
+        void Compactor();
+
+
+        /** Compact
+         *
+         *  Rewrite the live records of sector files with too much dead space to the end of the
+         *  current file, then retire the old files. Readers are not stopped while this runs.
+         *
+         *  @param[in] nRatio The percentage of dead space a file needs to be compacted.
+         *
+         *  @return The number of bytes reclaimed.
+         *
+         **/
+        uint64_t Compact(const uint32_t nRatio);
+
+
         /** TxnBegin
          *
          *  Start a database transaction.
@@ -777,10 +1388,14 @@ namespace LLD
 
         /** TxnCheckpoint
          *
-         *  Write the transaction commitment message.
+         *  Write the transaction commitment message into the shared journal.
+         *
+         *  @param[in] journal The journal shared by the databases in the transaction.
+         *
+         *  @return True if the transaction was added to the journal.
          *
          **/
-        bool TxnCheckpoint();
+        bool TxnCheckpoint(TxnJournal& journal);
 
 
         /** TxnRelease
@@ -801,12 +1416,49 @@ namespace LLD
         bool TxnCommit();
 
 
+        /** TxnSync
+         *
+         *  Sync the sector files written since the last sync to disk, so that the journal
+         *  of the records in them can be released.
+         *
+         *  @return True if the files were synced, false otherwise.
+         *
+         **/
+        bool TxnSync();
+
+
         /** TxnRecovery
          *
-         *  Recover a transaction from the journal.
+         *  Recover a transaction from its records in the journal.
+         *
+         *  @param[in] vJournal The journal records of this database.
+         *
+         *  @return True if the records reached their commit message.
+         *
+         **/
+        bool TxnRecovery(const std::vector<uint8_t>& vJournal);
+
+
+        /** GetName
+         *
+         *  Get the name of this database.
+         *
+         **/
+        const std::string& GetName() const
+        {
+            return strName;
+        }
+
+
+        /** GetCache
+         *
+         *  Get the cache pool of this database, for its hit and miss counters.
          *
          **/
-        bool TxnRecovery();
+        const CacheType* GetCache() const
+        {
+            return cachePool;
+        }
 
     };
 }
@@ -71,7 +71,7 @@ namespace LLD
     public:
 
         /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        ContractDB(const uint8_t nFlagsIn = FLAGS::CREATE | FLAGS::WRITE,
+        ContractDB(const uint16_t nFlagsIn = FLAGS::CREATE | FLAGS::WRITE,
             const uint32_t nBucketsIn = 77773, const uint32_t nCacheIn = 1024 * 1024);
 
 
@@ -18,8 +18,8 @@ ________________________________________________________________________________
 #include <LLC/types/uint1024.h>
 
 #include <LLD/templates/sector.h>
-#include <LLD/cache/binary_lru.h>
-#include <LLD/keychain/hashmap.h>
+#include <LLD/cache/shard_lru.h>
+#include <LLD/keychain/keychain.h>
 
 #include <TAO/Operation/types/contract.h>
 
@@ -72,7 +72,7 @@ namespace LLD
      *  The database class for the Ledger Layer.
      *
      **/
-    class LedgerDB : public SectorDatabase<BinaryHashMap, BinaryLRU>
+    class LedgerDB : public SectorDatabase<Keychain, ShardLRU>
     {
 
         /** Mutex to lock internall when accessing memory mode. **/
@@ -95,7 +95,7 @@ namespace LLD
 
 
         /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        LedgerDB(const uint8_t nFlagsIn = FLAGS::CREATE | FLAGS::WRITE,
+        LedgerDB(const uint16_t nFlagsIn = FLAGS::CREATE | FLAGS::WRITE,
             const uint32_t nBucketsIn = 77773, const uint32_t nCacheIn = 1024 * 1024);
 
 
@@ -48,7 +48,7 @@ namespace LLD
     public:
 
         /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        LocalDB(const uint8_t nFlagsIn = FLAGS::CREATE | FLAGS::WRITE,
+        LocalDB(const uint16_t nFlagsIn = FLAGS::CREATE | FLAGS::WRITE,
             const uint32_t nBucketsIn = 77773, const uint32_t nCacheIn = 1024 * 1024);
 
 
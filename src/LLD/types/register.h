@@ -18,8 +18,8 @@ ________________________________________________________________________________
 #include <LLC/types/uint1024.h>
 
 #include <LLD/templates/sector.h>
-#include <LLD/cache/binary_lru.h>
-#include <LLD/keychain/hashmap.h>
+#include <LLD/cache/shard_lru.h>
+#include <LLD/keychain/keychain.h>
 
 #include <TAO/Register/types/state.h>
 
@@ -52,7 +52,7 @@ namespace LLD
      *  The database class for the Register Layer.
      *
      **/
-    class RegisterDB : public SectorDatabase<BinaryHashMap, BinaryLRU>
+    class RegisterDB : public SectorDatabase<Keychain, ShardLRU>
     {
         
         /** Memory mutex to lock when accessing internal memory states. **/
@@ -71,11 +71,15 @@ namespace LLD
         RegisterTransaction* pCommit;
 
 
+        /** Flag to indicate the secondary indexes are complete and maintained. **/
+        std::atomic<bool> fIndexes;
+
+
     public:
 
 
         /** The Database Constructor. To determine file location and the Bytes per Record. **/
-        RegisterDB(const uint8_t nFlagsIn = FLAGS::CREATE | FLAGS::WRITE,
+        RegisterDB(const uint16_t nFlagsIn = FLAGS::CREATE | FLAGS::WRITE,
             const uint32_t nBucketsIn = 77773, const uint32_t nCacheIn = 1024 * 1024);
 
 
@@ -205,6 +209,59 @@ namespace LLD
         bool HasState(const uint256_t& hashRegister, const uint8_t nFlags = TAO::Ledger::FLAGS::BLOCK);
 
 
+        /** InitializeIndexes
+         *
+         *  Check the secondary indexes by owner, standard and token are complete, rebuilding them if requested.
+         *  The indexes are walked by prefix, so they are only kept with an ordered keychain, which
+         *  requires starting with -registerkeychain=tree. The default hashmap keychain has no indexes.
+         *
+         *  @param[in] fReindex Flag to rebuild the indexes from every state register.
+         *
+         *  @return True if the indexes are available.
+         *
+         **/
+        bool InitializeIndexes(const bool fReindex);
+
+
+        /** ListOwner
+         *
+         *  List the registers owned by a genesis or a register, from the owner index.
+         *
+         *  @param[in] hashOwner The owner of the registers.
+         *  @param[out] vRegisters The register addresses found.
+         *
+         *  @return True if the indexes are available, false without -registerkeychain=tree or complete indexes.
+         *
+         **/
+        bool ListOwner(const uint256_t& hashOwner, std::vector<uint256_t>& vRegisters);
+
+
+        /** ListStandard
+         *
+         *  List the object registers of an object standard, from the standard index.
+         *
+         *  @param[in] nStandard The object standard.
+         *  @param[out] vRegisters The register addresses found.
+         *
+         *  @return True if the indexes are available, false without -registerkeychain=tree or complete indexes.
+         *
+         **/
+        bool ListStandard(const uint8_t nStandard, std::vector<uint256_t>& vRegisters);
+
+
+        /** ListToken
+         *
+         *  List the accounts of a token, from the token index.
+         *
+         *  @param[in] hashToken The token identifier.
+         *  @param[out] vRegisters The register addresses found.
+         *
+         *  @return True if the indexes are available, false without -registerkeychain=tree or complete indexes.
+         *
+         **/
+        bool ListToken(const uint256_t& hashToken, std::vector<uint256_t>& vRegisters);
+
+
         /** MemoryBegin
          *
          *  Begin a memory transaction following ACID properties.
@@ -228,6 +285,52 @@ namespace LLD
          **/
         void MemoryCommit();
 
+
+    private:
+
+
+        /** UpdateIndexes
+         *
+         *  Update the secondary indexes of a register to a new state, or remove them if it is erased.
+         *  Uses the same ACID transaction as the state if one is open.
+         *
+         *  @param[in] hashRegister The register address.
+         *  @param[in] pstate The new state register, nullptr if the register is erased.
+         *
+         *  @return True if the indexes were updated.
+         *
+         **/
+        bool UpdateIndexes(const uint256_t& hashRegister, const TAO::Register::State* pstate);
+
+
+        /** WriteIndexes
+         *
+         *  Write or erase every secondary index of a state register.
+         *
+         *  @param[in] hashRegister The register address.
+         *  @param[in] state The state register to index.
+         *  @param[in] fErase Flag to erase the indexes instead of writing them.
+         *
+         *  @return True if the indexes were written.
+         *
+         **/
+        bool WriteIndexes(const uint256_t& hashRegister, const TAO::Register::State& state, const bool fErase);
+
+
+        /** ListIndex
+         *
+         *  List the registers of one value of a secondary index.
+         *
+         *  @param[in] strIndex The name of the index.
+         *  @param[in] value The indexed value.
+         *  @param[out] vRegisters The register addresses found.
+         *
+         *  @return True if the indexes are available, false without -registerkeychain=tree or complete indexes.
+         *
+         **/
+        template<typename Type>
+        bool ListIndex(const std::string& strIndex, const Type& value, std::vector<uint256_t>& vRegisters);
+
     };
 
 }
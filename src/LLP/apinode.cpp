@@ -12,6 +12,8 @@
 ____________________________________________________________________________________________*/
 
 
+#include <LLP/include/global.h>
+#include <LLP/include/metrics.h>
 #include <LLP/types/apinode.h>
 #include <LLP/templates/events.h>
 
@@ -90,6 +92,19 @@ namespace LLP
             return false;
         }
 
+        /* Serve the server metrics for Prometheus if enabled. */
+        if(INCOMING.strType == "GET" && INCOMING.strRequest == "/metrics" && config::GetBoolArg("-apiprometheus", false))
+        {
+            /* Build packet. */
+            HTTPPacket RESPONSE(200);
+            RESPONSE.mapHeaders["Content-Type"] = "text/plain; version=0.0.4";
+            RESPONSE.strContent = LLP::Prometheus(LLP::GetMetrics(), LLP::GetCacheMetrics());
+
+            this->WritePacket(RESPONSE);
+
+            return true;
+        }
+
         /* Parse the packet request. */
         std::string::size_type npos = INCOMING.strRequest.find('/', 1);
 
@@ -105,9 +120,6 @@ namespace LLP
         /* The HTTP response status code, default to 200 unless an error is encountered */
         uint16_t nStatus = 200;
 
-        /* Flag indicating that the connection should be kept alive */
-        bool fKeepAlive = false;
-
         /* Extract the parameters. */
         try
         {
@@ -286,25 +298,25 @@ namespace LLP
         if(INCOMING.mapHeaders.count("origin"))
             RESPONSE.mapHeaders["Access-Control-Allow-Origin"] = INCOMING.mapHeaders["origin"];
 
-        /* Add the connection header */
-        if(INCOMING.mapHeaders.count("connection") && INCOMING.mapHeaders["connection"] == "keep-alive")
-        {
-            RESPONSE.mapHeaders["Connection"] = "keep-alive";
-            fKeepAlive = true;
-        }
-        else
-        {
-            RESPONSE.mapHeaders["Connection"] = "close";
-            fKeepAlive = true;
-        }
+        /* Add the connection header, the connection is kept open either way for the client to close. */
+        RESPONSE.mapHeaders["Connection"] = INCOMING.KeepAlive() ? "keep-alive" : "close";
 
-        /* Add content. */
-        RESPONSE.strContent = ret.dump();
-            
-        /* Write the response */
-        this->WritePacket(RESPONSE);
+        /* Write the response with content. */
+        WriteResponse(RESPONSE, ret);
+
+        return true;
+    }
+
+
+    /* Returns the API and method of the incoming request. */
+    std::string APINode::MessageName() const
+    {
+        /* Remove the leading slash and any url encoded parameters. */
+        std::string strName = INCOMING.strRequest.substr(0, INCOMING.strRequest.find('?'));
+        if(!strName.empty() && strName[0] == '/')
+            strName.erase(0, 1);
 
-        return fKeepAlive;
+        return strName;
     }
 
 
@@ -53,6 +53,8 @@ namespace LLP
     , fCONNECTED      (false)
     , nDataThread     (-1)
     , nDataIndex      (-1)
+    , nProcessing     (0)
+    , nReadMark       (0)
     , FLUSH_CONDITION (nullptr)
     , fEVENT          (false)
     , EVENT_MUTEX     ( )
@@ -75,6 +77,8 @@ namespace LLP
     , fCONNECTED      (false)
     , nDataThread     (-1)
     , nDataIndex      (-1)
+    , nProcessing     (0)
+    , nReadMark       (0)
     , FLUSH_CONDITION (nullptr)
     , fEVENT          (false)
     , EVENT_MUTEX     ( )
@@ -97,6 +101,8 @@ namespace LLP
     , fCONNECTED      (false)
     , nDataThread     (-1)
     , nDataIndex      (-1)
+    , nProcessing     (0)
+    , nReadMark       (0)
     , FLUSH_CONDITION (nullptr)
     , fEVENT          (false)
     , EVENT_MUTEX     ( )
@@ -221,6 +227,36 @@ namespace LLP
     }
 
 
+    /* Write a serialized packet shared with other connections to the TCP stream. */
+    template <class PacketType>
+    void BaseConnection<PacketType>::WriteShared(const shared_buffer_t& pHeader, const shared_buffer_t& pData)
+    {
+        /* Get the total bytes of the packet. */
+        const uint64_t nBytes = pHeader->size() + pData->size();
+
+        /* Stop sending packets if send buffer is full. */
+        uint64_t nMaxSendBuffer = config::GetArg("-maxsendbuffer", MAX_SEND_BUFFER);
+        if(Buffered() + nBytes + 1024 < nMaxSendBuffer //reserve 1Kb of buffer for critical messages
+        || (fBufferFull.load() && Buffered() + nBytes < nMaxSendBuffer)) //catch for critical messages (< 1 Kb)
+        {
+            /* Debug dump of message type. */
+            debug::log(4, NODE, "sent shared packet (", nBytes, " bytes)");
+
+            /* Write the header and payload to socket buffer. */
+            Write(pHeader, pData);
+
+            /* Update packet count. */
+            ++PACKETS;
+        }
+        else //set buffer to full
+            fBufferFull.store(true);
+
+        /* Notify condition if available. */
+        if(FLUSH_CONDITION && Buffered())
+            FLUSH_CONDITION->notify_all();
+    }
+
+
     /*  Connect Socket to a Remote Endpoint. */
     template <class PacketType>
     bool BaseConnection<PacketType>::Connect(const BaseAddress &addrConnect)
@@ -12,6 +12,8 @@
 ____________________________________________________________________________________________*/
 
 #include <LLP/include/base_address.h>
+#include <LLP/include/metrics.h>
+#include <LLP/include/processor.h>
 #include <LLP/templates/data.h>
 
 #include <LLP/templates/socket.h>
@@ -25,6 +27,18 @@ ________________________________________________________________________________
 
 #include <Util/include/hex.h>
 
+#include <cstring>
+#include <limits>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
 
 namespace LLP
 {
@@ -33,8 +47,11 @@ namespace LLP
     template <class ProtocolType>
     DataThread<ProtocolType>::DataThread(uint32_t nID, bool ffDDOSIn,
                                          uint32_t rScore, uint32_t cScore,
-                                         uint32_t nTimeout, bool fMeter)
+                                         uint32_t nTimeout, bool fMeter, ProcessorPool* pProcessor,
+                                         Metrics* pMetrics)
     : SLOT_MUTEX      ( )
+    , EPOLL_PENDING   ( )
+    , EPOLL_RESUME    ( )
     , fDDOS           (ffDDOSIn)
     , fMETER          (fMeter)
     , fDestruct       (false)
@@ -44,6 +61,10 @@ namespace LLP
     , TIMEOUT         (nTimeout)
     , DDOS_rSCORE     (rScore)
     , DDOS_cSCORE     (cScore)
+    , EPOLL_FD        (open_epoll())
+    , PROCESSOR       (pProcessor)
+    , METRICS         (pMetrics)
+    , WAKE_PIPE       (open_wake())
     , CONNECTIONS     (memory::atomic_ptr< std::vector<memory::atomic_ptr<ProtocolType>> >(new std::vector<memory::atomic_ptr<ProtocolType>>()))
     , RELAY           (memory::atomic_ptr< std::queue<std::pair<typename ProtocolType::message_t, DataStream>> >(new std::queue<std::pair<typename ProtocolType::message_t, DataStream>>()))
     , CONDITION       ( )
@@ -69,6 +90,21 @@ namespace LLP
 
         CONNECTIONS.free();
         RELAY.free();
+
+    #if defined(__linux__)
+        /* Close the epoll backend. */
+        if(EPOLL_FD >= 0)
+            close(EPOLL_FD);
+    #endif
+
+    #ifndef WIN32
+        /* Close the wake pipe. */
+        if(WAKE_PIPE.first >= 0)
+        {
+            close(WAKE_PIPE.first);
+            close(WAKE_PIPE.second);
+        }
+    #endif
     }
 
 
@@ -82,6 +118,12 @@ namespace LLP
          */
         for(uint32_t nIndex = 0; nIndex < CONNECTIONS->size(); ++nIndex)
         {
+            /* Connections with a packet in the processor pool are disconnected by the data thread once it is finished. */
+            ProtocolType* CONNECTION = CONNECTIONS->at(nIndex).load();
+            if(!fDestruct.load() && CONNECTION
+            && (CONNECTION->nProcessing.fetch_or(PROCESSING::FAILED) & PROCESSING::BUSY))
+                continue;
+
             if(!fDestruct.load())
                 disconnect_remove_event(nIndex, DISCONNECT::FORCE);
             else
@@ -96,6 +138,15 @@ namespace LLP
     template <class ProtocolType>
     void DataThread<ProtocolType>::Thread()
     {
+    #if defined(__linux__)
+        /* Hand over to the epoll backend if enabled. */
+        if(EPOLL_FD >= 0)
+        {
+            epoll_thread();
+            return;
+        }
+    #endif
+
         /* Cache sleep time if applicable. */
         uint32_t nSleep = config::GetArg("-llpsleep", 0);
 
@@ -135,9 +186,16 @@ namespace LLP
             /* Wrapped mutex lock. */
             uint32_t nSize = static_cast<uint32_t>(CONNECTIONS->size());
 
-            /* Check the pollfd's size. */
-            if(POLLFDS.size() != nSize)
-                POLLFDS.resize(nSize);
+            /* Check the pollfd's size, with an extra entry for the wake pipe. */
+            const uint32_t nPoll = nSize + (WAKE_PIPE.first >= 0 ? 1 : 0);
+            if(POLLFDS.size() != nPoll)
+                POLLFDS.resize(nPoll);
+
+            /* Track if any connection is waiting on the processor pool. */
+            bool fProcessing = false;
+
+            /* Track if any connection has a packet left in its read buffer. */
+            bool fBuffered = false;
 
             /* Initialize the revents for all connection pollfd structures.
              * One connection must be live, so verify that and skip if none
@@ -158,6 +216,19 @@ namespace LLP
                         continue;
                     }
 
+                    /* Don't poll connections with a packet in the processor pool, they are read again once it is finished. */
+                    if(CONNECTIONS->at(nIndex)->nProcessing.load() & PROCESSING::BUSY)
+                    {
+                        POLLFDS.at(nIndex).fd = INVALID_SOCKET;
+                        fProcessing = true;
+
+                        continue;
+                    }
+
+                    /* Don't wait on the sockets if a packet was read along with the last one. */
+                    if(CONNECTIONS->at(nIndex)->PacketBuffered())
+                        fBuffered = true;
+
                     /* Set the correct file descriptor. */
                     POLLFDS.at(nIndex).fd = CONNECTIONS->at(nIndex)->fd;
                 }
@@ -167,20 +238,38 @@ namespace LLP
                 }
             }
 
+            /* Poll the wake pipe so finished packets interrupt the wait. */
+            if(nPoll > nSize)
+            {
+                POLLFDS.at(nSize).fd      = WAKE_PIPE.first;
+                POLLFDS.at(nSize).events  = POLLIN;
+                POLLFDS.at(nSize).revents = 0;
+            }
+
             /* Poll the sockets. */
 #ifdef WIN32
-            int32_t nPoll = WSAPoll((pollfd*)&POLLFDS[0], nSize, 100);
+            int32_t nReady = WSAPoll((pollfd*)&POLLFDS[0], nPoll, fBuffered ? 0 : (fProcessing ? 1 : 100)); //no wake pipe on windows
 #else
-            int32_t nPoll = poll((pollfd*)&POLLFDS[0], nSize, 100);
+            /* Without a wake pipe, connections in the processor pool are only picked up again by polling often. */
+            int32_t nReady = poll((pollfd*)&POLLFDS[0], nPoll, fBuffered ? 0 : ((fProcessing && nPoll == nSize) ? 1 : 100));
 #endif
 
             /* Check poll for available sockets. */
-            if(nPoll < 0)
+            if(nReady < 0)
             {
                 runtime::sleep(1);
                 continue;
             }
 
+        #ifndef WIN32
+            /* Empty the wake pipe. */
+            if(nPoll > nSize && (POLLFDS.at(nSize).revents & POLLIN))
+            {
+                uint8_t vDrain[64];
+                while(read(WAKE_PIPE.first, vDrain, sizeof(vDrain)) > 0) { }
+            }
+        #endif
+
 
             /* Check all connections for data and packets. */
             for(uint32_t nIndex = 0; nIndex < nSize; ++nIndex)
@@ -194,6 +283,10 @@ namespace LLP
                     if(!CONNECTION || !CONNECTION->Connected())
                         continue;
 
+                    /* Skip over connections with a packet in the processor pool. */
+                    if(pending_connection(nIndex, CONNECTION))
+                        continue;
+
                     /* Disconnect if there was a polling error */
                     if(POLLFDS.at(nIndex).revents & POLLERR)
                     {
@@ -208,105 +301,351 @@ namespace LLP
                         continue;
                     }
 
-                    /* Remove Connection if it has Timed out or had any read/write Errors. */
-                    if(CONNECTION->Errors())
+                    /* Disconnect if pollin signaled with no data (This happens on Linux). */
+                    if((POLLFDS.at(nIndex).revents & POLLIN)
+                    && CONNECTION->Available() == 0 && !CONNECTION->IsSSL())
                     {
-                        disconnect_remove_event(nIndex, DISCONNECT::ERRORS);
+                        disconnect_remove_event(nIndex, DISCONNECT::POLL_EMPTY);
                         continue;
                     }
 
-                    /* Remove Connection if it has Timed out or had any Errors. */
-                    if(CONNECTION->Timeout(TIMEOUT * 1000, Socket::READ))
+                    /* Check for errors, timeouts, buffers, and DDOS. */
+                    if(!check_connection(nIndex, CONNECTION))
+                        continue;
+
+                    /* Generic event for Connection. */
+                    CONNECTION->Event(EVENTS::GENERIC);
+
+                    /* Work on Reading a Packet. **/
+                    read_connection(nIndex, CONNECTION);
+                }
+                catch(const std::exception& e)
+                {
+                    debug::error(FUNCTION, "Data Connection: ", e.what());
+                    disconnect_remove_event(nIndex, DISCONNECT::ERRORS);
+                }
+            }
+        }
+    }
+
+
+#if defined(__linux__)
+    /* Data thread loop for the epoll backend. Only connections with events are read,
+     * while timeouts and generic events are driven by a timer wheel. */
+    template <class ProtocolType>
+    void DataThread<ProtocolType>::epoll_thread()
+    {
+        /* Cache sleep time if applicable. */
+        uint32_t nSleep = config::GetArg("-llpsleep", 0);
+
+        /* The mutex for the condition. */
+        std::mutex CONDITION_MUTEX;
+
+        /* The wheel ticks every 100 ms, with each connection due for its checks and a generic event every second. */
+        const uint64_t WHEEL_TICK     = 100;
+        const uint64_t WHEEL_INTERVAL = 10;
+        const uint32_t WHEEL_SLOTS    = 64;
+
+        /* Flags for the state of each connection slot. */
+        const uint8_t STATE_READY  = (1 << 0);
+        const uint8_t STATE_CLOSED = (1 << 1);
+
+        /* The events returned from each wait. */
+        std::vector<epoll_event> vEvents(256);
+
+        /* Edge triggered events only fire when new data arrives, so connections are kept ready until they stop making progress. */
+        std::vector<uint32_t> vReady;
+        std::vector<uint8_t>  vState;
+
+        /* The timer wheel, holding the connection index and the tick it is due on. */
+        std::vector< std::vector<std::pair<uint32_t, uint64_t>> > vWheel(WHEEL_SLOTS);
+        std::vector<uint64_t> vDue;
+
+        /* The start of the wheel, and the last tick it has visited. */
+        const uint64_t nStart = runtime::timestamp(true);
+        uint64_t nTick = 0;
+
+        /* The event data that marks the wake pipe. */
+        const uint64_t WAKE_EVENT = std::numeric_limits<uint64_t>::max();
+
+        /* Watch the wake pipe, so connections are read again as soon as the processor pool finishes their packet. */
+        if(WAKE_PIPE.first >= 0)
+        {
+            epoll_event event;
+            event.events   = EPOLLIN;
+            event.data.u64 = WAKE_EVENT;
+
+            if(epoll_ctl(EPOLL_FD, EPOLL_CTL_ADD, WAKE_PIPE.first, &event) < 0)
+                debug::error(FUNCTION, "failed to watch wake pipe: ", std::strerror(errno));
+        }
+
+        /* Schedule a connection on the timer wheel, replacing any earlier schedule. */
+        auto schedule = [&](const uint32_t nIndex, const uint64_t nDue)
+        {
+            if(nIndex >= vDue.size())
+                vDue.resize(nIndex + 1, 0);
+
+            vDue[nIndex] = nDue;
+            vWheel[nDue % WHEEL_SLOTS].push_back(std::make_pair(nIndex, nDue));
+        };
+
+        /* Add a connection to the ready list. */
+        auto ready = [&](const uint32_t nIndex, const uint8_t nFlags)
+        {
+            if(nIndex >= vState.size())
+                vState.resize(nIndex + 1, 0);
+
+            if(!(vState[nIndex] & STATE_READY))
+                vReady.push_back(nIndex);
+
+            vState[nIndex] |= (STATE_READY | nFlags);
+        };
+
+        /* The main connection handler loop. */
+        while(!fDestruct.load() && !config::fShutdown.load())
+        {
+            /* Check for data thread sleep (helps with cpu usage). */
+            if(nSleep > 0)
+                runtime::sleep(nSleep);
+
+            /* Keep data threads waiting for work. */
+            std::unique_lock<std::mutex> CONDITION_LOCK(CONDITION_MUTEX);
+            CONDITION.wait(CONDITION_LOCK,
+            [this]
+            {
+                return fDestruct.load()
+                || config::fShutdown.load()
+                || nIncoming.load() > 0
+                || nOutbound.load() > 0;
+            });
+
+            /* Check for close. */
+            if(fDestruct.load() || config::fShutdown.load())
+                return;
+
+            /* Schedule new connections, and read any data that arrived before they were watched. */
+            std::vector<uint32_t> vPending;
+            std::vector<uint32_t> vResume;
+            {
+                LOCK(SLOT_MUTEX);
+                vPending.swap(EPOLL_PENDING);
+                vResume.swap(EPOLL_RESUME);
+            }
+
+            /* Read connections again once the processor pool has finished their packet. */
+            for(const auto& nIndex : vResume)
+                ready(nIndex, 0);
+
+            for(const auto& nIndex : vPending)
+            {
+                if(nIndex < vState.size())
+                    vState[nIndex] &= ~STATE_CLOSED;
+
+                schedule(nIndex, nTick + WHEEL_INTERVAL);
+                ready(nIndex, 0);
+            }
+
+            /* Wait for events, without blocking while connections are still ready. */
+            int32_t nTimeout = 0;
+            if(vReady.empty())
+                nTimeout = static_cast<int32_t>(WHEEL_TICK - ((runtime::timestamp(true) - nStart) % WHEEL_TICK));
+
+            int32_t nEvents = epoll_wait(EPOLL_FD, &vEvents[0], static_cast<int32_t>(vEvents.size()), nTimeout);
+            if(nEvents < 0)
+            {
+                runtime::sleep(1);
+                continue;
+            }
+
+            /* Check the connections with events. */
+            for(int32_t nEvent = 0; nEvent < nEvents; ++nEvent)
+            {
+                /* Empty the wake pipe, the finished connections are picked up on the next loop. */
+                if(vEvents[nEvent].data.u64 == WAKE_EVENT)
+                {
+                    uint8_t vDrain[64];
+                    while(read(WAKE_PIPE.first, vDrain, sizeof(vDrain)) > 0) { }
+
+                    continue;
+                }
+
+                /* The event data holds the socket in the upper bits and the index in the lower bits. */
+                const uint32_t nIndex = static_cast<uint32_t>(vEvents[nEvent].data.u64);
+                const int32_t  nFile  = static_cast<int32_t>(vEvents[nEvent].data.u64 >> 32);
+                const uint32_t nFlags = vEvents[nEvent].events;
+
+                try
+                {
+                    /* Load the atomic pointer raw data. */
+                    ProtocolType* CONNECTION = CONNECTIONS->at(nIndex).load();
+
+                    /* Skip over inactive connections, or events for a socket that has since left this slot. */
+                    if(!CONNECTION || !CONNECTION->Connected() || CONNECTION->fd != nFile)
+                        continue;
+
+                    /* Keep the events of connections with a packet in the processor pool until it is finished. */
+                    if(CONNECTION->nProcessing.load() & PROCESSING::BUSY)
                     {
-                        disconnect_remove_event(nIndex, DISCONNECT::TIMEOUT);
+                        ready(nIndex, (nFlags & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) ? STATE_CLOSED : 0);
                         continue;
                     }
 
-                    /* Disconnect if pollin signaled with no data (This happens on Linux). */
-                    if((POLLFDS.at(nIndex).revents & POLLIN)
-                    && CONNECTION->Available() == 0 && !CONNECTION->IsSSL())
+                    /* Disconnect if there was a polling error */
+                    if(nFlags & EPOLLERR)
                     {
-                        disconnect_remove_event(nIndex, DISCONNECT::POLL_EMPTY);
+                        disconnect_remove_event(nIndex, DISCONNECT::POLL_ERROR);
                         continue;
                     }
 
-                    /* Disconnect if buffer is full and remote host isn't reading at all. */
-                    if(CONNECTION->Buffered()
-                    && CONNECTION->Timeout(15000, Socket::WRITE))
+                    /* Disconnect if the socket was disconnected by peer. */
+                    if(nFlags & EPOLLHUP)
                     {
-                        disconnect_remove_event(nIndex, DISCONNECT::TIMEOUT_WRITE);
+                        disconnect_remove_event(nIndex, DISCONNECT::PEER);
                         continue;
                     }
 
-                    /* Check that write buffers aren't overflowed. */
-                    if(CONNECTION->Buffered() > config::GetArg("-maxsendbuffer", MAX_SEND_BUFFER))
+                    /* Disconnect if the peer closed with no data left to read. */
+                    if((nFlags & EPOLLRDHUP) && CONNECTION->Available() == 0 && !CONNECTION->IsSSL())
                     {
-                        disconnect_remove_event(nIndex, DISCONNECT::BUFFER);
+                        disconnect_remove_event(nIndex, DISCONNECT::POLL_EMPTY);
                         continue;
                     }
 
-                    /* Handle any DDOS Filters. */
-                    if(fDDOS && CONNECTION->DDOS)
+                    /* Read the connection until it is drained. */
+                    ready(nIndex, (nFlags & EPOLLRDHUP) ? STATE_CLOSED : 0);
+                }
+                catch(const std::exception& e)
+                {
+                    debug::error(FUNCTION, "Data Connection: ", e.what());
+                    disconnect_remove_event(nIndex, DISCONNECT::ERRORS);
+                }
+            }
+
+            /* Work through the ready connections, keeping those that still have data. */
+            std::vector<uint32_t> vNext;
+            for(const auto& nIndex : vReady)
+            {
+                try
+                {
+                    /* Load the atomic pointer raw data. */
+                    ProtocolType* CONNECTION = CONNECTIONS->at(nIndex).load();
+
+                    /* Skip over inactive connections. */
+                    if(!CONNECTION || !CONNECTION->Connected())
                     {
-                        /* Ban a node if it has too many Requests per Second. **/
-                        if(CONNECTION->DDOS->rSCORE.Score() > DDOS_rSCORE
-                        || CONNECTION->DDOS->cSCORE.Score() > DDOS_cSCORE)
-                            CONNECTION->DDOS->Ban();
+                        vState[nIndex] = 0;
+                        continue;
+                    }
 
-                        /* Remove a connection if it was banned by DDOS Protection. */
-                        if(CONNECTION->DDOS->Banned())
-                        {
-                            debug::log(0, "BANNED: ", CONNECTION->GetAddress().ToString());
-                            disconnect_remove_event(nIndex, DISCONNECT::DDOS);
-                            continue;
-                        }
+                    /* Wait for the processor pool, the connection is made ready again once its packet is finished. */
+                    if(pending_connection(nIndex, CONNECTION))
+                    {
+                        vState[nIndex] &= ~STATE_READY;
+                        continue;
                     }
 
-                    /* Generic event for Connection. */
-                    CONNECTION->Event(EVENTS::GENERIC);
+                    /* Check for errors, timeouts, buffers, and DDOS. */
+                    if(!check_connection(nIndex, CONNECTION))
+                    {
+                        vState[nIndex] = 0;
+                        continue;
+                    }
 
                     /* Work on Reading a Packet. **/
-                    CONNECTION->ReadPacket();
+                    const int32_t nAvailable = CONNECTION->Available();
+                    if(!read_connection(nIndex, CONNECTION))
+                    {
+                        vState[nIndex] = 0;
+                        continue;
+                    }
 
-                    /* If a Packet was received successfully, increment request count [and DDOS count if enabled]. */
-                    if(CONNECTION->PacketComplete())
+                    /* Stop reading once the packet is handed to the processor pool. */
+                    if(CONNECTION->nProcessing.load() & PROCESSING::BUSY)
                     {
-                        /* Debug dump of message type. */
-                        if(config::nVerbose.load() >= 4)
-                            debug::log(4, FUNCTION, "Received Message (", CONNECTION->INCOMING.GetBytes().size(), " bytes)");
+                        vState[nIndex] &= ~STATE_READY;
+                        continue;
+                    }
 
-                        /* Debug dump of packet data. */
-                        if(config::nVerbose.load() >= 5)
-                            PrintHex(CONNECTION->INCOMING.GetBytes());
+                    /* Keep the connection ready while reading makes progress, or a packet is left in its read buffer.
+                     * New data will trigger another event. */
+                    const int32_t nRemaining = CONNECTION->Available();
+                    if((nRemaining > 0 && nRemaining < nAvailable) || CONNECTION->PacketBuffered())
+                    {
+                        vNext.push_back(nIndex);
+                        continue;
+                    }
+
+                    /* Disconnect once drained if the peer has closed. */
+                    if((vState[nIndex] & STATE_CLOSED) && nRemaining == 0 && !CONNECTION->IsSSL())
+                    {
+                        vState[nIndex] = 0;
+                        disconnect_remove_event(nIndex, DISCONNECT::POLL_EMPTY);
+                        continue;
+                    }
+
+                    vState[nIndex] &= ~STATE_READY;
+                }
+                catch(const std::exception& e)
+                {
+                    debug::error(FUNCTION, "Data Connection: ", e.what());
+                    disconnect_remove_event(nIndex, DISCONNECT::ERRORS);
+
+                    vState[nIndex] = 0;
+                }
+            }
+            vReady.swap(vNext);
+
+            /* Advance the timer wheel, visiting the connections that are due. */
+            const uint64_t nNow = (runtime::timestamp(true) - nStart) / WHEEL_TICK;
+            while(nTick < nNow)
+            {
+                /* Take the entries for this tick. */
+                std::vector<std::pair<uint32_t, uint64_t>> vSlot;
+                vSlot.swap(vWheel[(++nTick) % WHEEL_SLOTS]);
+
+                for(const auto& entry : vSlot)
+                {
+                    /* Skip entries replaced by a later schedule. */
+                    const uint32_t nIndex = entry.first;
+                    if(vDue[nIndex] != entry.second)
+                        continue;
 
-                        /* Handle Meters and DDOS. */
-                        if(fMETER)
-                            ++ProtocolType::REQUESTS;
+                    try
+                    {
+                        /* Load the atomic pointer raw data. */
+                        ProtocolType* CONNECTION = CONNECTIONS->at(nIndex).load();
 
-                        /* Increment rScore. */
-                        if(fDDOS && CONNECTION->DDOS)
-                            CONNECTION->DDOS->rSCORE += 1;
+                        /* Skip over inactive connections, they are scheduled again when the slot is reused. */
+                        if(!CONNECTION || !CONNECTION->Connected())
+                            continue;
 
-                        /* Packet Process return value of False will flag Data Thread to Disconnect. */
-                        if(!CONNECTION->ProcessPacket())
+                        /* Leave connections with a packet in the processor pool until the next interval. */
+                        if(pending_connection(nIndex, CONNECTION))
                         {
-                            disconnect_remove_event(nIndex, DISCONNECT::FORCE);
+                            schedule(nIndex, nTick + WHEEL_INTERVAL);
                             continue;
                         }
 
-                        /* Run procssed event for connection triggers. */
-                        CONNECTION->Event(EVENTS::PROCESSED);
-                        CONNECTION->ResetPacket();
+                        /* Check for errors, timeouts, buffers, and DDOS. */
+                        if(!check_connection(nIndex, CONNECTION))
+                            continue;
+
+                        /* Generic event for Connection. */
+                        CONNECTION->Event(EVENTS::GENERIC);
+
+                        /* Check the connection again next interval. */
+                        schedule(nIndex, nTick + WHEEL_INTERVAL);
+                    }
+                    catch(const std::exception& e)
+                    {
+                        debug::error(FUNCTION, "Data Connection: ", e.what());
+                        disconnect_remove_event(nIndex, DISCONNECT::ERRORS);
                     }
-                }
-                catch(const std::exception& e)
-                {
-                    debug::error(FUNCTION, "Data Connection: ", e.what());
-                    disconnect_remove_event(nIndex, DISCONNECT::ERRORS);
                 }
             }
         }
     }
+#endif
 
 
     /*  Thread that handles all the Reading / Writing of Data from Sockets.
@@ -360,12 +699,24 @@ namespace LLP
             std::pair<typename ProtocolType::message_t, DataStream> qRelay =
                 std::make_pair(typename ProtocolType::message_t(), DataStream(SER_NETWORK, MIN_PROTO_VERSION));
 
+            /* The relay serialized once, shared by every connection that relays it unfiltered. */
+            shared_buffer_t pHeader;
+            shared_buffer_t pData;
+
             /* Grab data from queue. */
             if(!RELAY->empty())
             {
                 /* Make a copy of the relay data. */
                 qRelay = RELAY->front();
                 RELAY->pop();
+
+                /* Serialize the header and payload, skipping empty relays. */
+                if(qRelay.second.size() != 0)
+                {
+                    pData   = std::make_shared<const std::vector<uint8_t>>(qRelay.second.Bytes());
+                    pHeader = std::make_shared<const std::vector<uint8_t>>(
+                        typename ProtocolType::packet_t(qRelay.first).GetHeader(static_cast<uint32_t>(pData->size())));
+                }
             }
 
             /* Check all connections for data and packets. */
@@ -374,22 +725,30 @@ namespace LLP
             {
                 try
                 {
-                    /* Reset stream read position. */
-                    qRelay.second.Reset();
-
                     /* Get atomic pointer to reduce locking around CONNECTIONS scope. */
                     memory::atomic_ptr<ProtocolType>& CONNECTION = CONNECTIONS->at(nIndex);
 
-                    /* Relay if there are active subscriptions. */
-                    const DataStream ssRelay = CONNECTION->RelayFilter(qRelay.first, qRelay.second);
-                    if(ssRelay.size() != 0)
+                    /* Check for data to relay. */
+                    if(pData)
                     {
-                        /* Build the sender packet. */
-                        typename ProtocolType::packet_t PACKET = typename ProtocolType::packet_t(qRelay.first);
-                        PACKET.SetData(ssRelay);
+                        /* Reset stream read position. */
+                        qRelay.second.Reset();
+
+                        /* Relay the shared buffers if the connection takes the data unchanged. */
+                        DataStream ssRelay(SER_NETWORK, MIN_PROTO_VERSION);
+                        if(CONNECTION->RelayFilter(qRelay.first, qRelay.second, ssRelay))
+                            CONNECTION->WriteShared(pHeader, pData);
 
-                        /* Write packet to socket. */
-                        CONNECTION->WritePacket(PACKET);
+                        /* Otherwise relay if there are active subscriptions. */
+                        else if(ssRelay.size() != 0)
+                        {
+                            /* Build the sender packet. */
+                            typename ProtocolType::packet_t PACKET = typename ProtocolType::packet_t(qRelay.first);
+                            PACKET.SetData(ssRelay);
+
+                            /* Write packet to socket. */
+                            CONNECTION->WritePacket(PACKET);
+                        }
                     }
 
                     /* Attempt to flush data when buffer is available. */
@@ -450,6 +809,12 @@ namespace LLP
     {
         LOCK(SLOT_MUTEX);
 
+    #if defined(__linux__)
+        /* Stop watching the socket before it is closed. */
+        if(EPOLL_FD >= 0)
+            epoll_ctl(EPOLL_FD, EPOLL_CTL_DEL, CONNECTIONS->at(nIndex)->fd, nullptr);
+    #endif
+
         /* Check for inbound socket. */
         if(CONNECTIONS->at(nIndex)->Incoming())
             --nIncoming;
@@ -478,6 +843,312 @@ namespace LLP
     }
 
 
+    /* Opens the epoll file descriptor when -llpbackend=epoll is set and supported. */
+    template <class ProtocolType>
+    int32_t DataThread<ProtocolType>::open_epoll()
+    {
+        /* Check the configured backend. */
+        const std::string strBackend = config::GetArg("-llpbackend", "poll");
+        if(strBackend == "poll")
+            return -1;
+
+    #if defined(__linux__)
+        if(strBackend == "epoll")
+        {
+            /* Create the epoll instance. */
+            int32_t nFile = epoll_create1(EPOLL_CLOEXEC);
+            if(nFile < 0)
+                debug::error(FUNCTION, "failed to create epoll instance: ", std::strerror(errno), ", falling back to poll");
+
+            return nFile;
+        }
+    #endif
+
+        debug::error(FUNCTION, "unsupported -llpbackend=", strBackend, ", falling back to poll");
+        return -1;
+    }
+
+
+    /* Registers a new connection's socket with the epoll backend, edge triggered. */
+    template <class ProtocolType>
+    void DataThread<ProtocolType>::add_event(const uint32_t nSlot)
+    {
+    #if defined(__linux__)
+        /* Check that the epoll backend is enabled. */
+        if(EPOLL_FD < 0)
+            return;
+
+        /* Skip connections that were dropped on connect. */
+        ProtocolType* CONNECTION = CONNECTIONS->at(nSlot).load();
+        if(!CONNECTION || !CONNECTION->Connected())
+            return;
+
+        /* Watch for reads and the peer closing, tagging the event with the socket and slot. */
+        epoll_event event;
+        event.events   = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        event.data.u64 = (static_cast<uint64_t>(static_cast<uint32_t>(CONNECTION->fd)) << 32) | nSlot;
+
+        /* Add the socket to the epoll instance. */
+        if(epoll_ctl(EPOLL_FD, EPOLL_CTL_ADD, CONNECTION->fd, &event) < 0)
+            debug::error(FUNCTION, "failed to watch socket: ", std::strerror(errno));
+
+        /* Have the data thread schedule the connection. */
+        EPOLL_PENDING.push_back(nSlot);
+    #endif
+    }
+
+
+    /* Opens the pipe that processor threads use to wake the data thread, when there is a processor pool. */
+    template <class ProtocolType>
+    std::pair<int32_t, int32_t> DataThread<ProtocolType>::open_wake()
+    {
+        std::pair<int32_t, int32_t> pairWake(-1, -1);
+
+    #ifndef WIN32
+        /* Check that packets are processed by the pool. */
+        if(!PROCESSOR)
+            return pairWake;
+
+        /* Create the pipe. */
+        int32_t nFiles[2];
+        if(pipe(nFiles) < 0)
+        {
+            debug::error(FUNCTION, "failed to open wake pipe: ", std::strerror(errno));
+            return pairWake;
+        }
+
+        /* Neither end should ever block. */
+        fcntl(nFiles[0], F_SETFL, fcntl(nFiles[0], F_GETFL) | O_NONBLOCK);
+        fcntl(nFiles[1], F_SETFL, fcntl(nFiles[1], F_GETFL) | O_NONBLOCK);
+
+        pairWake = std::make_pair(nFiles[0], nFiles[1]);
+    #endif
+
+        return pairWake;
+    }
+
+
+    /* Wakes the data thread to read a connection again once the processor pool has finished its packet. */
+    template <class ProtocolType>
+    void DataThread<ProtocolType>::wake(const uint32_t nIndex)
+    {
+        /* The epoll backend only reads connections with events, so tell it which one to read. */
+        if(EPOLL_FD >= 0)
+        {
+            LOCK(SLOT_MUTEX);
+            EPOLL_RESUME.push_back(nIndex);
+        }
+
+    #ifndef WIN32
+        /* Interrupt the wait, a full pipe means the data thread is already awake. */
+        if(WAKE_PIPE.second >= 0)
+        {
+            const uint8_t nWake = 1;
+            if(write(WAKE_PIPE.second, &nWake, 1) < 0)
+                return;
+        }
+    #endif
+    }
+
+
+    /* Checks a connection for errors, timeouts, stalled or overflowed buffers and DDOS scores. */
+    template <class ProtocolType>
+    bool DataThread<ProtocolType>::check_connection(const uint32_t nIndex, ProtocolType* CONNECTION)
+    {
+        /* Remove Connection if it has Timed out or had any read/write Errors. */
+        if(CONNECTION->Errors())
+        {
+            disconnect_remove_event(nIndex, DISCONNECT::ERRORS);
+            return false;
+        }
+
+        /* Remove Connection if it has Timed out or had any Errors. */
+        if(CONNECTION->Timeout(TIMEOUT * 1000, Socket::READ))
+        {
+            disconnect_remove_event(nIndex, DISCONNECT::TIMEOUT);
+            return false;
+        }
+
+        /* Disconnect if buffer is full and remote host isn't reading at all. */
+        if(CONNECTION->Buffered()
+        && CONNECTION->Timeout(15000, Socket::WRITE))
+        {
+            disconnect_remove_event(nIndex, DISCONNECT::TIMEOUT_WRITE);
+            return false;
+        }
+
+        /* Check that write buffers aren't overflowed. */
+        if(CONNECTION->Buffered() > config::GetArg("-maxsendbuffer", MAX_SEND_BUFFER))
+        {
+            disconnect_remove_event(nIndex, DISCONNECT::BUFFER);
+            return false;
+        }
+
+        /* Handle any DDOS Filters. */
+        if(fDDOS && CONNECTION->DDOS)
+        {
+            /* Ban a node if it has too many Requests per Second. **/
+            if(CONNECTION->DDOS->rSCORE.Score() > DDOS_rSCORE
+            || CONNECTION->DDOS->cSCORE.Score() > DDOS_cSCORE)
+                CONNECTION->DDOS->Ban();
+
+            /* Remove a connection if it was banned by DDOS Protection. */
+            if(CONNECTION->DDOS->Banned())
+            {
+                debug::log(0, "BANNED: ", CONNECTION->GetAddress().ToString());
+                disconnect_remove_event(nIndex, DISCONNECT::DDOS);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    /* Checks if a connection has a packet with the processor pool, and disconnects it once a failed packet is finished. */
+    template <class ProtocolType>
+    bool DataThread<ProtocolType>::pending_connection(const uint32_t nIndex, ProtocolType* CONNECTION)
+    {
+        /* The processor pool still has the connection. */
+        const uint8_t nFlags = CONNECTION->nProcessing.load();
+        if(nFlags & PROCESSING::BUSY)
+            return true;
+
+        /* Disconnect if the packet failed, or the connection was disconnected while it was processed. */
+        if(nFlags & PROCESSING::FAILED)
+        {
+            disconnect_remove_event(nIndex, DISCONNECT::FORCE);
+            return true;
+        }
+
+        return false;
+    }
+
+
+    /* Hands a connection's completed packet to the processor pool. */
+    template <class ProtocolType>
+    bool DataThread<ProtocolType>::dispatch_connection(const uint32_t nIndex, ProtocolType* CONNECTION)
+    {
+        /* The data thread leaves the connection alone until the flag is cleared. */
+        CONNECTION->nProcessing.fetch_or(PROCESSING::BUSY);
+
+        /* Process the packet on a worker. */
+        const bool fSubmitted = PROCESSOR->Submit([this, nIndex, CONNECTION]()
+        {
+            /* Packet Process return value of False will flag Data Thread to Disconnect. */
+            bool fProcessed = false;
+            try
+            {
+                fProcessed = process_connection(CONNECTION);
+            }
+            catch(const std::exception& e)
+            {
+                debug::error(FUNCTION, "Data Connection: ", e.what());
+            }
+
+            /* Hand the connection back to the data thread, which may free it from here on. */
+            if(!fProcessed)
+                CONNECTION->nProcessing.fetch_or(PROCESSING::FAILED);
+
+            CONNECTION->nProcessing.fetch_and(static_cast<uint8_t>(~PROCESSING::BUSY));
+            wake(nIndex);
+        });
+
+        /* Keep the packet on the data thread if the pool is stopped. */
+        if(!fSubmitted)
+            CONNECTION->nProcessing.fetch_and(static_cast<uint8_t>(~PROCESSING::BUSY));
+
+        return fSubmitted;
+    }
+
+
+    /* Reads from a connection and processes its packet once complete. */
+    template <class ProtocolType>
+    bool DataThread<ProtocolType>::read_connection(const uint32_t nIndex, ProtocolType* CONNECTION)
+    {
+        /* Work on Reading a Packet. **/
+        CONNECTION->ReadPacket();
+
+        /* If a Packet was received successfully, increment request count [and DDOS count if enabled]. */
+        if(CONNECTION->PacketComplete())
+        {
+            /* Debug dump of message type. */
+            if(config::nVerbose.load() >= 4)
+                debug::log(4, FUNCTION, "Received Message (", CONNECTION->INCOMING.GetBytes().size(), " bytes)");
+
+            /* Debug dump of packet data. */
+            if(config::nVerbose.load() >= 5)
+                PrintHex(CONNECTION->INCOMING.GetBytes());
+
+            /* Handle Meters and DDOS. */
+            if(fMETER)
+                ++ProtocolType::REQUESTS;
+
+            /* Increment rScore. */
+            if(fDDOS && CONNECTION->DDOS)
+                CONNECTION->DDOS->rSCORE += 1;
+
+            /* Hand the packet to the processor pool if there is one. */
+            if(PROCESSOR && dispatch_connection(nIndex, CONNECTION))
+                return true;
+
+            /* Packet Process return value of False will flag Data Thread to Disconnect. */
+            if(!process_connection(CONNECTION))
+            {
+                disconnect_remove_event(nIndex, DISCONNECT::FORCE);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+
+    /* Processes a connection's completed packet, recording it in the server metrics. */
+    template <class ProtocolType>
+    bool DataThread<ProtocolType>::process_connection(ProtocolType* CONNECTION)
+    {
+        /* Process the packet without metrics. */
+        if(!METRICS)
+        {
+            if(!CONNECTION->ProcessPacket())
+                return false;
+
+            /* Run procssed event for connection triggers. */
+            CONNECTION->Event(EVENTS::PROCESSED);
+            CONNECTION->ResetPacket();
+
+            return true;
+        }
+
+        /* Get the bytes read for the packet, and the bytes written before processing it. */
+        const uint64_t nRead    = CONNECTION->BytesRead();
+        const uint64_t nWritten = CONNECTION->BytesWritten();
+
+        const uint64_t nBytesIn = nRead - CONNECTION->nReadMark;
+        CONNECTION->nReadMark   = nRead;
+
+        /* Time the packet. */
+        runtime::timer timer;
+        timer.Start();
+
+        const bool fProcessed = CONNECTION->ProcessPacket();
+
+        /* Record the packet before it is reset. */
+        METRICS->Record(CONNECTION->MessageName(), nBytesIn,
+            CONNECTION->BytesWritten() - nWritten, timer.ElapsedMicroseconds());
+
+        if(!fProcessed)
+            return false;
+
+        /* Run procssed event for connection triggers. */
+        CONNECTION->Event(EVENTS::PROCESSED);
+        CONNECTION->ResetPacket();
+
+        return true;
+    }
+
+
     /* Explicity instantiate all template instances needed for compiler. */
     template class DataThread<TritiumNode>;
     template class DataThread<TimeNode>;
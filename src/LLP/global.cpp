@@ -13,6 +13,8 @@ ________________________________________________________________________________
 
 #include <LLC/include/random.h>
 
+#include <LLD/include/global.h>
+
 #include <LLP/include/global.h>
 #include <LLP/include/network.h>
 
@@ -68,6 +70,67 @@ namespace LLP
     }
 
 
+    /*  Get a snapshot of the metrics of each running server. */
+    std::vector<ServerMetrics> GetMetrics()
+    {
+        std::vector<ServerMetrics> vServers;
+
+        /* Add each server that is running. */
+        if(TRITIUM_SERVER)
+            vServers.push_back(TRITIUM_SERVER->GetMetrics());
+
+        if(TIME_SERVER)
+            vServers.push_back(TIME_SERVER->GetMetrics());
+
+        if(API_SERVER)
+            vServers.push_back(API_SERVER->GetMetrics());
+
+        if(RPC_SERVER)
+            vServers.push_back(RPC_SERVER->GetMetrics());
+
+        Server<Miner>* pMiningServer = MINING_SERVER.load();
+        if(pMiningServer)
+            vServers.push_back(pMiningServer->GetMetrics());
+
+        if(P2P_SERVER)
+            vServers.push_back(P2P_SERVER->GetMetrics());
+
+        return vServers;
+    }
+
+
+    /*  Get a snapshot of the caches of the databases that count their hits. */
+    std::vector<CacheMetrics> GetCacheMetrics()
+    {
+        std::vector<CacheMetrics> vCaches;
+
+        /* The register and ledger databases use the sharded cache. */
+        if(LLD::Register)
+        {
+            CacheMetrics cache;
+            cache.strName = LLD::Register->GetName();
+            cache.nHits   = LLD::Register->GetCache()->Hits();
+            cache.nMisses = LLD::Register->GetCache()->Misses();
+            cache.nBytes  = LLD::Register->GetCache()->Size();
+
+            vCaches.push_back(cache);
+        }
+
+        if(LLD::Ledger)
+        {
+            CacheMetrics cache;
+            cache.strName = LLD::Ledger->GetName();
+            cache.nHits   = LLD::Ledger->GetCache()->Hits();
+            cache.nMisses = LLD::Ledger->GetCache()->Misses();
+            cache.nBytes  = LLD::Ledger->GetCache()->Size();
+
+            vCaches.push_back(cache);
+        }
+
+        return vCaches;
+    }
+
+
     /*  Creates and returns the mining server. */
     Server<Miner>* CreateMiningServer()
     {
@@ -176,6 +239,9 @@ namespace LLP
         
         /* Max threads based on config */
         config.nMaxThreads = static_cast<uint16_t>(config::GetArg(std::string("-rpcthreads"), 4));
+
+        /* Processor threads for completed requests based on config */
+        config.nProcessThreads = static_cast<uint16_t>(config::GetArg(std::string("-rpcprocessthreads"), 4));
         
         /* 30s timeout */
         config.nTimeout = 30;
@@ -228,6 +294,9 @@ namespace LLP
         
         /* Max threads based on config */
         config.nMaxThreads = static_cast<uint16_t>(config::GetArg(std::string("-apithreads"), 10));
+
+        /* Processor threads for completed requests based on config */
+        config.nProcessThreads = static_cast<uint16_t>(config::GetArg(std::string("-apiprocessthreads"), 4));
         
         /* Timeout based on config, 30s default */
         config.nTimeout = static_cast<uint32_t>(config::GetArg(std::string("-apitimeout"), 30));
@@ -18,6 +18,38 @@ ________________________________________________________________________________
 
 #include <algorithm>
 
+/* Output adapter for the json serializer to append to a byte buffer. */
+namespace
+{
+    class json_buffer : public json::detail::output_adapter_protocol<char>
+    {
+        /* The buffer to append to. */
+        std::vector<uint8_t>& vBytes;
+
+    public:
+
+        /** Constructor **/
+        explicit json_buffer(std::vector<uint8_t>& vBytesIn)
+        : vBytes (vBytesIn)
+        {
+        }
+
+
+        /* Append a character. */
+        void write_character(char c) override
+        {
+            vBytes.push_back(static_cast<uint8_t>(c));
+        }
+
+
+        /* Append a run of characters. */
+        void write_characters(const char* s, std::size_t nLength) override
+        {
+            vBytes.insert(vBytes.end(), s, s + nLength);
+        }
+    };
+}
+
 namespace LLP
 {
 
@@ -25,6 +57,8 @@ namespace LLP
     HTTPNode::HTTPNode()
     : BaseConnection<HTTPPacket> ( )
     , vchBuffer                  ( )
+    , nBufferPos                 (0)
+    , fPartial                   (false)
     {
     }
 
@@ -33,6 +67,8 @@ namespace LLP
     HTTPNode::HTTPNode(const Socket &SOCKET_IN, DDOS_Filter* DDOS_IN, bool fDDOSIn)
     : BaseConnection<HTTPPacket> (SOCKET_IN, DDOS_IN, fDDOSIn)
     , vchBuffer                  ( )
+    , nBufferPos                 (0)
+    , fPartial                   (false)
     {
     }
 
@@ -41,6 +77,8 @@ namespace LLP
     HTTPNode::HTTPNode(DDOS_Filter* DDOS_IN, bool fDDOSIn)
     : BaseConnection<HTTPPacket> (DDOS_IN, fDDOSIn)
     , vchBuffer                  ( )
+    , nBufferPos                 (0)
+    , fPartial                   (false)
     {
     }
 
@@ -64,99 +102,117 @@ namespace LLP
     /*  Non-Blocking Packet reader to build a packet from TCP Connection. */
     void HTTPNode::ReadPacket()
     {
-        if(!INCOMING.Complete())
+        /* Wait for the last request to be processed, pipelined requests stay in the buffer. */
+        if(INCOMING.Complete())
+            return;
+
+        /* Drop the parsed requests from the front of the buffer once they are at least half of it. */
+        if(nBufferPos > 0 && nBufferPos >= vchBuffer.size() / 2)
         {
-            /* Handle Reading Data into Buffer. */
-            uint32_t nAvailable = Available();
-            if(nAvailable > 0)
-            {                
-                std::vector<int8_t> vchData(nAvailable);
-                int nRead = Read(vchData, nAvailable);
-                if(nRead > 0)
-                    vchBuffer.insert(vchBuffer.end(), vchData.begin(), vchData.begin() + nRead);
-            }
+            vchBuffer.erase(vchBuffer.begin(), vchBuffer.begin() + nBufferPos);
+            nBufferPos = 0;
+        }
+
+        /* Read the available data straight onto the end of the buffer. */
+        const int32_t nAvailable = Available();
+        if(nAvailable > 0)
+        {
+            const uint64_t nSize = vchBuffer.size();
+            vchBuffer.resize(nSize + nAvailable);
 
-            /* If waiting for buffer data, don't try to parse. */
-            if(vchBuffer.size() == 0)
+            /* Trim the buffer to the bytes that were read. */
+            const int32_t nRead = Read(&vchBuffer[nSize], nAvailable);
+            vchBuffer.resize(nSize + std::max(nRead, 0));
+        }
+
+        /* Parse the header a line at a time. */
+        while(!INCOMING.fHeader)
+        {
+            /* Break out the lines by the input buffer. */
+            auto itBegin = vchBuffer.begin() + nBufferPos;
+            auto itEnd   = std::find(itBegin, vchBuffer.end(), '\n');
+
+            /* Return if a full line hasn't been read yet. */
+            if(itEnd == vchBuffer.end())
+            {
+                fPartial = true;
                 return;
+            }
+
+            /* Move past the line, leaving off the carriage return. */
+            nBufferPos = (itEnd - vchBuffer.begin()) + 1;
+            if(itEnd != itBegin && *(itEnd - 1) == '\r')
+                --itEnd;
 
-            /* Allow up to 10 iterations to parse the header. */
-            for(int i = 0; i < 10; ++i)
+            /* Check for the end of header with an empty line. */
+            if(itBegin == itEnd)
             {
-                /* Read content if there is some. */
-                if(INCOMING.fHeader)
-                {
-                    INCOMING.strContent += std::string(vchBuffer.begin(), vchBuffer.end());
-                    vchBuffer.clear();
-                    return;
-                }
-
-                /* Break out the lines by the input buffer. */
-                auto it = std::find(vchBuffer.begin(), vchBuffer.end(), '\n');
-
-                /* Return if a full line hasn't been read yet. */
-                if(it == vchBuffer.end())
-                    return;
-
-                /* Check for the end of header with double CLRF. */
-                if(vchBuffer.begin() == (it - 1))
-                {
-                    INCOMING.fHeader = true;
-
-                    vchBuffer.erase(vchBuffer.begin(), it + 1); //erase the CLRF
-                    //this->Event()
-                    //TODO: assess the events code and calling virutal method from lower class in the inheritance heirarchy
-                }
-
-                /* Read all the headers. */
-                else if(!INCOMING.fHeader)
-                {
-                    /* Extract the line from the buffer. */
-                    std::string strLine = std::string(vchBuffer.begin(), it - 1);
-
-                    /* Dump the header if requested on read. */
-                    if(config::GetBoolArg("-httpheader"))
-                        debug::log(0, strLine);
-
-                    /* Find the delimiter to split. */
-                    std::string::size_type pos = strLine.find(':', 0);
-
-                    /* Handle the request types. */
-                    if(INCOMING.strType == "")
-                    {
-                        /* Find the end of request type. */
-                        std::string::size_type npos = strLine.find(' ', 0);
-                        INCOMING.strType = strLine.substr(0, npos);
-
-                        /* Find the start of version. */
-                        std::string::size_type npos2 = strLine.find(' ', npos + 1);
-                        INCOMING.strVersion = strLine.substr(npos2 + 1);
-
-                        /* Parse request from between the two. */
-                        INCOMING.strRequest = strLine.substr(npos + 1, npos2 - INCOMING.strType.length() - 1);
-
-                    }
-
-                    /* Handle normal headers. */
-                    else if(pos != std::string::npos)
-                    {
-                        /* Set the field value to lowercase. */
-                        std::string strField = ToLower(strLine.substr(0, pos));
-
-                        /* Parse out the content length field. */
-                        if(strField == "content-length")
-                            INCOMING.nContentLength = std::stoul(strLine.substr(pos + 2));
-
-                        /* Add line to the headers map. */
-                        INCOMING.mapHeaders[strField] = strLine.substr(pos + 2);
-
-                    }
-
-                    /* Erase line read from the read buffer. */
-                    vchBuffer.erase(vchBuffer.begin(), it + 1);
-                }
+                /* Skip empty lines between pipelined requests. */
+                if(INCOMING.strType == "")
+                    continue;
+
+                INCOMING.fHeader = true;
+                break;
+            }
+
+            /* Extract the line from the buffer. */
+            std::string strLine = std::string(itBegin, itEnd);
+
+            /* Dump the header if requested on read. */
+            if(config::GetBoolArg("-httpheader"))
+                debug::log(0, strLine);
+
+            /* Find the delimiter to split. */
+            std::string::size_type pos = strLine.find(':', 0);
+
+            /* Handle the request types. */
+            if(INCOMING.strType == "")
+            {
+                /* Find the end of request type. */
+                std::string::size_type npos = strLine.find(' ', 0);
+                INCOMING.strType = strLine.substr(0, npos);
+
+                /* Find the start of version. */
+                std::string::size_type npos2 = strLine.find(' ', npos + 1);
+                INCOMING.strVersion = strLine.substr(npos2 + 1);
+
+                /* Parse request from between the two. */
+                INCOMING.strRequest = strLine.substr(npos + 1, npos2 - INCOMING.strType.length() - 1);
+
+            }
+
+            /* Handle normal headers. */
+            else if(pos != std::string::npos)
+            {
+                /* Set the field value to lowercase. */
+                std::string strField = ToLower(strLine.substr(0, pos));
+
+                /* Parse out the content length field. */
+                if(strField == "content-length")
+                    INCOMING.nContentLength = std::stoul(strLine.substr(pos + 2));
+
+                /* Add line to the headers map. */
+                INCOMING.mapHeaders[strField] = strLine.substr(pos + 2);
+
             }
         }
+
+        /* Read the content up to its length, anything after it is the next request. */
+        const uint64_t nCopy = std::min(uint64_t(INCOMING.nContentLength - INCOMING.strContent.size()),
+                                        uint64_t(vchBuffer.size() - nBufferPos));
+
+        INCOMING.strContent.append(vchBuffer.begin() + nBufferPos, vchBuffer.begin() + nBufferPos + nCopy);
+        nBufferPos += nCopy;
+
+        /* The rest of the buffer is only part of a request until this one is complete. */
+        fPartial = !INCOMING.Complete();
+    }
+
+
+    /* Returns true if pipelined requests were read along with the last request. */
+    bool HTTPNode::PacketBuffered() const
+    {
+        return !fPartial && nBufferPos < vchBuffer.size();
     }
 
 
@@ -177,4 +233,17 @@ namespace LLP
         }
     }
 
+
+    /* Writes a response with json content, serialized straight into the buffer that is sent. */
+    void HTTPNode::WriteResponse(const HTTPPacket& RESPONSE, const json::json& jsonContent)
+    {
+        /* Serialize the content. */
+        std::shared_ptr<std::vector<uint8_t>> pContent = std::make_shared<std::vector<uint8_t>>();
+        json::detail::serializer<json::json> serializer(std::make_shared<json_buffer>(*pContent), ' ');
+        serializer.dump(jsonContent, false, false, 0);
+
+        /* Write the header and content together, without joining them. */
+        WriteShared(std::make_shared<const std::vector<uint8_t>>(RESPONSE.GetHeader(static_cast<uint32_t>(pContent->size()))), pContent);
+    }
+
 }
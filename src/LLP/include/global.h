@@ -55,6 +55,26 @@ namespace LLP
     void Shutdown();
 
 
+    /** GetMetrics
+     *
+     *  Get a snapshot of the metrics of each running server.
+     *
+     *  @return Returns the metrics of each server.
+     *
+     **/
+    std::vector<ServerMetrics> GetMetrics();
+
+
+    /** GetCacheMetrics
+     *
+     *  Get a snapshot of the caches of the databases that count their hits.
+     *
+     *  @return Returns the metrics of each database cache.
+     *
+     **/
+    std::vector<CacheMetrics> GetCacheMetrics();
+
+
     /** CreateMiningServer
      *
      *  Creates and returns the mining server.
@@ -159,6 +179,9 @@ namespace LLP
         /* The total data I/O threads. */
         config.nMaxThreads = static_cast<uint16_t>(config::GetArg(std::string("-threads"), 8));
 
+        /* The packet processor threads, shared by the data threads. */
+        config.nProcessThreads = static_cast<uint16_t>(config::GetArg(std::string("-processthreads"), 4));
+
         /* The timeout value (default: 30 seconds). */
         config.nTimeout = static_cast<uint32_t>(config::GetArg(std::string("-timeout"), 120));
 
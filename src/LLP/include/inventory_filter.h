@@ -0,0 +1,156 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLP_INCLUDE_INVENTORY_FILTER_H
+#define NEXUS_LLP_INCLUDE_INVENTORY_FILTER_H
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace LLP
+{
+
+    /** InventoryFilter
+     *
+     *  Rolling bloom filter of the inventory a peer is known to have, so items are not relayed
+     *  back to the peer that sent them, or sent to a peer twice.
+     *
+     *  Items are added to the current of two generations. Once it holds its capacity the older
+     *  generation is cleared and becomes the current one, so between one and two capacities of
+     *  the most recent items are remembered with a fixed amount of memory.
+     *
+     **/
+    class InventoryFilter
+    {
+        /** The number of bits set for each item. **/
+        static const uint32_t HASHES = 8;
+
+
+        /** The bits of the filters for each item. **/
+        static const uint32_t BITS_PER_ITEM = 16;
+
+
+        /** Mutex for thread safety, as the filter is used by the data and relay threads. **/
+        mutable std::mutex MUTEX;
+
+
+        /** The bits of the two generations. **/
+        std::vector<uint64_t> vFilters[2];
+
+
+        /** The index of the current generation. **/
+        uint32_t nCurrent;
+
+
+        /** The number of items added to the current generation. **/
+        uint32_t nItems;
+
+
+        /** The number of items each generation holds. **/
+        uint32_t nCapacity;
+
+
+        /** The mask of a bit position in a generation. **/
+        uint64_t nMask;
+
+
+        /** Random salt, so items can't be chosen to collide on every node. **/
+        uint64_t nSalt;
+
+
+    public:
+
+        /** Constructor
+         *
+         *  @param[in] nCapacityIn The number of items each generation holds.
+         *
+         **/
+        InventoryFilter(const uint32_t nCapacityIn);
+
+
+        /** Insert
+         *
+         *  Add an item to the filter.
+         *
+         *  @param[in] hash The hash of the item.
+         *
+         *  @return True if the item was new, false if it was already in the filter.
+         *
+         **/
+        template<typename HashType>
+        bool Insert(const HashType& hash)
+        {
+            return insert(hash.Get64(0), hash.Get64(1));
+        }
+
+
+        /** Has
+         *
+         *  Check if an item is in the filter.
+         *
+         *  @param[in] hash The hash of the item.
+         *
+         **/
+        template<typename HashType>
+        bool Has(const HashType& hash) const
+        {
+            return has(hash.Get64(0), hash.Get64(1));
+        }
+
+
+        /** Clear
+         *
+         *  Remove all items from the filter.
+         *
+         **/
+        void Clear();
+
+
+    private:
+
+        /** insert
+         *
+         *  Add an item to the filter by two words of its hash.
+         *
+         **/
+        bool insert(const uint64_t nHash0, const uint64_t nHash1);
+
+
+        /** has
+         *
+         *  Check if an item is in the filter by two words of its hash.
+         *
+         **/
+        bool has(const uint64_t nHash0, const uint64_t nHash1) const;
+
+
+        /** contains
+         *
+         *  Check if an item's bits are set in a generation.
+         *
+         **/
+        bool contains(const uint32_t nFilter, const uint64_t nBase, const uint64_t nStep) const;
+
+
+        /** positions
+         *
+         *  Get the start and step of an item's bit positions.
+         *
+         **/
+        void positions(const uint64_t nHash0, const uint64_t nHash1, uint64_t &nBase, uint64_t &nStep) const;
+    };
+}
+
+#endif
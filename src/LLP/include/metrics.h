@@ -0,0 +1,295 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLP_INCLUDE_METRICS_H
+#define NEXUS_LLP_INCLUDE_METRICS_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LLP
+{
+
+    /** Histogram
+     *
+     *  Log-linear histogram of processing times in microseconds. Each power of two is
+     *  split into eight buckets, so percentiles are within an eighth of the true value.
+     *
+     **/
+    class Histogram
+    {
+        /** The linear buckets in each power of two. **/
+        static const uint32_t SUB_BUCKETS = 8;
+
+
+        /** The total number of buckets, covering values up to 2^40. **/
+        static const uint32_t BUCKETS = (40 - 2) * SUB_BUCKETS;
+
+
+        /** The count of values in each bucket. **/
+        std::vector<uint64_t> vBuckets;
+
+
+        /** The number of values added. **/
+        uint64_t nCount;
+
+
+        /** The sum of the values added. **/
+        uint64_t nSum;
+
+
+    public:
+
+        /** Default Constructor **/
+        Histogram();
+
+
+        /** Add
+         *
+         *  Add a value to the histogram.
+         *
+         *  @param[in] nValue The value to add.
+         *
+         **/
+        void Add(const uint64_t nValue);
+
+
+        /** Percentile
+         *
+         *  Get the value below which the given fraction of values fall.
+         *
+         *  @param[in] dFraction The fraction between 0 and 1, such as 0.99.
+         *
+         *  @return The upper bound of the bucket holding the percentile, or zero if empty.
+         *
+         **/
+        uint64_t Percentile(const double dFraction) const;
+
+
+        /** Count
+         *
+         *  Get the number of values added.
+         *
+         **/
+        uint64_t Count() const;
+
+
+        /** Sum
+         *
+         *  Get the sum of the values added.
+         *
+         **/
+        uint64_t Sum() const;
+
+
+    private:
+
+        /** bucket
+         *
+         *  Get the bucket for a value.
+         *
+         *  @param[in] nValue The value to find the bucket of.
+         *
+         **/
+        static uint32_t bucket(const uint64_t nValue);
+
+
+        /** upper
+         *
+         *  Get the largest value that falls in a bucket.
+         *
+         *  @param[in] nBucket The bucket index.
+         *
+         **/
+        static uint64_t upper(const uint32_t nBucket);
+    };
+
+
+    /** MessageMetrics
+     *
+     *  The totals for one type of message handled by a server.
+     *
+     **/
+    struct MessageMetrics
+    {
+        /** The number of messages processed. **/
+        uint64_t nCount;
+
+
+        /** The bytes read for the messages. **/
+        uint64_t nBytesIn;
+
+
+        /** The bytes written while processing the messages. **/
+        uint64_t nBytesOut;
+
+
+        /** The processing times in microseconds. **/
+        Histogram histTime;
+
+
+        /** Default Constructor **/
+        MessageMetrics();
+    };
+
+
+    /** ServerMetrics
+     *
+     *  A snapshot of the metrics of one server.
+     *
+     **/
+    struct ServerMetrics
+    {
+        /** The name of the server's protocol. **/
+        std::string strName;
+
+
+        /** The number of connections. **/
+        uint32_t nConnections;
+
+
+        /** The messages waiting in the relay queues of the data threads. **/
+        uint64_t nRelayQueue;
+
+
+        /** The packets waiting for the processor pool. **/
+        uint64_t nProcessQueue;
+
+
+        /** The total bytes waiting in the send buffers. **/
+        uint64_t nBuffered;
+
+
+        /** The send buffer of each connection with bytes waiting, by address. **/
+        std::vector<std::pair<std::string, uint64_t>> vBuffers;
+
+
+        /** The inventory items relayed to connections. **/
+        uint64_t nRelayed;
+
+
+        /** The inventory items not relayed as the connection was known to have them. **/
+        uint64_t nRelayFiltered;
+
+
+        /** The metrics of each message type. **/
+        std::map<std::string, MessageMetrics> mapMessages;
+
+
+        /** Default Constructor **/
+        ServerMetrics();
+    };
+
+
+    /** CacheMetrics
+     *
+     *  A snapshot of the cache of one database.
+     *
+     **/
+    struct CacheMetrics
+    {
+        /** The name of the database. **/
+        std::string strName;
+
+
+        /** The reads that were found in the cache. **/
+        uint64_t nHits;
+
+
+        /** The reads that were not found in the cache. **/
+        uint64_t nMisses;
+
+
+        /** The bytes held by the cache. **/
+        uint64_t nBytes;
+
+
+        /** Default Constructor **/
+        CacheMetrics();
+    };
+
+
+    /** Metrics
+     *
+     *  Collects the count, bytes and processing times of each message type handled by a server.
+     *
+     **/
+    class Metrics
+    {
+        /** The most message types kept, as names can come from remote requests. Others are counted as other. **/
+        static const uint32_t MAX_MESSAGES = 256;
+
+
+        /** Mutex for thread safety. **/
+        mutable std::mutex MUTEX;
+
+
+        /** The metrics of each message type. **/
+        std::map<std::string, MessageMetrics> mapMessages;
+
+
+    public:
+
+        /** Default Constructor **/
+        Metrics();
+
+
+        /** Record
+         *
+         *  Record a processed message.
+         *
+         *  @param[in] strMessage The name of the message type.
+         *  @param[in] nBytesIn The bytes read for the message.
+         *  @param[in] nBytesOut The bytes written while processing the message.
+         *  @param[in] nTime The processing time in microseconds.
+         *
+         **/
+        void Record(const std::string& strMessage, const uint64_t nBytesIn, const uint64_t nBytesOut, const uint64_t nTime);
+
+
+        /** Messages
+         *
+         *  Get a copy of the metrics of each message type.
+         *
+         **/
+        std::map<std::string, MessageMetrics> Messages() const;
+
+
+        /** Clear
+         *
+         *  Reset the metrics.
+         *
+         **/
+        void Clear();
+    };
+
+
+    /** Prometheus
+     *
+     *  Format server metrics in the Prometheus text exposition format.
+     *
+     *  @param[in] vServers The metrics of each server.
+     *  @param[in] vCaches The metrics of each database cache.
+     *
+     *  @return The metrics as text.
+     *
+     **/
+    std::string Prometheus(const std::vector<ServerMetrics>& vServers,
+                           const std::vector<CacheMetrics>& vCaches = std::vector<CacheMetrics>());
+}
+
+#endif
@@ -0,0 +1,170 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLP_INCLUDE_PROCESSOR_H
+#define NEXUS_LLP_INCLUDE_PROCESSOR_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LLP
+{
+
+    /** ProcessorPool
+     *
+     *  Work stealing thread pool that data threads hand completed packets to, so that
+     *  a slow packet only holds up its own connection and not every socket of the data thread.
+     *
+     *  Each worker has its own queue, and takes work from the back of another worker's
+     *  queue when its own is empty. Tasks have no ordering between them, so a data thread
+     *  hands over one packet per connection at a time to keep each connection in order.
+     *
+     **/
+    class ProcessorPool
+    {
+        /** The queue of tasks for a worker. **/
+        struct Worker
+        {
+            /** Mutex for thread safety. **/
+            std::mutex MUTEX;
+
+            /** The tasks waiting for the worker. **/
+            std::deque<std::function<void()>> queueTasks;
+        };
+
+
+        /** Mutex for the sleeping workers. **/
+        std::mutex CONDITION_MUTEX;
+
+
+        /** The condition for workers waiting for tasks. **/
+        std::condition_variable CONDITION;
+
+
+        /** The queues of each worker. **/
+        std::vector<Worker*> vWorkers;
+
+
+        /** The worker threads. **/
+        std::vector<std::thread> vThreads;
+
+
+        /** The tasks submitted and not yet taken by a worker. **/
+        std::atomic<uint32_t> nPending;
+
+
+        /** The worker the next task is submitted to. **/
+        std::atomic<uint32_t> nNext;
+
+
+        /** The tasks taken from the queue of another worker. **/
+        std::atomic<uint64_t> nStolen;
+
+
+        /** Flag to stop the workers. **/
+        std::atomic<bool> fStop;
+
+
+    public:
+
+        /** Constructor
+         *
+         *  @param[in] nThreads The number of worker threads.
+         *
+         **/
+        ProcessorPool(const uint32_t nThreads);
+
+
+        /** Default Destructor **/
+        ~ProcessorPool();
+
+
+        /** Submit
+         *
+         *  Add a task for the workers, spreading tasks between the queues in turn.
+         *
+         *  @param[in] task The task to run.
+         *
+         *  @return False if the pool is stopped, in which case the task is not run.
+         *
+         **/
+        bool Submit(const std::function<void()>& task);
+
+
+        /** Stop
+         *
+         *  Stop the workers once they finish their current task, dropping any queued tasks.
+         *
+         **/
+        void Stop();
+
+
+        /** Size
+         *
+         *  Get the number of worker threads.
+         *
+         **/
+        uint32_t Size() const;
+
+
+        /** Pending
+         *
+         *  Get the number of tasks waiting for a worker.
+         *
+         **/
+        uint32_t Pending() const;
+
+
+        /** Stolen
+         *
+         *  Get the number of tasks taken from the queue of another worker.
+         *
+         **/
+        uint64_t Stolen() const;
+
+
+    private:
+
+        /** Thread
+         *
+         *  The worker thread, running tasks from its own queue or stolen from others.
+         *
+         *  @param[in] nID The index of the worker.
+         *
+         **/
+        void Thread(const uint32_t nID);
+
+
+        /** take
+         *
+         *  Take a task from the front of the worker's own queue, or the back of another worker's queue.
+         *
+         *  @param[in] nID The index of the worker.
+         *  @param[out] task The task that was taken.
+         *
+         *  @return True if a task was taken.
+         *
+         **/
+        bool take(const uint32_t nID, std::function<void()>& task);
+
+    };
+}
+
+#endif
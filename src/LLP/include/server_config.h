@@ -60,6 +60,14 @@ namespace LLP
 
         /** Max number of data threads this server should use **/
         uint16_t nMaxThreads;
+
+
+        /** Number of processor threads that handle completed packets, or 0 to process them on the data threads **/
+        uint16_t nProcessThreads;
+
+
+        /** Flag to determine if the server collects metrics for each message type **/
+        bool fMetrics;
         
 
         /** The timeout to set on new socket connections **/
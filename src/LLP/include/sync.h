@@ -0,0 +1,409 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_LLP_INCLUDE_SYNC_H
+#define NEXUS_LLP_INCLUDE_SYNC_H
+
+#include <LLC/types/uint1024.h>
+
+#include <TAO/Ledger/types/syncblock.h>
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LLP
+{
+
+    /** SyncRequest
+     *
+     *  A request for a node to send a list of block hashes or a range of sync blocks.
+     *
+     **/
+    struct SyncRequest
+    {
+        /** The session of the node to send the request to. **/
+        uint64_t nSession;
+
+
+        /** The block to list from (exclusive), or zero to list from a locator of the best chain. **/
+        uint1024_t hashStart;
+
+
+        /** The last block of the range (inclusive), or zero to list to the end of the chain. **/
+        uint1024_t hashStop;
+
+
+        /** True if the request is for block hashes rather than blocks. **/
+        bool fHeaders;
+    };
+
+
+    /** SyncManager
+     *
+     *  Downloads the chain from more than one node at a time. The block hashes are
+     *  listed by the sync node first, and are split into ranges that are assigned to
+     *  the nodes that have them. Blocks are held in a reorder buffer until their
+     *  previous block is processed, so they reach TAO::Ledger::Process in chain order.
+     *
+     *  A range that makes no progress within the stall timeout is given to another
+     *  node, and a node that stalls too often is not given any more ranges. The block
+     *  hashes are listed by another node if the sync node stalls or stops short of the
+     *  height reported by the other nodes.
+     *
+     **/
+    class SyncManager
+    {
+        /** A range of blocks assigned to a node. **/
+        struct SyncRange
+        {
+            /** The block before the range. **/
+            uint1024_t hashStart;
+
+            /** The last block of the range. **/
+            uint1024_t hashStop;
+
+            /** The last block received for the range. **/
+            uint1024_t hashLast;
+
+            /** The height of the last block of the range. **/
+            uint32_t nHeightStop;
+
+            /** The number of blocks still to be received. **/
+            uint32_t nRemaining;
+
+            /** The session the range is assigned to. **/
+            uint64_t nSession;
+
+            /** The time the range last made progress. **/
+            uint64_t nLastTime;
+        };
+
+
+        /** The sync state of a node. **/
+        struct SyncPeer
+        {
+            /** The best height reported by the node. **/
+            uint32_t nHeight;
+
+            /** The number of ranges assigned to the node. **/
+            uint32_t nRanges;
+
+            /** The blocks received from the node since the last report. **/
+            uint32_t nBlocks;
+
+            /** The number of ranges the node has stalled on. **/
+            uint32_t nStalls;
+
+            /** The requests waiting to be sent by the node. **/
+            std::vector<SyncRequest> vPending;
+        };
+
+
+        /** A block waiting for its previous block. **/
+        struct SyncEntry
+        {
+            /** The session that sent the block. **/
+            uint64_t nSession;
+
+            /** The hash of the block. **/
+            uint1024_t hashBlock;
+
+            /** The block. **/
+            TAO::Ledger::SyncBlock block;
+        };
+
+
+        /** Mutex for thread safety. **/
+        mutable std::mutex MUTEX;
+
+
+        /** True while a sync is running. **/
+        bool fActive;
+
+
+        /** True while a thread is processing the reorder buffer. **/
+        bool fProcessing;
+
+
+        /** True when the sync node has no more block hashes. **/
+        bool fHeadersDone;
+
+
+        /** The session of the node listing the block hashes. **/
+        uint64_t nHeaderSession;
+
+
+        /** The time the outstanding request for block hashes was sent, or zero. **/
+        uint64_t nHeadersTime;
+
+
+        /** The last block hash listed, and its height. **/
+        uint1024_t hashHeaders;
+        uint32_t nHeaderHeight;
+
+
+        /** The last block processed, and its height. **/
+        uint1024_t hashTip;
+        uint32_t nTipHeight;
+
+
+        /** The ranges waiting for a node, in chain order. **/
+        std::deque<SyncRange> queueRanges;
+
+
+        /** The ranges assigned to nodes. **/
+        std::vector<SyncRange> vAssigned;
+
+
+        /** The nodes taking part in the sync, by session. **/
+        std::map<uint64_t, SyncPeer> mapPeers;
+
+
+        /** The reorder buffer, by previous block hash. **/
+        std::map<uint1024_t, SyncEntry> mapBuffer;
+
+
+        /** The number of blocks in a range. **/
+        uint32_t nRangeSize;
+
+
+        /** The most blocks to have buffered or assigned at once. **/
+        uint32_t nMaxBuffer;
+
+
+        /** The seconds a range can go without progress before it is reassigned. **/
+        uint64_t nStallTimeout;
+
+
+    public:
+
+        /** The most ranges assigned to a node at once. **/
+        static const uint32_t MAX_RANGES = 2;
+
+
+        /** The stalls after which a node isn't given any more ranges. **/
+        static const uint32_t MAX_STALLS = 3;
+
+
+        /** Default Constructor **/
+        SyncManager();
+
+
+        /** Default Destructor **/
+        ~SyncManager();
+
+
+        /** Start
+         *
+         *  Start a sync, listing block hashes from the given node. Nodes already added are kept.
+         *
+         *  @param[in] nSession The session of the sync node.
+         *
+         **/
+        void Start(const uint64_t nSession);
+
+
+        /** Stop
+         *
+         *  Stop the sync, and release the buffered blocks and the nodes.
+         *
+         **/
+        void Stop();
+
+
+        /** Active
+         *
+         *  Check if a sync is running.
+         *
+         **/
+        bool Active() const;
+
+
+        /** AddPeer
+         *
+         *  Add a node that ranges can be assigned to.
+         *
+         *  @param[in] nSession The session of the node.
+         *
+         **/
+        void AddPeer(const uint64_t nSession);
+
+
+        /** RemovePeer
+         *
+         *  Remove a node, returning its ranges to the queue. If the node was listing
+         *  the block hashes, another node takes over.
+         *
+         *  @param[in] nSession The session of the node.
+         *
+         *  @return The session of the node listing the block hashes, or zero if there is none.
+         *
+         **/
+        uint64_t RemovePeer(const uint64_t nSession);
+
+
+        /** HasPeer
+         *
+         *  Check if a node is taking part in the sync.
+         *
+         *  @param[in] nSession The session of the node.
+         *
+         **/
+        bool HasPeer(const uint64_t nSession) const;
+
+
+        /** SetHeight
+         *
+         *  Set the best height reported by a node.
+         *
+         *  @param[in] nSession The session of the node.
+         *  @param[in] nHeight The height of the node's best chain.
+         *
+         **/
+        void SetHeight(const uint64_t nSession, const uint32_t nHeight);
+
+
+        /** Headers
+         *
+         *  Add block hashes listed by the sync node, split into ranges.
+         *
+         *  @param[in] nSession The session that listed the hashes.
+         *  @param[in] hashStart The block before the first hash.
+         *  @param[in] nHeight The height of the block before the first hash.
+         *  @param[in] vHashes The block hashes in chain order, empty at the end of the chain.
+         *
+         *  @return False if the hashes weren't requested.
+         *
+         **/
+        bool Headers(const uint64_t nSession, const uint1024_t& hashStart, const uint32_t nHeight,
+                     const std::vector<uint1024_t>& vHashes);
+
+
+        /** Requests
+         *
+         *  Reassign stalled ranges, assign the queued ranges, and get the requests a node needs to send.
+         *
+         *  @param[in] nSession The session of the node.
+         *  @param[in] nTimestamp The current time in seconds.
+         *
+         *  @return The requests for the node to send.
+         *
+         **/
+        std::vector<SyncRequest> Requests(const uint64_t nSession, const uint64_t nTimestamp);
+
+
+        /** Receive
+         *
+         *  Add a block received from a node to the reorder buffer.
+         *
+         *  @param[in] nSession The session that sent the block.
+         *  @param[in] block The block that was received.
+         *  @param[in] nTimestamp The current time in seconds.
+         *
+         *  @return False if the block is not the next block of a range assigned to the node.
+         *
+         **/
+        bool Receive(const uint64_t nSession, const TAO::Ledger::SyncBlock& block, const uint64_t nTimestamp);
+
+
+        /** Process
+         *
+         *  Process the buffered blocks that follow the last processed block.
+         *
+         *  @return The number of blocks accepted.
+         *
+         **/
+        uint32_t Process();
+
+
+        /** Complete
+         *
+         *  Check if every listed block has been processed.
+         *
+         **/
+        bool Complete() const;
+
+
+        /** Target
+         *
+         *  Get the height of the last block hash listed by the sync node.
+         *
+         **/
+        uint32_t Target() const;
+
+
+        /** BestHeight
+         *
+         *  Get the best height reported by the nodes, or the last height listed if that is higher.
+         *
+         **/
+        uint32_t BestHeight() const;
+
+
+        /** Utilization
+         *
+         *  Get the share of blocks received from each node since the last call.
+         *
+         *  @return A string for the sync log.
+         *
+         **/
+        std::string Utilization();
+
+
+    private:
+
+        /** schedule
+         *
+         *  Reassign stalled ranges and assign the queued ranges. Must be called with MUTEX held.
+         *
+         *  @param[in] nTimestamp The current time in seconds.
+         *
+         **/
+        void schedule(const uint64_t nTimestamp);
+
+
+        /** requeue
+         *
+         *  Return a range to the queue in chain order, from its last received block.
+         *
+         *  @param[in] range The range to return.
+         *
+         **/
+        void requeue(const SyncRange& range);
+
+
+        /** restart
+         *
+         *  Drop the ranges and buffered blocks, and list the block hashes again from the last processed block.
+         *
+         **/
+        void restart();
+
+
+        /** rotate
+         *
+         *  List the block hashes from the node that has stalled the least, other than the sync node.
+         *  The sync node is kept if there is no other node. Must be called with MUTEX held.
+         *
+         **/
+        void rotate();
+
+    };
+}
+
+#endif
@@ -0,0 +1,143 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLP/include/inventory_filter.h>
+
+#include <LLC/include/random.h>
+
+#include <Util/include/mutex.h>
+
+#include <algorithm>
+
+namespace LLP
+{
+
+    /* Mix the bits of a word, so every bit of the input affects every bit of the output. */
+    static uint64_t inventory_mix(uint64_t nValue)
+    {
+        nValue ^= nValue >> 33;
+        nValue *= 0xff51afd7ed558ccdULL;
+        nValue ^= nValue >> 33;
+        nValue *= 0xc4ceb9fe1a85ec53ULL;
+        nValue ^= nValue >> 33;
+
+        return nValue;
+    }
+
+
+    /* Constructor */
+    InventoryFilter::InventoryFilter(const uint32_t nCapacityIn)
+    : MUTEX     ( )
+    , vFilters  ( )
+    , nCurrent  (0)
+    , nItems    (0)
+    , nCapacity (std::max(nCapacityIn, 1u))
+    , nMask     (0)
+    , nSalt     (LLC::GetRand())
+    {
+        /* Round the bits of each generation up to a power of two, so positions are masked. */
+        uint64_t nBits = 64;
+        while(nBits < uint64_t(nCapacity) * BITS_PER_ITEM)
+            nBits <<= 1;
+
+        nMask = nBits - 1;
+
+        vFilters[0].assign(nBits / 64, 0);
+        vFilters[1].assign(nBits / 64, 0);
+    }
+
+
+    /* Remove all items from the filter. */
+    void InventoryFilter::Clear()
+    {
+        LOCK(MUTEX);
+
+        std::fill(vFilters[0].begin(), vFilters[0].end(), 0);
+        std::fill(vFilters[1].begin(), vFilters[1].end(), 0);
+
+        nItems = 0;
+    }
+
+
+    /* Add an item to the filter by two words of its hash. */
+    bool InventoryFilter::insert(const uint64_t nHash0, const uint64_t nHash1)
+    {
+        uint64_t nBase = 0, nStep = 0;
+        positions(nHash0, nHash1, nBase, nStep);
+
+        LOCK(MUTEX);
+
+        /* Check the current generation. */
+        if(contains(nCurrent, nBase, nStep))
+            return false;
+
+        /* Items only in the older generation are added again below, so they are kept for another generation. */
+        const bool fNew = !contains(nCurrent ^ 1, nBase, nStep);
+
+        /* Start a new generation once the current one is full, dropping the oldest items. */
+        if(nItems >= nCapacity)
+        {
+            nCurrent ^= 1;
+            nItems    = 0;
+
+            std::fill(vFilters[nCurrent].begin(), vFilters[nCurrent].end(), 0);
+        }
+
+        /* Set the item's bits. */
+        std::vector<uint64_t>& vFilter = vFilters[nCurrent];
+        for(uint32_t n = 0; n < HASHES; ++n)
+        {
+            const uint64_t nBit = (nBase + n * nStep) & nMask;
+            vFilter[nBit >> 6] |= (uint64_t(1) << (nBit & 63));
+        }
+
+        ++nItems;
+
+        return fNew;
+    }
+
+
+    /* Check if an item is in the filter by two words of its hash. */
+    bool InventoryFilter::has(const uint64_t nHash0, const uint64_t nHash1) const
+    {
+        uint64_t nBase = 0, nStep = 0;
+        positions(nHash0, nHash1, nBase, nStep);
+
+        LOCK(MUTEX);
+        return contains(0, nBase, nStep) || contains(1, nBase, nStep);
+    }
+
+
+    /* Check if an item's bits are set in a generation. */
+    bool InventoryFilter::contains(const uint32_t nFilter, const uint64_t nBase, const uint64_t nStep) const
+    {
+        const std::vector<uint64_t>& vFilter = vFilters[nFilter];
+        for(uint32_t n = 0; n < HASHES; ++n)
+        {
+            const uint64_t nBit = (nBase + n * nStep) & nMask;
+            if(!(vFilter[nBit >> 6] & (uint64_t(1) << (nBit & 63))))
+                return false;
+        }
+
+        return true;
+    }
+
+
+    /* Get the start and step of an item's bit positions. */
+    void InventoryFilter::positions(const uint64_t nHash0, const uint64_t nHash1, uint64_t &nBase, uint64_t &nStep) const
+    {
+        /* Double hashing, with an odd step so the positions don't repeat. */
+        nBase = inventory_mix(nHash0 ^ nSalt);
+        nStep = inventory_mix(nHash1 + nSalt) | 1;
+    }
+}
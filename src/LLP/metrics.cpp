@@ -0,0 +1,328 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLP/include/metrics.h>
+
+#include <Util/include/mutex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace LLP
+{
+
+    /* Escape a Prometheus label value. */
+    static std::string prometheus_label(const std::string& strValue)
+    {
+        std::string strRet;
+        strRet.reserve(strValue.size());
+
+        for(const char& c : strValue)
+        {
+            /* Backslashes, quotes and newlines are escaped. */
+            if(c == '\\' || c == '"')
+                strRet.push_back('\\');
+
+            if(c == '\n')
+            {
+                strRet += "\\n";
+                continue;
+            }
+
+            strRet.push_back(c);
+        }
+
+        return strRet;
+    }
+
+
+    /* Default Constructor */
+    Histogram::Histogram()
+    : vBuckets (BUCKETS, 0)
+    , nCount   (0)
+    , nSum     (0)
+    {
+    }
+
+
+    /* Add a value to the histogram. */
+    void Histogram::Add(const uint64_t nValue)
+    {
+        ++vBuckets[bucket(nValue)];
+
+        ++nCount;
+        nSum += nValue;
+    }
+
+
+    /* Get the value below which the given fraction of values fall. */
+    uint64_t Histogram::Percentile(const double dFraction) const
+    {
+        /* Check for an empty histogram. */
+        if(nCount == 0)
+            return 0;
+
+        /* Get the rank of the percentile, counting from one. */
+        uint64_t nRank = static_cast<uint64_t>(std::ceil(dFraction * nCount));
+        if(nRank == 0)
+            nRank = 1;
+
+        /* Find the bucket that holds the rank. */
+        uint64_t nTotal = 0;
+        for(uint32_t nBucket = 0; nBucket < BUCKETS; ++nBucket)
+        {
+            nTotal += vBuckets[nBucket];
+            if(nTotal >= nRank)
+                return upper(nBucket);
+        }
+
+        return upper(BUCKETS - 1);
+    }
+
+
+    /* Get the number of values added. */
+    uint64_t Histogram::Count() const
+    {
+        return nCount;
+    }
+
+
+    /* Get the sum of the values added. */
+    uint64_t Histogram::Sum() const
+    {
+        return nSum;
+    }
+
+
+    /* Get the bucket for a value. */
+    uint32_t Histogram::bucket(const uint64_t nValue)
+    {
+        /* The first two powers of two are counted exactly. */
+        if(nValue < 2 * SUB_BUCKETS)
+            return static_cast<uint32_t>(nValue);
+
+        /* Find the highest bit. */
+        uint32_t nBits = 0;
+        for(uint64_t nShift = nValue; nShift > 1; nShift >>= 1)
+            ++nBits;
+
+        /* Split each power of two by the three bits after the highest one. */
+        const uint32_t nSub    = static_cast<uint32_t>(nValue >> (nBits - 3)) & (SUB_BUCKETS - 1);
+        const uint32_t nBucket = 2 * SUB_BUCKETS + (nBits - 4) * SUB_BUCKETS + nSub;
+
+        return std::min(nBucket, BUCKETS - 1);
+    }
+
+
+    /* Get the largest value that falls in a bucket. */
+    uint64_t Histogram::upper(const uint32_t nBucket)
+    {
+        /* The first two powers of two are counted exactly. */
+        if(nBucket < 2 * SUB_BUCKETS)
+            return nBucket;
+
+        /* Get the power of two and the width of its buckets. */
+        const uint32_t nBits  = (nBucket - 2 * SUB_BUCKETS) / SUB_BUCKETS + 4;
+        const uint64_t nWidth = uint64_t(1) << (nBits - 3);
+
+        return (uint64_t(1) << nBits) + ((nBucket - 2 * SUB_BUCKETS) % SUB_BUCKETS + 1) * nWidth - 1;
+    }
+
+
+    /* Default Constructor */
+    MessageMetrics::MessageMetrics()
+    : nCount    (0)
+    , nBytesIn  (0)
+    , nBytesOut (0)
+    , histTime  ( )
+    {
+    }
+
+
+    /* Default Constructor */
+    ServerMetrics::ServerMetrics()
+    : strName       ( )
+    , nConnections  (0)
+    , nRelayQueue   (0)
+    , nProcessQueue (0)
+    , nBuffered     (0)
+    , vBuffers      ( )
+    , nRelayed      (0)
+    , nRelayFiltered(0)
+    , mapMessages   ( )
+    {
+    }
+
+
+    /* Default Constructor */
+    CacheMetrics::CacheMetrics()
+    : strName ( )
+    , nHits   (0)
+    , nMisses (0)
+    , nBytes  (0)
+    {
+    }
+
+
+    /* Default Constructor */
+    Metrics::Metrics()
+    : MUTEX       ( )
+    , mapMessages ( )
+    {
+    }
+
+
+    /* Record a processed message. */
+    void Metrics::Record(const std::string& strMessage, const uint64_t nBytesIn, const uint64_t nBytesOut, const uint64_t nTime)
+    {
+        LOCK(MUTEX);
+
+        /* Count new message types as other once the limit is reached. */
+        auto it = mapMessages.find(strMessage);
+        if(it == mapMessages.end())
+            it = mapMessages.emplace(mapMessages.size() < MAX_MESSAGES ? strMessage : "other", MessageMetrics()).first;
+
+        /* Update the totals for the message type. */
+        MessageMetrics& metrics = it->second;
+        ++metrics.nCount;
+        metrics.nBytesIn  += nBytesIn;
+        metrics.nBytesOut += nBytesOut;
+        metrics.histTime.Add(nTime);
+    }
+
+
+    /* Get a copy of the metrics of each message type. */
+    std::map<std::string, MessageMetrics> Metrics::Messages() const
+    {
+        LOCK(MUTEX);
+        return mapMessages;
+    }
+
+
+    /* Reset the metrics. */
+    void Metrics::Clear()
+    {
+        LOCK(MUTEX);
+        mapMessages.clear();
+    }
+
+
+    /* Format server metrics in the Prometheus text exposition format. */
+    std::string Prometheus(const std::vector<ServerMetrics>& vServers, const std::vector<CacheMetrics>& vCaches)
+    {
+        std::ostringstream ssRet;
+
+        /* The server gauges. */
+        ssRet << "# HELP nexus_llp_connections Connections to the server.\n";
+        ssRet << "# TYPE nexus_llp_connections gauge\n";
+        for(const auto& server : vServers)
+            ssRet << "nexus_llp_connections{server=\"" << prometheus_label(server.strName) << "\"} " << server.nConnections << "\n";
+
+        ssRet << "# HELP nexus_llp_relay_queue Messages waiting in the relay queues.\n";
+        ssRet << "# TYPE nexus_llp_relay_queue gauge\n";
+        for(const auto& server : vServers)
+            ssRet << "nexus_llp_relay_queue{server=\"" << prometheus_label(server.strName) << "\"} " << server.nRelayQueue << "\n";
+
+        ssRet << "# HELP nexus_llp_process_queue Packets waiting for the processor pool.\n";
+        ssRet << "# TYPE nexus_llp_process_queue gauge\n";
+        for(const auto& server : vServers)
+            ssRet << "nexus_llp_process_queue{server=\"" << prometheus_label(server.strName) << "\"} " << server.nProcessQueue << "\n";
+
+        ssRet << "# HELP nexus_llp_send_buffer_bytes Bytes waiting in the send buffers.\n";
+        ssRet << "# TYPE nexus_llp_send_buffer_bytes gauge\n";
+        for(const auto& server : vServers)
+            ssRet << "nexus_llp_send_buffer_bytes{server=\"" << prometheus_label(server.strName) << "\"} " << server.nBuffered << "\n";
+
+        /* The largest send buffer, as a label per connection would be unbounded. */
+        ssRet << "# HELP nexus_llp_send_buffer_max_bytes Bytes waiting in the largest send buffer.\n";
+        ssRet << "# TYPE nexus_llp_send_buffer_max_bytes gauge\n";
+        for(const auto& server : vServers)
+        {
+            uint64_t nMax = 0;
+            for(const auto& buffer : server.vBuffers)
+                nMax = std::max(nMax, buffer.second);
+
+            ssRet << "nexus_llp_send_buffer_max_bytes{server=\"" << prometheus_label(server.strName) << "\"} " << nMax << "\n";
+        }
+
+        /* The inventory relay counters, the filtered share is the relays saved by knowing what peers have. */
+        ssRet << "# HELP nexus_llp_relay_inventory_total Inventory items relayed to connections by result.\n";
+        ssRet << "# TYPE nexus_llp_relay_inventory_total counter\n";
+        for(const auto& server : vServers)
+        {
+            ssRet << "nexus_llp_relay_inventory_total{server=\"" << prometheus_label(server.strName) << "\",result=\"sent\"} " << server.nRelayed << "\n";
+            ssRet << "nexus_llp_relay_inventory_total{server=\"" << prometheus_label(server.strName) << "\",result=\"filtered\"} " << server.nRelayFiltered << "\n";
+        }
+
+        /* The message counters. */
+        ssRet << "# HELP nexus_llp_messages_total Messages processed by type.\n";
+        ssRet << "# TYPE nexus_llp_messages_total counter\n";
+        for(const auto& server : vServers)
+            for(const auto& message : server.mapMessages)
+                ssRet << "nexus_llp_messages_total{server=\"" << prometheus_label(server.strName)
+                      << "\",message=\"" << prometheus_label(message.first) << "\"} " << message.second.nCount << "\n";
+
+        ssRet << "# HELP nexus_llp_bytes_in_total Bytes read for messages by type.\n";
+        ssRet << "# TYPE nexus_llp_bytes_in_total counter\n";
+        for(const auto& server : vServers)
+            for(const auto& message : server.mapMessages)
+                ssRet << "nexus_llp_bytes_in_total{server=\"" << prometheus_label(server.strName)
+                      << "\",message=\"" << prometheus_label(message.first) << "\"} " << message.second.nBytesIn << "\n";
+
+        ssRet << "# HELP nexus_llp_bytes_out_total Bytes written while processing messages by type.\n";
+        ssRet << "# TYPE nexus_llp_bytes_out_total counter\n";
+        for(const auto& server : vServers)
+            for(const auto& message : server.mapMessages)
+                ssRet << "nexus_llp_bytes_out_total{server=\"" << prometheus_label(server.strName)
+                      << "\",message=\"" << prometheus_label(message.first) << "\"} " << message.second.nBytesOut << "\n";
+
+        /* The processing times as a summary in seconds. */
+        ssRet << "# HELP nexus_llp_processing_seconds Time spent processing messages by type.\n";
+        ssRet << "# TYPE nexus_llp_processing_seconds summary\n";
+        for(const auto& server : vServers)
+        {
+            for(const auto& message : server.mapMessages)
+            {
+                const std::string strLabels = "server=\"" + prometheus_label(server.strName)
+                                            + "\",message=\"" + prometheus_label(message.first) + "\"";
+
+                const Histogram& hist = message.second.histTime;
+                ssRet << "nexus_llp_processing_seconds{" << strLabels << ",quantile=\"0.5\"} "   << hist.Percentile(0.5)   / 1e6 << "\n";
+                ssRet << "nexus_llp_processing_seconds{" << strLabels << ",quantile=\"0.99\"} "  << hist.Percentile(0.99)  / 1e6 << "\n";
+                ssRet << "nexus_llp_processing_seconds{" << strLabels << ",quantile=\"0.999\"} " << hist.Percentile(0.999) / 1e6 << "\n";
+                ssRet << "nexus_llp_processing_seconds_sum{"   << strLabels << "} " << hist.Sum() / 1e6 << "\n";
+                ssRet << "nexus_llp_processing_seconds_count{" << strLabels << "} " << hist.Count() << "\n";
+            }
+        }
+
+        /* The database cache counters. */
+        if(!vCaches.empty())
+        {
+            ssRet << "# HELP nexus_lld_cache_reads_total Database reads by whether they were found in the cache.\n";
+            ssRet << "# TYPE nexus_lld_cache_reads_total counter\n";
+            for(const auto& cache : vCaches)
+            {
+                ssRet << "nexus_lld_cache_reads_total{database=\"" << prometheus_label(cache.strName) << "\",result=\"hit\"} " << cache.nHits << "\n";
+                ssRet << "nexus_lld_cache_reads_total{database=\"" << prometheus_label(cache.strName) << "\",result=\"miss\"} " << cache.nMisses << "\n";
+            }
+
+            ssRet << "# HELP nexus_lld_cache_bytes Bytes held by the database cache.\n";
+            ssRet << "# TYPE nexus_lld_cache_bytes gauge\n";
+            for(const auto& cache : vCaches)
+                ssRet << "nexus_lld_cache_bytes{database=\"" << prometheus_label(cache.strName) << "\"} " << cache.nBytes << "\n";
+        }
+
+        return ssRet.str();
+    }
+}
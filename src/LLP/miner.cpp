@@ -55,6 +55,15 @@ namespace LLP
     /* The block iterator to act as extra nonce. */
     std::atomic<uint32_t> Miner::nBlockIterator(0);
 
+
+    /* Mutex for the shared rounds. */
+    std::mutex Miner::ROUND_MUTEX;
+
+
+    /* The shared round for each channel. */
+    Miner::Round Miner::ROUNDS[3];
+
+
     /* Default Constructor */
     Miner::Miner()
     : Connection()
@@ -207,7 +216,7 @@ namespace LLP
                 /* Check for a new round. */
                 {
                     LOCK(MUTEX);
-                    if(check_best_height())
+                    if(!check_best_height())
                         return;
                 }
 
@@ -773,9 +782,6 @@ namespace LLP
         /* Reset the coinbase transaction. */
         CoinbaseTx.SetNull();
 
-        /* Set the block iterator back to zero so we can iterate new blocks next round. */
-        nBlockIterator = 0;
-
         debug::log(2, FUNCTION, "Cleared map of blocks");
     }
 
@@ -829,15 +835,88 @@ namespace LLP
             return nullptr;
         }
 
+        /* Check for a valid mining channel. */
+        const uint32_t nRound = nChannel.load();
+        if(nRound == 0 || nRound > 2)
+        {
+            debug::error(FUNCTION, "Invalid mining channel ", nRound);
+            return nullptr;
+        }
+
+        /* Get the last transaction of the sigchain, since the producer of the round has to follow it. */
+        uint512_t hashLast = 0;
+        LLD::Ledger->ReadLast(pSigChain->Genesis(), hashLast, TAO::Ledger::FLAGS::MEMPOOL);
+
         /* Allocate memory for the new block. */
         TAO::Ledger::TritiumBlock *pBlock = new TAO::Ledger::TritiumBlock();
 
         /* Lock this user's sigchain. */
         LOCK(session.CREATE_MUTEX);
 
-        /* Create a new block and loop for prime channel if minimum bit target length isn't met */
-        while(TAO::Ledger::CreateBlock(pSigChain, PIN, nChannel.load(), *pBlock, ++nBlockIterator, &CoinbaseTx))
+        /* Copy the block and merkle branch from the shared round of this channel. */
+        std::vector<uint512_t> vBranch;
         {
+            LOCK(ROUND_MUTEX);
+
+            /* New transactions only rebuild the round once it is this many seconds old. */
+            const uint64_t nRefresh = 5;
+
+            /* Build a new round on a new best block, a new sigchain transaction, or new memory pool transactions. */
+            Round& round = ROUNDS[nRound];
+            if(round.block.hashPrevBlock != TAO::Ledger::ChainState::hashBestChain.load()
+            || round.hashLast != hashLast
+            || (round.nInsertions != TAO::Ledger::mempool.Insertions() && runtime::timestamp() >= round.nTime + nRefresh))
+            {
+                /* Get the insertions before creating, so a transaction added meanwhile triggers the next round. */
+                const uint64_t nInsertions = TAO::Ledger::mempool.Insertions();
+                if(!TAO::Ledger::CreateBlock(pSigChain, PIN, nRound, round.block, ++nBlockIterator, &CoinbaseTx))
+                {
+                    round.block.SetNull();
+                    delete pBlock;
+
+                    debug::error(FUNCTION, "Failed to create round for channel ", nRound);
+                    return nullptr;
+                }
+
+                /* Get the merkle branch of the producer, which is always the last leaf. */
+                std::vector<uint512_t> vHashes;
+                for(const auto& tx : round.block.vtx)
+                    vHashes.push_back(tx.second);
+
+                vHashes.push_back(round.block.nVersion < 9 ? round.block.producer.GetHash() : round.block.vProducer.back().GetHash());
+                round.block.BuildMerkleTree(vHashes);
+
+                round.vBranch     = round.block.GetMerkleBranch(vHashes, vHashes.size() - 1);
+                round.hashLast    = hashLast;
+                round.nInsertions = nInsertions;
+                round.nTime       = runtime::timestamp();
+
+                debug::log(2, FUNCTION, "Created new round for channel ", nRound, " with ", round.block.vtx.size(), " transactions");
+            }
+
+            *pBlock = round.block;
+            vBranch = round.vBranch;
+        }
+
+        /* The cached merkle tree is the round's, not this block's. */
+        pBlock->vMerkleTree.clear();
+
+        /* Give this block its own producer, and loop for prime channel if minimum bit target length isn't met. */
+        while(true)
+        {
+            if(!TAO::Ledger::UpdateProducer(pSigChain, PIN, nRound, *pBlock, ++nBlockIterator, &CoinbaseTx))
+            {
+                delete pBlock;
+
+                debug::error(FUNCTION, "Failed to update producer for channel ", nRound);
+                return nullptr;
+            }
+
+            /* Only the producer changed, so the merkle root is rebuilt from its branch. */
+            const uint512_t hashProducer = (pBlock->nVersion < 9 ? pBlock->producer.GetHash() : pBlock->vProducer.back().GetHash());
+            pBlock->hashMerkleRoot = TAO::Ledger::Block::CheckMerkleTail(hashProducer, vBranch, pBlock->vtx.size());
+            pBlock->UpdateTime();
+
             /* Break out of loop when block is ready for prime mod. */
             if(is_prime_mod(nBitMask, pBlock))
                 break;
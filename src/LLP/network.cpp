@@ -86,6 +86,10 @@ namespace LLP
         SSL_CTX_set_session_cache_mode(pSSL_CTX, SSL_SESS_CACHE_OFF);
         SSL_CTX_set_options(pSSL_CTX, SSL_OP_NO_TICKET);
 
+        /* Allow partial writes so that flushes can move through the send queue, and allow retries from a different
+           buffer since small queued buffers are joined into one record before they are written. */
+        SSL_CTX_set_mode(pSSL_CTX, SSL_MODE_ENABLE_PARTIAL_WRITE | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+
         /* Instantiate a certificate for use with SSL context */
         LLC::X509Cert cert;
 
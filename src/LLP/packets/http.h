@@ -18,6 +18,7 @@ ________________________________________________________________________________
 
 #include <Util/include/runtime.h>
 #include <Util/include/debug.h>
+#include <Util/include/string.h>
 #include <vector>
 #include <map>
 
@@ -191,10 +192,30 @@ namespace LLP
          **/
         bool Complete() const
         {
-            if(strType == "GET" && fHeader)
-                return true;
+            /* Content is only read up to the content length, anything after it belongs to the next request. */
+            return fHeader && strContent.size() == nContentLength;
+        }
+
+
+        /** KeepAlive
+         *
+         *  Determine if a request asks for the connection to stay open after the response.
+         *  HTTP/1.1 connections are persistent unless closed, older versions must ask to keep alive.
+         *
+         **/
+        bool KeepAlive() const
+        {
+            /* Get the connection header if there is one. */
+            auto it = mapHeaders.find("connection");
+            if(it == mapHeaders.end())
+                return strVersion == "HTTP/1.1";
 
-            return fHeader && (nContentLength == 0 || (nContentLength > 0 && nContentLength == strContent.size()));
+            /* Check the header's value. */
+            const std::string strConnection = ToLower(it->second);
+            if(strConnection == "close")
+                return false;
+
+            return strVersion == "HTTP/1.1" || strConnection == "keep-alive";
         }
 
 
@@ -256,15 +277,16 @@ namespace LLP
         }
 
 
-        /** GetBytes
+        /** GetHeader
          *
-         *  Serializes class into a byte buffer. Used to write Packet to
-         *  Sockets.
+         *  Serializes the response header for content of the given length.
+         *
+         *  @param[in] nLength The length of the content.
          *
          *  @return Returns a byte buffer.
          *
          **/
-        std::vector<uint8_t> GetBytes() const
+        std::vector<uint8_t> GetHeader(const uint32_t nLength) const
         {
             //TODO: use constant format (not ...) -> ostringstream
             std::string strReply = debug::safe_printstr
@@ -275,24 +297,39 @@ namespace LLP
             );
 
             /* Check for content. */
-            if(strContent.size() > 0)
+            if(nLength > 0)
             {
-                strReply += debug::safe_printstr
-                (
-                    "Content-Length: ", strContent.size(), "\r\n",
-                    "Content-Type: application/json\r\n"
-                );
+                strReply += debug::safe_printstr("Content-Length: ", nLength, "\r\n");
+
+                /* Content is json unless a custom header says otherwise. */
+                if(!mapHeaders.count("Content-Type"))
+                    strReply += "Content-Type: application/json\r\n";
             }
 
             /* Add custom header fields. */
             for(const auto& header : mapHeaders)
                 strReply += debug::safe_printstr(header.first, ": ", header.second, "\r\n");;
 
-            /* Add end of header and content. */
-            strReply += debug::safe_printstr("\r\n", strContent);
+            /* Add end of header. */
+            strReply += "\r\n";
 
+            return std::vector<uint8_t>(strReply.begin(), strReply.end());
+        }
+
+
+        /** GetBytes
+         *
+         *  Serializes class into a byte buffer. Used to write Packet to
+         *  Sockets.
+         *
+         *  @return Returns a byte buffer.
+         *
+         **/
+        std::vector<uint8_t> GetBytes() const
+        {
             //get the bytes to submit over socket
-            std::vector<uint8_t> vBytes(strReply.begin(), strReply.end());
+            std::vector<uint8_t> vBytes = GetHeader(static_cast<uint32_t>(strContent.size()));
+            vBytes.insert(vBytes.end(), strContent.begin(), strContent.end());
 
             return vBytes;
         }
@@ -17,6 +17,8 @@ ________________________________________________________________________________
 #include <limits.h>
 #include <cstdint>
 
+#include <LLD/compress/lz4.h>
+
 #include <LLP/include/version.h>
 
 #include <Util/templates/datastream.h>
@@ -36,6 +38,9 @@ namespace LLP
      *  BYTE 7 - 10 : Packet Checksum
      *  Byte 11 +   : Packet Data
      *
+     *  A compressed packet has the COMPRESSED flag set, and its data is the size of
+     *  the decompressed payload as four bytes followed by the LZ4 compressed payload.
+     *
      **/
     class MessagePacket
     {
@@ -44,6 +49,14 @@ namespace LLP
         typedef uint16_t message_t;
 
 
+        /** Flag for a packet with an LZ4 compressed payload. **/
+        static const uint16_t COMPRESSED = (1 << 0);
+
+
+        /** The largest payload of a packet, before or after compression. (Max 2 MB Packet Size) **/
+        static const uint32_t MAX_SIZE = 1024 * 1024 * 2;
+
+
         /* Message enumeration. */
         uint16_t       MESSAGE;
 
@@ -226,14 +239,117 @@ namespace LLP
             if(IsNull())
                 return false;
 
-            /* Make sure Packet length is within bounds. (Max 2 MB Packet Size) */
-            if(LENGTH > (1024 * 1024 * 2))
+            /* Make sure Packet length is within bounds. */
+            if(LENGTH > MAX_SIZE)
                 return debug::error("Tritium Packet (", MESSAGE, ", ", LENGTH, " bytes) : Message too Large");
 
             return true;
         }
 
 
+        /** Compress
+         *
+         *  LZ4 compresses the payload into another packet with the COMPRESSED flag set.
+         *
+         *  @param[out] packet The compressed packet.
+         *
+         *  @return False if the payload doesn't get smaller, and should be sent as it is.
+         *
+         **/
+        bool Compress(MessagePacket& packet) const
+        {
+            /* Check for a payload to compress. */
+            if(DATA.empty() || (FLAGS & COMPRESSED))
+                return false;
+
+            /* Compress the payload behind its size. */
+            const int32_t nBound = LZ4_compressBound(static_cast<int32_t>(DATA.size()));
+            packet.DATA.resize(4 + nBound);
+
+            const int32_t nCompressed = LZ4_compress_default((const char*)&DATA[0], (char*)&packet.DATA[4],
+                static_cast<int32_t>(DATA.size()), nBound);
+
+            /* Send the payload as it is if it doesn't get any smaller. */
+            if(nCompressed <= 0 || 4 + static_cast<uint32_t>(nCompressed) >= DATA.size())
+                return false;
+
+            packet.DATA.resize(4 + nCompressed);
+
+            /* Write the size of the payload. */
+            const uint32_t nSize = static_cast<uint32_t>(DATA.size());
+            for(uint32_t i = 0; i < 4; ++i)
+                packet.DATA[i] = static_cast<uint8_t>(nSize >> (i * 8));
+
+            /* Set the header. */
+            packet.MESSAGE = MESSAGE;
+            packet.FLAGS   = (FLAGS | COMPRESSED);
+            packet.LENGTH  = static_cast<uint32_t>(packet.DATA.size());
+
+            return true;
+        }
+
+
+        /** Decompress
+         *
+         *  Decompresses the payload in place if the packet is compressed, clearing the COMPRESSED flag.
+         *
+         *  @return False if the compressed payload is invalid or its size is over the limit.
+         *
+         **/
+        bool Decompress()
+        {
+            /* Packets sent uncompressed are used as they are. */
+            if(!(FLAGS & COMPRESSED))
+                return true;
+
+            /* Check that the size is all there. */
+            if(DATA.size() <= 4)
+                return debug::error("Tritium Packet (", MESSAGE, ") : compressed packet too small");
+
+            /* Get the size of the payload. */
+            uint32_t nSize = 0;
+            for(uint32_t i = 0; i < 4; ++i)
+                nSize |= (static_cast<uint32_t>(DATA[i]) << (i * 8));
+
+            /* Enforce the packet limit on the decompressed size. Empty payloads are never compressed. */
+            if(nSize == 0 || nSize > MAX_SIZE)
+                return debug::error("Tritium Packet (", MESSAGE, ", ", nSize, " bytes) : invalid decompressed size");
+
+            /* Decompress into a new buffer, the sizes have to match exactly. */
+            std::vector<uint8_t> vData(nSize);
+            const int32_t nDecompressed = LZ4_decompress_safe((const char*)&DATA[4], (char*)&vData[0],
+                static_cast<int32_t>(DATA.size() - 4), static_cast<int32_t>(nSize));
+
+            if(nDecompressed < 0 || static_cast<uint32_t>(nDecompressed) != nSize)
+                return debug::error("Tritium Packet (", MESSAGE, ") : failed to decompress ", nDecompressed, "/", nSize, " bytes");
+
+            /* Replace the payload. */
+            DATA.swap(vData);
+            LENGTH = nSize;
+            FLAGS  = static_cast<uint16_t>(FLAGS & ~COMPRESSED);
+
+            return true;
+        }
+
+
+        /** GetHeader
+         *
+         *  Serializes the packet header for a payload of the given length.
+         *
+         *  @param[in] nLength The length of the payload.
+         *
+         *  @return Returns the serialized header bytes.
+         *
+         **/
+        std::vector<uint8_t> GetHeader(const uint32_t nLength) const
+        {
+            DataStream ssHeader(SER_NETWORK, MIN_PROTO_VERSION);
+            ssHeader << MESSAGE << FLAGS << nLength;
+
+            return std::vector<uint8_t>(ssHeader.begin(), ssHeader.end());
+        }
+
+
         /** GetBytes
          *
          *  Serializes class into a Byte Vector. Used to write Packet to Sockets.
@@ -243,10 +359,7 @@ namespace LLP
          **/
         std::vector<uint8_t> GetBytes() const
         {
-            DataStream ssHeader(SER_NETWORK, MIN_PROTO_VERSION);
-            ssHeader << *this;
-
-            std::vector<uint8_t> vBytes(ssHeader.begin(), ssHeader.end());
+            std::vector<uint8_t> vBytes = GetHeader(LENGTH);
             vBytes.insert(vBytes.end(), DATA.begin(), DATA.end());
 
             return vBytes;
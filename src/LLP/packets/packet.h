@@ -190,24 +190,40 @@ namespace LLP
         }
 
 
-        /** GetBytes
+        /** GetHeader
          *
-         *  Serializes class into a byte vector. Used to write packet to sockets.
+         *  Serializes the packet header for a payload of the given length.
+         *
+         *  @param[in] nLength The length of the payload.
          *
          **/
-        std::vector<uint8_t> GetBytes() const
+        std::vector<uint8_t> GetHeader(const uint32_t nLength) const
         {
             std::vector<uint8_t> BYTES(1, HEADER);
 
             if(HEADER < 128) /* Handle for Data Packets. */
             {
-                BYTES.push_back(static_cast<uint8_t>(LENGTH >> 24));
-                BYTES.push_back(static_cast<uint8_t>(LENGTH >> 16));
-                BYTES.push_back(static_cast<uint8_t>(LENGTH >> 8));
-                BYTES.push_back(static_cast<uint8_t>(LENGTH));
+                BYTES.push_back(static_cast<uint8_t>(nLength >> 24));
+                BYTES.push_back(static_cast<uint8_t>(nLength >> 16));
+                BYTES.push_back(static_cast<uint8_t>(nLength >> 8));
+                BYTES.push_back(static_cast<uint8_t>(nLength));
+            }
 
+            return BYTES;
+        }
+
+
+        /** GetBytes
+         *
+         *  Serializes class into a byte vector. Used to write packet to sockets.
+         *
+         **/
+        std::vector<uint8_t> GetBytes() const
+        {
+            std::vector<uint8_t> BYTES = GetHeader(LENGTH);
+
+            if(HEADER < 128) /* Handle for Data Packets. */
                 BYTES.insert(BYTES.end(),  DATA.begin(), DATA.end());
-            }
 
             return BYTES;
         }
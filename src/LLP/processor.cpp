@@ -0,0 +1,208 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLP/include/processor.h>
+
+#include <Util/include/debug.h>
+#include <Util/include/mutex.h>
+
+namespace LLP
+{
+
+    /* Constructor */
+    ProcessorPool::ProcessorPool(const uint32_t nThreads)
+    : CONDITION_MUTEX ( )
+    , CONDITION       ( )
+    , vWorkers        ( )
+    , vThreads        ( )
+    , nPending        (0)
+    , nNext           (0)
+    , nStolen         (0)
+    , fStop           (false)
+    {
+        /* Create the queues before any worker can steal from them. */
+        for(uint32_t nID = 0; nID < nThreads; ++nID)
+            vWorkers.push_back(new Worker());
+
+        /* Start the workers. */
+        for(uint32_t nID = 0; nID < nThreads; ++nID)
+            vThreads.push_back(std::thread(std::bind(&ProcessorPool::Thread, this, nID)));
+    }
+
+
+    /* Default Destructor */
+    ProcessorPool::~ProcessorPool()
+    {
+        Stop();
+
+        /* Free the queues. */
+        for(auto& pWorker : vWorkers)
+            delete pWorker;
+
+        vWorkers.clear();
+    }
+
+
+    /* Add a task for the workers, spreading tasks between the queues in turn. */
+    bool ProcessorPool::Submit(const std::function<void()>& task)
+    {
+        /* Check that there are workers to run the task. */
+        if(fStop.load() || vWorkers.empty())
+            return false;
+
+        /* Add the task to the next worker's queue, counting it before any worker can take it. */
+        Worker* pWorker = vWorkers[nNext++ % vWorkers.size()];
+        {
+            LOCK(pWorker->MUTEX);
+
+            pWorker->queueTasks.push_back(task);
+            ++nPending;
+        }
+
+        /* Wake a worker, passing through the condition mutex so the wakeup isn't missed. */
+        {
+            LOCK(CONDITION_MUTEX);
+        }
+        CONDITION.notify_one();
+
+        return true;
+    }
+
+
+    /* Stop the workers once they finish their current task, dropping any queued tasks. */
+    void ProcessorPool::Stop()
+    {
+        /* Set the stop flag under the condition mutex so sleeping workers see it. */
+        {
+            LOCK(CONDITION_MUTEX);
+            fStop = true;
+        }
+        CONDITION.notify_all();
+
+        /* Wait for the workers. */
+        for(auto& thread : vThreads)
+        {
+            if(thread.joinable())
+                thread.join();
+        }
+
+        /* Drop the tasks that were never run. */
+        for(auto& pWorker : vWorkers)
+        {
+            LOCK(pWorker->MUTEX);
+            pWorker->queueTasks.clear();
+        }
+        nPending = 0;
+    }
+
+
+    /* Get the number of worker threads. */
+    uint32_t ProcessorPool::Size() const
+    {
+        return static_cast<uint32_t>(vWorkers.size());
+    }
+
+
+    /* Get the number of tasks waiting for a worker. */
+    uint32_t ProcessorPool::Pending() const
+    {
+        return nPending.load();
+    }
+
+
+    /* Get the number of tasks taken from the queue of another worker. */
+    uint64_t ProcessorPool::Stolen() const
+    {
+        return nStolen.load();
+    }
+
+
+    /* The worker thread, running tasks from its own queue or stolen from others. */
+    void ProcessorPool::Thread(const uint32_t nID)
+    {
+        /* The task being run. */
+        std::function<void()> task;
+
+        /* Run tasks until stopped. */
+        while(!fStop.load())
+        {
+            /* Wait for a task. */
+            {
+                std::unique_lock<std::mutex> CONDITION_LOCK(CONDITION_MUTEX);
+                CONDITION.wait(CONDITION_LOCK,
+                [this]
+                {
+                    return fStop.load() || nPending.load() > 0;
+                });
+            }
+
+            /* Check for stop. */
+            if(fStop.load())
+                return;
+
+            /* Another worker may have taken the task first. */
+            if(!take(nID, task))
+                continue;
+
+            /* Run the task, keeping the worker alive if it throws. */
+            try { task(); }
+            catch(const std::exception& e)
+            {
+                debug::error(FUNCTION, "processor ", nID, ": ", e.what());
+            }
+
+            /* Release anything held by the task. */
+            task = nullptr;
+        }
+    }
+
+
+    /* Take a task from the front of the worker's own queue, or the back of another worker's queue. */
+    bool ProcessorPool::take(const uint32_t nID, std::function<void()>& task)
+    {
+        /* Check the worker's own queue first, oldest task first. */
+        {
+            Worker* pWorker = vWorkers[nID];
+
+            LOCK(pWorker->MUTEX);
+            if(!pWorker->queueTasks.empty())
+            {
+                task = std::move(pWorker->queueTasks.front());
+                pWorker->queueTasks.pop_front();
+
+                --nPending;
+                return true;
+            }
+        }
+
+        /* Steal the newest task from the other queues, starting after this worker. */
+        const uint32_t nWorkers = static_cast<uint32_t>(vWorkers.size());
+        for(uint32_t nOffset = 1; nOffset < nWorkers; ++nOffset)
+        {
+            Worker* pWorker = vWorkers[(nID + nOffset) % nWorkers];
+
+            LOCK(pWorker->MUTEX);
+            if(!pWorker->queueTasks.empty())
+            {
+                task = std::move(pWorker->queueTasks.back());
+                pWorker->queueTasks.pop_back();
+
+                --nPending;
+                ++nStolen;
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
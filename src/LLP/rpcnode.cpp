@@ -42,6 +42,7 @@ namespace LLP
     /** Default Constructor **/
     RPCNode::RPCNode()
     : HTTPNode()
+    , strMethod ( )
     {
     }
 
@@ -49,6 +50,7 @@ namespace LLP
     /** Constructor **/
     RPCNode::RPCNode(LLP::Socket SOCKET_IN, LLP::DDOS_Filter* DDOS_IN, bool fDDOSIn)
     : HTTPNode(SOCKET_IN, DDOS_IN, fDDOSIn)
+    , strMethod ( )
     {
     }
 
@@ -56,6 +58,7 @@ namespace LLP
     /** Constructor **/
     RPCNode::RPCNode(LLP::DDOS_Filter* DDOS_IN, bool fDDOSIn)
     : HTTPNode(DDOS_IN, fDDOSIn)
+    , strMethod ( )
     {
     }
 
@@ -146,6 +149,9 @@ namespace LLP
             return false;
         }
 
+        /* Clear the method of the last request. */
+        strMethod.clear();
+
         json::json jsonID = nullptr;
         try
         {
@@ -161,7 +167,7 @@ namespace LLP
                 throw APIException(-32600, "Method must be a string");
 
             /* Get the method string. */
-            std::string strMethod = jsonIncoming["method"].get<std::string>();
+            strMethod = jsonIncoming["method"].get<std::string>();
 
             /* Check for parameters, if none set default value to empty array. */
             json::json jsonParams = jsonIncoming["params"].is_null() ? "[]" : jsonIncoming["params"];
@@ -182,8 +188,12 @@ namespace LLP
             #ifndef NO_WALLET
             json::json jsonResult = TAO::API::RPCCommands->Execute(strMethod, jsonParams, false);
 
-            /* Push the response data with json payload. */
-            PushResponse(200, JSONReply(jsonResult, nullptr, jsonID).dump());
+            /* Keep the connection open unless the request asks to close it. */
+            HTTPPacket RESPONSE(200);
+            RESPONSE.mapHeaders["Connection"] = INCOMING.KeepAlive() ? "keep-alive" : "close";
+
+            /* Write the response with json payload. */
+            WriteResponse(RESPONSE, JSONReply(jsonResult, nullptr, jsonID));
             #endif
         }
 
@@ -260,9 +270,20 @@ namespace LLP
         }
 
         /* Send the response packet. */
-        PushResponse(nStatus, JSONReply(json::json(nullptr), jsonError, jsonID).dump());
+        WriteResponse(HTTPPacket(nStatus), JSONReply(json::json(nullptr), jsonError, jsonID));
     }
 
+    /* Returns the method of the last request. */
+    std::string RPCNode::MessageName() const
+    {
+        /* Requests that couldn't be parsed have no method. */
+        if(strMethod.empty())
+            return "unknown";
+
+        return strMethod;
+    }
+
+
     bool RPCNode::Authorized(std::map<std::string, std::string>& mapHeaders)
     {
         /* Check the headers. */
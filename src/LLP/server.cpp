@@ -15,6 +15,7 @@ ________________________________________________________________________________
 #include <LLP/templates/data.h>
 #include <LLP/templates/ddos.h>
 #include <LLP/include/network.h>
+#include <LLP/include/processor.h>
 
 #include <LLP/types/tritium.h>
 #include <LLP/types/time.h>
@@ -68,6 +69,8 @@ namespace LLP
     , DDOS_TIMESPAN   (config.nDDOSTimespan)
     , MAX_THREADS     (config.nMaxThreads)
     , DATA_THREADS    ( )
+    , PROCESSOR       (config.nProcessThreads > 0 ? new ProcessorPool(config.nProcessThreads) : nullptr)
+    , METRICS         (config.fMetrics ? new Metrics() : nullptr)
     , MANAGER         ( )
     , LISTEN_THREAD   ( )
     , SSL_LISTEN_THREAD   ( )
@@ -83,7 +86,7 @@ namespace LLP
         for(uint16_t nIndex = 0; nIndex < MAX_THREADS; ++nIndex)
         {
             DATA_THREADS.push_back(new DataThread<ProtocolType>(
-                nIndex, config.fDDOS, config.nDDOSRScore, config.nDDOSCScore, config.nTimeout, config.fMeter));
+                nIndex, config.fDDOS, config.nDDOSRScore, config.nDDOSCScore, config.nTimeout, config.fMeter, PROCESSOR, METRICS));
         }
 
         /* Initialize the address manager. */
@@ -172,6 +175,10 @@ namespace LLP
         if(SSL_LISTEN_THREAD.joinable())
             SSL_LISTEN_THREAD.join();
 
+        /* Stop the processor pool before the connections it works on are freed. */
+        if(PROCESSOR)
+            PROCESSOR->Stop();
+
         /* Delete the data threads. */
         for(uint16_t nIndex = 0; nIndex < MAX_THREADS; ++nIndex)
         {
@@ -179,6 +186,20 @@ namespace LLP
             DATA_THREADS[nIndex] = nullptr;
         }
 
+        /* Delete the processor pool. */
+        if(PROCESSOR)
+        {
+            delete PROCESSOR;
+            PROCESSOR = nullptr;
+        }
+
+        /* Delete the metrics once no data thread can record to them. */
+        if(METRICS)
+        {
+            delete METRICS;
+            METRICS = nullptr;
+        }
+
         /* Delete the DDOS entries. */
         auto it = DDOS_MAP.begin();
         for(; it != DDOS_MAP.end(); ++it)
@@ -278,6 +299,61 @@ namespace LLP
     }
 
 
+    /*  Get a snapshot of the message metrics, queues and send buffers of this server. */
+    template <class ProtocolType>
+    ServerMetrics Server<ProtocolType>::GetMetrics()
+    {
+        ServerMetrics metrics;
+        metrics.strName = Name();
+
+        /* Get the metrics of each message type. */
+        if(METRICS)
+            metrics.mapMessages = METRICS->Messages();
+
+        /* Get the packets waiting for the processor pool. */
+        if(PROCESSOR)
+            metrics.nProcessQueue = PROCESSOR->Pending();
+
+        /* Add the counters kept by the protocol. */
+        ProtocolType::AddMetrics(metrics);
+
+        for(uint16_t nThread = 0; nThread < MAX_THREADS; ++nThread)
+        {
+            /* Get the relay queue of the data thread. */
+            metrics.nRelayQueue += DATA_THREADS[nThread]->RELAY->size();
+
+            /* Loop through connections in data thread. */
+            uint16_t nSize = static_cast<uint16_t>(DATA_THREADS[nThread]->CONNECTIONS->size());
+            for(uint16_t nIndex = 0; nIndex < nSize; ++nIndex)
+            {
+                try
+                {
+                    /* Get the current atomic_ptr. */
+                    memory::atomic_ptr<ProtocolType>& CONNECTION = DATA_THREADS[nThread]->CONNECTIONS->at(nIndex);
+                    if(!CONNECTION)
+                        continue;
+
+                    ++metrics.nConnections;
+
+                    /* Add the send buffers with bytes waiting. */
+                    const uint64_t nBuffered = CONNECTION->Buffered();
+                    if(nBuffered == 0)
+                        continue;
+
+                    metrics.nBuffered += nBuffered;
+                    metrics.vBuffers.push_back(std::make_pair(CONNECTION->addr.ToString(), nBuffered));
+                }
+                catch(const std::exception& e)
+                {
+                    //debug::error(FUNCTION, e.what());
+                }
+            }
+        }
+
+        return metrics;
+    }
+
+
     /*  Select a random and currently open connections. */
     template <class ProtocolType>
     memory::atomic_ptr<ProtocolType>& Server<ProtocolType>::GetConnection()
@@ -29,6 +29,8 @@ namespace LLP
     , nMaxIncoming  (std::numeric_limits<uint32_t>::max())
     , nMaxConnections(std::numeric_limits<uint32_t>::max())
     , nMaxThreads   (1)
+    , nProcessThreads(0)
+    , fMetrics      (true)
     , nTimeout      (30)
     , fMeter        (false)
     , fDDOS         (false)
@@ -24,8 +24,13 @@ ________________________________________________________________________________
 #ifndef WIN32
 #include <arpa/inet.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
 #include <openssl/ssl.h>
 #include <openssl/err.h>
 #include <openssl/opensslv.h>
@@ -33,6 +38,70 @@ ________________________________________________________________________________
 namespace LLP
 {
 
+    /** Max free chunks to keep in the pool. **/
+    const uint32_t MAX_POOL_CHUNKS = 1024; //16MB of free chunks
+
+
+    /** Mutex to protect the chunk pool. **/
+    std::mutex POOL_MUTEX;
+
+
+    /** The free chunks that sockets can copy small writes into. **/
+    std::vector<std::vector<uint8_t>*> vChunkPool;
+
+
+    /* Return a chunk to the pool once no queue holds it. */
+    static void release_chunk(std::vector<uint8_t>* pRelease)
+    {
+        /* Keep the chunk for reuse if the pool has room. */
+        {
+            LOCK(POOL_MUTEX);
+
+            if(vChunkPool.size() < MAX_POOL_CHUNKS)
+            {
+                pRelease->clear();
+                vChunkPool.push_back(pRelease);
+
+                return;
+            }
+        }
+
+        delete pRelease;
+    }
+
+
+    /* Get an empty chunk from the pool, or allocate a new one. */
+    static std::shared_ptr<std::vector<uint8_t>> get_chunk()
+    {
+        std::vector<uint8_t>* pGet = nullptr;
+        {
+            LOCK(POOL_MUTEX);
+
+            if(!vChunkPool.empty())
+            {
+                pGet = vChunkPool.back();
+                vChunkPool.pop_back();
+            }
+        }
+
+        /* Allocate a new chunk with the full capacity, so appends never reallocate. */
+        if(pGet == nullptr)
+        {
+            pGet = new std::vector<uint8_t>();
+            pGet->reserve(SEND_CHUNK_SIZE);
+        }
+
+        return std::shared_ptr<std::vector<uint8_t>>(pGet, release_chunk);
+    }
+
+
+    /* Get the current time in microseconds for the queue timers. */
+    static uint64_t queue_timestamp()
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+
     /* The default constructor. */
     Socket::Socket()
     : pollfd             ( )
@@ -42,8 +111,15 @@ namespace LLP
     , nLastSend          (0)
     , nLastRecv          (0)
     , nError             (0)
-    , vBuffer            ( )
+    , qBuffer            ( )
+    , pChunk             ( )
+    , nBufferSent        (0)
+    , nBuffered          (0)
     , fBufferFull        (false)
+    , nFlushLatency      (0)
+    , nMaxFlushLatency   (0)
+    , nBytesRead         (0)
+    , nBytesWritten      (0)
     , nConsecutiveErrors (0)
     , addr               ( )
     {
@@ -64,8 +140,15 @@ namespace LLP
     , nLastSend          (socket.nLastSend.load())
     , nLastRecv          (socket.nLastRecv.load())
     , nError             (socket.nError.load())
-    , vBuffer            (socket.vBuffer)
+    , qBuffer            (socket.qBuffer)
+    , pChunk             ( )
+    , nBufferSent        (socket.nBufferSent)
+    , nBuffered          (socket.nBuffered.load())
     , fBufferFull        (socket.fBufferFull.load())
+    , nFlushLatency      (socket.nFlushLatency.load())
+    , nMaxFlushLatency   (socket.nMaxFlushLatency.load())
+    , nBytesRead         (socket.nBytesRead.load())
+    , nBytesWritten      (socket.nBytesWritten.load())
     , nConsecutiveErrors (socket.nConsecutiveErrors.load())
     , addr               (socket.addr)
     {
@@ -98,8 +181,15 @@ namespace LLP
     , nLastSend          (0)
     , nLastRecv          (0)
     , nError             (0)
-    , vBuffer            ( )
+    , qBuffer            ( )
+    , pChunk             ( )
+    , nBufferSent        (0)
+    , nBuffered          (0)
     , fBufferFull        (false)
+    , nFlushLatency      (0)
+    , nMaxFlushLatency   (0)
+    , nBytesRead         (0)
+    , nBytesWritten      (0)
     , nConsecutiveErrors (0)
     , addr               (addrIn)
     {
@@ -215,8 +305,15 @@ namespace LLP
     , nLastSend          (0)
     , nLastRecv          (0)
     , nError             (0)
-    , vBuffer            ( )
+    , qBuffer            ( )
+    , pChunk             ( )
+    , nBufferSent        (0)
+    , nBuffered          (0)
     , fBufferFull        (false)
+    , nFlushLatency      (0)
+    , nMaxFlushLatency   (0)
+    , nBytesRead         (0)
+    , nBytesWritten      (0)
     , nConsecutiveErrors (0)
     , addr               ( )
     {
@@ -651,7 +748,10 @@ namespace LLP
             }
         }
         else if(nRead > 0)
+        {
             nLastRecv = runtime::timestamp(true);
+            nBytesRead += nRead;
+        }
 
         return nRead;
     }
@@ -659,6 +759,13 @@ namespace LLP
 
     /* Read data from the socket buffer non-blocking */
     int32_t Socket::Read(std::vector<int8_t> &vData, size_t nBytes)
+    {
+        return Read(&vData[0], nBytes);
+    }
+
+
+    /* Read data from the socket buffer non-blocking */
+    int32_t Socket::Read(int8_t* pData, size_t nBytes)
     {
         LOCK(SOCKET_MUTEX);
 
@@ -668,13 +775,13 @@ namespace LLP
         int32_t nRead = 0;
 
         if(pSSL)
-            nRead = SSL_read(pSSL, (int8_t*)&vData[0], nBytes);
+            nRead = SSL_read(pSSL, pData, nBytes);
         else
         {
         #ifdef WIN32
-            nRead = static_cast<int32_t>(recv(fd, (char*)&vData[0], nBytes, MSG_DONTWAIT));
+            nRead = static_cast<int32_t>(recv(fd, (char*)pData, nBytes, MSG_DONTWAIT));
         #else
-            nRead = static_cast<int32_t>(recv(fd, (int8_t*)&vData[0], nBytes, MSG_DONTWAIT));
+            nRead = static_cast<int32_t>(recv(fd, pData, nBytes, MSG_DONTWAIT));
         #endif
         }
 
@@ -740,7 +847,10 @@ namespace LLP
             }
         }
         else if(nRead > 0)
+        {
             nLastRecv = runtime::timestamp(true);
+            nBytesRead += nRead;
+        }
 
         return nRead;
     }
@@ -755,11 +865,12 @@ namespace LLP
             LOCK(DATA_MUTEX);
 
             /* Check overflow buffer. */
-            if(vBuffer.size() > 0)
+            if(!qBuffer.empty())
             {
-                debug::log(3, FUNCTION, "vBuffer ", vBuffer.size(), " bytes");
+                debug::log(3, FUNCTION, "buffered ", nBuffered.load(), " bytes");
 
-                vBuffer.insert(vBuffer.end(), vData.begin(), vData.end());
+                queue_bytes(&vData[0], vData.size());
+                nBytesWritten += vData.size();
 
                 return static_cast<int32_t>(nBytes);
             }
@@ -789,13 +900,22 @@ namespace LLP
                 nError = SSL_get_error(pSSL, nSent);
             else
                 nError = WSAGetLastError();
+
+            /* Nothing was sent if the socket would block, so queue it all. */
+            if(error_code() != 0)
+                return nSent;
+
+            nSent = 0;
         }
 
+        /* Count the bytes sent or queued. */
+        nBytesWritten += vData.size();
+
         /* If not all data was sent non-blocking, recurse until it is complete. */
-        else if(nSent != vData.size())
+        if(nSent != vData.size())
         {
             LOCK(DATA_MUTEX);
-            vBuffer.insert(vBuffer.end(), vData.begin() + nSent, vData.end());
+            queue_bytes(&vData[nSent], vData.size() - nSent);
         }
         else //don't update last sent unless all the data was written to the buffer
             nLastSend = runtime::timestamp(true);
@@ -804,44 +924,95 @@ namespace LLP
     }
 
 
-    /* Flushes data out of the overflow buffer */
-    int Socket::Flush()
+    /* Write a header and payload in one gather write, non-blocking. */
+    int32_t Socket::Write(const shared_buffer_t& pHeader, const shared_buffer_t& pData)
     {
-        int32_t nSent   = 0;
-        uint32_t nBytes = 0;
-        uint32_t nSize  = 0;
+        const uint64_t nBytes = pHeader->size() + pData->size();
 
         {
             LOCK(DATA_MUTEX);
-            nSize = static_cast<uint32_t>(vBuffer.size());
-        }
 
-        /* Don't flush if buffer doesn't have any data. */
-        if(nSize == 0)
-            return 0;
+            /* Queue behind any buffered data to keep the stream in order. */
+            if(!qBuffer.empty())
+            {
+                debug::log(3, FUNCTION, "buffered ", nBuffered.load(), " bytes");
 
-        /* maximum transmission unit. */
-        const uint32_t MTU = 16384;
+                queue_buffer(pHeader, 0);
+                queue_buffer(pData, 0);
+                nBytesWritten += nBytes;
 
-        /* Set the maximum bytes to flush to 2^16 or maximum socket buffers. */
-        nBytes = std::min(nSize, std::min((uint32_t)config::GetArg("-maxsendsize", MTU), MTU));
+                return static_cast<int32_t>(nBytes);
+            }
+        }
 
-        /* If there were any errors, handle them gracefully. */
+        /* Write the header and payload. */
+        int32_t nSent = 0;
         {
-            LOCK2(DATA_MUTEX);
             LOCK(SOCKET_MUTEX);
+            nSent = send_buffers(*pHeader, *pData);
+        }
 
+        /* Handle for error state. */
+        if(nSent < 0)
+        {
             if(pSSL)
-                nSent = static_cast<int32_t>(SSL_write(pSSL, (int8_t *)&vBuffer[0], nBytes));
+                nError = SSL_get_error(pSSL, nSent);
             else
+                nError = WSAGetLastError();
+
+            /* Nothing was sent if the socket would block, so queue it all. */
+            if(error_code() != 0)
+                return nSent;
+
+            nSent = 0;
+        }
+
+        /* Count the bytes sent or queued. */
+        nBytesWritten += nBytes;
+
+        /* Queue the bytes that were not sent, by reference. */
+        if(static_cast<uint64_t>(nSent) < nBytes)
+        {
+            LOCK(DATA_MUTEX);
+
+            const uint64_t nHeader = pHeader->size();
+            if(static_cast<uint64_t>(nSent) < nHeader)
             {
-            #ifdef WIN32
-                nSent = static_cast<int32_t>(send(fd, (char*)&vBuffer[0], nBytes, MSG_NOSIGNAL | MSG_DONTWAIT));
-            #else
-                nSent = static_cast<int32_t>(send(fd, (int8_t*)&vBuffer[0], nBytes, MSG_NOSIGNAL | MSG_DONTWAIT));
-            #endif
+                queue_buffer(pHeader, nSent);
+                queue_buffer(pData, 0);
             }
+            else
+                queue_buffer(pData, nSent - nHeader);
+        }
+        else //don't update last sent unless all the data was written to the buffer
+            nLastSend = runtime::timestamp(true);
 
+        return nSent;
+    }
+
+
+    /* Flushes data out of the overflow buffer */
+    int Socket::Flush()
+    {
+        /* Don't flush if buffer doesn't have any data. */
+        if(nBuffered.load() == 0)
+            return 0;
+
+        /* Set the maximum bytes to flush to the flush size or maximum socket buffers. */
+        const uint32_t nMaxBytes = std::min((uint32_t)config::GetArg("-maxsendsize", MAX_FLUSH_SIZE), MAX_FLUSH_SIZE);
+
+        /* If there were any errors, handle them gracefully. */
+        int32_t nSent = 0;
+        {
+            LOCK2(DATA_MUTEX);
+            LOCK(SOCKET_MUTEX);
+
+            /* Check the queue again now that it is locked. */
+            if(qBuffer.empty())
+                return 0;
+
+            /* Send as many queued buffers as allowed. */
+            nSent = send_queue(nMaxBytes);
         }
 
         /* Handle errors on flush. */
@@ -860,8 +1031,8 @@ namespace LLP
         {
             LOCK(DATA_MUTEX);
 
-            /* Erase from current buffer. */
-            vBuffer.erase(vBuffer.begin(), vBuffer.begin() + nSent);
+            /* Move past the sent bytes, releasing the buffers that were fully sent. */
+            release_buffers(nSent);
 
             /* Update socket timers. */
             nLastSend          = runtime::timestamp(true);
@@ -894,7 +1065,35 @@ namespace LLP
     /* Check that the socket has data that is buffered. */
     uint64_t Socket::Buffered() const
     {
-        return vBuffer.size();
+        return nBuffered.load();
+    }
+
+
+    /* Get the average time in microseconds that queued buffers waited to be sent. */
+    uint64_t Socket::FlushLatency() const
+    {
+        return nFlushLatency.load();
+    }
+
+
+    /* Get the longest time in microseconds that a queued buffer waited to be sent. */
+    uint64_t Socket::MaxFlushLatency() const
+    {
+        return nMaxFlushLatency.load();
+    }
+
+
+    /* Get the total bytes read from the socket. */
+    uint64_t Socket::BytesRead() const
+    {
+        return nBytesRead.load();
+    }
+
+
+    /* Get the total bytes written to the socket, including bytes still queued. */
+    uint64_t Socket::BytesWritten() const
+    {
+        return nBytesWritten.load();
     }
 
 
@@ -947,6 +1146,233 @@ namespace LLP
         return nError;
     }
 
+
+    /* Send a header and payload with a single gather write, or one after the other with SSL. */
+    int32_t Socket::send_buffers(const std::vector<uint8_t>& vHeader, const std::vector<uint8_t>& vData)
+    {
+        /* SSL has no gather write, so stop after the header unless it was all written. */
+        if(pSSL)
+        {
+            int32_t nSent = static_cast<int32_t>(SSL_write(pSSL, (int8_t*)&vHeader[0], vHeader.size()));
+            if(nSent != static_cast<int32_t>(vHeader.size()) || vData.empty())
+                return nSent;
+
+            int32_t nData = static_cast<int32_t>(SSL_write(pSSL, (int8_t*)&vData[0], vData.size()));
+            return (nData > 0) ? nSent + nData : nSent;
+        }
+
+    #ifdef WIN32
+        /* Send the header and payload as one buffer array. */
+        WSABUF vBuffers[2];
+        vBuffers[0].buf = (char*)&vHeader[0];
+        vBuffers[0].len = static_cast<ULONG>(vHeader.size());
+        vBuffers[1].buf = vData.empty() ? nullptr : (char*)&vData[0];
+        vBuffers[1].len = static_cast<ULONG>(vData.size());
+
+        DWORD nSent = 0;
+        if(WSASend(fd, vBuffers, vData.empty() ? 1 : 2, &nSent, 0, nullptr, nullptr) == SOCKET_ERROR)
+            return -1;
+
+        return static_cast<int32_t>(nSent);
+    #else
+        /* Send the header and payload with one system call, without joining them. */
+        struct iovec vBuffers[2];
+        vBuffers[0].iov_base = (void*)&vHeader[0];
+        vBuffers[0].iov_len  = vHeader.size();
+        vBuffers[1].iov_base = vData.empty() ? nullptr : (void*)&vData[0];
+        vBuffers[1].iov_len  = vData.size();
+
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov    = vBuffers;
+        msg.msg_iovlen = vData.empty() ? 1 : 2;
+
+        return static_cast<int32_t>(sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT));
+    #endif
+    }
+
+
+    /* Send from the front of the queue, gathering as many buffers as allowed into one write. */
+    int32_t Socket::send_queue(const uint32_t nMaxBytes)
+    {
+        /* SSL has no gather write, so join small buffers into one record instead of writing a record for each. */
+        if(pSSL)
+        {
+            const std::vector<uint8_t>& vFront = *qBuffer.front().pBuffer;
+            const uint32_t nFront = static_cast<uint32_t>(std::min(static_cast<uint64_t>(nMaxBytes), vFront.size() - nBufferSent));
+
+            /* Write large or lone buffers directly. */
+            if(nFront >= SEND_CHUNK_SIZE || qBuffer.size() == 1)
+                return static_cast<int32_t>(SSL_write(pSSL, (int8_t*)&vFront[nBufferSent], nFront));
+
+            /* Copy the front buffers into one record. */
+            uint8_t vRecord[SEND_CHUNK_SIZE];
+            uint32_t nRecord = 0;
+
+            uint64_t nOffset = nBufferSent;
+            for(const auto& queued : qBuffer)
+            {
+                const uint32_t nCopy = static_cast<uint32_t>(std::min(static_cast<uint64_t>(SEND_CHUNK_SIZE - nRecord), queued.pBuffer->size() - nOffset));
+                std::copy(queued.pBuffer->begin() + nOffset, queued.pBuffer->begin() + nOffset + nCopy, vRecord + nRecord);
+
+                nRecord += nCopy;
+                nOffset  = 0;
+
+                /* Stop once the record is full. */
+                if(nRecord == SEND_CHUNK_SIZE || nRecord >= nMaxBytes)
+                    break;
+            }
+
+            return static_cast<int32_t>(SSL_write(pSSL, (int8_t*)vRecord, std::min(nRecord, nMaxBytes)));
+        }
+
+    #ifdef WIN32
+        /* Gather the front buffers into one buffer array. */
+        WSABUF vBuffers[MAX_FLUSH_BUFFERS];
+        DWORD nBuffers = 0;
+
+        uint64_t nTotal  = 0;
+        uint64_t nOffset = nBufferSent;
+        for(const auto& queued : qBuffer)
+        {
+            const uint64_t nSize = std::min(static_cast<uint64_t>(nMaxBytes) - nTotal, queued.pBuffer->size() - nOffset);
+            vBuffers[nBuffers].buf = (char*)&(*queued.pBuffer)[nOffset];
+            vBuffers[nBuffers].len = static_cast<ULONG>(nSize);
+
+            nTotal  += nSize;
+            nOffset  = 0;
+
+            /* Stop once the buffer array or byte limit is reached. */
+            if(++nBuffers == MAX_FLUSH_BUFFERS || nTotal == nMaxBytes)
+                break;
+        }
+
+        DWORD nSent = 0;
+        if(WSASend(fd, vBuffers, nBuffers, &nSent, 0, nullptr, nullptr) == SOCKET_ERROR)
+            return -1;
+
+        return static_cast<int32_t>(nSent);
+    #else
+        /* Gather the front buffers so that they are sent with one system call. */
+        struct iovec vBuffers[MAX_FLUSH_BUFFERS];
+        uint32_t nBuffers = 0;
+
+        uint64_t nTotal  = 0;
+        uint64_t nOffset = nBufferSent;
+        for(const auto& queued : qBuffer)
+        {
+            const uint64_t nSize = std::min(static_cast<uint64_t>(nMaxBytes) - nTotal, queued.pBuffer->size() - nOffset);
+            vBuffers[nBuffers].iov_base = (void*)&(*queued.pBuffer)[nOffset];
+            vBuffers[nBuffers].iov_len  = nSize;
+
+            nTotal  += nSize;
+            nOffset  = 0;
+
+            /* Stop once the buffer array or byte limit is reached. */
+            if(++nBuffers == MAX_FLUSH_BUFFERS || nTotal == nMaxBytes)
+                break;
+        }
+
+        struct msghdr msg;
+        std::memset(&msg, 0, sizeof(msg));
+        msg.msg_iov    = vBuffers;
+        msg.msg_iovlen = nBuffers;
+
+        return static_cast<int32_t>(sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT));
+    #endif
+    }
+
+
+    /* Add a buffer to the back of the send queue, skipping the bytes already sent. */
+    void Socket::queue_buffer(const shared_buffer_t& pBuffer, const uint64_t nOffset)
+    {
+        /* Skip empty buffers. */
+        if(pBuffer->size() == nOffset)
+            return;
+
+        /* A partly sent buffer can only be shared at the front of the queue, otherwise copy what is left. */
+        if(nOffset > 0 && !qBuffer.empty())
+        {
+            queue_bytes(&(*pBuffer)[nOffset], pBuffer->size() - nOffset);
+            return;
+        }
+
+        /* Start the queue where the buffer was left. */
+        if(qBuffer.empty())
+            nBufferSent = nOffset;
+
+        /* Shared buffers can't be appended to, so small writes start a new chunk after this. */
+        qBuffer.push_back({ pBuffer, queue_timestamp() });
+        pChunk.reset();
+
+        nBuffered += (pBuffer->size() - nOffset);
+    }
+
+
+    /* Copy bytes to the back of the send queue. */
+    void Socket::queue_bytes(const uint8_t* pBegin, const uint64_t nSize)
+    {
+        /* Skip empty writes. */
+        if(nSize == 0)
+            return;
+
+        /* Large writes get a buffer of their own, so they are sent without being split. */
+        if(nSize >= SEND_CHUNK_SIZE)
+        {
+            qBuffer.push_back({ std::make_shared<const std::vector<uint8_t>>(pBegin, pBegin + nSize), queue_timestamp() });
+            pChunk.reset();
+        }
+        else
+        {
+            /* Start a new pooled chunk if the one at the back is full. */
+            if(!pChunk || pChunk->size() + nSize > SEND_CHUNK_SIZE)
+            {
+                pChunk = get_chunk();
+                qBuffer.push_back({ pChunk, queue_timestamp() });
+            }
+
+            /* Append to the chunk, which is never reallocated as it has the full capacity. */
+            pChunk->insert(pChunk->end(), pBegin, pBegin + nSize);
+        }
+
+        nBuffered += nSize;
+    }
+
+
+    /* Release sent bytes from the front of the queue and record how long they waited. */
+    void Socket::release_buffers(uint64_t nSent)
+    {
+        nBuffered -= nSent;
+
+        /* Pop every buffer that was fully sent. */
+        const uint64_t nNow = queue_timestamp();
+        while(nSent > 0 && !qBuffer.empty())
+        {
+            /* Move past the sent bytes if the front buffer is only partly sent. */
+            const uint64_t nFront = qBuffer.front().pBuffer->size() - nBufferSent;
+            if(nSent < nFront)
+            {
+                nBufferSent += nSent;
+                break;
+            }
+
+            /* Track the average and longest time buffers waited in the queue. */
+            const uint64_t nLatency = nNow - qBuffer.front().nQueued;
+            nFlushLatency    = (nFlushLatency.load() * 7 + nLatency) / 8;
+            nMaxFlushLatency = std::max(nMaxFlushLatency.load(), nLatency);
+
+            /* Release the front buffer. */
+            qBuffer.pop_front();
+            nBufferSent = 0;
+            nSent      -= nFront;
+        }
+
+        /* The pooled chunk can only be appended to while it is still queued. */
+        if(qBuffer.empty())
+            pChunk.reset();
+    }
+
+
     /*  Creates or destroys the SSL object depending on the flag set. */
     void Socket::SetSSL(bool fSSL)
     {
@@ -0,0 +1,671 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/include/global.h>
+
+#include <LLP/include/sync.h>
+
+#include <Legacy/types/legacy.h>
+
+#include <TAO/Ledger/include/process.h>
+#include <TAO/Ledger/types/tritium.h>
+
+#include <Util/include/args.h>
+#include <Util/include/debug.h>
+
+#include <algorithm>
+
+namespace LLP
+{
+
+    /* Get the hash of a sync block. */
+    static uint1024_t sync_hash(const TAO::Ledger::SyncBlock& block)
+    {
+        /* Check version switch. */
+        if(block.nVersion >= 7)
+            return TAO::Ledger::TritiumBlock(block).GetHash();
+
+        return Legacy::LegacyBlock(block).GetHash();
+    }
+
+
+    /* Default Constructor */
+    SyncManager::SyncManager()
+    : MUTEX         ( )
+    , fActive       (false)
+    , fProcessing   (false)
+    , fHeadersDone  (false)
+    , nHeaderSession(0)
+    , nHeadersTime  (0)
+    , hashHeaders   (0)
+    , nHeaderHeight (0)
+    , hashTip       (0)
+    , nTipHeight    (0)
+    , queueRanges   ( )
+    , vAssigned     ( )
+    , mapPeers      ( )
+    , mapBuffer     ( )
+    , nRangeSize    (250)
+    , nMaxBuffer    (2000)
+    , nStallTimeout (15)
+    {
+    }
+
+
+    /* Default Destructor */
+    SyncManager::~SyncManager()
+    {
+    }
+
+
+    /* Start a sync, listing block hashes from the given node. */
+    void SyncManager::Start(const uint64_t nSession)
+    {
+        LOCK(MUTEX);
+
+        /* Get the limits from the config. */
+        nRangeSize    = std::max(int64_t(1),  config::GetArg("-syncrange", 250));
+        nMaxBuffer    = std::max(int64_t(nRangeSize), config::GetArg("-syncbuffer", 2000));
+        nStallTimeout = std::max(int64_t(1),  config::GetArg("-syncstalltimeout", 15));
+
+        /* Clear the previous sync. */
+        queueRanges.clear();
+        vAssigned.clear();
+        mapBuffer.clear();
+
+        /* Reset the nodes, keeping the ones already added. */
+        for(auto& peer : mapPeers)
+        {
+            peer.second.nRanges = 0;
+            peer.second.nBlocks = 0;
+            peer.second.nStalls = 0;
+            peer.second.vPending.clear();
+        }
+
+        /* The sync node also downloads ranges. */
+        if(!mapPeers.count(nSession))
+            mapPeers[nSession] = SyncPeer{0, 0, 0, 0, std::vector<SyncRequest>()};
+
+        /* List the block hashes from a locator of the best chain. */
+        nHeaderSession = nSession;
+        nHeadersTime   = 0;
+        fHeadersDone   = false;
+        hashHeaders    = 0;
+        nHeaderHeight  = 0;
+        hashTip        = 0;
+        nTipHeight     = 0;
+        fActive        = true;
+
+        debug::log(0, FUNCTION, "Parallel sync started from session ", nSession, " [", mapPeers.size(), " peers]");
+    }
+
+
+    /* Stop the sync, and release the buffered blocks and the nodes. */
+    void SyncManager::Stop()
+    {
+        LOCK(MUTEX);
+
+        fActive        = false;
+        nHeaderSession = 0;
+
+        queueRanges.clear();
+        vAssigned.clear();
+        mapPeers.clear();
+        mapBuffer.clear();
+    }
+
+
+    /* Check if a sync is running. */
+    bool SyncManager::Active() const
+    {
+        LOCK(MUTEX);
+
+        return fActive;
+    }
+
+
+    /* Add a node that ranges can be assigned to. */
+    void SyncManager::AddPeer(const uint64_t nSession)
+    {
+        LOCK(MUTEX);
+
+        /* Check for duplicates. */
+        if(!fActive || mapPeers.count(nSession))
+            return;
+
+        mapPeers[nSession] = SyncPeer{0, 0, 0, 0, std::vector<SyncRequest>()};
+    }
+
+
+    /* Remove a node, returning its ranges to the queue. */
+    uint64_t SyncManager::RemovePeer(const uint64_t nSession)
+    {
+        LOCK(MUTEX);
+
+        /* Return the node's ranges to the queue. */
+        for(auto it = vAssigned.begin(); it != vAssigned.end(); )
+        {
+            if(it->nSession == nSession)
+            {
+                requeue(*it);
+                it = vAssigned.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        mapPeers.erase(nSession);
+
+        /* List the rest of the block hashes from the node that has stalled the least. */
+        if(fActive && nSession == nHeaderSession)
+            rotate();
+
+        return fActive ? nHeaderSession : 0;
+    }
+
+
+    /* Check if a node is taking part in the sync. */
+    bool SyncManager::HasPeer(const uint64_t nSession) const
+    {
+        LOCK(MUTEX);
+
+        return fActive && mapPeers.count(nSession);
+    }
+
+
+    /* Set the best height reported by a node. */
+    void SyncManager::SetHeight(const uint64_t nSession, const uint32_t nHeight)
+    {
+        LOCK(MUTEX);
+
+        /* Check for the node. */
+        auto it = mapPeers.find(nSession);
+        if(it != mapPeers.end())
+            it->second.nHeight = nHeight;
+    }
+
+
+    /* Add block hashes listed by the sync node, split into ranges. */
+    bool SyncManager::Headers(const uint64_t nSession, const uint1024_t& hashStart, const uint32_t nHeight,
+                              const std::vector<uint1024_t>& vHashes)
+    {
+        LOCK(MUTEX);
+
+        /* Check that the hashes are from the sync node. */
+        if(!fActive || nSession != nHeaderSession)
+            return false;
+
+        /* The first list starts from the common ancestor of the locator. */
+        if(hashHeaders == 0)
+        {
+            hashHeaders   = hashStart;
+            nHeaderHeight = nHeight;
+            hashTip       = hashStart;
+            nTipHeight    = nHeight;
+        }
+
+        /* Check that the list follows the last one. */
+        else if(hashStart != hashHeaders)
+            return false;
+
+        /* An empty list is the end of the chain. */
+        nHeadersTime = 0;
+        if(vHashes.empty())
+        {
+            /* Ask a node that reported a higher height if the sync node stopped short of it. */
+            for(const auto& peer : mapPeers)
+            {
+                if(peer.first == nSession || peer.second.nHeight <= nHeaderHeight || peer.second.nStalls >= MAX_STALLS)
+                    continue;
+
+                debug::log(0, FUNCTION, "Session ", nSession, " listed to height ", nHeaderHeight, " of ", peer.second.nHeight);
+
+                ++mapPeers[nSession].nStalls;
+                rotate();
+
+                return true;
+            }
+
+            fHeadersDone = true;
+            return true;
+        }
+
+        /* Split the hashes into ranges. */
+        for(uint32_t n = 0; n < vHashes.size(); n += nRangeSize)
+        {
+            const uint32_t nBlocks = std::min(nRangeSize, static_cast<uint32_t>(vHashes.size() - n));
+
+            SyncRange range;
+            range.hashStart   = hashHeaders;
+            range.hashStop    = vHashes[n + nBlocks - 1];
+            range.hashLast    = hashHeaders;
+            range.nHeightStop = nHeaderHeight + nBlocks;
+            range.nRemaining  = nBlocks;
+            range.nSession    = 0;
+            range.nLastTime   = 0;
+
+            queueRanges.push_back(range);
+
+            /* The next range starts from the end of this one. */
+            hashHeaders   = range.hashStop;
+            nHeaderHeight = range.nHeightStop;
+        }
+
+        debug::log(2, FUNCTION, "Listed ", vHashes.size(), " blocks to height ", nHeaderHeight, " [", queueRanges.size(), " ranges queued]");
+
+        return true;
+    }
+
+
+    /* Reassign stalled ranges, assign the queued ranges, and get the requests a node needs to send. */
+    std::vector<SyncRequest> SyncManager::Requests(const uint64_t nSession, const uint64_t nTimestamp)
+    {
+        LOCK(MUTEX);
+
+        std::vector<SyncRequest> vRequests;
+        if(!fActive)
+            return vRequests;
+
+        /* Update the assignments. */
+        schedule(nTimestamp);
+
+        /* Take the requests waiting for this node. */
+        auto it = mapPeers.find(nSession);
+        if(it != mapPeers.end())
+            vRequests.swap(it->second.vPending);
+
+        return vRequests;
+    }
+
+
+    /* Add a block received from a node to the reorder buffer. */
+    bool SyncManager::Receive(const uint64_t nSession, const TAO::Ledger::SyncBlock& block, const uint64_t nTimestamp)
+    {
+        /* Get the block hash before locking. */
+        const uint1024_t hashBlock = sync_hash(block);
+
+        LOCK(MUTEX);
+        if(!fActive)
+            return false;
+
+        /* Find the range this block continues. */
+        for(auto it = vAssigned.begin(); it != vAssigned.end(); ++it)
+        {
+            if(it->nSession != nSession || it->hashLast != block.hashPrevBlock)
+                continue;
+
+            /* Check the end of the range. */
+            SyncPeer& peer = mapPeers[nSession];
+            if(hashBlock == it->hashStop)
+            {
+                --peer.nRanges;
+                vAssigned.erase(it);
+            }
+            else if(--it->nRemaining == 0)
+            {
+                /* The node sent a different chain than the one that was listed. */
+                debug::error(FUNCTION, "range ", it->hashStop.SubString(), " from session ", nSession, " ended on ", hashBlock.SubString());
+
+                ++peer.nStalls;
+                restart();
+
+                return false;
+            }
+            else
+            {
+                it->hashLast  = hashBlock;
+                it->nLastTime = nTimestamp;
+            }
+
+            /* Hold the block until its previous block is processed. */
+            ++peer.nBlocks;
+            if(!mapBuffer.count(block.hashPrevBlock))
+                mapBuffer.emplace(block.hashPrevBlock, SyncEntry{nSession, hashBlock, block});
+
+            return true;
+        }
+
+        return false;
+    }
+
+
+    /* Process the buffered blocks that follow the last processed block. */
+    uint32_t SyncManager::Process()
+    {
+        /* Only one thread processes the buffer, the others leave their blocks for it. */
+        {
+            LOCK(MUTEX);
+            if(!fActive || fProcessing)
+                return 0;
+
+            fProcessing = true;
+        }
+
+        /* Process blocks while the next one is buffered. */
+        uint32_t nAccepted = 0;
+        while(true)
+        {
+            SyncEntry entry;
+            {
+                LOCK(MUTEX);
+
+                /* Checking for the next block and clearing the flag under one lock means no block is left behind. */
+                auto it = mapBuffer.find(hashTip);
+                if(!fActive || it == mapBuffer.end())
+                {
+                    fProcessing = false;
+                    break;
+                }
+
+                entry = std::move(it->second);
+                mapBuffer.erase(it);
+            }
+
+            /* The first block listed from a locator is already in the chain. */
+            uint8_t nStatus = 0;
+            if(LLD::Ledger->HasBlock(entry.hashBlock))
+                nStatus |= TAO::Ledger::PROCESS::DUPLICATE;
+
+            /* Check version switch. */
+            else if(entry.block.nVersion >= 7)
+            {
+                /* Build a tritium block from sync block. */
+                TAO::Ledger::TritiumBlock tritium(entry.block);
+
+                /* Verbose debug output. */
+                if(config::nVerbose >= 3)
+                    debug::log(3, FUNCTION, "processing sync block ", entry.hashBlock.SubString(), " height = ", entry.block.nHeight);
+
+                TAO::Ledger::Process(tritium, nStatus);
+            }
+            else
+            {
+                /* Build a legacy block from sync block. */
+                Legacy::LegacyBlock legacy(entry.block);
+
+                /* Verbose debug output. */
+                if(config::nVerbose >= 3)
+                    debug::log(3, FUNCTION, "processing sync block ", entry.hashBlock.SubString(), " height = ", entry.block.nHeight);
+
+                TAO::Ledger::Process(legacy, nStatus);
+            }
+
+            LOCK(MUTEX);
+
+            /* Move the tip forward. */
+            if(nStatus & (TAO::Ledger::PROCESS::ACCEPTED | TAO::Ledger::PROCESS::DUPLICATE))
+            {
+                hashTip    = entry.hashBlock;
+                nTipHeight = entry.block.nHeight;
+
+                if(nStatus & TAO::Ledger::PROCESS::ACCEPTED)
+                    ++nAccepted;
+
+                continue;
+            }
+
+            /* Stop taking ranges from the node that sent a bad block, and list again from the tip. */
+            debug::error(FUNCTION, "sync block ", entry.hashBlock.SubString(), " from session ", entry.nSession, " failed to process");
+            if(entry.nSession != nHeaderSession)
+                mapPeers.erase(entry.nSession);
+            else
+                ++mapPeers[nHeaderSession].nStalls;
+
+            restart();
+        }
+
+        return nAccepted;
+    }
+
+
+    /* Check if every listed block has been processed. */
+    bool SyncManager::Complete() const
+    {
+        LOCK(MUTEX);
+
+        return fActive && fHeadersDone && hashTip == hashHeaders
+            && queueRanges.empty() && vAssigned.empty() && mapBuffer.empty();
+    }
+
+
+    /* Get the height of the last block hash listed by the sync node. */
+    uint32_t SyncManager::Target() const
+    {
+        LOCK(MUTEX);
+
+        return nHeaderHeight;
+    }
+
+
+    /* Get the best height reported by the nodes. */
+    uint32_t SyncManager::BestHeight() const
+    {
+        LOCK(MUTEX);
+
+        uint32_t nBest = nHeaderHeight;
+        for(const auto& peer : mapPeers)
+            nBest = std::max(nBest, peer.second.nHeight);
+
+        return nBest;
+    }
+
+
+    /* Get the share of blocks received from each node since the last call. */
+    std::string SyncManager::Utilization()
+    {
+        LOCK(MUTEX);
+
+        /* Get the total blocks received. */
+        uint64_t nTotal = 0;
+        for(const auto& peer : mapPeers)
+            nTotal += peer.second.nBlocks;
+
+        /* Build the share for each node. */
+        std::string strPeers = debug::safe_printstr(mapPeers.size(), " peers");
+        for(auto& peer : mapPeers)
+        {
+            strPeers += debug::safe_printstr(" ", nTotal ? (peer.second.nBlocks * 100) / nTotal : 0, "%");
+            peer.second.nBlocks = 0;
+        }
+
+        return strPeers;
+    }
+
+
+    /* Reassign stalled ranges and assign the queued ranges. */
+    void SyncManager::schedule(const uint64_t nTimestamp)
+    {
+        /* Check for stalled ranges. */
+        for(auto it = vAssigned.begin(); it != vAssigned.end(); )
+        {
+            if(it->nLastTime + nStallTimeout >= nTimestamp)
+            {
+                ++it;
+                continue;
+            }
+
+            /* Count the stall against the node. */
+            auto itPeer = mapPeers.find(it->nSession);
+            if(itPeer != mapPeers.end())
+            {
+                SyncPeer& peer = itPeer->second;
+                --peer.nRanges;
+
+                /* Drop the request if the node hasn't sent it yet. */
+                const uint1024_t hashStop = it->hashStop;
+                peer.vPending.erase(std::remove_if(peer.vPending.begin(), peer.vPending.end(),
+                    [&hashStop](const SyncRequest& request) { return request.hashStop == hashStop; }), peer.vPending.end());
+
+                if(++peer.nStalls == MAX_STALLS)
+                    debug::log(0, FUNCTION, "Session ", it->nSession, " stalled ", static_cast<uint32_t>(MAX_STALLS), " times, no longer assigning ranges");
+            }
+
+            debug::log(0, FUNCTION, "Range to height ", it->nHeightStop, " stalled on session ", it->nSession, ", reassigning");
+
+            requeue(*it);
+            it = vAssigned.erase(it);
+        }
+
+        /* Ask another node for the block hashes if the request timed out. */
+        if(nHeadersTime != 0 && nHeadersTime + nStallTimeout < nTimestamp)
+        {
+            debug::log(0, FUNCTION, "Block hashes stalled on session ", nHeaderSession);
+
+            auto itPeer = mapPeers.find(nHeaderSession);
+            if(itPeer != mapPeers.end())
+                ++itPeer->second.nStalls;
+
+            rotate();
+        }
+
+        /* Get the blocks buffered or on their way. */
+        uint64_t nBuffered = mapBuffer.size();
+        for(const auto& range : vAssigned)
+            nBuffered += range.nRemaining;
+
+        /* Assign ranges in chain order while the buffer has room. */
+        while(!queueRanges.empty())
+        {
+            SyncRange& range = queueRanges.front();
+            if(nBuffered + range.nRemaining > nMaxBuffer)
+                break;
+
+            /* Find the least busy node that has the range. */
+            auto itBest = mapPeers.end();
+            for(auto it = mapPeers.begin(); it != mapPeers.end(); ++it)
+            {
+                const SyncPeer& peer = it->second;
+                if(peer.nRanges >= MAX_RANGES || peer.nStalls >= MAX_STALLS || peer.nHeight < range.nHeightStop)
+                    continue;
+
+                if(itBest == mapPeers.end() || peer.nRanges + peer.nStalls < itBest->second.nRanges + itBest->second.nStalls)
+                    itBest = it;
+            }
+
+            /* Wait for a node to become free. */
+            if(itBest == mapPeers.end())
+                break;
+
+            /* Assign the range. */
+            range.nSession  = itBest->first;
+            range.nLastTime = nTimestamp;
+
+            ++itBest->second.nRanges;
+            itBest->second.vPending.push_back(SyncRequest{range.nSession, range.hashStart, range.hashStop, false});
+
+            nBuffered += range.nRemaining;
+
+            vAssigned.push_back(range);
+            queueRanges.pop_front();
+        }
+
+        /* Get the blocks waiting for a node. */
+        uint64_t nQueued = 0;
+        for(const auto& range : queueRanges)
+            nQueued += range.nRemaining;
+
+        /* List more block hashes when the queue runs low. */
+        if(!fHeadersDone && nHeadersTime == 0 && nQueued < nMaxBuffer && mapPeers.count(nHeaderSession))
+        {
+            mapPeers[nHeaderSession].vPending.push_back(SyncRequest{nHeaderSession, hashHeaders, 0, true});
+            nHeadersTime = nTimestamp;
+        }
+    }
+
+
+    /* Return a range to the queue in chain order, from its last received block. */
+    void SyncManager::requeue(const SyncRange& range)
+    {
+        /* Get the range that is left. */
+        SyncRange rangeLeft = range;
+        rangeLeft.hashStart = range.hashLast;
+        rangeLeft.nSession  = 0;
+        rangeLeft.nLastTime = 0;
+
+        /* Insert before the first range that ends later. */
+        auto it = queueRanges.begin();
+        while(it != queueRanges.end() && it->nHeightStop < rangeLeft.nHeightStop)
+            ++it;
+
+        queueRanges.insert(it, rangeLeft);
+    }
+
+
+    /* Drop the ranges and buffered blocks, and list the block hashes again from the last processed block. */
+    void SyncManager::restart()
+    {
+        debug::log(0, FUNCTION, "Restarting parallel sync from height ", nTipHeight);
+
+        /* Release the assignments. */
+        for(auto& peer : mapPeers)
+        {
+            peer.second.nRanges = 0;
+            peer.second.vPending.clear();
+        }
+
+        queueRanges.clear();
+        vAssigned.clear();
+        mapBuffer.clear();
+
+        /* List again from the tip, from another node if the sync node keeps stalling. */
+        hashHeaders   = hashTip;
+        nHeaderHeight = nTipHeight;
+        nHeadersTime  = 0;
+        fHeadersDone  = false;
+
+        auto it = mapPeers.find(nHeaderSession);
+        if(it == mapPeers.end() || it->second.nStalls >= MAX_STALLS)
+            rotate();
+    }
+
+
+    /* List the block hashes from the node that has stalled the least, other than the sync node. */
+    void SyncManager::rotate()
+    {
+        /* Find the node with the fewest stalls, then the highest height. */
+        auto itBest = mapPeers.end();
+        for(auto it = mapPeers.begin(); it != mapPeers.end(); ++it)
+        {
+            if(it->first == nHeaderSession)
+                continue;
+
+            if(itBest == mapPeers.end() || it->second.nStalls < itBest->second.nStalls
+            || (it->second.nStalls == itBest->second.nStalls && it->second.nHeight > itBest->second.nHeight))
+                itBest = it;
+        }
+
+        /* Send the outstanding request again. */
+        nHeadersTime = 0;
+
+        /* Keep the sync node if it is the only one left. */
+        if(itBest == mapPeers.end())
+        {
+            if(!mapPeers.count(nHeaderSession))
+                nHeaderSession = 0;
+
+            return;
+        }
+
+        /* Drop the request if the old sync node hasn't sent it yet. */
+        auto itOld = mapPeers.find(nHeaderSession);
+        if(itOld != mapPeers.end())
+        {
+            std::vector<SyncRequest>& vPending = itOld->second.vPending;
+            vPending.erase(std::remove_if(vPending.begin(), vPending.end(),
+                [](const SyncRequest& request) { return request.fHeaders; }), vPending.end());
+        }
+
+        nHeaderSession = itBest->first;
+        debug::log(0, FUNCTION, "Listing block hashes from session ", nHeaderSession);
+    }
+}
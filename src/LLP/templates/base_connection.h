@@ -30,6 +30,7 @@ namespace LLP
 
     /* Forward declarations. */
     class DDOS_Filter;
+    struct ServerMetrics;
 
 
     /** BaseConnection
@@ -108,6 +109,14 @@ namespace LLP
         int32_t nDataIndex;
 
 
+        /** Flags for the packet handed to the processor pool, see PROCESSING in data.h. **/
+        std::atomic<uint8_t> nProcessing;
+
+
+        /** Bytes read when the last packet was processed, for the bytes of each message in the server metrics. **/
+        uint64_t nReadMark;
+
+
         /** Condition variable pointer from data thread. **/
         std::condition_variable* FLUSH_CONDITION;
 
@@ -169,15 +178,49 @@ namespace LLP
         static std::string Name() { return "Base"; }
 
 
-        /** Notifications
+        /** MessageName
+         *
+         *  Returns the name of the incoming packet's message type, for the server metrics.
+         *  Must be called after the packet is processed and before it is reset.
+         *
+         **/
+        std::string MessageName() const { return "packet"; }
+
+
+        /** PacketBuffered
+         *
+         *  Returns true if another packet may already be in the read buffer, such as pipelined
+         *  requests, so the data thread reads the connection again without waiting on the socket.
+         *
+         **/
+        bool PacketBuffered() const { return false; }
+
+
+        /** AddMetrics
+         *
+         *  Adds counters kept by this type of Node to the server metrics.
+         *
+         *  @param[out] metrics The server metrics to add to.
+         *
+         **/
+        static void AddMetrics(ServerMetrics& metrics) { }
+
+
+        /** RelayFilter
          *
          *  Filter out relay requests with notifications node is subscribed to.
          *
+         *  @param[in] message The message being relayed.
+         *  @param[in] ssData The data being relayed.
+         *  @param[out] ssRelay The filtered data to relay, empty to skip the relay.
+         *
+         *  @return True to relay the data unchanged, without filtering.
+         *
          **/
         template<typename MessageType>
-        const DataStream RelayFilter(const MessageType& message, const DataStream& ssData) const
+        bool RelayFilter(const MessageType& message, const DataStream& ssData, DataStream& ssRelay) const
         {
-            return ssData; //copy over relay like normal for all items to be relayed
+            return true; //relay like normal for all items to be relayed
         }
 
 
@@ -283,6 +326,18 @@ namespace LLP
         void WritePacket(const PacketType& PACKET);
 
 
+        /** WriteShared
+         *
+         *  Write a serialized packet shared with other connections to the TCP stream.
+         *  The buffers are sent by reference, and never copied for this connection.
+         *
+         *  @param[in] pHeader The serialized packet header.
+         *  @param[in] pData The packet payload.
+         *
+         **/
+        void WriteShared(const shared_buffer_t& pHeader, const shared_buffer_t& pData);
+
+
         /** ReadPacket
          *
          *  Non-Blocking Packet reader to build a packet from TCP Connection.
@@ -40,6 +40,8 @@ namespace LLP
     class Socket;
     class DDOS_Filter;
     class BaseAddress;
+    class ProcessorPool;
+    class Metrics;
 
 
     /* Flags for connection count. */
@@ -54,6 +56,17 @@ namespace LLP
     }
 
 
+    /* Flags for a packet handed to the processor pool. */
+    namespace PROCESSING
+    {
+        enum
+        {
+            BUSY   = (1 << 0),
+            FAILED = (1 << 1),
+        };
+    }
+
+
     /** DataThread
      *
      *  Base Template Thread Class for Server base. Used for Core LLP Packet Functionality.
@@ -68,6 +81,14 @@ namespace LLP
         std::mutex SLOT_MUTEX;
 
 
+        /** Slots added since the data thread last checked, for it to schedule on its timer wheel. Locked by SLOT_MUTEX. **/
+        std::vector<uint32_t> EPOLL_PENDING;
+
+
+        /** Slots whose packet the processor pool has finished, for the data thread to read again. Locked by SLOT_MUTEX. **/
+        std::vector<uint32_t> EPOLL_RESUME;
+
+
     public:
 
         /* Variables to track Connection / Request Count. */
@@ -85,6 +106,22 @@ namespace LLP
         uint32_t DDOS_cSCORE;
 
 
+        /** The epoll file descriptor for the epoll backend, or -1 when polling. **/
+        int32_t EPOLL_FD;
+
+
+        /** The processor pool that completed packets are handed to, or nullptr to process them on the data thread. **/
+        ProcessorPool* PROCESSOR;
+
+
+        /** The metrics that processed packets are recorded to, or nullptr if they aren't collected. **/
+        Metrics* METRICS;
+
+
+        /** The pipe processor threads write to when a packet is finished, waking the data thread. **/
+        std::pair<int32_t, int32_t> WAKE_PIPE;
+
+
         /* Vector to store Connections. */
         memory::atomic_ptr< std::vector< memory::atomic_ptr<ProtocolType>> > CONNECTIONS;
 
@@ -113,7 +150,8 @@ namespace LLP
          *
          **/
         DataThread<ProtocolType>(uint32_t nID, bool ffDDOSIn, uint32_t rScore, uint32_t cScore,
-                                 uint32_t nTimeout, bool fMeter = false);
+                                 uint32_t nTimeout, bool fMeter = false, ProcessorPool* pProcessor = nullptr,
+                                 Metrics* pMetrics = nullptr);
 
 
         /** Default Destructor
@@ -161,6 +199,9 @@ namespace LLP
                     memory::atomic_ptr<ProtocolType>& CONNECTION = CONNECTIONS->at(nSlot);
                     CONNECTION->Event(EVENTS::CONNECT);
 
+                    /* Watch the socket for the epoll backend. */
+                    add_event(nSlot);
+
                     /* Iterate the DDOS cScore (Connection score). */
                     if(DDOS)
                         DDOS -> cSCORE += 1;
@@ -233,6 +274,9 @@ namespace LLP
                     memory::atomic_ptr<ProtocolType>& CONNECTION = CONNECTIONS->at(nSlot);
                     CONNECTION->Event(EVENTS::CONNECT);
 
+                    /* Watch the socket for the epoll backend. */
+                    add_event(nSlot);
+
                     /* Check for inbound socket. */
                     if(CONNECTION->Incoming())
                         ++nIncoming;
@@ -367,6 +411,125 @@ namespace LLP
          **/
         uint32_t find_slot();
 
+
+        /** open_epoll
+         *
+         *  Opens the epoll file descriptor when -llpbackend=epoll is set and supported.
+         *
+         *  @return The epoll file descriptor, or -1 to poll the connections.
+         *
+         **/
+        int32_t open_epoll();
+
+
+        /** add_event
+         *
+         *  Registers a new connection's socket with the epoll backend, edge triggered.
+         *  Must be called while holding SLOT_MUTEX.
+         *
+         *  @param[in] nSlot The index of the connection to watch.
+         *
+         **/
+        void add_event(const uint32_t nSlot);
+
+
+        /** open_wake
+         *
+         *  Opens the pipe that processor threads use to wake the data thread, when there is a processor pool.
+         *
+         *  @return The read and write ends of the pipe, or -1 if there is none.
+         *
+         **/
+        std::pair<int32_t, int32_t> open_wake();
+
+
+        /** wake
+         *
+         *  Wakes the data thread to read a connection again once the processor pool has finished its packet.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *
+         **/
+        void wake(const uint32_t nIndex);
+
+
+        /** epoll_thread
+         *
+         *  Data thread loop for the epoll backend. Only connections with events are read,
+         *  while timeouts and generic events are driven by a timer wheel.
+         *
+         **/
+        void epoll_thread();
+
+
+        /** check_connection
+         *
+         *  Checks a connection for errors, timeouts, stalled or overflowed buffers and DDOS scores.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *  @param[in] CONNECTION The connection to check.
+         *
+         *  @return False if the connection was disconnected.
+         *
+         **/
+        bool check_connection(const uint32_t nIndex, ProtocolType* CONNECTION);
+
+
+        /** pending_connection
+         *
+         *  Checks if a connection has a packet with the processor pool, and disconnects it
+         *  once the pool has finished a packet that failed.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *  @param[in] CONNECTION The connection to check.
+         *
+         *  @return True if the connection should be skipped.
+         *
+         **/
+        bool pending_connection(const uint32_t nIndex, ProtocolType* CONNECTION);
+
+
+        /** dispatch_connection
+         *
+         *  Hands a connection's completed packet to the processor pool. The data thread
+         *  doesn't touch the connection again until the pool has finished with it, which
+         *  keeps the packets of each connection in order.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *  @param[in] CONNECTION The connection with the completed packet.
+         *
+         *  @return False if the pool is stopped, and the packet should be processed on the data thread.
+         *
+         **/
+        bool dispatch_connection(const uint32_t nIndex, ProtocolType* CONNECTION);
+
+
+        /** read_connection
+         *
+         *  Reads from a connection and processes its packet once complete, or hands
+         *  it to the processor pool if there is one.
+         *
+         *  @param[in] nIndex The data thread index of the connection.
+         *  @param[in] CONNECTION The connection to read.
+         *
+         *  @return False if the connection was disconnected.
+         *
+         **/
+        bool read_connection(const uint32_t nIndex, ProtocolType* CONNECTION);
+
+
+        /** process_connection
+         *
+         *  Processes a connection's completed packet and fires the processed event,
+         *  recording the packet's type, bytes and processing time in the server metrics.
+         *
+         *  @param[in] CONNECTION The connection with the completed packet.
+         *
+         *  @return False if the packet failed, and the connection should be disconnected.
+         *
+         **/
+        bool process_connection(ProtocolType* CONNECTION);
+
     };
 }
 
@@ -19,6 +19,7 @@ ________________________________________________________________________________
 #include <LLP/templates/data.h>
 #include <LLP/include/legacy_address.h>
 #include <LLP/include/manager.h>
+#include <LLP/include/metrics.h>
 #include <LLP/include/server_config.h>
 
 #include <map>
@@ -35,6 +36,7 @@ namespace LLP
     class AddressManager;
     class DDOS_Filter;
     class InfoAddress;
+    class ProcessorPool;
     typedef struct ssl_st SSL;
 
 
@@ -96,6 +98,14 @@ namespace LLP
         std::vector<DataThread<ProtocolType> *> DATA_THREADS;
 
 
+        /** The processor pool shared by the data threads, or nullptr if they process their own packets. **/
+        ProcessorPool* PROCESSOR;
+
+
+        /** The metrics of each message type, or nullptr if they aren't collected. **/
+        Metrics* METRICS;
+
+
         /** condition variable for manager thread. **/
         std::condition_variable MANAGER;
 
@@ -282,6 +292,16 @@ namespace LLP
         uint32_t GetConnectionCount(const uint8_t nFlags = FLAGS::ALL);
 
 
+        /** GetMetrics
+         *
+         *  Get a snapshot of the message metrics, queues and send buffers of this server.
+         *
+         *  @return Returns the server metrics.
+         *
+         **/
+        ServerMetrics GetMetrics();
+
+
         /** Get Connection
          *
          *  Select a random and currently open connection
@@ -19,6 +19,8 @@ ________________________________________________________________________________
 #include <LLP/include/base_address.h>
 
 #include <vector>
+#include <deque>
+#include <memory>
 #include <cstdint>
 #include <mutex>
 #include <atomic>
@@ -34,6 +36,38 @@ namespace LLP
     const uint64_t MAX_SEND_BUFFER = 3 * 1024 * 1024; //3MB max send buffer
 
 
+    /** Size of the pooled chunks that small writes are copied into while a socket is backed up. **/
+    const uint32_t SEND_CHUNK_SIZE = 16 * 1024; //16Kb matches a TLS record
+
+
+    /** Max bytes to send with one flush. **/
+    const uint32_t MAX_FLUSH_SIZE = 256 * 1024; //256Kb per flush
+
+
+    /** Max queued buffers to gather into one flush. **/
+    const uint32_t MAX_FLUSH_BUFFERS = 64;
+
+
+    /** Immutable bytes that can be queued on many sockets without copying. **/
+    typedef std::shared_ptr<const std::vector<uint8_t>> shared_buffer_t;
+
+
+    /** QueuedBuffer
+     *
+     *  A buffer waiting in a socket send queue, with the time it was queued.
+     *
+     **/
+    struct QueuedBuffer
+    {
+        /** The bytes to send. **/
+        shared_buffer_t pBuffer;
+
+
+        /** The time in microseconds that the buffer was queued. **/
+        uint64_t nQueued;
+    };
+
+
     /** Socket
      *
      *  Base Template class to handle outgoing / incoming LLP data for both
@@ -68,14 +102,42 @@ namespace LLP
         std::atomic<int32_t> nError;
 
 
-        /** Oversize buffer for large packets. **/
-        std::vector<uint8_t> vBuffer;
+        /** Queue of buffers waiting to be sent. Buffers may be shared with other sockets, so are never modified. **/
+        std::deque<QueuedBuffer> qBuffer;
+
+
+        /** The pooled chunk at the back of the queue that small writes are appended to, if any. **/
+        std::shared_ptr<std::vector<uint8_t>> pChunk;
+
+
+        /** The bytes already sent from the front buffer of the queue. **/
+        uint64_t nBufferSent;
+
+
+        /** The total bytes waiting to be sent. **/
+        std::atomic<uint64_t> nBuffered;
 
 
         /** Flag to catch if buffer write failed. **/
         std::atomic<bool> fBufferFull;
 
 
+        /** The average time in microseconds that queued buffers waited to be sent. **/
+        std::atomic<uint64_t> nFlushLatency;
+
+
+        /** The longest time in microseconds that a queued buffer waited to be sent. **/
+        std::atomic<uint64_t> nMaxFlushLatency;
+
+
+        /** The total bytes read from the socket. **/
+        std::atomic<uint64_t> nBytesRead;
+
+
+        /** The total bytes written to the socket, including bytes still queued. **/
+        std::atomic<uint64_t> nBytesWritten;
+
+
     public:
 
 
@@ -192,6 +254,19 @@ namespace LLP
         int32_t Read(std::vector<int8_t>& vchData, size_t nBytes);
 
 
+        /** Read
+         *
+         *  Read data from the socket buffer non-blocking
+         *
+         *  @param[out] pData The memory to read into, with room for nBytes
+         *  @param[in] nBytes The total bytes to read
+         *
+         *  @return the total bytes that were read
+         *
+         **/
+        int32_t Read(int8_t* pData, size_t nBytes);
+
+
         /** Write
          *
          *  Write data into the socket buffer non-blocking
@@ -205,6 +280,20 @@ namespace LLP
         int32_t Write(const std::vector<uint8_t>& vData, size_t nBytes);
 
 
+        /** Write
+         *
+         *  Write a header and payload in one gather write, non-blocking.
+         *  Any bytes not sent are queued by reference, so shared buffers are never copied.
+         *
+         *  @param[in] pHeader The header bytes to be written.
+         *  @param[in] pData The payload bytes to be written.
+         *
+         *  @return the total bytes that were written
+         *
+         **/
+        int32_t Write(const shared_buffer_t& pHeader, const shared_buffer_t& pData);
+
+
         /** Flush
          *
          *  Flushes data out of the overflow buffer
@@ -234,6 +323,38 @@ namespace LLP
         uint64_t Buffered() const;
 
 
+        /** FlushLatency
+         *
+         *  Get the average time in microseconds that queued buffers waited to be sent.
+         *
+         **/
+        uint64_t FlushLatency() const;
+
+
+        /** MaxFlushLatency
+         *
+         *  Get the longest time in microseconds that a queued buffer waited to be sent.
+         *
+         **/
+        uint64_t MaxFlushLatency() const;
+
+
+        /** BytesRead
+         *
+         *  Get the total bytes read from the socket.
+         *
+         **/
+        uint64_t BytesRead() const;
+
+
+        /** BytesWritten
+         *
+         *  Get the total bytes written to the socket, including bytes still queued.
+         *
+         **/
+        uint64_t BytesWritten() const;
+
+
         /** IsNull
          *
          *  Checks if is in null state.
@@ -287,6 +408,69 @@ namespace LLP
          **/
         int32_t error_code() const;
 
+
+        /** send_buffers
+         *
+         *  Send a header and payload with a single gather write, or one after the other with SSL.
+         *  Must be called while holding the socket lock.
+         *
+         *  @param[in] vHeader The header bytes to send.
+         *  @param[in] vData The payload bytes to send.
+         *
+         *  @return the total bytes that were sent, or negative on error
+         *
+         **/
+        int32_t send_buffers(const std::vector<uint8_t>& vHeader, const std::vector<uint8_t>& vData);
+
+
+        /** send_queue
+         *
+         *  Send from the front of the queue, gathering as many buffers as allowed into one write.
+         *  Small buffers are joined into one record with SSL, which has no gather write.
+         *  Must be called while holding the data and socket locks.
+         *
+         *  @param[in] nMaxBytes The maximum bytes to send.
+         *
+         *  @return the total bytes that were sent, or negative on error
+         *
+         **/
+        int32_t send_queue(const uint32_t nMaxBytes);
+
+
+        /** queue_buffer
+         *
+         *  Add a buffer to the back of the send queue, skipping the bytes already sent.
+         *  Must be called while holding the data lock.
+         *
+         *  @param[in] pBuffer The buffer to queue.
+         *  @param[in] nOffset The bytes of the buffer already sent.
+         *
+         **/
+        void queue_buffer(const shared_buffer_t& pBuffer, const uint64_t nOffset);
+
+
+        /** queue_bytes
+         *
+         *  Copy bytes to the back of the send queue. Small writes are appended to pooled chunks.
+         *  Must be called while holding the data lock.
+         *
+         *  @param[in] pBegin The first byte to queue.
+         *  @param[in] nSize The total bytes to queue.
+         *
+         **/
+        void queue_bytes(const uint8_t* pBegin, const uint64_t nSize);
+
+
+        /** release_buffers
+         *
+         *  Release sent bytes from the front of the queue and record how long they waited.
+         *  Must be called while holding the data lock.
+         *
+         *  @param[in] nSent The total bytes that were sent.
+         *
+         **/
+        void release_buffers(uint64_t nSent);
+
     };
 
 }
@@ -14,11 +14,11 @@ ________________________________________________________________________________
 #include <LLC/include/random.h>
 
 #include <LLD/include/global.h>
-#include <LLD/cache/binary_key.h>
 
 #include <LLP/types/tritium.h>
 #include <LLP/include/global.h>
 #include <LLP/include/manager.h>
+#include <LLP/include/metrics.h>
 #include <LLP/templates/events.h>
 
 #include <TAO/API/include/global.h>
@@ -36,6 +36,7 @@ ________________________________________________________________________________
 #include <TAO/Ledger/include/process.h>
 
 #include <TAO/Ledger/types/client.h>
+#include <TAO/Ledger/types/compactblock.h>
 #include <TAO/Ledger/types/locator.h>
 #include <TAO/Ledger/types/mempool.h>
 #include <TAO/Ledger/types/merkle.h>
@@ -94,6 +95,10 @@ namespace LLP
     std::atomic<uint64_t> TritiumNode::nLastTimeReceived(0);
 
 
+    /* Downloads blocks from more than one node during sync. */
+    SyncManager TritiumNode::SYNC;
+
+
     /* Remaining time left to finish syncing. */
     std::atomic<uint64_t> TritiumNode::nRemainingTime(0);
 
@@ -102,8 +107,13 @@ namespace LLP
     LLP::BaseAddress TritiumNode::thisAddress;
 
 
-    /* The local relay inventory cache. */
-    static LLD::KeyLRU cacheInventory = LLD::KeyLRU(1024 * 1024);
+    /* Inventory items relayed to nodes. */
+    std::atomic<uint64_t> TritiumNode::nRelayedInventory(0);
+
+
+    /* Inventory items not relayed as the node was known to have them. */
+    std::atomic<uint64_t> TritiumNode::nFilteredInventory(0);
+
 
     /** Mutex for controlling access to the p2p requests map. **/
     std::mutex TritiumNode::P2P_REQUESTS_MUTEX;
@@ -120,12 +130,17 @@ namespace LLP
     , fInitialized(false)
     , nSubscriptions(0)
     , nNotifications(0)
+    , setCompactRequests()
+    , filterInventory(config::GetArg("-inventoryfilter", 16384))
     , nLastPing(0)
     , nLastSamples(0)
     , mapLatencyTracker()
     , hashGenesis(0)
     , nTrust(0)
     , nProtocolVersion(0)
+    , fCompactBlocks(false)
+    , fSyncHeaders(false)
+    , fCompression(false)
     , nCurrentSession(0)
     , nCurrentHeight(0)
     , hashCheckpoint(0)
@@ -148,12 +163,17 @@ namespace LLP
     , fInitialized(false)
     , nSubscriptions(0)
     , nNotifications(0)
+    , setCompactRequests()
+    , filterInventory(config::GetArg("-inventoryfilter", 16384))
     , nLastPing(0)
     , nLastSamples(0)
     , mapLatencyTracker()
     , hashGenesis(0)
     , nTrust(0)
     , nProtocolVersion(0)
+    , fCompactBlocks(false)
+    , fSyncHeaders(false)
+    , fCompression(false)
     , nCurrentSession(0)
     , nCurrentHeight(0)
     , hashCheckpoint(0)
@@ -176,12 +196,17 @@ namespace LLP
     , fInitialized(false)
     , nSubscriptions(0)
     , nNotifications(0)
+    , setCompactRequests()
+    , filterInventory(config::GetArg("-inventoryfilter", 16384))
     , nLastPing(0)
     , nLastSamples(0)
     , mapLatencyTracker()
     , hashGenesis(0)
     , nTrust(0)
     , nProtocolVersion(0)
+    , fCompactBlocks(false)
+    , fSyncHeaders(false)
+    , fCompression(false)
     , nCurrentSession(0)
     , nCurrentHeight(0)
     , hashCheckpoint(0)
@@ -216,7 +241,10 @@ namespace LLP
 
                 /* Respond with version message if incoming connection. */
                 if(fOUTGOING)
-                    PushMessage(ACTION::VERSION, PROTOCOL_VERSION, SESSION_ID, version::CLIENT_VERSION_BUILD_STRING);
+                    PushMessage(ACTION::VERSION, PROTOCOL_VERSION, SESSION_ID, version::CLIENT_VERSION_BUILD_STRING,
+                        uint8_t(config::GetBoolArg("-compactblocks", true) ? SPECIFIER::COMPACT : 0),
+                        uint8_t(!config::fClient.load() && config::GetBoolArg("-parallelsync", true) ? SPECIFIER::HEADERS : 0),
+                        uint8_t(config::GetBoolArg("-compression", true) ? SPECIFIER::COMPRESSED : 0));
 
                 break;
             }
@@ -345,6 +373,11 @@ namespace LLP
                 }
 
 
+                /* Send the parallel sync requests, which also reassigns stalled ranges. */
+                if(SYNC.HasPeer(nCurrentSession))
+                    SyncRequests();
+
+
                 /* Unreliabilitiy re-requesting (max time since getblocks) */
                 if(TAO::Ledger::ChainState::Synchronizing()
                 && nCurrentSession == TAO::Ledger::nSyncSession.load()
@@ -425,9 +458,24 @@ namespace LLP
                     /* Debug output for node disconnect. */
                     debug::log(0, NODE, "Sync Node Disconnected (", strReason, ")");
 
-                    SwitchNode();
+                    /* Hand a parallel sync to another node, or switch nodes. */
+                    const uint64_t nSession = SYNC.RemovePeer(nCurrentSession);
+                    if(nSession != 0)
+                    {
+                        /* Set the sync session-id. */
+                        TAO::Ledger::nSyncSession.store(nSession);
+
+                        /* Reset last time received. */
+                        nLastTimeReceived.store(runtime::timestamp());
+                    }
+                    else
+                        SwitchNode();
                 }
 
+                /* Return the ranges assigned to this node. */
+                else
+                    SYNC.RemovePeer(nCurrentSession);
+
 
                 {
                     LOCK(SESSIONS_MUTEX);
@@ -456,6 +504,18 @@ namespace LLP
     /** Main message handler once a packet is recieved. **/
     bool TritiumNode::ProcessPacket()
     {
+        /* Decompress the payload, which is only compressed if we asked for it in our version message. */
+        if(INCOMING.FLAGS & MessagePacket::COMPRESSED)
+        {
+            /* Check that compression is enabled. */
+            if(!config::GetBoolArg("-compression", true))
+                return debug::drop(NODE, "compressed packet without compression");
+
+            /* Check the decompressed payload. */
+            if(!INCOMING.Decompress())
+                return debug::drop(NODE, "invalid compressed packet");
+        }
+
         /* Deserialize the packeet from incoming packet payload. */
         DataStream ssPacket(INCOMING.DATA, SER_NETWORK, PROTOCOL_VERSION);
         switch(INCOMING.MESSAGE)
@@ -476,6 +536,25 @@ namespace LLP
                 /* Get the version string. */
                 ssPacket >> strFullVersion;
 
+                /* Check the features the node supports. Older nodes don't send specifiers, and ignore ours. */
+                while(!ssPacket.End())
+                {
+                    uint8_t nSpecifier = 0;
+                    ssPacket >> nSpecifier;
+
+                    /* Check if the node relays compact blocks. */
+                    if(nSpecifier == SPECIFIER::COMPACT)
+                        fCompactBlocks = config::GetBoolArg("-compactblocks", true);
+
+                    /* Check if the node lists block hashes for parallel sync. */
+                    else if(nSpecifier == SPECIFIER::HEADERS)
+                        fSyncHeaders = !config::fClient.load() && config::GetBoolArg("-parallelsync", true);
+
+                    /* Check if the node decompresses payloads. */
+                    else if(nSpecifier == SPECIFIER::COMPRESSED)
+                        fCompression = config::GetBoolArg("-compression", true);
+                }
+
                 /* Check for invalid session-id. */
                 if(nCurrentSession == 0)
                     return debug::drop(NODE, "invalid session-id");
@@ -515,7 +594,10 @@ namespace LLP
                     PushMessage(ACTION::VERSION,
                         PROTOCOL_VERSION,
                         SESSION_ID,
-                        version::CLIENT_VERSION_BUILD_STRING);
+                        version::CLIENT_VERSION_BUILD_STRING,
+                        uint8_t(config::GetBoolArg("-compactblocks", true) ? SPECIFIER::COMPACT : 0),
+                        uint8_t(!config::fClient.load() && config::GetBoolArg("-parallelsync", true) ? SPECIFIER::HEADERS : 0),
+                        uint8_t(config::GetBoolArg("-compression", true) ? SPECIFIER::COMPRESSED : 0));
 
                     /* Add to address manager. */
                     if(TRITIUM_SERVER->GetAddressManager())
@@ -561,17 +643,43 @@ namespace LLP
                         /* Make sure the sync timer is stopped.  We don't start this until we receive our first sync block*/
                         SYNCTIMER.Stop();
 
-                        /* Subscribe to this node. */
-                        Subscribe(SUBSCRIPTION::LASTINDEX | SUBSCRIPTION::BESTCHAIN | SUBSCRIPTION::BESTHEIGHT);
+                        /* List the block hashes from this node, and download the blocks from every node that can list them. */
+                        if(fSyncHeaders)
+                        {
+                            /* Subscribe to this node. */
+                            Subscribe(SUBSCRIPTION::BESTCHAIN | SUBSCRIPTION::BESTHEIGHT);
+
+                            /* Start the parallel sync. */
+                            SYNC.Start(nCurrentSession);
+                            SyncRequests();
+                        }
+                        else
+                        {
+                            /* Blocks only come from this node. */
+                            SYNC.Stop();
 
-                        /* Ask for list of blocks if this is current sync node. */
-                        PushMessage(ACTION::LIST,
-                            config::fClient.load() ? uint8_t(SPECIFIER::CLIENT) : uint8_t(SPECIFIER::SYNC),
-                            uint8_t(TYPES::BLOCK),
-                            uint8_t(TYPES::LOCATOR),
-                            TAO::Ledger::Locator(TAO::Ledger::ChainState::hashBestChain.load()),
-                            uint1024_t(0)
-                        );
+                            /* Subscribe to this node. */
+                            Subscribe(SUBSCRIPTION::LASTINDEX | SUBSCRIPTION::BESTCHAIN | SUBSCRIPTION::BESTHEIGHT);
+
+                            /* Ask for list of blocks if this is current sync node. */
+                            PushMessage(ACTION::LIST,
+                                config::fClient.load() ? uint8_t(SPECIFIER::CLIENT) : uint8_t(SPECIFIER::SYNC),
+                                uint8_t(TYPES::BLOCK),
+                                uint8_t(TYPES::LOCATOR),
+                                TAO::Ledger::Locator(TAO::Ledger::ChainState::hashBestChain.load()),
+                                uint1024_t(0)
+                            );
+                        }
+                    }
+
+                    /* Download blocks from this node if a parallel sync is running. */
+                    else if(fSyncHeaders && SYNC.Active())
+                    {
+                        /* Add the node to the sync. */
+                        SYNC.AddPeer(nCurrentSession);
+
+                        /* Ranges are only assigned to nodes that have them. */
+                        Subscribe(SUBSCRIPTION::BESTHEIGHT);
                     }
                 }
 
@@ -1044,15 +1152,16 @@ namespace LLP
                     ssPacket >> nType;
 
                     /* Check for legacy or transactions specifiers. */
-                    bool fLegacy = false, fTransactions = false, fSyncBlock = false, fClientBlock = false;
+                    bool fLegacy = false, fTransactions = false, fSyncBlock = false, fClientBlock = false, fHeaders = false;
                     if(nType == SPECIFIER::LEGACY || nType == SPECIFIER::TRANSACTIONS
-                    || nType == SPECIFIER::SYNC   || nType == SPECIFIER::CLIENT)
+                    || nType == SPECIFIER::SYNC   || nType == SPECIFIER::CLIENT || nType == SPECIFIER::HEADERS)
                     {
                         /* Set specifiers. */
                         fLegacy       = (nType == SPECIFIER::LEGACY);
                         fTransactions = (nType == SPECIFIER::TRANSACTIONS);
                         fSyncBlock    = (nType == SPECIFIER::SYNC);
                         fClientBlock  = (nType == SPECIFIER::CLIENT);
+                        fHeaders      = (nType == SPECIFIER::HEADERS);
 
                         /* Go to next type in stream. */
                         ssPacket >> nType;
@@ -1142,6 +1251,11 @@ namespace LLP
                             if(!LLD::Ledger->ReadBlock(hashStart, stateLast))
                                 return debug::drop(NODE, "failed to read starting block");
 
+                            /* Block hashes are listed in one message after the starting block and its height. */
+                            const uint1024_t hashBegin = hashStart;
+                            const uint32_t nHeightBegin = stateLast.nHeight;
+                            std::vector<uint1024_t> vHashes;
+
                             /* Do a sequential read to obtain the list.
                                3000 seems to be the optimal amount to overcome higher-latency connections during sync */
                             std::vector<TAO::Ledger::BlockState> vStates;
@@ -1177,8 +1291,12 @@ namespace LLP
                                     /* Cache the block hash. */
                                     stateLast = state;
 
+                                    /* Handle for listing block hashes. */
+                                    if(fHeaders)
+                                        vHashes.push_back(hashStart);
+
                                     /* Handle for special sync block type specifier. */
-                                    if(fSyncBlock)
+                                    else if(fSyncBlock)
                                     {
                                         /* Build the sync block from state. */
                                         TAO::Ledger::SyncBlock block(state);
@@ -1268,6 +1386,17 @@ namespace LLP
                                 }
                             }
 
+                            /* Send the block hashes, where an empty list is the end of the chain. */
+                            if(fHeaders)
+                            {
+                                PushMessage(TYPES::BLOCK, uint8_t(SPECIFIER::HEADERS), hashBegin, nHeightBegin, vHashes);
+
+                                /* Debug output. */
+                                debug::log(3, NODE, "ACTION::LIST: HEADERS ", vHashes.size(), " from ", hashBegin.SubString());
+
+                                break;
+                            }
+
                             /* Check for last subscription. */
                             if(nNotifications & SUBSCRIPTION::LASTINDEX)
                                 PushMessage(ACTION::NOTIFY, uint8_t(TYPES::LASTINDEX), uint8_t(TYPES::BLOCK), fBufferFull.load() ? stateLast.hashPrevBlock : hashStart);
@@ -1294,6 +1423,10 @@ namespace LLP
                             if(fSyncBlock)
                                 return debug::drop(NODE, "cannot use SPECIFIER::SYNC for transaction lists");
 
+                            /* Check for invalid specifiers. */
+                            if(fHeaders)
+                                return debug::drop(NODE, "cannot use SPECIFIER::HEADERS for transaction lists");
+
                             /* Check for legacy. */
                             if(fLegacy)
                             {
@@ -1601,15 +1734,16 @@ namespace LLP
                     ssPacket >> nType;
 
                     /* Check for legacy or transactions specifiers. */
-                    bool fLegacy = false, fPoolstake = false, fTransactions = false, fClient = false;
+                    bool fLegacy = false, fPoolstake = false, fTransactions = false, fClient = false, fCompact = false;
                     if(nType == SPECIFIER::LEGACY || nType == SPECIFIER::POOLSTAKE
-                    || nType == SPECIFIER::TRANSACTIONS || nType == SPECIFIER::CLIENT)
+                    || nType == SPECIFIER::TRANSACTIONS || nType == SPECIFIER::CLIENT || nType == SPECIFIER::COMPACT)
                     {
                         /* Set specifiers. */
                         fLegacy       = (nType == SPECIFIER::LEGACY);
                         fPoolstake    = (nType == SPECIFIER::POOLSTAKE);
                         fTransactions = (nType == SPECIFIER::TRANSACTIONS);
                         fClient       = (nType == SPECIFIER::CLIENT);
+                        fCompact      = (nType == SPECIFIER::COMPACT);
 
                         /* Go to next type in stream. */
                         ssPacket >> nType;
@@ -1633,6 +1767,9 @@ namespace LLP
                             uint1024_t hashBlock;
                             ssPacket >> hashBlock;
 
+                            /* The node will have the block once it is sent. */
+                            filterInventory.Insert(hashBlock);
+
                             /* Check the database for the block. */
                             TAO::Ledger::BlockState state;
                             if(LLD::Ledger->ReadBlock(hashBlock, state))
@@ -1670,6 +1807,18 @@ namespace LLP
                                     /* Build tritium block from state. */
                                     TAO::Ledger::TritiumBlock block(state);
 
+                                    /* Handle for compact blocks. */
+                                    if(fCompact)
+                                    {
+                                        /* Push the compact block with a new salt for its short ids. */
+                                        PushMessage(TYPES::BLOCK, uint8_t(SPECIFIER::COMPACT), TAO::Ledger::CompactBlock(block, LLC::GetRand()));
+
+                                        /* Debug output. */
+                                        debug::log(3, NODE, "ACTION::GET: COMPACT::BLOCK ", hashBlock.SubString(), " with ", block.vtx.size(), " transactions");
+
+                                        break;
+                                    }
+
                                     /* Check for transactions. */
                                     if(fTransactions)
                                     {
@@ -1721,10 +1870,72 @@ namespace LLP
                             if(fTransactions || fClient)
                                 return debug::drop(NODE, "ACTION::GET::TRANSACTION: invalid specifier for TYPES::TRANSACTION");
 
+                            /* Handle for the missing transactions of a compact block. */
+                            if(fCompact)
+                            {
+                                /* Check for client mode since this method should never be called except by a client. */
+                                if(config::fClient.load())
+                                    return debug::drop(NODE, "ACTION::GET::COMPACT::TRANSACTION disabled in -client mode");
+
+                                /* Get the block and the indexes of its missing transactions. */
+                                uint1024_t hashBlock;
+                                ssPacket >> hashBlock;
+
+                                std::vector<uint32_t> vIndexes;
+                                ssPacket >> vIndexes;
+
+                                /* Check the database for the block. */
+                                TAO::Ledger::BlockState state;
+                                if(!LLD::Ledger->ReadBlock(hashBlock, state) || state.nVersion < 7)
+                                {
+                                    debug::log(3, NODE, "ACTION::GET: COMPACT::TRANSACTION unknown block ", hashBlock.SubString());
+                                    break;
+                                }
+
+                                /* Push the missing transactions. */
+                                TAO::Ledger::TritiumBlock block(state);
+                                for(const auto& nIndex : vIndexes)
+                                {
+                                    /* Check the index is in the block. */
+                                    if(nIndex >= block.vtx.size())
+                                        return debug::drop(NODE, "ACTION::GET::COMPACT::TRANSACTION: index out of range");
+
+                                    /* Basic checks for legacy transactions. */
+                                    const std::pair<uint8_t, uint512_t>& proof = block.vtx[nIndex];
+                                    if(proof.first == TAO::Ledger::TRANSACTION::LEGACY)
+                                    {
+                                        /* Check the legacy database. */
+                                        Legacy::Transaction tx;
+                                        if(LLD::Legacy->ReadTx(proof.second, tx, TAO::Ledger::FLAGS::MEMPOOL))
+                                            PushMessage(TYPES::TRANSACTION, uint8_t(SPECIFIER::LEGACY), tx);
+                                    }
+
+                                    /* Basic checks for tritium transactions. */
+                                    else if(proof.first == TAO::Ledger::TRANSACTION::TRITIUM)
+                                    {
+                                        /* Check the ledger database. */
+                                        TAO::Ledger::Transaction tx;
+                                        if(LLD::Ledger->ReadTx(proof.second, tx, TAO::Ledger::FLAGS::MEMPOOL))
+                                            PushMessage(TYPES::TRANSACTION, uint8_t(SPECIFIER::TRITIUM), tx);
+                                    }
+                                }
+
+                                /* Push the compact block again last, so it is rebuilt once the transactions are accepted. */
+                                PushMessage(TYPES::BLOCK, uint8_t(SPECIFIER::COMPACT), TAO::Ledger::CompactBlock(block, LLC::GetRand()));
+
+                                /* Debug output. */
+                                debug::log(3, NODE, "ACTION::GET: COMPACT::TRANSACTION ", vIndexes.size(), " for block ", hashBlock.SubString());
+
+                                break;
+                            }
+
                             /* Get the index of transaction. */
                             uint512_t hashTx;
                             ssPacket >> hashTx;
 
+                            /* The node will have the transaction once it is sent. */
+                            filterInventory.Insert(hashTx);
+
                             /* Check for legacy. */
                             if(fLegacy)
                             {
@@ -2143,6 +2354,9 @@ namespace LLP
                             uint1024_t hashBlock;
                             ssPacket >> hashBlock;
 
+                            /* The node has the block, so it isn't relayed back. */
+                            filterInventory.Insert(hashBlock);
+
                             /* Check for client mode. */
                             if(config::fClient.load())
                             {
@@ -2157,7 +2371,13 @@ namespace LLP
                             {
                                 /* Check the database for the block. */
                                 if(!LLD::Ledger->HasBlock(hashBlock))
+                                {
+                                    /* Ask for a compact block if its transactions are likely in our memory pool. */
+                                    if(fCompactBlocks && (nSubscriptions & SUBSCRIPTION::TRANSACTION))
+                                        ssResponse << uint8_t(SPECIFIER::COMPACT);
+
                                     ssResponse << uint8_t(TYPES::BLOCK) << hashBlock;
+                                }
 
                                 /* Debug output. */
                                 debug::log(3, NODE, "ACTION::NOTIFY: BLOCK ", hashBlock.SubString());
@@ -2199,11 +2419,14 @@ namespace LLP
                             uint512_t hashTx = 0;
                             ssPacket >> hashTx;
 
+                            /* The node has the transaction, so it isn't relayed back. */
+                            filterInventory.Insert(hashTx);
+
                             /* Handle for -client mode which deals with merkle transactions. */
                             if(config::fClient.load())
                             {
                                 /* Check ledger database. */
-                                if(!cacheInventory.Has(hashTx) && !LLD::Client->HasTx(hashTx, TAO::Ledger::FLAGS::MEMPOOL))
+                                if(!LLD::Client->HasTx(hashTx, TAO::Ledger::FLAGS::MEMPOOL))
                                 {
                                     /* Debug output. */
                                     debug::log(3, NODE, "ACTION::NOTIFY: MERKLE TRANSACTION ", hashTx.SubString());
@@ -2222,7 +2445,7 @@ namespace LLP
                             if(fLegacy)
                             {
                                 /* Check legacy database. */
-                                if(!cacheInventory.Has(hashTx) && !LLD::Legacy->HasTx(hashTx, TAO::Ledger::FLAGS::MEMPOOL))
+                                if(!LLD::Legacy->HasTx(hashTx, TAO::Ledger::FLAGS::MEMPOOL))
                                 {
                                     /* Debug output. */
                                     debug::log(3, NODE, "ACTION::NOTIFY: LEGACY TRANSACTION ", hashTx.SubString());
@@ -2252,7 +2475,7 @@ namespace LLP
                             else
                             {
                                 /* Check ledger database. */
-                                if(!cacheInventory.Has(hashTx) && !LLD::Ledger->HasTx(hashTx, TAO::Ledger::FLAGS::MEMPOOL))
+                                if(!LLD::Ledger->HasTx(hashTx, TAO::Ledger::FLAGS::MEMPOOL))
                                 {
                                     /* Debug output. */
                                     debug::log(3, NODE, "ACTION::NOTIFY: TRITIUM TRANSACTION ", hashTx.SubString());
@@ -2278,6 +2501,13 @@ namespace LLP
                             /* Keep track of current height. */
                             ssPacket >> nCurrentHeight;
 
+                            /* Ranges can be assigned up to the new height. */
+                            if(SYNC.HasPeer(nCurrentSession))
+                            {
+                                SYNC.SetHeight(nCurrentSession, nCurrentHeight);
+                                SyncRequests();
+                            }
+
                             /* Debug output. */
                             debug::log(3, NODE, "ACTION::NOTIFY: BESTHEIGHT ", nCurrentHeight);
 
@@ -2405,6 +2635,9 @@ namespace LLP
                                 fSynchronized.store(true);
                                 TAO::Ledger::nSyncSession.store(0);
 
+                                /* Release the parallel sync. */
+                                SYNC.Stop();
+
                                 /* Unsubcribe from last. */
                                 Unsubscribe(SUBSCRIPTION::LASTINDEX);
 
@@ -2553,7 +2786,8 @@ namespace LLP
             case TYPES::BLOCK:
             {
                 /* Check for subscription. */
-                if(!(nSubscriptions & SUBSCRIPTION::BLOCK) && TAO::Ledger::nSyncSession.load() != nCurrentSession)
+                if(!(nSubscriptions & SUBSCRIPTION::BLOCK) && TAO::Ledger::nSyncSession.load() != nCurrentSession
+                && !SYNC.HasPeer(nCurrentSession))
                     return debug::drop(NODE, "TYPES::BLOCK: unsolicited data");
 
                 /* Star the sync timer if this is the first sync block */
@@ -2613,6 +2847,9 @@ namespace LLP
                         TAO::Ledger::TritiumBlock block;
                         ssPacket >> block;
 
+                        /* The node has the block, so it isn't relayed back. */
+                        filterInventory.Insert(block.GetHash());
+
                         /* Process the block. */
                         TAO::Ledger::Process(block, nStatus);
 
@@ -2676,6 +2913,98 @@ namespace LLP
                         break;
                     }
 
+                    /* Handle for a compact block. */
+                    case SPECIFIER::COMPACT:
+                    {
+                        /* Check for client mode since this method should never be called except by a client. */
+                        if(config::fClient.load())
+                            return debug::drop(NODE, "TYPES::BLOCK::COMPACT: disabled in -client mode");
+
+                        /* Get the compact block from the stream. */
+                        TAO::Ledger::CompactBlock compact;
+                        ssPacket >> compact;
+
+                        /* The node has the block, so it isn't relayed back. */
+                        const uint1024_t hashBlock = compact.block.GetHash();
+                        filterInventory.Insert(hashBlock);
+
+                        /* Check for a block we already have. */
+                        if(LLD::Ledger->HasBlock(hashBlock))
+                        {
+                            setCompactRequests.erase(hashBlock);
+                            break;
+                        }
+
+                        /* Rebuild the block from the memory pool. */
+                        TAO::Ledger::TritiumBlock block;
+                        std::vector<uint32_t> vMissing;
+                        if(!compact.Reconstruct(block, vMissing)
+                        || (!vMissing.empty() && setCompactRequests.count(hashBlock)))
+                        {
+                            /* Ask for the full block if the short ids didn't match, or transactions are still missing. */
+                            PushMessage(ACTION::GET, uint8_t(TYPES::BLOCK), hashBlock);
+                            setCompactRequests.erase(hashBlock);
+
+                            /* Log the fallback. */
+                            debug::log(3, FUNCTION, "requesting full block ", hashBlock.SubString(), " for compact block");
+
+                            break;
+                        }
+
+                        /* Ask for only the missing transactions, which are followed by the compact block again. */
+                        if(!vMissing.empty())
+                        {
+                            /* Keep the pending set bounded. */
+                            if(setCompactRequests.size() >= 16)
+                                setCompactRequests.clear();
+
+                            setCompactRequests.insert(hashBlock);
+                            PushMessage(ACTION::GET, uint8_t(SPECIFIER::COMPACT), uint8_t(TYPES::TRANSACTION), hashBlock, vMissing);
+
+                            /* Log the missing data. */
+                            debug::log(3, FUNCTION, "requesting ", vMissing.size(), " of ", compact.vShortIDs.size(), " missing txs for compact block ", hashBlock.SubString());
+
+                            break;
+                        }
+
+                        /* The block is complete. */
+                        setCompactRequests.erase(hashBlock);
+
+                        /* Verbose debug output. */
+                        debug::log(3, FUNCTION, "rebuilt compact block ", hashBlock.SubString(), " with ", block.vtx.size(), " transactions");
+
+                        /* Process the block. */
+                        TAO::Ledger::Process(block, nStatus);
+
+                        /* Ask for the full block if it depends on transactions we don't have, its handler requests them. */
+                        if(nStatus & TAO::Ledger::PROCESS::INCOMPLETE)
+                        {
+                            PushMessage(ACTION::GET, uint8_t(TYPES::BLOCK), hashBlock);
+
+                            /* Log the fallback. */
+                            debug::log(3, FUNCTION, "requesting full block ", hashBlock.SubString(), " for incomplete compact block");
+                        }
+
+                        /* Check for duplicate and ask for previous block. */
+                        if(!(nStatus & TAO::Ledger::PROCESS::DUPLICATE)
+                        && !(nStatus & TAO::Ledger::PROCESS::IGNORED)
+                        && !(nStatus & TAO::Ledger::PROCESS::INCOMPLETE)
+                        &&  (nStatus & TAO::Ledger::PROCESS::ORPHAN))
+                        {
+                            /* Ask for list of blocks. */
+                            PushMessage(ACTION::LIST,
+                                uint8_t(SPECIFIER::TRANSACTIONS),
+                                uint8_t(TYPES::BLOCK),
+                                uint8_t(TYPES::LOCATOR),
+                                TAO::Ledger::Locator(TAO::Ledger::ChainState::hashBestChain.load()),
+                                uint1024_t(block.hashPrevBlock)
+                            );
+                        }
+
+                        break;
+                    }
+
+
                     /* Handle for a tritium transaction. */
                     case SPECIFIER::SYNC:
                     {
@@ -2691,6 +3020,27 @@ namespace LLP
                         TAO::Ledger::SyncBlock block;
                         ssPacket >> block;
 
+                        /* Parallel sync buffers the blocks from every node so they are processed in chain order. */
+                        if(SYNC.Active())
+                        {
+                            /* Check that the block was requested from this node. */
+                            if(!SYNC.Receive(nCurrentSession, block, runtime::timestamp()))
+                            {
+                                debug::log(3, NODE, "TYPES::BLOCK::SYNC: unrequested block at height ", block.nHeight);
+                                break;
+                            }
+
+                            /* Process the blocks that are ready. */
+                            if(SYNC.Process() > 0)
+                                nStatus |= TAO::Ledger::PROCESS::ACCEPTED;
+
+                            /* Check for completion, and ask for the next range. */
+                            SyncComplete();
+                            SyncRequests();
+
+                            break;
+                        }
+
                         /* Check version switch. */
                         if(block.nVersion >= 7)
                         {
@@ -2721,6 +3071,42 @@ namespace LLP
                     }
 
 
+                    /* Handle for the block hashes of a parallel sync. */
+                    case SPECIFIER::HEADERS:
+                    {
+                        /* Check for client mode since this method should never be called except by a client. */
+                        if(config::fClient.load())
+                            return debug::drop(NODE, "TYPES::BLOCK::HEADERS: disabled in -client mode");
+
+                        /* Get the starting block and its height. */
+                        uint1024_t hashStart;
+                        ssPacket >> hashStart;
+
+                        uint32_t nHeight = 0;
+                        ssPacket >> nHeight;
+
+                        /* Get the block hashes. */
+                        std::vector<uint1024_t> vHashes;
+                        ssPacket >> vHashes;
+
+                        /* Split the hashes into ranges. */
+                        if(!SYNC.Headers(nCurrentSession, hashStart, nHeight, vHashes))
+                        {
+                            debug::log(3, NODE, "TYPES::BLOCK::HEADERS: unrequested hashes from ", hashStart.SubString());
+                            break;
+                        }
+
+                        /* Debug output. */
+                        debug::log(3, NODE, "TYPES::BLOCK::HEADERS: ", vHashes.size(), " from height ", nHeight);
+
+                        /* Check for completion, and hand out the new ranges. */
+                        SyncComplete();
+                        SyncRequests();
+
+                        break;
+                    }
+
+
                     /* Handle for a tritium transaction. */
                     case SPECIFIER::CLIENT:
                     {
@@ -2767,7 +3153,7 @@ namespace LLP
                     nConsecutiveFails   = 0;
 
                     /* Reset last time received. */
-                    if(nCurrentSession == TAO::Ledger::nSyncSession.load())
+                    if(nCurrentSession == TAO::Ledger::nSyncSession.load() || SYNC.HasPeer(nCurrentSession))
                         nLastTimeReceived.store(runtime::timestamp());
                 }
 
@@ -2834,6 +3220,10 @@ namespace LLP
                         Legacy::Transaction tx;
                         ssPacket >> tx;
 
+                        /* The node has the transaction, so it isn't relayed back. */
+                        const uint512_t hashTx = tx.GetHash();
+                        filterInventory.Insert(hashTx);
+
                         /* Accept into memory pool. */
                         if(TAO::Ledger::mempool.Accept(tx, this))
                         {
@@ -2843,7 +3233,7 @@ namespace LLP
                                 ACTION::NOTIFY,
                                 uint8_t(SPECIFIER::LEGACY),
                                 uint8_t(TYPES::TRANSACTION),
-                                tx.GetHash()
+                                hashTx
                             );
 
                             /* Reset consecutive failures. */
@@ -2863,11 +3253,14 @@ namespace LLP
                         TAO::Ledger::Transaction tx;
                         ssPacket >> tx;
 
+                        /* The node has the transaction, so it isn't relayed back. */
+                        const uint512_t hashTx = tx.GetHash();
+                        filterInventory.Insert(hashTx);
+
                         /* Accept into memory pool. */
                         if(TAO::Ledger::mempool.Accept(tx, this))
                         {
                             /* Relay the transaction notification. */
-                            uint512_t hashTx = tx.GetHash();
                             TRITIUM_SERVER->Relay
                             (
                                 /* Standard transaction relay. */
@@ -2906,13 +3299,16 @@ namespace LLP
                         ssPacket >> nTTL;
                         ssPacket >> tx;
 
+                        /* The node has the transaction, so it isn't relayed back. */
+                        const uint512_t hashTx = tx.GetHash();
+                        filterInventory.Insert(hashTx);
+
                         /* Accept into stake pool. */
                         if(TAO::Ledger::stakepool.Accept(tx, this))
                         {
                             /* Relay the transaction notification if more TTL count */
                             if(nTTL > 0)
                             {
-                                uint512_t hashTx = tx.GetHash();
                                 --nTTL;
 
                                 TRITIUM_SERVER->Relay
@@ -3028,7 +3424,12 @@ namespace LLP
                                 }
 
                                 /* Flush to disk and clear mempool. */
-                                LLD::TxnCommit(TAO::Ledger::FLAGS::BLOCK);
+                                if(!LLD::TxnCommit(TAO::Ledger::FLAGS::BLOCK))
+                                {
+                                    LLD::TxnAbort(TAO::Ledger::FLAGS::BLOCK);
+                                    return debug::error(FUNCTION, "failed to commit transaction to database");
+                                }
+
                                 TAO::Ledger::mempool.Remove(hashTx);
 
                                 tx.print();
@@ -3089,7 +3490,12 @@ namespace LLP
                                     }
 
                                     /* Flush to disk and clear mempool. */
-                                    LLD::TxnCommit(TAO::Ledger::FLAGS::BLOCK);
+                                    if(!LLD::TxnCommit(TAO::Ledger::FLAGS::BLOCK))
+                                    {
+                                        LLD::TxnAbort(TAO::Ledger::FLAGS::BLOCK);
+                                        return debug::error(FUNCTION, "failed to commit transaction to database");
+                                    }
+
                                     TAO::Ledger::mempool.Remove(hashTx);
 
                                     debug::log(0, hashTx.SubString(), " ACCEPTED");
@@ -3424,6 +3830,28 @@ namespace LLP
     }
 
 
+    /*  Write a single packet to the TCP stream, compressing its payload if the node supports it. */
+    void TritiumNode::WritePacket(const MessagePacket& PACKET)
+    {
+        /* Check if the payload is large enough to be worth compressing. */
+        if(fCompression.load() && PACKET.LENGTH >= static_cast<uint32_t>(config::GetArg("-compressthreshold", 1024)))
+        {
+            /* Write the compressed packet if it got any smaller. */
+            MessagePacket COMPRESSED_PACKET;
+            if(PACKET.Compress(COMPRESSED_PACKET))
+            {
+                debug::log(4, NODE, "compressed message ", std::hex, PACKET.MESSAGE, std::dec,
+                    " from ", PACKET.LENGTH, " to ", COMPRESSED_PACKET.LENGTH, " bytes");
+
+                BaseConnection::WritePacket(COMPRESSED_PACKET);
+                return;
+            }
+        }
+
+        BaseConnection::WritePacket(PACKET);
+    }
+
+
     /*  Non-Blocking Packet reader to build a packet from TCP Connection.
      *  This keeps thread from spending too much time for each Connection. */
     void TritiumNode::ReadPacket()
@@ -3471,6 +3899,110 @@ namespace LLP
     }
 
 
+    /* Get the name of a message, type, specifier or response code. */
+    static std::string code_name(const uint16_t nCode)
+    {
+        switch(nCode)
+        {
+            /* Actions. */
+            case ACTION::LIST:           return "LIST";
+            case ACTION::GET:            return "GET";
+            case ACTION::NOTIFY:         return "NOTIFY";
+            case ACTION::AUTH:           return "AUTH";
+            case ACTION::DEAUTH:         return "DEAUTH";
+            case ACTION::VERSION:        return "VERSION";
+            case ACTION::SUBSCRIBE:      return "SUBSCRIBE";
+            case ACTION::UNSUBSCRIBE:    return "UNSUBSCRIBE";
+            case ACTION::VALIDATE:       return "VALIDATE";
+            case ACTION::REQUEST:        return "REQUEST";
+            case ACTION::PING:           return "PING";
+            case ACTION::PONG:           return "PONG";
+
+            /* Types. */
+            case TYPES::UINT256_T:       return "UINT256_T";
+            case TYPES::UINT512_T:       return "UINT512_T";
+            case TYPES::UINT1024_T:      return "UINT1024_T";
+            case TYPES::STRING:          return "STRING";
+            case TYPES::BYTES:           return "BYTES";
+            case TYPES::LOCATOR:         return "LOCATOR";
+            case TYPES::LASTINDEX:       return "LASTINDEX";
+            case TYPES::BLOCK:           return "BLOCK";
+            case TYPES::TRANSACTION:     return "TRANSACTION";
+            case TYPES::TIMESEED:        return "TIMESEED";
+            case TYPES::BESTHEIGHT:      return "BESTHEIGHT";
+            case TYPES::CHECKPOINT:      return "CHECKPOINT";
+            case TYPES::ADDRESS:         return "ADDRESS";
+            case TYPES::BESTCHAIN:       return "BESTCHAIN";
+            case TYPES::MEMPOOL:         return "MEMPOOL";
+            case TYPES::SIGCHAIN:        return "SIGCHAIN";
+            case TYPES::MERKLE:          return "MERKLE";
+            case TYPES::GENESIS:         return "GENESIS";
+            case TYPES::NOTIFICATION:    return "NOTIFICATION";
+            case TYPES::TRIGGER:         return "TRIGGER";
+            case TYPES::REGISTER:        return "REGISTER";
+            case TYPES::P2PCONNECTION:   return "P2PCONNECTION";
+            case TYPES::PEERADDRESS:     return "PEERADDRESS";
+
+            /* Specifiers. */
+            case SPECIFIER::LEGACY:      return "LEGACY";
+            case SPECIFIER::TRITIUM:     return "TRITIUM";
+            case SPECIFIER::SYNC:        return "SYNC";
+            case SPECIFIER::TRANSACTIONS: return "TRANSACTIONS";
+            case SPECIFIER::CLIENT:      return "CLIENT";
+            case SPECIFIER::POOLSTAKE:   return "POOLSTAKE";
+            case SPECIFIER::COMPACT:     return "COMPACT";
+            case SPECIFIER::HEADERS:     return "HEADERS";
+            case SPECIFIER::COMPRESSED:  return "COMPRESSED";
+
+            /* Responses. */
+            case RESPONSE::ACCEPTED:     return "ACCEPTED";
+            case RESPONSE::REJECTED:     return "REJECTED";
+            case RESPONSE::STALE:        return "STALE";
+            case RESPONSE::UNSUBSCRIBED: return "UNSUBSCRIBED";
+            case RESPONSE::AUTHORIZED:   return "AUTHORIZED";
+            case RESPONSE::COMPLETED:    return "COMPLETED";
+            case RESPONSE::VALIDATED:    return "VALIDATED";
+        }
+
+        /* Unknown codes are named by value so the metrics don't grow without limit. */
+        return debug::safe_printstr("0x", std::hex, nCode);
+    }
+
+
+    /* Returns the name of the incoming packet's message type. */
+    std::string TritiumNode::MessageName() const
+    {
+        std::string strName = code_name(INCOMING.MESSAGE);
+
+        /* Only verbs are followed by object types. */
+        switch(INCOMING.MESSAGE)
+        {
+            case ACTION::LIST:
+            case ACTION::GET:
+            case ACTION::NOTIFY:
+            case ACTION::SUBSCRIBE:
+            case ACTION::UNSUBSCRIBE:
+            case ACTION::VALIDATE:
+            case ACTION::REQUEST:
+            {
+                /* Add the specifier of the first object. */
+                uint32_t nPos = 0;
+                if(nPos < INCOMING.DATA.size()
+                && INCOMING.DATA[nPos] >= SPECIFIER::LEGACY && INCOMING.DATA[nPos] <= SPECIFIER::HEADERS)
+                    strName += ":" + code_name(INCOMING.DATA[nPos++]);
+
+                /* Add the type of the first object. */
+                if(nPos < INCOMING.DATA.size())
+                    strName += ":" + code_name(INCOMING.DATA[nPos]);
+
+                break;
+            }
+        }
+
+        return strName;
+    }
+
+
     /* Determine if a node is authorized and therfore trusted. */
     bool TritiumNode::Authorized() const
     {
@@ -3753,11 +4285,8 @@ namespace LLP
 
 
     /* Checks if a node is subscribed to receive a notification. */
-    const DataStream TritiumNode::RelayFilter(const uint16_t nMsg, const DataStream& ssData) const
+    bool TritiumNode::RelayFilter(const uint16_t nMsg, const DataStream& ssData, DataStream& ssRelay) const
     {
-        /* The data stream to relay*/
-        DataStream ssRelay(SER_NETWORK, MIN_PROTO_VERSION);
-
         /* Switch based on message type */
         switch(nMsg)
         {
@@ -3774,15 +4303,12 @@ namespace LLP
                     case TYPES::P2PCONNECTION:
                     {
                         /* Ensure the peer is on a high enough version to receive the P2PCONNECTION message */
-                        if(nProtocolVersion >= MIN_TRITIUM_VERSION)
-                            ssRelay = ssData;
-                        break;
+                        return (nProtocolVersion >= MIN_TRITIUM_VERSION);
                     }
                     default:
                     {
                         /* Default to letting the message be relayed */
-                        ssRelay = ssData;
-                        break;
+                        return true;
                     }
                 }
 
@@ -3825,9 +4351,18 @@ namespace LLP
                             /* Check subscription. */
                             if(nNotifications & SUBSCRIPTION::BLOCK)
                             {
+                                /* Skip blocks the node is known to have. */
+                                if(!filterInventory.Insert(hashBlock))
+                                {
+                                    ++nFilteredInventory;
+                                    break;
+                                }
+
                                 /* Write block to stream. */
                                 ssRelay << uint8_t(TYPES::BLOCK);
                                 ssRelay << hashBlock;
+
+                                ++nRelayedInventory;
                             }
 
                             break;
@@ -3841,9 +4376,21 @@ namespace LLP
                             uint512_t hashTx;
                             ssData >> hashTx;
 
+                            /* Get the TTL for poolstake, so the stream is read to the next type even if not relayed. */
+                            uint8_t nTTL = 0;
+                            if(fPoolstake)
+                                ssData >> nTTL;
+
                             /* Check subscription. */
                             if(nNotifications & SUBSCRIPTION::TRANSACTION)
                             {
+                                /* Skip transactions the node is known to have. */
+                                if(!filterInventory.Insert(hashTx))
+                                {
+                                    ++nFilteredInventory;
+                                    break;
+                                }
+
                                 /* Check for legacy. */
                                 if(fLegacy)
                                     ssRelay << uint8_t(SPECIFIER::LEGACY);
@@ -3858,12 +4405,9 @@ namespace LLP
 
                                 /* Add TTL for poolstake */
                                 if(fPoolstake)
-                                {
-                                    uint8_t nTTL;
-                                    ssData >> nTTL;
-
                                     ssRelay << nTTL;
-                                }
+
+                                ++nRelayedInventory;
                             }
 
                             break;
@@ -4009,7 +4553,7 @@ namespace LLP
                         default:
                         {
                             debug::error(FUNCTION, "Malformed binary stream");
-                            return ssRelay;
+                            return false;
                         }
                     }
                 }
@@ -4019,13 +4563,20 @@ namespace LLP
             default:
             {
                 /* default behaviour is to let the message be relayed */
-                ssRelay = ssData;
-                break;
+                return true;
             }
         }
 
 
-        return ssRelay;
+        return false;
+    }
+
+
+    /* Adds the inventory relay counters to the server metrics. */
+    void TritiumNode::AddMetrics(ServerMetrics& metrics)
+    {
+        metrics.nRelayed       = nRelayedInventory.load();
+        metrics.nRelayFiltered = nFilteredInventory.load();
     }
 
 
@@ -4082,15 +4633,31 @@ namespace LLP
                 /* Set the sync session-id. */
                 TAO::Ledger::nSyncSession.store(pnode->nCurrentSession);
 
-                /* Subscribe to this node. */
-                pnode->Subscribe(SUBSCRIPTION::LASTINDEX | SUBSCRIPTION::BESTCHAIN | SUBSCRIPTION::BESTHEIGHT);
-                pnode->PushMessage(ACTION::LIST,
-                    config::fClient.load() ? uint8_t(SPECIFIER::CLIENT) : uint8_t(SPECIFIER::SYNC),
-                    uint8_t(TYPES::BLOCK),
-                    uint8_t(TYPES::LOCATOR),
-                    TAO::Ledger::Locator(TAO::Ledger::ChainState::hashBestChain.load()),
-                    uint1024_t(0)
-                );
+                /* Restart a parallel sync from this node. */
+                if(pnode->fSyncHeaders)
+                {
+                    /* Subscribe to this node. */
+                    pnode->Subscribe(SUBSCRIPTION::BESTCHAIN | SUBSCRIPTION::BESTHEIGHT);
+
+                    /* The block hashes are listed again from a locator. */
+                    SYNC.Start(pnode->nCurrentSession);
+                    pnode->SyncRequests();
+                }
+                else
+                {
+                    /* Blocks only come from this node. */
+                    SYNC.Stop();
+
+                    /* Subscribe to this node. */
+                    pnode->Subscribe(SUBSCRIPTION::LASTINDEX | SUBSCRIPTION::BESTCHAIN | SUBSCRIPTION::BESTHEIGHT);
+                    pnode->PushMessage(ACTION::LIST,
+                        config::fClient.load() ? uint8_t(SPECIFIER::CLIENT) : uint8_t(SPECIFIER::SYNC),
+                        uint8_t(TYPES::BLOCK),
+                        uint8_t(TYPES::LOCATOR),
+                        TAO::Ledger::Locator(TAO::Ledger::ChainState::hashBestChain.load()),
+                        uint1024_t(0)
+                    );
+                }
 
                 /* Reset last time received. */
                 nLastTimeReceived.store(runtime::timestamp());
@@ -4112,4 +4679,69 @@ namespace LLP
             debug::log(0, FUNCTION, "No Sync Nodes Available");
         }
     }
+
+
+    /* Send the parallel sync requests assigned to this node. */
+    void TritiumNode::SyncRequests()
+    {
+        /* Get the requests, which also reassigns stalled ranges. */
+        const std::vector<SyncRequest> vRequests = SYNC.Requests(nCurrentSession, runtime::timestamp());
+        for(const auto& request : vRequests)
+        {
+            /* List the block hashes from a locator of the best chain. */
+            if(request.fHeaders && request.hashStart == 0)
+            {
+                PushMessage(ACTION::LIST,
+                    uint8_t(SPECIFIER::HEADERS),
+                    uint8_t(TYPES::BLOCK),
+                    uint8_t(TYPES::LOCATOR),
+                    TAO::Ledger::Locator(TAO::Ledger::ChainState::hashBestChain.load()),
+                    uint1024_t(0)
+                );
+            }
+
+            /* List the block hashes, or a range of blocks, after the starting block. */
+            else
+            {
+                PushMessage(ACTION::LIST,
+                    request.fHeaders ? uint8_t(SPECIFIER::HEADERS) : uint8_t(SPECIFIER::SYNC),
+                    uint8_t(TYPES::BLOCK),
+                    uint8_t(TYPES::UINT1024_T),
+                    request.hashStart,
+                    request.hashStop
+                );
+            }
+
+            /* Debug output. */
+            debug::log(3, NODE, "SYNC: requested ", request.fHeaders ? "hashes" : "blocks", " from ", request.hashStart.SubString());
+        }
+    }
+
+
+    /* Set the state to synchronized when the parallel sync has processed every listed block. */
+    void TritiumNode::SyncComplete()
+    {
+        /* Check that every listed block was processed. */
+        if(!SYNC.Complete())
+            return;
+
+        /* Set state to synchronized. */
+        fSynchronized.store(true);
+        TAO::Ledger::nSyncSession.store(0);
+
+        /* Release the parallel sync. */
+        SYNC.Stop();
+
+        /* Total blocks synchronized */
+        uint32_t nBlocks = TAO::Ledger::ChainState::stateBest.load().nHeight - nSyncStart.load();
+
+        /* Calculate the time to sync*/
+        uint32_t nElapsed = SYNCTIMER.Elapsed();
+        if(nElapsed == 0)
+            nElapsed = 1;
+
+        /* Log that sync is complete. */
+        debug::log(0, NODE, "SYNC: Synchronization COMPLETE at ", TAO::Ledger::ChainState::hashBestChain.load().SubString());
+        debug::log(0, NODE, "SYNC: Synchronized ", nBlocks, " blocks in ", nElapsed, " seconds [", nBlocks / nElapsed, " blocks/s]");
+    }
 }
@@ -83,6 +83,14 @@ namespace LLP
         bool ProcessPacket() final;
 
 
+        /** MessageName
+         *
+         *  Returns the API and method of the incoming request, such as ledger/get/block.
+         *
+         **/
+        std::string MessageName() const;
+
+
         /** Authorized
          *
          *  Check if an authorization base64 encoded string is correct.
@@ -18,6 +18,8 @@ ________________________________________________________________________________
 #include <LLP/templates/base_connection.h>
 #include <LLP/packets/http.h>
 
+#include <Util/include/json.h>
+
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -52,6 +54,14 @@ namespace LLP
         /* Internal Read Buffer. */
         std::vector<int8_t> vchBuffer;
 
+
+        /* The position in the read buffer up to which requests have been parsed. */
+        uint64_t nBufferPos;
+
+
+        /* Flag for knowing the rest of the read buffer is only part of a request. */
+        bool fPartial;
+
     public:
 
         /** Default Constructor **/
@@ -111,6 +121,15 @@ namespace LLP
         void ReadPacket() final;
 
 
+        /** PacketBuffered
+         *
+         *  Returns true if pipelined requests were read along with the last request,
+         *  so the data thread parses them without waiting on the socket.
+         *
+         **/
+        bool PacketBuffered() const;
+
+
         /** PushResponse
          *
          *  Returns an HTTP packet with response code and content.
@@ -122,6 +141,19 @@ namespace LLP
          **/
         void PushResponse(const uint16_t nMsg, const std::string& strContent);
 
+
+        /** WriteResponse
+         *
+         *  Writes a response with json content. The content is serialized straight into
+         *  the buffer that is sent, and written along with the header without copying.
+         *
+         *  @param[in] RESPONSE The response with the status and header fields.
+         *
+         *  @param[in] jsonContent The content to post return with.
+         *
+         **/
+        void WriteResponse(const HTTPPacket& RESPONSE, const json::json& jsonContent);
+
     };
 
 }
@@ -16,6 +16,7 @@ ________________________________________________________________________________
 
 #include <LLP/templates/connection.h>
 #include <TAO/Ledger/types/block.h>
+#include <TAO/Ledger/types/tritium.h>
 #include <Legacy/types/coinbase.h>
 #include <atomic>
 
@@ -84,6 +85,44 @@ namespace LLP
 
     private:
 
+        /** Round
+         *
+         *  The block template for a channel, shared by every connection mining it. Each connection only
+         *  replaces the producer with its own extra nonce and coinbase, and updates the merkle root from the
+         *  merkle branch of the producer.
+         *
+         **/
+        struct Round
+        {
+            /** The block with the transactions for this round. **/
+            TAO::Ledger::TritiumBlock block;
+
+
+            /** The merkle branch of the producer, the last transaction. **/
+            std::vector<uint512_t> vBranch;
+
+
+            /** The last transaction of the mining signature chain the producer follows. **/
+            uint512_t hashLast;
+
+
+            /** The memory pool insertion count when the template was built. **/
+            uint64_t nInsertions;
+
+
+            /** The time the template was built. **/
+            uint64_t nTime;
+        };
+
+
+        /** Mutex for the shared rounds. **/
+        static std::mutex ROUND_MUTEX;
+
+
+        /** The shared round for each channel. **/
+        static Round ROUNDS[3];
+
+
         /* Externally set coinbase to be set on mined blocks */
         Legacy::Coinbase CoinbaseTx;
 
@@ -226,7 +265,7 @@ namespace LLP
 
         /** new_block
          *
-         *  Adds a new block to the map.
+         *  Creates a new block from the shared round of the channel, building the round first if it is stale.
          *
          **/
         TAO::Ledger::Block *new_block();
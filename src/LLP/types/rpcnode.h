@@ -78,8 +78,20 @@ namespace LLP
          **/
         bool ProcessPacket() final;
 
+
+        /** MessageName
+         *
+         *  Returns the method of the last request, or unknown if it couldn't be parsed.
+         *
+         **/
+        std::string MessageName() const;
+
     protected:
 
+        /** The method of the last request. **/
+        std::string strMethod;
+
+
         /** JSONReply
          *
          *  Reply a standard response from RPC server.
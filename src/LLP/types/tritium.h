@@ -17,7 +17,9 @@ ________________________________________________________________________________
 
 #include <LLC/include/random.h>
 
+#include <LLP/include/inventory_filter.h>
 #include <LLP/include/network.h>
+#include <LLP/include/sync.h>
 #include <LLP/include/version.h>
 #include <LLP/packets/message.h>
 #include <LLP/templates/base_connection.h>
@@ -29,6 +31,8 @@ ________________________________________________________________________________
 
 #include <Util/include/memory.h>
 
+#include <set>
+
 namespace LLP
 {
     namespace Tritium
@@ -107,6 +111,9 @@ namespace LLP
                 TRANSACTIONS = 0x43, //specify to send memory transactions first
                 CLIENT       = 0x44, //specify for blocks to be sent and received for clients
                 POOLSTAKE    = 0x45, //specify for pooled coinstake transactions
+                COMPACT      = 0x46, //specify for compact blocks with short transaction ids
+                HEADERS      = 0x47, //specify for block hashes to download blocks in parallel
+                COMPRESSED   = 0x48, //specify for payloads to be sent compressed
             };
         }
 
@@ -163,6 +170,22 @@ namespace LLP
         static void SwitchNode();
 
 
+        /** SyncRequests
+         *
+         *  Send the parallel sync requests assigned to this node.
+         *
+         **/
+        void SyncRequests();
+
+
+        /** SyncComplete
+         *
+         *  Set the state to synchronized when the parallel sync has processed every listed block.
+         *
+         **/
+        void SyncComplete();
+
+
         /** State of if this node has logged in to remote node. **/
         std::atomic<bool> fLoggedIn;
 
@@ -199,6 +222,14 @@ namespace LLP
         uint16_t nNotifications;
 
 
+        /** Compact blocks that are waiting for their missing transactions. **/
+        std::set<uint1024_t> setCompactRequests;
+
+
+        /** The blocks and transactions this node is known to have, so they aren't relayed to it again. **/
+        mutable InventoryFilter filterInventory;
+
+
     public:
 
         /** Name
@@ -225,6 +256,18 @@ namespace LLP
         static std::atomic<uint64_t> nLastTimeReceived;
 
 
+        /** Downloads blocks from more than one node during sync. **/
+        static SyncManager SYNC;
+
+
+        /** Inventory items relayed to nodes. **/
+        static std::atomic<uint64_t> nRelayedInventory;
+
+
+        /** Inventory items not relayed as the node was known to have them. **/
+        static std::atomic<uint64_t> nFilteredInventory;
+
+
         /** Default Constructor **/
         TritiumNode();
 
@@ -265,6 +308,18 @@ namespace LLP
         uint32_t nProtocolVersion;
 
 
+        /** Flag to determine if this node relays compact blocks. **/
+        bool fCompactBlocks;
+
+
+        /** Flag to determine if this node lists block hashes for parallel sync. **/
+        bool fSyncHeaders;
+
+
+        /** Flag to determine if payloads sent to this node are compressed. **/
+        std::atomic<bool> fCompression;
+
+
         /** This node's session-id. **/
         uint64_t nCurrentSession;
 
@@ -343,6 +398,25 @@ namespace LLP
         void ReadPacket() final;
 
 
+        /** MessageName
+         *
+         *  Returns the name of the incoming packet's message type, followed by the
+         *  specifier and type of its first object for verbs such as GET:BLOCK.
+         *
+         **/
+        std::string MessageName() const;
+
+
+        /** AddMetrics
+         *
+         *  Adds the inventory relay counters to the server metrics.
+         *
+         *  @param[out] metrics The server metrics to add to.
+         *
+         **/
+        static void AddMetrics(ServerMetrics& metrics);
+
+
         /** Authorized
          *
          *  Determine if a node is authorized and therfore trusted.
@@ -372,14 +446,18 @@ namespace LLP
         void Subscribe(const uint16_t nFlags, bool fSubscribe = true);
 
 
-        /** Notifications
+        /** RelayFilter
          *
          *  Checks if a node is subscribed to receive a notification.
          *
-         *  @return a data stream with relevant relay information
+         *  @param[in] nMsg The message being relayed.
+         *  @param[in] ssData The data being relayed.
+         *  @param[out] ssRelay The data with relevant relay information, empty to skip the relay.
+         *
+         *  @return True to relay the data unchanged, without filtering.
          *
          **/
-        const DataStream RelayFilter(const uint16_t nMsg, const DataStream& ssData) const;
+        bool RelayFilter(const uint16_t nMsg, const DataStream& ssData, DataStream& ssRelay) const;
 
 
         /** Auth
@@ -445,6 +523,17 @@ namespace LLP
         }
 
 
+        /** WritePacket
+         *
+         *  Write a single packet to the TCP stream, compressing its payload
+         *  if the node supports it and the payload is over -compressthreshold.
+         *
+         *  @param[in] PACKET The packet to write.
+         *
+         **/
+        void WritePacket(const MessagePacket& PACKET);
+
+
         /** PushMessage
          *
          *  Adds a tritium packet to the queue to write to the socket.
@@ -547,7 +547,11 @@ namespace Legacy
         }
 
         /* Commit the transaction to database. */
-        LLD::TxnCommit();
+        if(!LLD::TxnCommit())
+        {
+            LLD::TxnAbort();
+            return debug::error(FUNCTION, "failed to commit block to database");
+        }
 
         return true;
     }
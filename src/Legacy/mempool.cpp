@@ -49,6 +49,7 @@ namespace TAO
                 return false;
 
             /* Add to the map. */
+            WLOCK(INDEX_MUTEX);
             mapLegacy[nTxHash] = tx;
 
             return true;
@@ -95,6 +96,8 @@ namespace TAO
                 {
                     /* Add to conflicts map. */
                     debug::error(FUNCTION, "LEGACY CONFLICT: INPUTS CLAIMED ", vin.prevout.hash.SubString(), ", ", vin.prevout.n);
+
+                    WLOCK(INDEX_MUTEX);
                     mapLegacyConflicts[hashTx] = tx;
 
                     return false;
@@ -223,13 +226,17 @@ namespace TAO
             if(!tx.Connect(inputs, state, TAO::Ledger::FLAGS::MEMPOOL))
                 return debug::error(FUNCTION, "tx ", hashTx.SubString(), " failed to connect inputs");
 
-            /* Set the inputs to be claimed. */
-            uint32_t s = tx.vin.size();
-            for(uint32_t i = 0; i < s; ++i)
-                mapInputs[tx.vin[i].prevout] = hashTx;
+            {
+                WLOCK(INDEX_MUTEX);
+
+                /* Set the inputs to be claimed. */
+                uint32_t s = tx.vin.size();
+                for(uint32_t i = 0; i < s; ++i)
+                    mapInputs[tx.vin[i].prevout] = hashTx;
 
-            /* Add to the legacy map. */
-            mapLegacy[hashTx] = tx;
+                /* Add to the legacy map. */
+                mapLegacy[hashTx] = tx;
+            }
 
             /* Relay tx if creating ourselves. */
             if(!pnode && LLP::TRITIUM_SERVER)
@@ -254,13 +261,15 @@ namespace TAO
         /* Checks if a given output is spent in memory. */
         bool Mempool::IsSpent(const uint512_t& hash, const uint32_t n)
         {
+            SLOCK(INDEX_MUTEX);
+
             return mapInputs.count(Legacy::OutPoint(hash, n));
         }
 
         /* Gets a legacy transaction from mempool */
         bool Mempool::Get(const uint512_t& hashTx, Legacy::Transaction &tx, bool &fConflicted) const
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
             /* Check in conflict memory. */
             if(mapLegacyConflicts.count(hashTx))
@@ -289,7 +298,7 @@ namespace TAO
         /* Gets a legacy transaction from mempool */
         bool Mempool::Get(const uint512_t& hashTx, Legacy::Transaction &tx) const
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
             /* Check the memory map. */
             if(!mapLegacy.count(hashTx))
@@ -305,7 +314,7 @@ namespace TAO
         /* Gets the size of the memory pool. */
         uint32_t Mempool::SizeLegacy()
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
             return mapLegacy.size();
         }
@@ -185,6 +185,19 @@ namespace TAO
             json::json VoidTransaction(const json::json& params, bool fHelp);
 
 
+            /** Mempool
+             *
+             *  Returns an object containing statistics for the memory pool
+             *
+             *  @param[in] params The parameters from the API call.
+             *  @param[in] fHelp Trigger for help data.
+             *
+             *  @return The return object in JSON.
+             *
+             **/
+            json::json Mempool(const json::json& params, bool fHelp);
+
+
         };
     }
 }
@@ -18,6 +18,7 @@ ________________________________________________________________________________
 #include <TAO/API/types/ledger.h>
 
 #include <TAO/Ledger/include/chainstate.h>
+#include <TAO/Ledger/include/constants.h>
 #include <TAO/Ledger/include/difficulty.h>
 #include <TAO/Ledger/include/retarget.h>
 #include <TAO/Ledger/include/supply.h>
@@ -177,5 +178,26 @@ namespace TAO
         }
 
 
+        /* Returns an object containing statistics for the memory pool. */
+        json::json Ledger::Mempool(const json::json& params, bool fHelp)
+        {
+            /* Get the statistics in one pass under the pool's read lock. */
+            const TAO::Ledger::Mempool::Info info = TAO::Ledger::mempool.GetInfo();
+
+            json::json obj;
+            obj["transactions"] = info.nTransactions;
+            obj["legacy"]       = info.nLegacy;
+            obj["conflicts"]    = info.nConflicts;
+            obj["orphans"]      = info.nOrphans;
+            obj["sigchains"]    = info.nGenesis;
+            obj["bytes"]        = info.nBytes;
+            obj["maxbytes"]     = info.nMaxBytes;
+            obj["fees"]         = (double) info.nFees / TAO::Ledger::NXS_COIN;
+            obj["evicted"]      = info.nEvicted;
+
+            return obj;
+        }
+
+
     } /* End API Namespace*/
 } /* End Ledger Namespace*/
@@ -13,6 +13,8 @@ ________________________________________________________________________________
 
 #include <LLD/include/global.h>
 
+#include <LLP/include/global.h>
+
 #include <TAO/Ledger/include/constants.h>
 #include <TAO/Ledger/include/chainstate.h>
 #include <TAO/Ledger/include/difficulty.h>
@@ -211,7 +213,61 @@ namespace TAO
             jsonReserves["hash"] = fHasHash ? double(lastHashBlockState.nReleasedReserve[0]) / TAO::Ledger::NXS_COIN : 0;
             jsonReserves["prime"] = fHasPrime ? double(lastPrimeBlockState.nReleasedReserve[0]) / TAO::Ledger::NXS_COIN : 0;
             jsonRet["reserves"] = jsonReserves;
-            
+
+
+            /* Add the LLP server metrics. */
+            json::json jsonLLP;
+            for(const auto& server : LLP::GetMetrics())
+            {
+                json::json jsonServer;
+                jsonServer["connections"]   = server.nConnections;
+                jsonServer["relayqueue"]    = server.nRelayQueue;
+                jsonServer["processqueue"]  = server.nProcessQueue;
+                jsonServer["buffered"]      = server.nBuffered;
+                jsonServer["relayed"]       = server.nRelayed;
+                jsonServer["relayfiltered"] = server.nRelayFiltered;
+
+                /* Add the send buffers with bytes waiting. */
+                json::json jsonBuffers = json::json::object();
+                for(const auto& buffer : server.vBuffers)
+                    jsonBuffers[buffer.first] = buffer.second;
+
+                jsonServer["buffers"] = jsonBuffers;
+
+                /* Add the metrics of each message type, with processing times in microseconds. */
+                json::json jsonMessages = json::json::object();
+                for(const auto& message : server.mapMessages)
+                {
+                    json::json jsonMessage;
+                    jsonMessage["count"]    = message.second.nCount;
+                    jsonMessage["bytesin"]  = message.second.nBytesIn;
+                    jsonMessage["bytesout"] = message.second.nBytesOut;
+                    jsonMessage["p50"]      = message.second.histTime.Percentile(0.5);
+                    jsonMessage["p99"]      = message.second.histTime.Percentile(0.99);
+                    jsonMessage["p999"]     = message.second.histTime.Percentile(0.999);
+
+                    jsonMessages[message.first] = jsonMessage;
+                }
+
+                jsonServer["messages"] = jsonMessages;
+                jsonLLP[server.strName] = jsonServer;
+            }
+            jsonRet["llp"] = jsonLLP;
+
+
+            /* Add the database cache metrics. */
+            json::json jsonLLD;
+            for(const auto& cache : LLP::GetCacheMetrics())
+            {
+                json::json jsonCache;
+                jsonCache["hits"]   = cache.nHits;
+                jsonCache["misses"] = cache.nMisses;
+                jsonCache["bytes"]  = cache.nBytes;
+
+                jsonLLD[cache.strName] = jsonCache;
+            }
+            jsonRet["lld"] = jsonLLD;
+
 
             return jsonRet;
         }
@@ -210,6 +210,13 @@ namespace TAO
                     /* Unix timestamp of the last time this node had any communications with the peer */
                     obj["lastseen"] = connection->load()->nLastPing.load();
 
+                    /* The bytes queued for sending to the peer */
+                    obj["buffered"] = connection->load()->Buffered();
+
+                    /* The average and longest time in microseconds that queued data waited to be sent */
+                    obj["flushlatency"]    = connection->load()->FlushLatency();
+                    obj["maxflushlatency"] = connection->load()->MaxFlushLatency();
+
                     /* See if the connection is in the address manager */
                     if(LLP::TRITIUM_SERVER->GetAddressManager() != nullptr
                     && LLP::TRITIUM_SERVER->GetAddressManager()->Has(connection->load()->addr))
@@ -249,8 +249,41 @@ namespace TAO
             /* The vector of token accounts for the token being filtered*/
             std::vector<std::pair<TAO::Register::Address, TAO::Register::Object>> vTokenAccounts;
 
+            /* The accounts of the token from the register token index. */
+            std::vector<uint256_t> vIndexed;
+
+            /* Use the token index if it is available, reading only the accounts on the requested page. */
+            if(LLD::Register->ListToken(hashToken, vIndexed))
+            {
+                for(const auto& hashAccount : vIndexed)
+                {
+                    /* The token index includes the token and trust accounts, only list accounts. */
+                    const TAO::Register::Address hashAddress = TAO::Register::Address(hashAccount);
+                    if(!hashAddress.IsAccount())
+                        continue;
+
+                    /* Accounts before the requested page are only counted. */
+                    if(vTokenAccounts.size() < nPage * nLimit)
+                    {
+                        vTokenAccounts.push_back(std::make_pair(hashAddress, TAO::Register::Object()));
+                        continue;
+                    }
+
+                    /* Read the account state. */
+                    TAO::Register::Object account;
+                    if(!LLD::Register->ReadState(hashAddress, account) || !account.Parse())
+                        continue;
+
+                    vTokenAccounts.push_back(std::make_pair(hashAddress, account));
+
+                    /* Stop once the requested page is filled. */
+                    if(vTokenAccounts.size() > (nPage + 1) * nLimit)
+                        break;
+                }
+            }
+
             /* Batch read up to 100,000 */
-            if(LLD::Register->BatchRead("account", vAccounts, 100000))
+            else if(LLD::Register->BatchRead("account", vAccounts, 100000))
             {
                 /* Check that the account belongs to the token being filtered on */
                 for(auto& account : vAccounts)
@@ -145,6 +145,30 @@ namespace TAO
             if(!LLD::Ledger->ReadLast(hashGenesis, hashLast, TAO::Ledger::FLAGS::MEMPOOL))
                 return false;
 
+            /* Use the register owner index if there are no transactions for this sig chain in the mempool. */
+            if(!config::fClient.load() && !TAO::Ledger::mempool.Has(hashGenesis))
+            {
+                /* Registers owned by the sig chain, and those transferred by it that haven't been claimed yet. */
+                uint256_t hashPrevOwner = hashGenesis;
+                hashPrevOwner.SetType(TAO::Ledger::GENESIS::SYSTEM);
+
+                std::vector<uint256_t> vOwned;
+                if(LLD::Register->ListOwner(hashGenesis, vOwned) && LLD::Register->ListOwner(hashPrevOwner, vOwned))
+                {
+                    /* Registers transferred to a token that we own are still ours. */
+                    const uint32_t nOwned = vOwned.size();
+                    for(uint32_t n = 0; n < nOwned; ++n)
+                    {
+                        if(TAO::Register::Address(vOwned[n]).IsToken())
+                            LLD::Register->ListOwner(vOwned[n], vOwned);
+                    }
+
+                    vRegisters.insert(vRegisters.end(), vOwned.begin(), vOwned.end());
+
+                    return true;
+                }
+            }
+
             /* Check the cache to see if we have already cached the registers for this sig chain and it is still valid. */
             if(cache.Has(hashGenesis))
             {
@@ -1199,8 +1223,17 @@ namespace TAO
         bool ListTokenizedObjects(const TAO::Register::Address& hashToken,
                                   std::vector<TAO::Register::Address>& vObjects)
         {
-            /* There is no index of the assets owned by a token.  Therefore, to determine which assets the token owns, we can scan
-               through the events for the token itself to find all object transfers where the new owner is the token. */
+            /* Tokenized assets are owned by the token, so use the register owner index if it is available. */
+            std::vector<uint256_t> vOwned;
+            if(LLD::Register->ListOwner(hashToken, vOwned))
+            {
+                vObjects.insert(vObjects.end(), vOwned.begin(), vOwned.end());
+
+                return vObjects.size() > 0;
+            }
+
+            /* Without the index, to determine which assets the token owns, we can scan through the events
+               for the token itself to find all object transfers where the new owner is the token. */
 
             /* Transaction for the event. */
             TAO::Ledger::Transaction tx;
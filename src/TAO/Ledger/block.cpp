@@ -420,6 +420,26 @@ namespace TAO
         }
 
 
+        /* Compute the merkle root for a new last transaction, from the merkle branch of the last index. */
+        uint512_t Block::CheckMerkleTail(const uint512_t& hash, const std::vector<uint512_t>& vMerkleBranch, uint32_t nIndex)
+        {
+            /* Generate merkle root. */
+            uint512_t hashMerkleRet = hash;
+            for(const auto& hashLeaf : vMerkleBranch)
+            {
+                /* The last node of a level is only on the left when the level is odd, where it pairs with itself. */
+                if (nIndex & 1)
+                    hashMerkleRet = LLC::SK512(BEGIN(hashLeaf), END(hashLeaf), BEGIN(hashMerkleRet), END(hashMerkleRet));
+                else
+                    hashMerkleRet = LLC::SK512(BEGIN(hashMerkleRet), END(hashMerkleRet), BEGIN(hashMerkleRet), END(hashMerkleRet));
+
+                nIndex >>= 1;
+            }
+
+            return hashMerkleRet;
+        }
+
+
         /* For debugging Purposes seeing block state data dump */
         std::string Block::ToString() const
         {
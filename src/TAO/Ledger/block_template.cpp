@@ -0,0 +1,231 @@
+/*__________________________________________________________________________________________
+
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+			(c) Copyright The Nexus Developers 2014 - 2019
+
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+			"ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/include/global.h>
+
+#include <LLP/include/version.h>
+
+#include <TAO/Ledger/include/chainstate.h>
+#include <TAO/Ledger/include/constants.h>
+#include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/types/block_template.h>
+#include <TAO/Ledger/types/mempool.h>
+
+#include <Util/include/args.h>
+#include <Util/include/debug.h>
+#include <Util/include/runtime.h>
+#include <Util/templates/serialize.h>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /* The template shared by the block creation functions. */
+        BlockTemplate blocktemplate;
+
+
+        /* Default Constructor */
+        BlockTemplate::BlockTemplate()
+        : MUTEX         ( )
+        , hashBest      (0)
+        , nInsertions   (0)
+        , nRemovals     (0)
+        , vtx           ( )
+        , setIncluded   ( )
+        , setDependents ( )
+        {
+        }
+
+
+        /* Get the transactions for a new block, bringing the template up to date first. */
+        void BlockTemplate::Get(std::vector<std::pair<uint8_t, uint512_t>>& vtxOut, const uint64_t nReserved)
+        {
+            LOCK(MUTEX);
+
+            /* Start over on a new best block, or once transactions left the memory pool, as the MINER view is stale. */
+            if(hashBest != ChainState::hashBestChain.load() || nRemovals != mempool.Removals())
+                rebuild();
+
+            /* Add the transactions that arrived since the last call. */
+            if(nInsertions != mempool.Insertions())
+                update(nReserved);
+
+            /* Hand out as much of the template as fits beside this block's producer. */
+            const uint64_t nEntry = EntrySize();
+
+            size_t nCount = vtx.size();
+            while(nCount > 0 && nReserved + (nCount - 1) * nEntry + 256 >= MAX_BLOCK_SIZE)
+                --nCount;
+
+            vtxOut.insert(vtxOut.end(), vtx.begin(), vtx.begin() + nCount);
+        }
+
+
+        /* Drop the template so the next call rebuilds it. */
+        void BlockTemplate::Clear()
+        {
+            LOCK(MUTEX);
+
+            /* A best block of zero never matches the chain. */
+            hashBest = 0;
+        }
+
+
+        /* The serialized size of one transaction entry in a block. */
+        uint64_t BlockTemplate::EntrySize()
+        {
+            /* The transaction type byte and the transaction hash. */
+            static const uint64_t nEntry = 1 + ::GetSerializeSize(uint512_t(0), SER_NETWORK, LLP::PROTOCOL_VERSION);
+
+            return nEntry;
+        }
+
+
+        /* Start over from the current best block. */
+        void BlockTemplate::rebuild()
+        {
+            /* Get the counts before the memory pool is read, so changes during the rebuild are seen next call. */
+            hashBest    = ChainState::hashBestChain.load();
+            nRemovals   = mempool.Removals();
+            nInsertions = 0;
+
+            /* Clear the transactions. */
+            vtx.clear();
+            setIncluded.clear();
+            setDependents.clear();
+
+            /* Start a new MINER view of the registers, which lasts until the next rebuild. */
+            LLD::TxnBegin(FLAGS::MINER);
+        }
+
+
+        /* Add the memory pool transactions that aren't in the template yet. */
+        void BlockTemplate::update(const uint64_t nReserved)
+        {
+            /* Get the count before the memory pool is read. */
+            nInsertions = mempool.Insertions();
+
+            /* Check the memory pool. */
+            std::vector<uint512_t> vMempool;
+            mempool.List(vMempool);
+
+            debug::log(3, "BEGIN-------------------------------------");
+
+            /* Transactions skipped for now, which may be added on a later call. */
+            std::set<uint512_t> setSkipped;
+
+            /* Loop through the list of transactions. */
+            const uint64_t nEntry = EntrySize();
+            for(const auto& hash : vMempool)
+            {
+                /* Skip the transactions already handled. */
+                if(setIncluded.count(hash) || setDependents.count(hash))
+                    continue;
+
+                /* Check the Size limits of the Current Block. */
+                if(nReserved + vtx.size() * nEntry + 256 >= MAX_BLOCK_SIZE)
+                    break;
+
+                /* Get the transaction from the memory pool. */
+                TAO::Ledger::Transaction tx;
+                if(!mempool.Get(hash, tx))
+                    continue;
+
+                /* Don't add transactions that are coinbase or coinstake. */
+                if(tx.IsCoinBase() || tx.IsCoinStake())
+                {
+                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - tx is coinbase/coinstake");
+                    continue;
+                }
+
+                /* Check for failed dependants. */
+                if(setDependents.count(tx.hashPrevTx))
+                {
+                    setDependents.insert(hash);
+
+                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - INVALID dependent");
+                    continue;
+                }
+
+                /* Check for dependants skipped for now. */
+                if(setSkipped.count(tx.hashPrevTx))
+                {
+                    setSkipped.insert(hash);
+                    continue;
+                }
+
+                /* Check for timestamp violations, which pass once the time catches up. */
+                if(tx.nTimestamp > runtime::unifiedtimestamp() + runtime::maxdrift())
+                {
+                    setSkipped.insert(hash);
+
+                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - timesamp too far in future");
+                    continue;
+                }
+
+                /* Check that the hashlast is on disk. If it is not, then the sig chain genesis must also be in this block.  If for
+                   any reason the genesis transaction should be in this block but failed one of the rules here, then we could end
+                   up with a subsequent transaction also in this block for which the genesis is not going to exist.  In which case
+                   we need to omit this transaction also. The simplest solution for this is to skip any transactions that are not
+                   the first in the sequence if the hash last is not currently on disk. If a sig chain transcation and subsequent
+                   transaction genuinely should be in the same block, then ths will just result in the subsequent transaction being
+                   left out of this block and included in the next. This is checked before connecting, so the MINER view
+                   only ever holds the transactions in the template. */
+                uint512_t hashLast = 0;
+                if(!tx.IsFirst() && !LLD::Ledger->ReadLast(tx.hashGenesis, hashLast))
+                {
+                    setDependents.insert(hash);
+
+                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - genesis not on disk");
+                    continue;
+                }
+
+                /* Check the pre-states and post-states. */
+                if(!tx.Verify(FLAGS::MINER))
+                {
+                    setDependents.insert(hash);
+
+                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - failed to verify");
+                    continue;
+                }
+
+                /* Check to see if this transaction connects. */
+                if(!tx.Connect(FLAGS::MINER))
+                {
+                    setDependents.insert(hash);
+
+                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - failed to connect");
+                    continue;
+                }
+
+                /* Dump sequence on verbose 3 levels. */
+                if(config::nVerbose >= 3)
+                    tx.print();
+
+                /* Add the transaction to the template. */
+                vtx.push_back(std::make_pair(TRANSACTION::TRITIUM, hash));
+                setIncluded.insert(hash);
+            }
+
+            debug::log(3, "END-------------------------------------");
+
+            /* Look at the memory pool again next call if any transactions were skipped for now. */
+            if(!setSkipped.empty())
+                nInsertions = 0;
+        }
+    }
+}
@@ -196,7 +196,11 @@ namespace TAO
                 /* Set the best to older block. */
                 LLD::TxnBegin();
                 state.SetBest();
-                LLD::TxnCommit();
+                if(!LLD::TxnCommit())
+                {
+                    LLD::TxnAbort();
+                    return debug::error(FUNCTION, "failed to commit forkblocks rollback to database");
+                }
             }
 
             /* Fill out the best chain stats. */
@@ -0,0 +1,147 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLC/hash/SK.h>
+
+#include <LLP/include/version.h>
+
+#include <TAO/Ledger/types/compactblock.h>
+#include <TAO/Ledger/types/mempool.h>
+
+#include <Util/templates/datastream.h>
+
+#include <map>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /** The bits of a short id that hold the hash. **/
+        const uint64_t SHORTID_MASK = 0x00ffffffffffffff;
+
+
+        /* Default constructor. */
+        CompactBlock::CompactBlock()
+        : block     ( )
+        , nSalt     (0)
+        , vShortIDs ( )
+        {
+        }
+
+
+        /* Build a compact block from a tritium block. */
+        CompactBlock::CompactBlock(const TritiumBlock& blockIn, const uint64_t nSaltIn)
+        : block     (blockIn)
+        , nSalt     (nSaltIn)
+        , vShortIDs ( )
+        {
+            /* The transactions are sent as short ids. */
+            block.vtx.clear();
+
+            /* Get the short ids in block order. */
+            vShortIDs.reserve(blockIn.vtx.size());
+            for(const auto& proof : blockIn.vtx)
+                vShortIDs.push_back(ShortID(proof.first, proof.second));
+        }
+
+
+        /* Default Destructor */
+        CompactBlock::~CompactBlock()
+        {
+        }
+
+
+        /* Get the short id of a transaction for this block's salt. */
+        uint64_t CompactBlock::ShortID(const uint8_t nType, const uint512_t& hashTx) const
+        {
+            /* Create a data stream to get the hash. */
+            DataStream ss(SER_GETHASH, LLP::PROTOCOL_VERSION);
+            ss << nSalt << hashTx;
+
+            return (uint64_t(nType) << 56) | (LLC::SK64(ss.begin(), ss.end()) & SHORTID_MASK);
+        }
+
+
+        /* Rebuild the tritium block from the transactions in the memory pool. */
+        bool CompactBlock::Reconstruct(TritiumBlock& blockOut, std::vector<uint32_t>& vMissing) const
+        {
+            /* Get the memory pool transactions. */
+            std::vector<std::pair<uint8_t, uint512_t>> vPool;
+            mempool.Hashes(vPool);
+
+            /* Map the short ids of the memory pool. A hash of zero marks an id shared by more than one transaction. */
+            std::map<uint64_t, uint512_t> mapShortIDs;
+            for(const auto& proof : vPool)
+            {
+                /* Check for a collision. */
+                const uint64_t nShortID = ShortID(proof.first, proof.second);
+                if(mapShortIDs.count(nShortID))
+                    mapShortIDs[nShortID] = 0;
+                else
+                    mapShortIDs[nShortID] = proof.second;
+            }
+
+            /* Copy the block and fill in the transactions that were found. */
+            blockOut = block;
+            blockOut.vtx.clear();
+            blockOut.vtx.reserve(vShortIDs.size());
+
+            vMissing.clear();
+            for(uint32_t n = 0; n < vShortIDs.size(); ++n)
+            {
+                /* Get the transaction type from the top byte. */
+                const uint8_t nType = static_cast<uint8_t>(vShortIDs[n] >> 56);
+
+                /* Missing and ambiguous transactions need to be requested. */
+                auto it = mapShortIDs.find(vShortIDs[n]);
+                if(it == mapShortIDs.end() || it->second == 0)
+                {
+                    blockOut.vtx.push_back(std::make_pair(nType, uint512_t(0)));
+                    vMissing.push_back(n);
+
+                    continue;
+                }
+
+                blockOut.vtx.push_back(std::make_pair(nType, it->second));
+            }
+
+            /* Wait for the missing transactions before checking the merkle root. */
+            if(!vMissing.empty())
+                return true;
+
+            /* Get the hashes for the merkle tree, with the producer(s) last. */
+            std::vector<uint512_t> vHashes;
+            vHashes.reserve(blockOut.vtx.size() + blockOut.vProducer.size() + 1);
+            for(const auto& proof : blockOut.vtx)
+                vHashes.push_back(proof.second);
+
+            if(blockOut.nVersion < 9)
+                vHashes.push_back(blockOut.producer.GetHash());
+            else
+            {
+                for(const auto& txProducer : blockOut.vProducer)
+                    vHashes.push_back(txProducer.GetHash());
+            }
+
+            /* Check the merkle root, so a short id that matched the wrong transaction is caught before processing. */
+            if(blockOut.hashMerkleRoot != blockOut.BuildMerkleTree(vHashes))
+                return debug::error(FUNCTION, "merkle root mismatch for compact block ", blockOut.GetHash().SubString());
+
+            return true;
+        }
+    }
+}
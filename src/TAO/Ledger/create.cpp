@@ -36,6 +36,7 @@ ________________________________________________________________________________
 #include <TAO/Ledger/include/timelocks.h>
 #include <TAO/Ledger/include/genesis_block.h>
 
+#include <TAO/Ledger/types/block_template.h>
 #include <TAO/Ledger/types/mempool.h>
 #include <TAO/Ledger/types/client.h>
 
@@ -160,102 +161,16 @@ namespace TAO
             /* Clear the transactions. */
             block.vtx.clear();
 
-            /* Check the memory pool. */
-            std::vector<uint512_t> vMempool;
-            mempool.List(vMempool);
-
-            /* Start a ACID transaction (to be disposed). */
-            LLD::TxnBegin(FLAGS::MINER);
-
-            debug::log(3, "BEGIN-------------------------------------");
-
-            /* Loop through the list of transactions. */
-            std::set<uint512_t> setDependents;
-            for(const auto& hash : vMempool)
-            {
-                /* Check the Size limits of the Current Block. */
-                if(::GetSerializeSize(block, SER_NETWORK, LLP::PROTOCOL_VERSION) + 256 >= MAX_BLOCK_SIZE)
-                    break;
-
-                /* Get the transaction from the memory pool. */
-                TAO::Ledger::Transaction tx;
-                if(!mempool.Get(hash, tx))
-                    continue;
-
-                /* Don't add transactions that are coinbase or coinstake. */
-                if(tx.IsCoinBase() || tx.IsCoinStake())
-                {
-                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - tx is coinbase/coinstake");
-                    continue;
-                }
-
-                /* Check for failed dependants. */
-                if(setDependents.count(tx.hashPrevTx))
-                {
-                    setDependents.insert(hash);
-
-                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - INVALID dependent");
-                    continue;
-                }
-
-                /* Check for timestamp violations. */
-                if(tx.nTimestamp > runtime::unifiedtimestamp() + runtime::maxdrift())
-                {
-                    setDependents.insert(hash);
-
-                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - timesamp too far in future");
-                    continue;
-                }
-
-                /* Check the pre-states and post-states. */
-                if(!tx.Verify(FLAGS::MINER))
-                {
-                    setDependents.insert(hash);
-
-                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - failed to verify");
-                    continue;
-                }
-
-                /* Check to see if this transaction connects. */
-                if(!tx.Connect(FLAGS::MINER))
-                {
-                    setDependents.insert(hash);
-
-                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - failed to connect");
-                    continue;
-                }
+            /* Get the tritium transactions from the template, which only does work for memory pool changes since the last block. */
+            const uint64_t nReserved = ::GetSerializeSize(block, SER_NETWORK, LLP::PROTOCOL_VERSION);
+            blocktemplate.Get(block.vtx, nReserved);
 
-                /* Check that the hashlast is on disk. If it is not, then the sig chain genesis must also be in this block.  If for
-                   any reason the genesis transaction should be in this block but failed one of the above rules, then we could end
-                   up with a subsequent transaction also in this block for which the genesis is not going to exist.  In which case
-                   we need to omit this transaction also. The simplest solution for this is to skip any transactions that are not
-                   the first in the sequence if the hash last is not currently on disk. If a sig chain transcation and subsequent
-                   transaction genuinely should be in the same block, then ths will just result in the subsequent transaction being
-                   left out of this block and included in the next.*/
-                uint512_t hashLast = 0;
-                if(!tx.IsFirst() && !LLD::Ledger->ReadLast(tx.hashGenesis, hashLast) )
-                {
-                    setDependents.insert(hash);
-
-                    debug::log(2, FUNCTION, "Skipping transaction ", hash.SubString(), " - genesis not on disk");
-                    continue;
-                }
+            /* Track the block size by entry, rather than serializing the whole block for each transaction. */
+            const uint64_t nEntry = BlockTemplate::EntrySize();
+            uint64_t nSize = nReserved + block.vtx.size() * nEntry;
 
-                /* Dump sequence on verbose 3 levels. */
-                if(config::nVerbose >= 3)
-                    tx.print();
-
-                /* Add the transaction to the block. */
-                block.vtx.push_back(std::make_pair(TRANSACTION::TRITIUM, hash));
-            }
-
-            debug::log(3, "END-------------------------------------");
-
-            /* Abort the temporary ACID transaction. */
-            LLD::TxnAbort(FLAGS::MINER);
-
-            /* Clear for legacy. */
-            vMempool.clear();
+            /* Check the memory pool. */
+            std::vector<uint512_t> vMempool;
 
             /* Retrieve list of transaction hashes from mempool. Limit list to a sane size that would typically more than fill a
              * legacy block, rather than pulling entire pool if it is very large. */
@@ -266,7 +181,7 @@ namespace TAO
             for(const auto& hash : vMempool)
             {
                 /* Check the Size limits of the Current Block. */
-                if(::GetSerializeSize(block, SER_NETWORK, LLP::PROTOCOL_VERSION) + 256 >= MAX_BLOCK_SIZE)
+                if(nSize + 256 >= MAX_BLOCK_SIZE)
                     break;
 
                 /* Get the transaction from the memory pool. */
@@ -324,6 +239,7 @@ namespace TAO
 
                 /* Add the transaction to the block. */
                 block.vtx.push_back(std::make_pair(TRANSACTION::LEGACY, hash));
+                nSize += nEntry;
             }
         }
 
@@ -362,6 +278,113 @@ namespace TAO
         }
 
 
+        /* Update the producer of a cached mining block for a new extra nonce, and sign it. */
+        bool UpdateProducer(const memory::encrypted_ptr<TAO::Ledger::SignatureChain>& user, const SecureString& pin,
+            const uint32_t nChannel, TAO::Ledger::TritiumBlock& block, const uint64_t nExtraNonce,
+            Legacy::Coinbase *pCoinbaseRecipients)
+        {
+            /* Retrieve block producer from the block */
+            TAO::Ledger::Transaction txProducer;
+            if(block.nVersion < 9)
+                txProducer = block.producer;
+            else
+                txProducer = block.vProducer.back(); //outside of stake pool, only one producer
+
+            /* Use the extra nonce if block is coinbase. */
+            if(nChannel == 1 || nChannel == 2)
+            {
+                /* Output type 0 is mining/minting reward */
+                uint64_t nBlockReward = GetCoinbaseReward(ChainState::stateBest.load(), nChannel, 0);
+
+                /* Create coinbase transaction. */
+                txProducer[0].Clear();
+                txProducer[0] << uint8_t(TAO::Operation::OP::COINBASE);
+
+                /* Add the spendable genesis. */
+                txProducer[0] << user->Genesis();
+
+                /* The total to be credited. */
+                uint64_t nCredit = nBlockReward;
+
+                /* If there are coinbase recipients, set the reward to the coinbase wallet reward. */
+                if(pCoinbaseRecipients && !pCoinbaseRecipients->IsNull())
+                    nCredit = pCoinbaseRecipients->WalletReward();
+
+                /* Check to make sure credit is non-zero. */
+                if(nCredit == 0)
+                    return debug::error(FUNCTION, "Empty block producer reward.");
+
+                txProducer[0] << nCredit;
+
+                /* The extra nonce to coinbase. */
+                txProducer[0] << nExtraNonce;
+
+                /* Add coinbase recipient amounts to block producer transaction if any. */
+                if(pCoinbaseRecipients && !pCoinbaseRecipients->IsNull())
+                {
+                    /* Ensure wallet reward and recipient amounts add up to correct block reward. */
+                    if(!pCoinbaseRecipients->IsValid())
+                        return debug::error(FUNCTION, "Coinbase recipients contain invalid amounts.");
+
+                    /* Get the map of outputs for this coinbase. */
+                    std::map<std::string, uint64_t> mapOutputs = pCoinbaseRecipients->Outputs();
+                    uint32_t nTx = 1;
+
+                    for(const auto& entry : mapOutputs)
+                    {
+                        /* Build the recipient address from a hex string. */
+                        uint256_t hashGenesis = uint256_t(entry.first);
+
+                        /* Ensure the address is valid. */
+                        if(!LLD::Ledger->HasGenesis(hashGenesis))
+                            return debug::error(FUNCTION, "Invaild recipient address: ", entry.first, " (", nTx, ")");
+
+                        /* Set coinbase operation. */
+                        txProducer[nTx].Clear();
+                        txProducer[nTx] << uint8_t(TAO::Operation::OP::COINBASE);
+
+                        /* Set sigchain recipient. */
+                        txProducer[nTx] << hashGenesis;
+
+                        /* Set coinbase amount for associated recipent. */
+                        txProducer[nTx] << entry.second;
+
+                        /* The extra nonce to coinbase. */
+                        txProducer[nTx] << nExtraNonce;
+
+                        ++nTx;
+                    }
+                }
+            }
+            else if(nChannel == 3)
+            {
+                /* Create an authorize producer. */
+                txProducer[0].Clear();
+                txProducer[0] << uint8_t(TAO::Operation::OP::AUTHORIZE);
+
+                /* Get the sigchain txid. */
+                txProducer[0] << txProducer.hashPrevTx;
+
+                /* Set the genesis operation. */
+                txProducer[0] << txProducer.hashGenesis;
+            }
+
+            /* Sign the producer transaction. */
+            txProducer.Sign(user->Generate(txProducer.nSequence, pin));
+
+            /* Update block producer */
+            if(block.nVersion < 9)
+                block.producer = txProducer;
+            else
+            {
+                block.vProducer.clear();
+                block.vProducer.push_back(txProducer);
+            }
+
+            return true;
+        }
+
+
         /* Create a new block object from the chain. */
         bool CreateBlock(const memory::encrypted_ptr<TAO::Ledger::SignatureChain>& user, const SecureString& pin,
             const uint32_t nChannel, TAO::Ledger::TritiumBlock& block, const uint64_t nExtraNonce,
@@ -430,96 +453,9 @@ namespace TAO
                     blockCache[nChannel].store(block);
                 }
 
-                /* Use the extra nonce if block is coinbase. */
-                if(nChannel == 1 || nChannel == 2)
-                {
-                    /* Output type 0 is mining/minting reward */
-                    uint64_t nBlockReward = GetCoinbaseReward(ChainState::stateBest.load(), nChannel, 0);
-
-                    /* Create coinbase transaction. */
-                    txProducer[0].Clear();
-                    txProducer[0] << uint8_t(TAO::Operation::OP::COINBASE);
-
-                    /* Add the spendable genesis. */
-                    txProducer[0] << user->Genesis();
-
-                    /* The total to be credited. */
-                    uint64_t nCredit = nBlockReward;
-
-                    /* If there are coinbase recipients, set the reward to the coinbase wallet reward. */
-                    if(pCoinbaseRecipients && !pCoinbaseRecipients->IsNull())
-                        nCredit = pCoinbaseRecipients->WalletReward();
-
-                    /* Check to make sure credit is non-zero. */
-                    if(nCredit == 0)
-                        return debug::error(FUNCTION, "Empty block producer reward.");
-
-                    txProducer[0] << nCredit;
-
-                    /* The extra nonce to coinbase. */
-                    txProducer[0] << nExtraNonce;
-
-                    /* Add coinbase recipient amounts to block producer transaction if any. */
-                    if(pCoinbaseRecipients && !pCoinbaseRecipients->IsNull())
-                    {
-                        /* Ensure wallet reward and recipient amounts add up to correct block reward. */
-                        if(!pCoinbaseRecipients->IsValid())
-                            return debug::error(FUNCTION, "Coinbase recipients contain invalid amounts.");
-
-                        /* Get the map of outputs for this coinbase. */
-                        std::map<std::string, uint64_t> mapOutputs = pCoinbaseRecipients->Outputs();
-                        uint32_t nTx = 1;
-
-                        for(const auto& entry : mapOutputs)
-                        {
-                            /* Build the recipient address from a hex string. */
-                            uint256_t hashGenesis = uint256_t(entry.first);
-
-                            /* Ensure the address is valid. */
-                            if(!LLD::Ledger->HasGenesis(hashGenesis))
-                                return debug::error(FUNCTION, "Invaild recipient address: ", entry.first, " (", nTx, ")");
-
-                            /* Set coinbase operation. */
-                            txProducer[nTx].Clear();
-                            txProducer[nTx] << uint8_t(TAO::Operation::OP::COINBASE);
-
-                            /* Set sigchain recipient. */
-                            txProducer[nTx] << hashGenesis;
-
-                            /* Set coinbase amount for associated recipent. */
-                            txProducer[nTx] << entry.second;
-
-                            /* The extra nonce to coinbase. */
-                            txProducer[nTx] << nExtraNonce;
-
-                            ++nTx;
-                        }
-                    }
-                }
-                else if(nChannel == 3)
-                {
-                    /* Create an authorize producer. */
-                    txProducer[0].Clear();
-                    txProducer[0] << uint8_t(TAO::Operation::OP::AUTHORIZE);
-
-                    /* Get the sigchain txid. */
-                    txProducer[0] << txProducer.hashPrevTx;
-
-                    /* Set the genesis operation. */
-                    txProducer[0] << txProducer.hashGenesis;
-                }
-
-                /* Sign the producer transaction. */
-                txProducer.Sign(user->Generate(txProducer.nSequence, pin));
-
-                /* Update block producer */
-                if(block.nVersion < 9)
-                    block.producer = txProducer;
-                else
-                {
-                    block.vProducer.clear();
-                    block.vProducer.push_back(txProducer);
-                }
+                /* Set the producer for this extra nonce. */
+                if(!UpdateProducer(user, pin, nChannel, block, nExtraNonce, pCoinbaseRecipients))
+                    return false;
 
                 /* Rebuild the merkle tree for updated block. */
                 std::vector<uint512_t> vHashes;
@@ -527,7 +463,7 @@ namespace TAO
                     vHashes.push_back(tx.second);
 
                 /* Producer transaction is last. */
-                vHashes.push_back(txProducer.GetHash());
+                vHashes.push_back(block.nVersion < 9 ? block.producer.GetHash() : block.vProducer.back().GetHash());
 
                 /* Build the block's merkle root. */
                 block.hashMerkleRoot = block.BuildMerkleTree(vHashes);
@@ -72,6 +72,24 @@ namespace TAO
         void AddBlockData(const TAO::Ledger::BlockState& stateBest, const uint32_t nChannel, TAO::Ledger::TritiumBlock& block);
 
 
+        /** UpdateProducer
+         *
+         *  Update the producer of a cached mining block for a new extra nonce and coinbase recipients, and sign it.
+         *  The merkle root is left to the caller.
+         *
+         *  @param[in] user The signature chain to generate this block
+         *  @param[in] pin The pin number to generate with.
+         *  @param[in] nChannel The channel to create block for.
+         *  @param[out] block The block object with the producer to update.
+         *  @param[in] nExtraNonce An extra nonce to use for double iterating.
+         *  @param[in] pCoinbaseRecipients The coinbase recipients, if any.
+         *
+         **/
+        bool UpdateProducer(const memory::encrypted_ptr<TAO::Ledger::SignatureChain>& user, const SecureString& pin,
+                            const uint32_t nChannel, TAO::Ledger::TritiumBlock& block, const uint64_t nExtraNonce = 0,
+                            Legacy::Coinbase *pCoinbaseRecipients = nullptr);
+
+
         /** CreateBlock
          *
          *  Create a new block object from the chain.
@@ -0,0 +1,54 @@
+/*__________________________________________________________________________________________
+
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+			(c) Copyright The Nexus Developers 2014 - 2019
+
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+			"ad vocem populi" - To The Voice of The People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_TAO_LEDGER_INCLUDE_VALIDATION_H
+#define NEXUS_TAO_LEDGER_INCLUDE_VALIDATION_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /** ValidationThreads
+         *
+         *  Get the number of threads that help run context-free checks, set with -validationthreads.
+         *  Zero runs the checks on the calling thread alone.
+         *
+         **/
+        uint32_t ValidationThreads();
+
+
+        /** CheckParallel
+         *
+         *  Run checks that don't depend on chain state, such as signatures, on the validation threads.
+         *  The calling thread takes checks as well, and once a check fails the rest are skipped.
+         *
+         *  @param[in] vChecks The checks to run, in no given order.
+         *
+         *  @return True if every check passed.
+         *
+         **/
+        bool CheckParallel(const std::vector<std::function<bool()>>& vChecks);
+
+    }
+}
+
+#endif
@@ -26,10 +26,15 @@ ________________________________________________________________________________
 #include <TAO/Ledger/include/constants.h>
 #include <TAO/Ledger/include/timelocks.h>
 #include <TAO/Ledger/include/chainstate.h>
+#include <TAO/Ledger/include/enum.h>
 #include <TAO/Ledger/types/mempool.h>
+#include <TAO/Ledger/types/verify_cache.h>
 
 #include <TAO/Ledger/include/create.h>
 
+#include <Util/include/args.h>
+#include <Util/templates/serialize.h>
+
 
 /* Global TAO namespace. */
 namespace TAO
@@ -40,17 +45,33 @@ namespace TAO
     {
         Mempool mempool;
 
+
+        /* The size the ledger memory pool is kept under, set in megabytes with -maxmempool. */
+        static uint64_t max_bytes()
+        {
+            return static_cast<uint64_t>(std::max(int64_t(1), config::GetArg("-maxmempool", 300))) * 1024 * 1024;
+        }
+
+
         /** Default Constructor. **/
         Mempool::Mempool()
         : MUTEX              ( )
+        , INDEX_MUTEX        ( )
         , mapLegacy          ( )
         , mapLegacyConflicts ( )
         , mapLedger          ( )
+        , mapSequences       ( )
+        , setPriority        ( )
         , mapConflicts       ( )
         , mapOrphans         ( )
         , mapClaimed         ( )
         , mapInputs          ( )
         , setOrphansByIndex  ( )
+        , nBytes             (0)
+        , nFees              (0)
+        , nEvicted           (0)
+        , nInsertions        (0)
+        , nRemovals          (0)
         {
         }
 
@@ -74,7 +95,8 @@ namespace TAO
                 return false;
 
             /* Add to the map. */
-            mapLedger[hashTx] = tx;
+            WLOCK(INDEX_MUTEX);
+            insert(hashTx, tx, false);
 
             return true;
         }
@@ -113,6 +135,10 @@ namespace TAO
             if(!tx.Check())
                 return debug::error(FUNCTION, "tx ", hashTx.SubString(), " REJECTED: ", debug::GetLastError());
 
+            /* The checks don't depend on chain state, so blocks with this transaction can skip them once signatures are checked. */
+            if(!ChainState::Synchronizing())
+                verifycache.AddChecked(hashTx);
+
             /* Check for orphans and conflicts when not first transaction. */
             if(!tx.IsFirst())
             {
@@ -125,8 +151,12 @@ namespace TAO
                         " ORPHAN in ", std::dec, time.ElapsedMilliseconds(), " ms");
 
                     /* Push to orphan queue. */
-                    mapOrphans[tx.hashPrevTx] = tx;
-                    setOrphansByIndex.insert(hashTx);
+                    {
+                        WLOCK(INDEX_MUTEX);
+
+                        mapOrphans[tx.hashPrevTx] = tx;
+                        setOrphansByIndex.insert(hashTx);
+                    }
 
                     /* Increment consecutive orphans. */
                     if(pnode)
@@ -144,6 +174,8 @@ namespace TAO
                 {
                     /* Add to conflicts map. */
                     debug::error(FUNCTION, "CONFLICT: prev tx ", (mapClaimed.count(tx.hashPrevTx) ? "CLAIMED " : "CONFLICTED "), tx.hashPrevTx.SubString());
+
+                    WLOCK(INDEX_MUTEX);
                     mapConflicts[hashTx] = tx;
 
                     return false;
@@ -159,6 +191,8 @@ namespace TAO
                 {
                     /* Add to conflicts map. */
                     debug::error(FUNCTION, "CONFLICT: hash last mismatch ", tx.hashPrevTx.SubString());
+
+                    WLOCK(INDEX_MUTEX);
                     mapConflicts[hashTx] = tx;
 
                     return false;
@@ -169,6 +203,9 @@ namespace TAO
             if(!tx.Verify(FLAGS::MEMPOOL))
                 return debug::error(FUNCTION, "tx ", hashTx.SubString(), " REJECTED: ", debug::GetLastError());
 
+            /* Verify against the registers on disk too, so connecting the block can skip it while they are unchanged. */
+            verifycache.AddVerified(tx);
+
             /* Connect transaction in memory. */
             LLD::TxnBegin(FLAGS::MEMPOOL);
             if(!tx.Connect(FLAGS::MEMPOOL))
@@ -183,11 +220,18 @@ namespace TAO
             LLD::TxnCommit(FLAGS::MEMPOOL);
 
             /* Set the internal memory. */
-            mapLedger[hashTx] = tx;
+            {
+                WLOCK(INDEX_MUTEX);
+                insert(hashTx, tx, true);
 
-            /* Update map claimed if not first tx. */
-            if(!tx.IsFirst())
-                mapClaimed[tx.hashPrevTx] = hashTx;
+                /* Update map claimed if not first tx. */
+                if(!tx.IsFirst())
+                    mapClaimed[tx.hashPrevTx] = hashTx;
+            }
+
+            /* Keep the pool under its size limit. */
+            if(!evict(hashTx))
+                return debug::error(FUNCTION, "tx ", hashTx.SubString(), " REJECTED: memory pool full");
 
             /* Debug output. */
             debug::log(3, FUNCTION, "tx ", hashTx.SubString(), " ACCEPTED in ", std::dec, time.ElapsedMilliseconds(), " ms");
@@ -242,8 +286,12 @@ namespace TAO
                 }
 
                 /* Erase the transaction. */
-                mapOrphans.erase(hashTx);
-                setOrphansByIndex.erase(hashThis);
+                {
+                    WLOCK(INDEX_MUTEX);
+
+                    mapOrphans.erase(hashTx);
+                    setOrphansByIndex.erase(hashThis);
+                }
 
                 /* Set the hashTx. */
                 hashTx = hashThis;
@@ -254,13 +302,14 @@ namespace TAO
         /* Gets a transaction from mempool */
         bool Mempool::Get(const uint512_t& hashTx, TAO::Ledger::Transaction &tx, bool &fConflicted) const
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
             /* Check in conflict memory. */
-            if(mapConflicts.count(hashTx))
+            auto itConflict = mapConflicts.find(hashTx);
+            if(itConflict != mapConflicts.end())
             {
                 /* Get from conflicts map. */
-                tx = mapConflicts.at(hashTx);
+                tx = itConflict->second;
                 fConflicted = true;
 
                 debug::log(0, FUNCTION, "CONFLICTED TRANSACTION: ", hashTx.SubString());
@@ -269,9 +318,10 @@ namespace TAO
             }
 
             /* Check in ledger memory. */
-            if(mapLedger.count(hashTx))
+            auto it = mapLedger.find(hashTx);
+            if(it != mapLedger.end())
             {
-                tx = mapLedger.at(hashTx);
+                tx = it->second.tx;
 
                 return true;
             }
@@ -283,12 +333,13 @@ namespace TAO
         /* Gets a transaction from mempool */
         bool Mempool::Get(const uint512_t& hashTx, TAO::Ledger::Transaction &tx) const
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
             /* Check in ledger memory. */
-            if(mapLedger.count(hashTx))
+            auto it = mapLedger.find(hashTx);
+            if(it != mapLedger.end())
             {
-                tx = mapLedger.at(hashTx);
+                tx = it->second.tx;
 
                 return true;
             }
@@ -300,23 +351,15 @@ namespace TAO
         /* Get by genesis. */
         bool Mempool::Get(const uint256_t& hashGenesis, std::vector<TAO::Ledger::Transaction> &vtx) const
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
-            /* Check through the ledger map for the genesis. */
-            for(const auto& tx : mapLedger)
-            {
-                /* Check for non-conflicted genesis-id's. */
-                if(tx.second.hashGenesis == hashGenesis)
-                    vtx.push_back(tx.second);
-            }
+            /* Get the transactions for the genesis in sequence order. */
+            sequence(hashGenesis, vtx);
 
             /* Check that a transaction was found. */
             if(vtx.size() == 0)
                 return false;
 
-            /* Sort the list by sequence numbers. */
-            std::sort(vtx.begin(), vtx.end());
-
             /* Check that the mempool transactions are in correct order. */
             uint512_t hashLast = vtx[0].GetHash();
             for(uint32_t n = 1; n < vtx.size(); ++n)
@@ -358,7 +401,7 @@ namespace TAO
         /* Checks if a transaction exists. */
         bool Mempool::Has(const uint512_t& hashTx) const
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
             return mapLedger.count(hashTx) || mapLegacy.count(hashTx) || mapConflicts.count(hashTx);
         }
@@ -367,14 +410,9 @@ namespace TAO
         /* Checks if a genesis exists. */
         bool Mempool::Has(const uint256_t& hashGenesis) const
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
-            /* Check through the ledger map for the genesis. */
-            for(const auto& tx : mapLedger)
-                if(tx.second.hashGenesis == hashGenesis)
-                    return true;
-
-            return false;
+            return mapSequences.count(hashGenesis);
         }
 
 
@@ -382,29 +420,28 @@ namespace TAO
         bool Mempool::Remove(const uint512_t& hashTx)
         {
             RLOCK(MUTEX);
+            WLOCK(INDEX_MUTEX);
 
             /* Erase from conflicted memory. */
-            if(mapConflicts.count(hashTx))
-                mapConflicts.erase(hashTx);
+            mapConflicts.erase(hashTx);
 
             /* Erase from legacy conflicted memory. */
-            if(mapLegacyConflicts.count(hashTx))
-                mapLegacyConflicts.erase(hashTx);
+            mapLegacyConflicts.erase(hashTx);
 
             /* Erase from orphans memory. */
-            if(setOrphansByIndex.count(hashTx))
-                setOrphansByIndex.erase(hashTx);
+            setOrphansByIndex.erase(hashTx);
 
             /* Find the transaction in pool. */
-            if(mapLedger.count(hashTx))
+            auto it = mapLedger.find(hashTx);
+            if(it != mapLedger.end())
             {
-                /* Get a reference from the map. */
-                const TAO::Ledger::Transaction& tx = mapLedger[hashTx];
+                /* Get the previous hash before the entry is gone. */
+                const uint512_t hashPrevTx = it->second.tx.hashPrevTx;
 
                 /* Erase from the memory map. */
-                mapClaimed.erase(tx.hashPrevTx);
-                mapOrphans.erase(tx.hashPrevTx);
-                mapLedger.erase(hashTx);
+                mapClaimed.erase(hashPrevTx);
+                mapOrphans.erase(hashPrevTx);
+                erase(hashTx);
 
                 return true;
             }
@@ -433,31 +470,22 @@ namespace TAO
 
             //TODO: evict conflicted transctions from mempool
 
-            /* Create map of transactions by genesis. */
-            std::map<uint256_t, std::vector<TAO::Ledger::Transaction> > mapTransactions;
-
-            /* Loop through all the transactions. */
-            for(const auto& tx : mapLedger)
-            {
-                /* Cache the genesis. */
-                const uint256_t& hashGenesis = tx.second.hashGenesis;
-
-                /* Check in map for push back. */
-                if(!mapTransactions.count(hashGenesis))
-                    mapTransactions[hashGenesis] = std::vector<TAO::Ledger::Transaction>();
+            /* Get the signature chains in the pool, as transactions are removed while checking them. */
+            std::vector<uint256_t> vGenesis;
+            vGenesis.reserve(mapSequences.size());
+            for(const auto& list : mapSequences)
+                vGenesis.push_back(list.first);
 
-                /* Push to back of map. */
-                mapTransactions[hashGenesis].push_back(tx.second);
-            }
-
-            /* Loop transctions map by genesis. */
-            for(auto& list : mapTransactions)
+            /* Loop transctions by genesis. */
+            for(const auto& hashGenesis : vGenesis)
             {
-                /* Get reference of the vector. */
-                std::vector<TAO::Ledger::Transaction>& vtx = list.second;
+                /* Get the transactions in sequence order. */
+                std::vector<TAO::Ledger::Transaction> vtx;
+                sequence(hashGenesis, vtx);
 
-                /* Sort the list by sequence numbers. */
-                std::sort(vtx.begin(), vtx.end());
+                /* Check for signature chains emptied by an earlier removal. */
+                if(vtx.empty())
+                    continue;
 
                 /* Add the hashes into list. */
                 uint512_t hashLast = 0;
@@ -466,8 +494,8 @@ namespace TAO
                 if(!vtx[0].IsFirst())
                 {
                     /* Read last hash. */
-                    if(!LLD::Ledger->ReadLast(list.first, hashLast))
-                        break;
+                    if(!LLD::Ledger->ReadLast(hashGenesis, hashLast))
+                        continue;
 
                     /* Check the last hash. */
                     if(vtx[0].hashPrevTx != hashLast)
@@ -492,20 +520,23 @@ namespace TAO
                             }
 
                             /* Find the transaction in pool. */
-                            if(mapLedger.count(tx->GetHash()))
+                            const uint512_t hashTx = tx->GetHash();
+                            if(mapLedger.count(hashTx))
                             {
-                                debug::log(0, "DELETED ", tx->GetHash().SubString());
+                                debug::log(0, "DELETED ", hashTx.SubString());
 
                                 /* Erase from the memory map. */
+                                WLOCK(INDEX_MUTEX);
+
                                 mapClaimed.erase(tx->hashPrevTx);
-                                mapLedger.erase(tx->GetHash());
+                                erase(hashTx);
                             }
                         }
 
                         debug::log(3, "END REMOVE ------------------------------");
 
 
-                        break;
+                        continue;
                     }
                 }
 
@@ -515,10 +546,6 @@ namespace TAO
                 /* Loop through transaction by genesis. */
                 for(uint32_t n = 1; n < vtx.size(); ++n)
                 {
-                    /* Check for end of index. */
-                    if(n == vtx.size())
-                        break;
-
                     /* Check that transaction is in sequence. */
                     if(vtx[n].hashPrevTx != hashLast)
                     {
@@ -571,81 +598,57 @@ namespace TAO
         /* List transactions in memory pool. */
         bool Mempool::List(std::vector<uint512_t> &vHashes, uint32_t nCount, bool fLegacy)
         {
-            RLOCK(MUTEX);
-
-            //TODO: need to check dependant transactions and sequence them properly otherwise this will fail
+            SLOCK(INDEX_MUTEX);
 
             /* If legacy flag set, skip over getting tritium transactions. */
             if(!fLegacy)
             {
-                /* Create map of transactions by genesis. */
-                std::map<uint256_t, std::vector<TAO::Ledger::Transaction> > mapTransactions;
-
-                /* Loop through all the transactions. */
-                for(const auto& tx : mapLedger)
+                /* Visit signature chains in the order of their highest priority transaction. */
+                std::unordered_set<uint256_t, Hasher> setListed;
+                for(const auto& priority : setPriority)
                 {
-                    /* Check that this transaction isn't conflicted. */
-                    //if(mapConflicts.count(tx.first))
-                    //    continue;
-
                     /* Cache the genesis. */
-                    const uint256_t& hashGenesis = tx.second.hashGenesis;
+                    const uint256_t& hashGenesis = mapLedger.at(priority.hashTx).tx.hashGenesis;
 
-                    /* Check in map for push back. */
-                    if(!mapTransactions.count(hashGenesis))
-                        mapTransactions[hashGenesis] = std::vector<TAO::Ledger::Transaction>();
+                    /* Check that the signature chain wasn't listed already. */
+                    if(!setListed.insert(hashGenesis).second)
+                        continue;
 
-                    /* Push to back of map. */
-                    mapTransactions[hashGenesis].push_back(tx.second);
-                }
-
-                /* Loop transctions map by genesis. */
-                for(auto& list : mapTransactions)
-                {
-                    /* Get reference of the vector. */
-                    std::vector<TAO::Ledger::Transaction>& vtx = list.second;
-
-                    /* Sort the list by sequence numbers. */
-                    std::sort(vtx.begin(), vtx.end());
-
-                    /* Add the hashes into list. */
-                    uint512_t hashLast = 0;
+                    /* Get the transactions by sequence. */
+                    const std::set<std::pair<uint32_t, uint512_t>>& setSequence = mapSequences.at(hashGenesis);
 
                     /* Check last hash for valid transactions. */
-                    if(!vtx[0].IsFirst())
+                    const TAO::Ledger::Transaction& txFirst = mapLedger.at(setSequence.begin()->second).tx;
+                    if(!txFirst.IsFirst())
                     {
                         /* Read last index from disk. */
-                        if(!LLD::Ledger->ReadLast(list.first, hashLast))
-                            break; //NOTE: this may need an error
+                        uint512_t hashLast = 0;
+                        if(!LLD::Ledger->ReadLast(hashGenesis, hashLast))
+                            continue;
 
                         /* Check the last hash. */
-                        if(vtx[0].hashPrevTx != hashLast)
-                            break;
+                        if(txFirst.hashPrevTx != hashLast)
+                            continue;
                     }
 
-                    /* Set last from next transaction. */
-                    hashLast = vtx[0].GetHash();
-
                     /* Loop through transaction by genesis. */
-                    for(uint32_t n = 1; n <= vtx.size(); ++n)
+                    uint512_t hashLast = 0;
+                    for(const auto& seq : setSequence)
                     {
-                        /* Add to the output queue. */
-                        vHashes.push_back(hashLast);
-
-                        /* Check for end of index. */
-                        if(n == vtx.size())
+                        /* Check that transaction is in sequence, skipping any orphans found. */
+                        const TAO::Ledger::Transaction& tx = mapLedger.at(seq.second).tx;
+                        if(hashLast != 0 && tx.hashPrevTx != hashLast)
                             break;
 
+                        /* Add to the output queue. */
+                        vHashes.push_back(seq.second);
+
                         /* Check count. */
                         if(--nCount == 0)
                             return true;
 
-                        /* Check that transaction is in sequence. */
-                        if(vtx[n].hashPrevTx != hashLast)
-                            break; //SKIP ANY ORPHANS FOUND
-
                         /* Set last hash. */
-                        hashLast = vtx[n].GetHash();
+                        hashLast = seq.second;
                     }
                 }
             }
@@ -667,12 +670,267 @@ namespace TAO
         }
 
 
+        /* Get the hashes of all transactions in memory pool, including conflicted transactions. */
+        void Mempool::Hashes(std::vector<std::pair<uint8_t, uint512_t>> &vtx) const
+        {
+            SLOCK(INDEX_MUTEX);
+
+            /* Reserve room for every transaction. */
+            vtx.reserve(vtx.size() + mapLedger.size() + mapConflicts.size() + mapLegacy.size() + mapLegacyConflicts.size());
+
+            /* Add the tritium transactions. */
+            for(const auto& tx : mapLedger)
+                vtx.push_back(std::make_pair(uint8_t(TRANSACTION::TRITIUM), tx.first));
+
+            for(const auto& tx : mapConflicts)
+                vtx.push_back(std::make_pair(uint8_t(TRANSACTION::TRITIUM), tx.first));
+
+            /* Add the legacy transactions. */
+            for(const auto& tx : mapLegacy)
+                vtx.push_back(std::make_pair(uint8_t(TRANSACTION::LEGACY), tx.first));
+
+            for(const auto& tx : mapLegacyConflicts)
+                vtx.push_back(std::make_pair(uint8_t(TRANSACTION::LEGACY), tx.first));
+        }
+
+
         /* Gets the size of the memory pool. */
         uint32_t Mempool::Size()
         {
-            RLOCK(MUTEX);
+            SLOCK(INDEX_MUTEX);
 
             return static_cast<uint32_t>(mapLedger.size() + mapLegacy.size());
         }
+
+
+        /* Gets the statistics of the memory pool. */
+        Mempool::Info Mempool::GetInfo() const
+        {
+            SLOCK(INDEX_MUTEX);
+
+            Info info;
+            info.nTransactions = static_cast<uint32_t>(mapLedger.size());
+            info.nLegacy       = static_cast<uint32_t>(mapLegacy.size());
+            info.nConflicts    = static_cast<uint32_t>(mapConflicts.size() + mapLegacyConflicts.size());
+            info.nOrphans      = static_cast<uint32_t>(setOrphansByIndex.size());
+            info.nGenesis      = static_cast<uint32_t>(mapSequences.size());
+            info.nBytes        = nBytes;
+            info.nMaxBytes     = max_bytes();
+            info.nFees         = nFees;
+            info.nEvicted      = nEvicted;
+
+            return info;
+        }
+
+
+        /* Gets the number of ledger transactions added since startup. */
+        uint64_t Mempool::Insertions() const
+        {
+            return nInsertions.load();
+        }
+
+
+        /* Gets the number of ledger transactions removed since startup. */
+        uint64_t Mempool::Removals() const
+        {
+            return nRemovals.load();
+        }
+
+
+        /* Add a ledger transaction to the pool and its indexes. */
+        void Mempool::insert(const uint512_t& hashTx, const TAO::Ledger::Transaction& tx, const bool fConnected)
+        {
+            /* Build the entry. */
+            Entry& entry     = mapLedger[hashTx];
+            entry.tx         = tx;
+            entry.nFees      = tx.Fees();
+            entry.nTime      = runtime::unifiedtimestamp();
+            entry.nBytes     = ::GetSerializeSize(tx, SER_NETWORK, LLP::PROTOCOL_VERSION);
+            entry.fConnected = fConnected;
+
+            /* Add to the indexes. */
+            mapSequences[tx.hashGenesis].insert(std::make_pair(tx.nSequence, hashTx));
+            setPriority.insert(Priority{entry.nFees, entry.nTime, hashTx});
+
+            /* Add to the dependents of the transactions its contracts refer to. */
+            for(uint32_t nContract = 0; nContract < tx.Size(); ++nContract)
+            {
+                uint512_t hashPrev = 0;
+                if(tx[nContract].Previous(hashPrev))
+                    mapDependents[hashPrev].insert(hashTx);
+            }
+
+            /* Add to the totals. */
+            nBytes += entry.nBytes;
+            nFees  += entry.nFees;
+
+            ++nInsertions;
+        }
+
+
+        /* Remove a ledger transaction from the pool and its indexes. */
+        bool Mempool::erase(const uint512_t& hashTx)
+        {
+            /* Find the entry. */
+            auto it = mapLedger.find(hashTx);
+            if(it == mapLedger.end())
+                return false;
+
+            const Entry& entry = it->second;
+
+            /* Remove from the sequence index, and the signature chain once it has no transactions left. */
+            auto itSequence = mapSequences.find(entry.tx.hashGenesis);
+            if(itSequence != mapSequences.end())
+            {
+                itSequence->second.erase(std::make_pair(entry.tx.nSequence, hashTx));
+                if(itSequence->second.empty())
+                    mapSequences.erase(itSequence);
+            }
+
+            /* Remove from the priority index. */
+            setPriority.erase(Priority{entry.nFees, entry.nTime, hashTx});
+
+            /* Remove from the dependents index. */
+            for(uint32_t nContract = 0; nContract < entry.tx.Size(); ++nContract)
+            {
+                uint512_t hashPrev = 0;
+                if(!entry.tx[nContract].Previous(hashPrev))
+                    continue;
+
+                auto itDependents = mapDependents.find(hashPrev);
+                if(itDependents == mapDependents.end())
+                    continue;
+
+                itDependents->second.erase(hashTx);
+                if(itDependents->second.empty())
+                    mapDependents.erase(itDependents);
+            }
+
+            /* Remove from the totals. */
+            nBytes -= entry.nBytes;
+            nFees  -= entry.nFees;
+
+            mapLedger.erase(it);
+            ++nRemovals;
+
+            return true;
+        }
+
+
+        /* Get the transactions of a signature chain in sequence order. */
+        void Mempool::sequence(const uint256_t& hashGenesis, std::vector<TAO::Ledger::Transaction> &vtx) const
+        {
+            /* Check for the signature chain. */
+            auto it = mapSequences.find(hashGenesis);
+            if(it == mapSequences.end())
+                return;
+
+            /* Add the transactions in order. */
+            vtx.reserve(vtx.size() + it->second.size());
+            for(const auto& seq : it->second)
+                vtx.push_back(mapLedger.at(seq.second).tx);
+        }
+
+
+        /* Evict the lowest priority transactions until the pool is under its size limit. */
+        bool Mempool::evict(const uint512_t& hashTx)
+        {
+            /* Keep evicting until the pool fits. */
+            bool fAccepted = true;
+            while(nBytes > max_bytes())
+            {
+                /* Find the lowest priority transaction that can be evicted along with the rest of its signature chain. */
+                std::vector<uint512_t> vEvict;
+                for(auto it = setPriority.rbegin(); it != setPriority.rend(); ++it)
+                {
+                    /* Get the transactions after it in the signature chain, newest first. */
+                    const std::set<std::pair<uint32_t, uint512_t>>& setSequence =
+                        mapSequences.at(mapLedger.at(it->hashTx).tx.hashGenesis);
+
+                    vEvict.clear();
+                    for(auto seq = setSequence.rbegin(); seq != setSequence.rend(); ++seq)
+                    {
+                        /* Transactions added unchecked from a block were never connected in memory, so they stay. */
+                        if(!mapLedger.at(seq->second).fConnected)
+                        {
+                            vEvict.clear();
+                            break;
+                        }
+
+                        vEvict.push_back(seq->second);
+                        if(seq->second == it->hashTx)
+                            break;
+                    }
+
+                    /* Transactions credited or claimed by another signature chain stay, so its contracts keep their inputs. */
+                    for(const auto& hashEvict : vEvict)
+                    {
+                        auto itDependents = mapDependents.find(hashEvict);
+                        if(itDependents == mapDependents.end())
+                            continue;
+
+                        /* Dependents later in the same signature chain are evicted along with it. */
+                        bool fDependents = false;
+                        for(const auto& hashDependent : itDependents->second)
+                        {
+                            if(std::find(vEvict.begin(), vEvict.end(), hashDependent) == vEvict.end())
+                            {
+                                fDependents = true;
+                                break;
+                            }
+                        }
+
+                        if(fDependents)
+                        {
+                            vEvict.clear();
+                            break;
+                        }
+                    }
+
+                    /* Check for transactions to evict. */
+                    if(!vEvict.empty())
+                        break;
+                }
+
+                /* Check for nothing left to evict. */
+                if(vEvict.empty())
+                    break;
+
+                /* Reset memory states to disk indexes, newest first. */
+                LLD::TxnBegin(FLAGS::MEMPOOL);
+                for(const auto& hashEvict : vEvict)
+                {
+                    TAO::Ledger::Transaction tx = mapLedger.at(hashEvict).tx;
+                    if(!tx.Disconnect(FLAGS::MEMPOOL))
+                    {
+                        LLD::TxnAbort(FLAGS::MEMPOOL);
+
+                        debug::error(FUNCTION, "failed to disconnect tx ", hashEvict.SubString());
+                        return fAccepted;
+                    }
+                }
+
+                /* Commit the memory transaction. */
+                LLD::TxnCommit(FLAGS::MEMPOOL);
+
+                /* Erase from the memory maps. */
+                WLOCK(INDEX_MUTEX);
+                for(const auto& hashEvict : vEvict)
+                {
+                    /* Check for the transaction just accepted. */
+                    if(hashEvict == hashTx)
+                        fAccepted = false;
+
+                    debug::log(2, FUNCTION, "EVICTED tx ", hashEvict.SubString(), " with ", nBytes, " bytes in pool");
+
+                    mapClaimed.erase(mapLedger.at(hashEvict).tx.hashPrevTx);
+                    erase(hashEvict);
+
+                    ++nEvicted;
+                }
+            }
+
+            return fAccepted;
+        }
     }
 }
@@ -154,41 +154,53 @@ namespace TAO
                 /* Special meter for synchronizing. */
                 if(block.nHeight % (config::fClient ? 5000 : 1000) == 0 && TAO::Ledger::ChainState::Synchronizing())
                 {
-                    /* Grab the current sync node. */
-                    uint32_t nHours = 0, nMinutes = 0, nSeconds = 0;
-                    if(LLP::TritiumNode::SessionActive(nSyncSession.load()))
+                    /* Get the height the sync is working towards. */
+                    uint32_t nHours = 0, nMinutes = 0, nSeconds = 0, nTarget = 0;
+                    const bool fParallel = LLP::TritiumNode::SYNC.Active();
+                    if(fParallel)
+                        nTarget = LLP::TritiumNode::SYNC.BestHeight(); //don't lock a node that could be waiting on this thread
+                    else if(LLP::TritiumNode::SessionActive(nSyncSession.load()))
                     {
                         /* Get the current connected legacy node. */
                         memory::atomic_ptr<LLP::TritiumNode>& pnode = LLP::TritiumNode::GetNode(nSyncSession.load());
                         try //we want to catch exceptions thrown by atomic_ptr in the case there was a free on another thread
                         {
-                            /* Check for potential overflow if current height is not set. */
-                            if(pnode->nCurrentHeight > ChainState::nBestHeight.load())
-                            {
-                                /* Get the total height left to go. */
-                                uint32_t nRemaining = (pnode->nCurrentHeight - ChainState::nBestHeight.load());
-                                uint32_t nTotalBlocks = (ChainState::nBestHeight.load() - LLP::TritiumNode::nSyncStart.load());
-
-                                /* Calculate blocks per second. */
-                                uint32_t nRate = nTotalBlocks / (LLP::TritiumNode::SYNCTIMER.Elapsed() + 1);
-                                LLP::TritiumNode::nRemainingTime.store(nRemaining / (nRate + 1));
-
-                                /* Get the remaining time. */
-                                nHours   =  LLP::TritiumNode::nRemainingTime.load() / 3600;
-                                nMinutes = (LLP::TritiumNode::nRemainingTime.load() - (nHours * 3600)) / 60;
-                                nSeconds = (LLP::TritiumNode::nRemainingTime.load() - (nHours * 3600)) % 60;
-                            }
+                            nTarget = pnode->nCurrentHeight;
                         }
                         catch(const std::exception& e) {}
                     }
 
+                    /* Check for potential overflow if current height is not set. */
+                    if(nTarget > ChainState::nBestHeight.load())
+                    {
+                        /* Get the total height left to go. */
+                        uint32_t nRemaining = (nTarget - ChainState::nBestHeight.load());
+                        uint32_t nTotalBlocks = (ChainState::nBestHeight.load() - LLP::TritiumNode::nSyncStart.load());
+
+                        /* Calculate blocks per second. */
+                        uint32_t nRate = nTotalBlocks / (LLP::TritiumNode::SYNCTIMER.Elapsed() + 1);
+                        LLP::TritiumNode::nRemainingTime.store(nRemaining / (nRate + 1));
+
+                        /* Get the remaining time. */
+                        nHours   =  LLP::TritiumNode::nRemainingTime.load() / 3600;
+                        nMinutes = (LLP::TritiumNode::nRemainingTime.load() - (nHours * 3600)) / 60;
+                        nSeconds = (LLP::TritiumNode::nRemainingTime.load() - (nHours * 3600)) % 60;
+                    }
+
+                    /* Get the share of blocks from each node for a parallel sync. */
+                    const std::string strPeers = fParallel ? "[" + LLP::TritiumNode::SYNC.Utilization() + "]" : std::string();
+
                     uint64_t nElapsed = runtime::timestamp(true) - nSynchronizationTimer;
+                    if(nElapsed == 0)
+                        nElapsed = 1;
+
                     debug::log(0, FUNCTION,
                         "Processed ", (config::fClient ? 5000 : 1000), " blocks in ", nElapsed, " ms [", std::setw(2),
                         TAO::Ledger::ChainState::PercentSynchronized(), " %]",
                         " height=", block.nHeight,
                         " trust=", TAO::Ledger::ChainState::nBestChainTrust.load(),
                         " [", (config::fClient ? 5000000 : 1000000) / nElapsed, " blocks/s]",
+                        strPeers,
                         "[", std::setw(2), std::setfill('0'), nHours, ":",
                               std::setw(2), std::setfill('0'), nMinutes, ":",
                               std::setw(2), std::setfill('0'), nSeconds, " remaining]");
@@ -45,6 +45,7 @@ ________________________________________________________________________________
 #include <TAO/Ledger/types/genesis.h>
 #include <TAO/Ledger/types/mempool.h>
 #include <TAO/Ledger/types/client.h>
+#include <TAO/Ledger/types/verify_cache.h>
 
 #include <Util/include/string.h>
 
@@ -1119,14 +1120,17 @@ namespace TAO
                             return debug::error(FUNCTION, "last hash hash mismatch");
                     }
 
-                    /* Verify the Ledger Pre-States. */
-                    if(!tx.Verify(FLAGS::BLOCK)) //NOTE: double checking this for now in post-processing
+                    /* Verify the Ledger Pre-States, unless verified entering the memory pool with its registers unchanged since. */
+                    if(!verifycache.Verified(hash) && !tx.Verify(FLAGS::BLOCK))
                         return false;
 
                     /* Connect the transaction. */
                     if(!tx.Connect(FLAGS::BLOCK, this))
                         return debug::error(FUNCTION, "failed to connect transaction");
 
+                    /* The transaction won't be verified again. */
+                    verifycache.Remove(hash);
+
                     /* Add legacy transactions to the wallet where appropriate */
                     #ifndef NO_WALLET
                     Legacy::Wallet::GetInstance().AddToWalletIfInvolvingMe(tx, *this, true);
@@ -485,6 +485,14 @@ namespace TAO
 
         /* Verify a transaction contracts. */
         bool Transaction::Verify(const uint8_t nFlags) const
+        {
+            std::vector<uint256_t> vRegisters;
+            return Verify(nFlags, vRegisters);
+        }
+
+
+        /* Verify a transaction contracts, getting the registers they were verified against. */
+        bool Transaction::Verify(const uint8_t nFlags, std::vector<uint256_t>& vRegisters) const
         {
             /* Create a temporary map for pre-states. */
             std::map<uint256_t, TAO::Register::State> mapStates;
@@ -500,6 +508,11 @@ namespace TAO
                     return false;
             }
 
+            /* Every register read from the database is kept in the temporary map. */
+            vRegisters.clear();
+            for(const auto& state : mapStates)
+                vRegisters.push_back(state.first);
+
             return true;
         }
 
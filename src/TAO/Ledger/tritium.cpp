@@ -36,7 +36,9 @@ ________________________________________________________________________________
 #include <TAO/Ledger/include/enum.h>
 #include <TAO/Ledger/include/supply.h>
 #include <TAO/Ledger/include/timelocks.h>
+#include <TAO/Ledger/include/validation.h>
 #include <TAO/Ledger/types/syncblock.h>
+#include <TAO/Ledger/types/verify_cache.h>
 
 #include <TAO/Register/include/enum.h>
 #include <TAO/Register/types/address.h>
@@ -402,10 +404,6 @@ namespace TAO
                 /* Check coinbase/coinstake timestamp against block time */
                 if(GetBlockTime() > (uint64_t)producer.nTimestamp + ((nVersion < 4) ? 1200 : 3600))
                     return debug::error(FUNCTION, "producer transaction timestamp is too early");
-
-                /* Check that the producer is a valid transaction. */
-                if(!producer.Check())
-                    return debug::error(FUNCTION, "producer transaction is invalid");
             }
             else
             {
@@ -417,10 +415,6 @@ namespace TAO
                     /* Check coinbase/coinstake timestamp against block time */
                     if(GetBlockTime() > (uint64_t)txProducer.nTimestamp + 3600)
                         return debug::error(FUNCTION, "producer transaction timestamp is too early");
-
-                    /* Check that the producer is a valid transaction. */
-                    if(!txProducer.Check())
-                        return debug::error(FUNCTION, "producer transaction is invalid");
                 }
             }
 
@@ -570,6 +564,10 @@ namespace TAO
             /* Get list of producer transactions. */
             std::map<uint256_t, uint512_t> mapLast;
 
+            /* The tritium transactions, checked on the validation threads once they are all read. */
+            std::vector<TAO::Ledger::Transaction> vTritium;
+            vTritium.reserve(vtx.size());
+
             /* Get the signature operations for legacy tx's. */
             uint32_t nSize = (uint32_t)vtx.size();
             for(uint32_t i = 0; i < nSize; ++i)
@@ -627,6 +625,10 @@ namespace TAO
 
                     /* Set the last hash for given genesis. */
                     mapLast[tx.hashGenesis] = tx.GetHash();
+
+                    /* Keep the transaction for its checks, unless it passed them entering the memory pool. */
+                    if(!verifycache.Checked(vtx[i].second))
+                        vTritium.push_back(std::move(tx));
                 }
                 else
                     return debug::error(FUNCTION, "unknown transaction type");
@@ -680,60 +682,111 @@ namespace TAO
             if(nSigOps > MAX_BLOCK_SIGOPS)
                 return debug::error(FUNCTION, "out-of-bounds SigOpCount");
 
+            /* The checks that don't depend on chain state run on the validation threads. */
+            std::vector<std::function<bool()>> vChecks;
+            vChecks.reserve(vProducer.size() + vTritium.size() + 2);
+
+            /* Check that the producer(s) are valid transactions. */
+            if(nVersion < 9)
+            {
+                vChecks.push_back([this]() -> bool
+                {
+                    if(!producer.Check())
+                        return debug::error(FUNCTION, "producer transaction is invalid");
+
+                    return true;
+                });
+            }
+            else
+            {
+                for(const TAO::Ledger::Transaction& txProducer : vProducer)
+                {
+                    vChecks.push_back([&txProducer]() -> bool
+                    {
+                        if(!txProducer.Check())
+                            return debug::error(FUNCTION, "producer transaction is invalid");
+
+                        return true;
+                    });
+                }
+            }
+
             /* Check the merkle root. */
-            if(hashMerkleRoot != BuildMerkleTree(vHashes))
-                return debug::error(FUNCTION, "hashMerkleRoot mismatch");
+            vChecks.push_back([this, &vHashes]() -> bool
+            {
+                if(hashMerkleRoot != BuildMerkleTree(vHashes))
+                    return debug::error(FUNCTION, "hashMerkleRoot mismatch");
 
-            /* Verify producer signature(s) (if not synchronizing) */
+                return true;
+            });
+
+            /* Check the transactions and the block signature (if not synchronizing) */
             if(!TAO::Ledger::ChainState::Synchronizing())
             {
-                TAO::Ledger::Transaction txProducer;
+                /* Transactions that came with the block were added to the memory pool unchecked. */
+                for(const TAO::Ledger::Transaction& tx : vTritium)
+                {
+                    vChecks.push_back([&tx]() -> bool
+                    {
+                        if(!tx.Check())
+                            return debug::error(FUNCTION, "transaction ", tx.GetHash().SubString(), " is invalid");
 
-                if(nVersion < 9)
-                    txProducer = producer;
-                else
-                    txProducer = vProducer.back(); ///block signed by block finder which is last producer
+                        return true;
+                    });
+                }
 
-                /* Switch based on signature type. */
-                switch(txProducer.nKeyType)
+                /* Verify producer signature. */
+                vChecks.push_back([this]() -> bool
                 {
-                    /* Support for the FALCON signature scheeme. */
-                    case SIGNATURE::FALCON:
+                    const TAO::Ledger::Transaction& txProducer = (nVersion < 9 ? producer : vProducer.back()); ///block signed by block finder which is last producer
+
+                    /* Switch based on signature type. */
+                    switch(txProducer.nKeyType)
                     {
-                        /* Create the FL Key object. */
-                        LLC::FLKey key;
+                        /* Support for the FALCON signature scheeme. */
+                        case SIGNATURE::FALCON:
+                        {
+                            /* Create the FL Key object. */
+                            LLC::FLKey key;
 
-                        /* Set the public key and verify. */
-                        key.SetPubKey(txProducer.vchPubKey);
+                            /* Set the public key and verify. */
+                            key.SetPubKey(txProducer.vchPubKey);
 
-                        /* Check the Block Signature. */
-                        if(!VerifySignature(key))
-                            return debug::error(FUNCTION, "bad block signature");
+                            /* Check the Block Signature. */
+                            if(!VerifySignature(key))
+                                return debug::error(FUNCTION, "bad block signature");
 
-                        break;
-                    }
+                            break;
+                        }
 
-                    /* Support for the BRAINPOOL signature scheme. */
-                    case SIGNATURE::BRAINPOOL:
-                    {
-                        /* Create EC Key object. */
-                        LLC::ECKey key = LLC::ECKey(LLC::BRAINPOOL_P512_T1, 64);
+                        /* Support for the BRAINPOOL signature scheme. */
+                        case SIGNATURE::BRAINPOOL:
+                        {
+                            /* Create EC Key object. */
+                            LLC::ECKey key = LLC::ECKey(LLC::BRAINPOOL_P512_T1, 64);
 
-                        /* Set the public key and verify. */
-                        key.SetPubKey(txProducer.vchPubKey);
+                            /* Set the public key and verify. */
+                            key.SetPubKey(txProducer.vchPubKey);
 
-                        /* Check the Block Signature. */
-                        if(!VerifySignature(key))
-                            return debug::error(FUNCTION, "bad block signature");
+                            /* Check the Block Signature. */
+                            if(!VerifySignature(key))
+                                return debug::error(FUNCTION, "bad block signature");
 
-                        break;
+                            break;
+                        }
+
+                        default:
+                            return debug::error(FUNCTION, "unknown signature type");
                     }
 
-                    default:
-                        return debug::error(FUNCTION, "unknown signature type");
-                }
+                    return true;
+                });
             }
 
+            /* Run the checks, only the state-dependent Accept and Connect stay in block order. */
+            if(!CheckParallel(vChecks))
+                return debug::error(FUNCTION, "block ", GetHash().SubString(), " failed checks");
+
             return true;
         }
 
@@ -874,7 +927,11 @@ namespace TAO
             }
 
             /* Commit the transaction to database. */
-            LLD::TxnCommit();
+            if(!LLD::TxnCommit())
+            {
+                LLD::TxnAbort();
+                return debug::error(FUNCTION, "failed to commit block to database");
+            }
 
             /* Check for best chain. */
             if(GetHash() == ChainState::hashBestChain.load())
@@ -326,6 +326,22 @@ namespace TAO
             static uint512_t CheckMerkleBranch(const uint512_t& hash, const std::vector<uint512_t>& vMerkleBranch, uint32_t nIndex);
 
 
+            /** CheckMerkleTail
+             *
+             *  Compute the merkle root for a new last transaction, from the merkle branch of the last index. Where the
+             *  last transaction is paired with itself, its own hash is used in place of the branch entry, so the branch
+             *  stays valid for any last transaction.
+             *
+             *  @param[in] hash The transaction-id of the last transaction.
+             *  @param[in] vMerkleBranch The merkle branch of the last index.
+             *  @param[in] nIndex The index of the last transaction.
+             *
+             *  @return The merkle root.
+             *
+             **/
+            static uint512_t CheckMerkleTail(const uint512_t& hash, const std::vector<uint512_t>& vMerkleBranch, uint32_t nIndex);
+
+
             /** ToString
              *
              *  For debugging Purposes seeing block state data dump
@@ -0,0 +1,131 @@
+/*__________________________________________________________________________________________
+
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+			(c) Copyright The Nexus Developers 2014 - 2019
+
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+			"ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_TAO_LEDGER_TYPES_BLOCK_TEMPLATE_H
+#define NEXUS_TAO_LEDGER_TYPES_BLOCK_TEMPLATE_H
+
+#include <LLC/types/uint1024.h>
+
+#include <mutex>
+#include <set>
+#include <vector>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /** BlockTemplate
+         *
+         *  The tritium transactions for the next block, kept between calls so each memory pool
+         *  transaction is verified and connected in the MINER view once rather than on every new block
+         *  request. New memory pool transactions are added to the end, and the template is rebuilt when
+         *  the best chain changes or transactions leave the memory pool.
+         *
+         **/
+        class BlockTemplate
+        {
+            /** Mutex for thread safety, also guarding the MINER view of the databases. **/
+            std::mutex MUTEX;
+
+
+            /** The best block the template was built on. **/
+            uint1024_t hashBest;
+
+
+            /** The memory pool insertion count the template has seen. **/
+            uint64_t nInsertions;
+
+
+            /** The memory pool removal count the template was built at. **/
+            uint64_t nRemovals;
+
+
+            /** The transactions in block order. **/
+            std::vector<std::pair<uint8_t, uint512_t>> vtx;
+
+
+            /** The transactions in the template. **/
+            std::set<uint512_t> setIncluded;
+
+
+            /** The transactions that failed, and so fail the transactions that follow them. **/
+            std::set<uint512_t> setDependents;
+
+
+        public:
+
+            /** Default Constructor. **/
+            BlockTemplate();
+
+
+            /** Get
+             *
+             *  Get the transactions for a new block, bringing the template up to date first. The work done
+             *  is only for memory pool changes since the last call, so with no changes this only copies the list.
+             *
+             *  @param[out] vtxOut The transactions for the block.
+             *  @param[in] nReserved The serialized size of the block without these transactions.
+             *
+             **/
+            void Get(std::vector<std::pair<uint8_t, uint512_t>>& vtxOut, const uint64_t nReserved);
+
+
+            /** Clear
+             *
+             *  Drop the template so the next call rebuilds it.
+             *
+             **/
+            void Clear();
+
+
+            /** EntrySize
+             *
+             *  The serialized size of one transaction entry in a block.
+             *
+             **/
+            static uint64_t EntrySize();
+
+
+        private:
+
+            /** rebuild
+             *
+             *  Start over from the current best block. Must be called with MUTEX held.
+             *
+             **/
+            void rebuild();
+
+
+            /** update
+             *
+             *  Add the memory pool transactions that aren't in the template yet. Must be called with MUTEX held.
+             *
+             *  @param[in] nReserved The serialized size of the block without the transactions.
+             *
+             **/
+            void update(const uint64_t nReserved);
+
+        };
+
+
+        /** The template shared by the block creation functions. **/
+        extern BlockTemplate blocktemplate;
+    }
+}
+
+#endif
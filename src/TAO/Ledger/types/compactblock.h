@@ -0,0 +1,114 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_TAO_LEDGER_TYPES_COMPACTBLOCK_H
+#define NEXUS_TAO_LEDGER_TYPES_COMPACTBLOCK_H
+
+#include <TAO/Ledger/types/tritium.h>
+
+#include <Util/templates/serialize.h>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /** CompactBlock
+         *
+         *  A tritium block for relay, with short ids in place of its transaction hashes.
+         *  The receiver rebuilds the block from the transactions in its memory pool,
+         *  and only needs to ask for the transactions that it is missing.
+         *
+         *  A short id holds the transaction type in the top byte, and the low 56 bits of
+         *  the hash of the salt and transaction hash in the remaining bytes. The salt is
+         *  chosen by the sender, so colliding transactions can't be prepared in advance.
+         *
+         **/
+        class CompactBlock
+        {
+        public:
+
+            /** The block with its producer(s) and without its transaction list. **/
+            TritiumBlock block;
+
+
+            /** The salt for the short ids. **/
+            uint64_t nSalt;
+
+
+            /** The short ids of the transactions, in block order. **/
+            std::vector<uint64_t> vShortIDs;
+
+
+            /** Serialization **/
+            IMPLEMENT_SERIALIZE
+            (
+                READWRITE(block);
+                READWRITE(nSalt);
+                READWRITE(vShortIDs);
+            )
+
+
+            /** The default constructor. **/
+            CompactBlock();
+
+
+            /** Constructor
+             *
+             *  Build a compact block from a tritium block.
+             *
+             *  @param[in] blockIn The block to compact.
+             *  @param[in] nSaltIn The salt for the short ids.
+             *
+             **/
+            CompactBlock(const TritiumBlock& blockIn, const uint64_t nSaltIn);
+
+
+            /** Default Destructor **/
+            ~CompactBlock();
+
+
+            /** ShortID
+             *
+             *  Get the short id of a transaction for this block's salt.
+             *
+             *  @param[in] nType The transaction type.
+             *  @param[in] hashTx The transaction hash.
+             *
+             *  @return The 64-bit short id.
+             *
+             **/
+            uint64_t ShortID(const uint8_t nType, const uint512_t& hashTx) const;
+
+
+            /** Reconstruct
+             *
+             *  Rebuild the tritium block from the transactions in the memory pool.
+             *
+             *  @param[out] blockOut The rebuilt block.
+             *  @param[out] vMissing The indexes of the transactions not found in the memory pool.
+             *
+             *  @return False if the transactions found don't match the merkle root, so the full block is needed.
+             *
+             **/
+            bool Reconstruct(TritiumBlock& blockOut, std::vector<uint32_t>& vMissing) const;
+
+        };
+    }
+}
+
+#endif
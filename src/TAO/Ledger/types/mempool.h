@@ -25,6 +25,12 @@ ________________________________________________________________________________
 #include <Legacy/types/outpoint.h>
 
 #include <Util/include/mutex.h>
+#include <Util/include/shared_mutex.h>
+
+#include <atomic>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace LLP
 {
@@ -52,8 +58,109 @@ namespace TAO
             /* Mutex to local access to the mempool */
             mutable std::recursive_mutex MUTEX;
 
+
+            /** Info
+             *
+             *  Statistics for the memory pool.
+             *
+             **/
+            struct Info
+            {
+                /** The tritium transactions in the pool. **/
+                uint32_t nTransactions;
+
+                /** The legacy transactions in the pool. **/
+                uint32_t nLegacy;
+
+                /** The conflicted transactions, tritium and legacy. **/
+                uint32_t nConflicts;
+
+                /** The orphan transactions waiting for their previous transaction. **/
+                uint32_t nOrphans;
+
+                /** The signature chains with transactions in the pool. **/
+                uint32_t nGenesis;
+
+                /** The serialized size of the tritium transactions. **/
+                uint64_t nBytes;
+
+                /** The size the pool is kept under by eviction. **/
+                uint64_t nMaxBytes;
+
+                /** The fees of the tritium transactions. **/
+                uint64_t nFees;
+
+                /** The transactions evicted since startup. **/
+                uint64_t nEvicted;
+            };
+
         private:
 
+            /** Hash a transaction or genesis hash for the hashed containers. Their low bits are already uniform. **/
+            struct Hasher
+            {
+                size_t operator()(const uint512_t& hash) const
+                {
+                    return static_cast<size_t>(hash.Get64(0));
+                }
+
+                size_t operator()(const uint256_t& hash) const
+                {
+                    return static_cast<size_t>(hash.Get64(0));
+                }
+            };
+
+
+            /** A tritium transaction with the values it is indexed by. **/
+            struct Entry
+            {
+                /** The transaction. **/
+                TAO::Ledger::Transaction tx;
+
+                /** The fees paid by the transaction. **/
+                uint64_t nFees;
+
+                /** The time the transaction entered the pool. **/
+                uint64_t nTime;
+
+                /** The serialized size of the transaction. **/
+                uint64_t nBytes;
+
+                /** Flag for a transaction connected in memory by Accept, rather than added unchecked from a block. **/
+                bool fConnected;
+            };
+
+
+            /** Orders transactions by priority: highest fees first, then oldest first. **/
+            struct Priority
+            {
+                /** The fees paid by the transaction. **/
+                uint64_t nFees;
+
+                /** The time the transaction entered the pool. **/
+                uint64_t nTime;
+
+                /** The transaction hash. **/
+                uint512_t hashTx;
+
+                bool operator<(const Priority& priority) const
+                {
+                    if(nFees != priority.nFees)
+                        return nFees > priority.nFees;
+
+                    if(nTime != priority.nTime)
+                        return nTime < priority.nTime;
+
+                    return hashTx < priority.hashTx;
+                }
+            };
+
+
+            /** Reader-writer lock for the transaction containers. Lookups hold it shared, so they don't wait on
+             *  the validation done under MUTEX. Changes hold MUTEX as well, so holding MUTEX is enough to read. **/
+            mutable shared_mutex INDEX_MUTEX;
+
+
             /** The transactions in the ledger memory pool. **/
             std::map<uint512_t, Legacy::Transaction> mapLegacy;
 
@@ -63,19 +170,31 @@ namespace TAO
 
 
             /** The transactions in the ledger memory pool. **/
-            std::map<uint512_t, TAO::Ledger::Transaction> mapLedger;
+            std::unordered_map<uint512_t, Entry, Hasher> mapLedger;
+
+
+            /** The ledger transactions of each signature chain, ordered by sequence. **/
+            std::unordered_map<uint256_t, std::set<std::pair<uint32_t, uint512_t>>, Hasher> mapSequences;
+
+
+            /** The ledger transactions ordered by priority. **/
+            std::set<Priority> setPriority;
 
 
             /** The transactions in the conflicted ledger memory pool. **/
-            std::map<uint512_t, TAO::Ledger::Transaction> mapConflicts;
+            std::unordered_map<uint512_t, TAO::Ledger::Transaction, Hasher> mapConflicts;
 
 
             /** Oprhan transactions in queue. **/
-            std::map<uint512_t, TAO::Ledger::Transaction> mapOrphans;
+            std::unordered_map<uint512_t, TAO::Ledger::Transaction, Hasher> mapOrphans;
 
 
             /** Record of conflicted transactions in mempool. **/
-            std::map<uint512_t, uint512_t> mapClaimed;
+            std::unordered_map<uint512_t, uint512_t, Hasher> mapClaimed;
+
+
+            /** The ledger transactions with contracts that credit, claim or validate each transaction. **/
+            std::unordered_map<uint512_t, std::unordered_set<uint512_t, Hasher>, Hasher> mapDependents;
 
 
             /** Record of legacy inputs in the mempool. **/
@@ -83,7 +202,78 @@ namespace TAO
 
 
             /** Set to keep track of duplicate orphans by index. **/
-            std::set<uint512_t> setOrphansByIndex;
+            std::unordered_set<uint512_t, Hasher> setOrphansByIndex;
+
+
+            /** The serialized size of the ledger transactions. **/
+            uint64_t nBytes;
+
+
+            /** The fees of the ledger transactions. **/
+            uint64_t nFees;
+
+
+            /** The transactions evicted since startup. **/
+            uint64_t nEvicted;
+
+
+            /** The ledger transactions added since startup. **/
+            std::atomic<uint64_t> nInsertions;
+
+
+            /** The ledger transactions removed since startup. **/
+            std::atomic<uint64_t> nRemovals;
+
+
+            /** insert
+             *
+             *  Add a ledger transaction to the pool and its indexes.
+             *  Must be called with MUTEX held and INDEX_MUTEX locked for writing.
+             *
+             *  @param[in] hashTx The transaction hash.
+             *  @param[in] tx The transaction to add.
+             *  @param[in] fConnected Flag for a transaction connected in memory.
+             *
+             **/
+            void insert(const uint512_t& hashTx, const TAO::Ledger::Transaction& tx, const bool fConnected);
+
+
+            /** erase
+             *
+             *  Remove a ledger transaction from the pool and its indexes.
+             *  Must be called with MUTEX held and INDEX_MUTEX locked for writing.
+             *
+             *  @param[in] hashTx The transaction hash.
+             *
+             *  @return true if the transaction was in the pool.
+             *
+             **/
+            bool erase(const uint512_t& hashTx);
+
+
+            /** sequence
+             *
+             *  Get the transactions of a signature chain in sequence order.
+             *  Must be called with MUTEX held or INDEX_MUTEX locked for reading.
+             *
+             *  @param[in] hashGenesis The genesis of the signature chain.
+             *  @param[out] vtx The transactions.
+             *
+             **/
+            void sequence(const uint256_t& hashGenesis, std::vector<TAO::Ledger::Transaction> &vtx) const;
+
+
+            /** evict
+             *
+             *  Evict the lowest priority transactions, with the later transactions of their signature chains,
+             *  until the pool is under its size limit. Must be called with MUTEX held.
+             *
+             *  @param[in] hashTx The transaction just accepted.
+             *
+             *  @return false if the transaction just accepted was evicted.
+             *
+             **/
+            bool evict(const uint512_t& hashTx);
 
         public:
 
@@ -312,6 +502,16 @@ namespace TAO
             bool List(std::vector<uint512_t> &vHashes, uint32_t nCount = std::numeric_limits<uint32_t>::max(), bool fLegacy = false);
 
 
+            /** Hashes
+             *
+             *  Get the hashes of all transactions in memory pool, including conflicted transactions.
+             *
+             *  @param[out] vtx List of transaction types and hashes.
+             *
+             **/
+            void Hashes(std::vector<std::pair<uint8_t, uint512_t>> &vtx) const;
+
+
             /** Size
              *
              *  Gets the size of the memory pool.
@@ -326,6 +526,30 @@ namespace TAO
              *
              **/
             uint32_t SizeLegacy();
+
+
+            /** GetInfo
+             *
+             *  Gets the statistics of the memory pool.
+             *
+             **/
+            Info GetInfo() const;
+
+
+            /** Insertions
+             *
+             *  Gets the number of ledger transactions added since startup, to detect new transactions.
+             *
+             **/
+            uint64_t Insertions() const;
+
+
+            /** Removals
+             *
+             *  Gets the number of ledger transactions removed since startup, to detect transactions leaving the pool.
+             *
+             **/
+            uint64_t Removals() const;
         };
 
         extern Mempool mempool;
@@ -217,6 +217,19 @@ namespace TAO
             bool Verify(const uint8_t nFlags = TAO::Ledger::FLAGS::BLOCK) const;
 
 
+            /** Verify
+             *
+             *  Verify a transaction contracts, getting the registers they were verified against.
+             *
+             *  @param[in] nFlags The flags to read the registers with.
+             *  @param[out] vRegisters The addresses of the registers the contracts read or created.
+             *
+             *  @return true if transaction is valid.
+             *
+             **/
+            bool Verify(const uint8_t nFlags, std::vector<uint256_t>& vRegisters) const;
+
+
             /** CheckTrust
              *
              *  Check that the claimed trust score and stake reward are correct.
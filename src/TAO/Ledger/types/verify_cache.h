@@ -0,0 +1,225 @@
+/*__________________________________________________________________________________________
+
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+			(c) Copyright The Nexus Developers 2014 - 2019
+
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+			"ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_TAO_LEDGER_TYPES_VERIFY_CACHE_H
+#define NEXUS_TAO_LEDGER_TYPES_VERIFY_CACHE_H
+
+#include <LLC/types/uint1024.h>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <vector>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /* Forward declarations. */
+        class Transaction;
+
+
+        /** VerifyCache
+         *
+         *  Remembers the transactions that passed their signature checks and their register pre-state
+         *  verification when accepted into the memory pool, so connecting a block can skip that work.
+         *
+         *  Pre-states are verified against the registers on disk, and each register write counts
+         *  against a slot for its address. A transaction stays verified while none of the slots of the
+         *  registers it read were written after its verification started.
+         *
+         **/
+        class VerifyCache
+        {
+            /** The number of shards the transactions are spread over, each with its own lock. **/
+            static const uint32_t SHARDS = 16;
+
+
+            /** The number of register write slots. **/
+            static const uint32_t SLOTS = 1 << 16;
+
+
+            /** The transactions kept in each generation of a shard. **/
+            static const uint32_t MAX_SHARD = 2048;
+
+
+            /** The results kept for a transaction. **/
+            struct Entry
+            {
+                /** Flag for a transaction that passed its context-free checks. **/
+                bool fChecked;
+
+                /** Flag for a transaction with its pre-states verified against the disk. **/
+                bool fVerified;
+
+                /** The register write count when its verification started. **/
+                uint64_t nWrites;
+
+                /** The write slots of the registers its contracts read. **/
+                std::vector<uint32_t> vSlots;
+
+                Entry();
+            };
+
+
+            /** A lock and two generations of transactions, the older dropped when the newer fills. **/
+            struct Shard
+            {
+                /** Mutex for thread safety. **/
+                std::mutex MUTEX;
+
+                /** The current generation. **/
+                std::map<uint512_t, Entry> mapCurrent;
+
+                /** The previous generation. **/
+                std::map<uint512_t, Entry> mapPrevious;
+            };
+
+
+            /** The shards of transactions. **/
+            Shard vShards[SHARDS];
+
+
+            /** The register write count when each slot was last written. **/
+            std::vector<std::atomic<uint64_t>> vWritten;
+
+
+            /** The count of register writes. **/
+            std::atomic<uint64_t> nWrites;
+
+
+            /** The register write count of the last clear. **/
+            std::atomic<uint64_t> nCleared;
+
+
+        public:
+
+            /** Default Constructor. **/
+            VerifyCache();
+
+
+            /** AddChecked
+             *
+             *  Record a transaction that passed its context-free checks.
+             *
+             *  @param[in] hashTx The transaction hash.
+             *
+             **/
+            void AddChecked(const uint512_t& hashTx);
+
+
+            /** Checked
+             *
+             *  Determine if a transaction passed its context-free checks.
+             *
+             *  @param[in] hashTx The transaction hash.
+             *
+             *  @return True if the checks can be skipped.
+             *
+             **/
+            bool Checked(const uint512_t& hashTx);
+
+
+            /** AddVerified
+             *
+             *  Verify a transaction's pre-states against the registers on disk, and record it if they match.
+             *  This fails quietly for transactions that depend on registers with pending states in the memory pool.
+             *
+             *  @param[in] tx The transaction to verify.
+             *
+             *  @return True if the transaction was recorded.
+             *
+             **/
+            bool AddVerified(const Transaction& tx);
+
+
+            /** Verified
+             *
+             *  Determine if a transaction's pre-states are still verified, with none of its registers written since.
+             *
+             *  @param[in] hashTx The transaction hash.
+             *
+             *  @return True if the pre-state verification can be skipped.
+             *
+             **/
+            bool Verified(const uint512_t& hashTx);
+
+
+            /** Written
+             *
+             *  Note a register state written to disk, after the write.
+             *
+             *  @param[in] hashRegister The register address.
+             *
+             **/
+            void Written(const uint256_t& hashRegister);
+
+
+            /** Remove
+             *
+             *  Remove a transaction once it is connected.
+             *
+             *  @param[in] hashTx The transaction hash.
+             *
+             **/
+            void Remove(const uint512_t& hashTx);
+
+
+            /** Clear
+             *
+             *  Stop trusting every pre-state verification, such as when register writes are aborted.
+             *
+             **/
+            void Clear();
+
+
+        private:
+
+            /** shard
+             *
+             *  Get the shard for a transaction.
+             *
+             **/
+            Shard& shard(const uint512_t& hashTx);
+
+
+            /** slot
+             *
+             *  Get the write slot for a register.
+             *
+             **/
+            static uint32_t slot(const uint256_t& hashRegister);
+
+
+            /** entry
+             *
+             *  Get the entry for a transaction in the current generation of its shard, moving it from
+             *  the previous generation or adding it as needed. Must be called with the shard locked.
+             *
+             **/
+            static Entry& entry(Shard& shard, const uint512_t& hashTx);
+
+        };
+
+
+        /** The cache of verified transactions shared by the memory pool and block connect. **/
+        extern VerifyCache verifycache;
+    }
+}
+
+#endif
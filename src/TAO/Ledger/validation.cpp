@@ -0,0 +1,156 @@
+/*__________________________________________________________________________________________
+
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+			(c) Copyright The Nexus Developers 2014 - 2019
+
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+			"ad vocem populi" - To The Voice of The People
+
+____________________________________________________________________________________________*/
+
+#include <LLP/include/processor.h>
+
+#include <TAO/Ledger/include/validation.h>
+
+#include <Util/include/args.h>
+#include <Util/include/mutex.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <thread>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /* The checks of one call to CheckParallel, shared with the helpers that may outlive the call. */
+        struct ValidationBatch
+        {
+            /** The checks to run, only used while checks are left to take. **/
+            const std::vector<std::function<bool()>>* pChecks;
+
+            /** The number of checks. **/
+            const uint32_t nSize;
+
+            /** The next check to take. **/
+            std::atomic<uint32_t> nNext;
+
+            /** The checks that were run or skipped. **/
+            std::atomic<uint32_t> nDone;
+
+            /** Flag set when a check fails. **/
+            std::atomic<bool> fFailed;
+
+            /** Mutex for the condition. **/
+            std::mutex MUTEX;
+
+            /** The condition the caller waits on for the helpers. **/
+            std::condition_variable CONDITION;
+
+
+            ValidationBatch(const std::vector<std::function<bool()>>& vChecks)
+            : pChecks   (&vChecks)
+            , nSize     (static_cast<uint32_t>(vChecks.size()))
+            , nNext     (0)
+            , nDone     (0)
+            , fFailed   (false)
+            , MUTEX     ( )
+            , CONDITION ( )
+            {
+            }
+
+
+            /* Take checks until none are left, returning when the last one is done. */
+            void Run()
+            {
+                uint32_t nDoneHere = 0;
+                for(uint32_t nCheck = nNext++; nCheck < nSize; nCheck = nNext++)
+                {
+                    /* Skip the rest of the checks once one fails. */
+                    if(!fFailed.load() && !(*pChecks)[nCheck]())
+                        fFailed = true;
+
+                    ++nDoneHere;
+                }
+
+                /* Wake the caller once every check is done. */
+                if(nDoneHere > 0 && (nDone += nDoneHere) == nSize)
+                {
+                    LOCK(MUTEX);
+                    CONDITION.notify_all();
+                }
+            }
+        };
+
+
+        /* The pool of validation threads, started on first use. */
+        static LLP::ProcessorPool* validation_pool()
+        {
+            static std::unique_ptr<LLP::ProcessorPool> pPool(ValidationThreads() > 0 ? new LLP::ProcessorPool(ValidationThreads()) : nullptr);
+            return pPool.get();
+        }
+
+
+        /* Get the number of threads that help run context-free checks. */
+        uint32_t ValidationThreads()
+        {
+            /* The calling thread takes checks too, so leave it a core by default. */
+            static const uint32_t nThreads = static_cast<uint32_t>(std::max(0, static_cast<int32_t>(
+                config::GetArg("-validationthreads", std::max(1u, std::thread::hardware_concurrency()) - 1))));
+
+            return nThreads;
+        }
+
+
+        /* Run checks that don't depend on chain state on the validation threads. */
+        bool CheckParallel(const std::vector<std::function<bool()>>& vChecks)
+        {
+            /* Check for nothing to do. */
+            if(vChecks.empty())
+                return true;
+
+            /* Run a single check, or all of them without validation threads, on this thread. */
+            LLP::ProcessorPool* pPool = validation_pool();
+            if(!pPool || vChecks.size() == 1)
+            {
+                for(const auto& check : vChecks)
+                {
+                    if(!check())
+                        return false;
+                }
+
+                return true;
+            }
+
+            /* Ask for one helper per check beyond the first, up to the number of threads. */
+            std::shared_ptr<ValidationBatch> pBatch = std::make_shared<ValidationBatch>(vChecks);
+
+            const uint32_t nHelpers = std::min(pPool->Size(), static_cast<uint32_t>(vChecks.size() - 1));
+            for(uint32_t nHelper = 0; nHelper < nHelpers; ++nHelper)
+            {
+                if(!pPool->Submit([pBatch]{ pBatch->Run(); }))
+                    break;
+            }
+
+            /* Take checks here as well, so the helpers that are busy elsewhere never hold us up. */
+            pBatch->Run();
+
+            /* Wait for the checks the helpers took. */
+            {
+                std::unique_lock<std::mutex> lock(pBatch->MUTEX);
+                pBatch->CONDITION.wait(lock, [pBatch]{ return pBatch->nDone.load() == pBatch->nSize; });
+            }
+
+            return !pBatch->fFailed.load();
+        }
+    }
+}
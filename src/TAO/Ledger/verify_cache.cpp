@@ -0,0 +1,229 @@
+/*__________________________________________________________________________________________
+
+			(c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+			(c) Copyright The Nexus Developers 2014 - 2019
+
+			Distributed under the MIT software license, see the accompanying
+			file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+			"ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/types/transaction.h>
+#include <TAO/Ledger/types/verify_cache.h>
+
+#include <Util/include/debug.h>
+#include <Util/include/mutex.h>
+
+/* Global TAO namespace. */
+namespace TAO
+{
+
+    /* Ledger Layer namespace. */
+    namespace Ledger
+    {
+
+        /* The cache of verified transactions shared by the memory pool and block connect. */
+        VerifyCache verifycache;
+
+
+        /* Default Constructor */
+        VerifyCache::Entry::Entry()
+        : fChecked  (false)
+        , fVerified (false)
+        , nWrites   (0)
+        , vSlots    ( )
+        {
+        }
+
+
+        /* Default Constructor */
+        VerifyCache::VerifyCache()
+        : vShards  ( )
+        , vWritten (SLOTS)
+        , nWrites  (0)
+        , nCleared (0)
+        {
+        }
+
+
+        /* Record a transaction that passed its context-free checks. */
+        void VerifyCache::AddChecked(const uint512_t& hashTx)
+        {
+            Shard& SHARD = shard(hashTx);
+            LOCK(SHARD.MUTEX);
+
+            entry(SHARD, hashTx).fChecked = true;
+        }
+
+
+        /* Determine if a transaction passed its context-free checks. */
+        bool VerifyCache::Checked(const uint512_t& hashTx)
+        {
+            Shard& SHARD = shard(hashTx);
+            LOCK(SHARD.MUTEX);
+
+            /* Check the current generation first. */
+            auto it = SHARD.mapCurrent.find(hashTx);
+            if(it != SHARD.mapCurrent.end())
+                return it->second.fChecked;
+
+            /* Check the previous generation. */
+            it = SHARD.mapPrevious.find(hashTx);
+            if(it != SHARD.mapPrevious.end())
+                return it->second.fChecked;
+
+            return false;
+        }
+
+
+        /* Verify a transaction's pre-states against the registers on disk, and record it if they match. */
+        bool VerifyCache::AddVerified(const Transaction& tx)
+        {
+            /* Get the write count before any register is read, so writes during the verification are seen. */
+            const uint64_t nStart = nWrites.load();
+
+            /* Verify without logging, as registers with pending states in the memory pool won't match the disk. */
+            std::vector<uint256_t> vRegisters;
+            {
+                const bool fLogError = debug::fLogError;
+                debug::fLogError = false;
+
+                const bool fVerified = tx.Verify(FLAGS::BLOCK, vRegisters);
+
+                debug::fLogError = fLogError;
+                if(!fVerified)
+                    return false;
+            }
+
+            /* Get the slots of the registers read. */
+            std::vector<uint32_t> vSlots;
+            vSlots.reserve(vRegisters.size());
+            for(const auto& hashRegister : vRegisters)
+                vSlots.push_back(slot(hashRegister));
+
+            /* Record the verification. */
+            const uint512_t hashTx = tx.GetHash();
+
+            Shard& SHARD = shard(hashTx);
+            LOCK(SHARD.MUTEX);
+
+            Entry& ENTRY    = entry(SHARD, hashTx);
+            ENTRY.fVerified = true;
+            ENTRY.nWrites   = nStart;
+            ENTRY.vSlots    = std::move(vSlots);
+
+            return true;
+        }
+
+
+        /* Determine if a transaction's pre-states are still verified. */
+        bool VerifyCache::Verified(const uint512_t& hashTx)
+        {
+            Shard& SHARD = shard(hashTx);
+            LOCK(SHARD.MUTEX);
+
+            /* Find the transaction in either generation. */
+            auto it = SHARD.mapCurrent.find(hashTx);
+            if(it == SHARD.mapCurrent.end())
+            {
+                it = SHARD.mapPrevious.find(hashTx);
+                if(it == SHARD.mapPrevious.end())
+                    return false;
+            }
+
+            /* Check that it was verified since the last clear. */
+            const Entry& ENTRY = it->second;
+            if(!ENTRY.fVerified || ENTRY.nWrites < nCleared.load())
+                return false;
+
+            /* Check that none of its registers were written since. */
+            for(const auto& nSlot : ENTRY.vSlots)
+            {
+                if(vWritten[nSlot].load() > ENTRY.nWrites)
+                    return false;
+            }
+
+            return true;
+        }
+
+
+        /* Note a register state written to disk, after the write. */
+        void VerifyCache::Written(const uint256_t& hashRegister)
+        {
+            /* Move the slot forward to the new write count, never back if another write overtook us. */
+            const uint64_t nWrite = ++nWrites;
+
+            std::atomic<uint64_t>& nWritten = vWritten[slot(hashRegister)];
+            for(uint64_t nLast = nWritten.load(); nLast < nWrite; )
+            {
+                if(nWritten.compare_exchange_weak(nLast, nWrite))
+                    break;
+            }
+        }
+
+
+        /* Remove a transaction once it is connected. */
+        void VerifyCache::Remove(const uint512_t& hashTx)
+        {
+            Shard& SHARD = shard(hashTx);
+            LOCK(SHARD.MUTEX);
+
+            SHARD.mapCurrent.erase(hashTx);
+            SHARD.mapPrevious.erase(hashTx);
+        }
+
+
+        /* Stop trusting every pre-state verification. */
+        void VerifyCache::Clear()
+        {
+            nCleared = ++nWrites;
+        }
+
+
+        /* Get the shard for a transaction. */
+        VerifyCache::Shard& VerifyCache::shard(const uint512_t& hashTx)
+        {
+            return vShards[hashTx.Get64(0) % SHARDS];
+        }
+
+
+        /* Get the write slot for a register. */
+        uint32_t VerifyCache::slot(const uint256_t& hashRegister)
+        {
+            return static_cast<uint32_t>(hashRegister.Get64(0) % SLOTS);
+        }
+
+
+        /* Get the entry for a transaction in the current generation of its shard. */
+        VerifyCache::Entry& VerifyCache::entry(Shard& shard, const uint512_t& hashTx)
+        {
+            /* Check the current generation. */
+            auto it = shard.mapCurrent.find(hashTx);
+            if(it != shard.mapCurrent.end())
+                return it->second;
+
+            /* Start a new generation when the current one is full. */
+            if(shard.mapCurrent.size() >= MAX_SHARD)
+            {
+                shard.mapPrevious = std::move(shard.mapCurrent);
+                shard.mapCurrent.clear();
+            }
+
+            /* Move the entry from the previous generation, or add a new one. */
+            Entry& ENTRY = shard.mapCurrent[hashTx];
+
+            it = shard.mapPrevious.find(hashTx);
+            if(it != shard.mapPrevious.end())
+            {
+                ENTRY = std::move(it->second);
+                shard.mapPrevious.erase(it);
+            }
+
+            return ENTRY;
+        }
+    }
+}
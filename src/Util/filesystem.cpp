@@ -158,6 +158,26 @@ namespace filesystem
     }
 
 
+    /* Flushes a file or folder from the specified path to disk. */
+    bool sync(const std::string &path)
+    {
+    #ifndef WIN32
+        int nFD = open(path.c_str(), O_RDONLY);
+        if(nFD < 0)
+            return false;
+
+        /* The descriptor is read only, but syncs the pages written through any other descriptor. */
+        const bool fSynced = (fsync(nFD) == 0);
+        close(nFD);
+
+        return fSynced;
+    #else
+        /* Windows has no descriptors to sync here, so only check the path. */
+        return exists(path);
+    #endif
+    }
+
+
     /* Determines if the file or folder from the specified path exists. */
     bool exists(const std::string &path)
     {
@@ -65,6 +65,19 @@ namespace filesystem
     bool rename(const std::string &pathOld, const std::string &pathNew); 
 
 
+    /** sync
+     *
+     *  Flushes a file or folder from the specified path to disk, so a folder keeps its renamed
+     *  and created entries across a crash.
+     *
+     *  @param[in] path The path to sync.
+     *
+     *  @return Returns true if the path was synced, false otherwise.
+     *
+     **/
+    bool sync(const std::string &path);
+
+
     /** exists
      *
      *  Determines if the file or folder from the specified path exists.
@@ -0,0 +1,166 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#pragma once
+#ifndef NEXUS_UTIL_INCLUDE_SHARED_MUTEX_H
+#define NEXUS_UTIL_INCLUDE_SHARED_MUTEX_H
+
+#include <condition_variable>
+#include <cstdint>
+
+#include <Util/include/mutex.h>
+
+/* Macro preprocessor definitions for reader and writer locks. */
+#define SLOCK(mut) shared_lock slk(mut)
+#define WLOCK(mut) std::unique_lock<shared_mutex> wlk(mut)
+
+
+/** shared_mutex
+ *
+ *  Reader-writer lock, as C++11 has no std::shared_mutex. Any number of readers can hold it at once,
+ *  while a writer holds it alone. A waiting writer keeps new readers out so it can't be starved.
+ *  Neither side is recursive.
+ *
+ **/
+class shared_mutex
+{
+    /** Internal mutex for the lock state. **/
+    std::mutex INTERNAL_MUTEX;
+
+
+    /** Condition for readers and writers waiting on the lock. **/
+    std::condition_variable CONDITION;
+
+
+    /** The number of readers holding the lock. **/
+    uint32_t nReaders;
+
+
+    /** The number of writers waiting for the lock. **/
+    uint32_t nWaiting;
+
+
+    /** Flag set while a writer holds the lock. **/
+    bool fWriter;
+
+public:
+
+    /** Default Constructor. **/
+    shared_mutex()
+    : INTERNAL_MUTEX ( )
+    , CONDITION      ( )
+    , nReaders       (0)
+    , nWaiting       (0)
+    , fWriter        (false)
+    {
+    }
+
+
+    /** lock
+     *
+     *  Lock for writing, waiting for the readers to finish.
+     *
+     **/
+    void lock()
+    {
+        std::unique_lock<std::mutex> lk(INTERNAL_MUTEX);
+
+        ++nWaiting;
+        CONDITION.wait(lk, [this]{ return !fWriter && nReaders == 0; });
+        --nWaiting;
+
+        fWriter = true;
+    }
+
+
+    /** unlock
+     *
+     *  Release the lock for writing.
+     *
+     **/
+    void unlock()
+    {
+        {
+            LOCK(INTERNAL_MUTEX);
+            fWriter = false;
+        }
+
+        CONDITION.notify_all();
+    }
+
+
+    /** lock_shared
+     *
+     *  Lock for reading, waiting while a writer holds or waits for the lock.
+     *
+     **/
+    void lock_shared()
+    {
+        std::unique_lock<std::mutex> lk(INTERNAL_MUTEX);
+        CONDITION.wait(lk, [this]{ return !fWriter && nWaiting == 0; });
+
+        ++nReaders;
+    }
+
+
+    /** unlock_shared
+     *
+     *  Release the lock for reading, waking a writer after the last reader.
+     *
+     **/
+    void unlock_shared()
+    {
+        bool fLast = false;
+        {
+            LOCK(INTERNAL_MUTEX);
+            fLast = (--nReaders == 0);
+        }
+
+        if(fLast)
+            CONDITION.notify_all();
+    }
+};
+
+
+/** shared_lock
+ *
+ *  Holds a shared_mutex for reading for the life of the object.
+ *
+ **/
+class shared_lock
+{
+    /** The mutex held for reading. **/
+    shared_mutex& MUTEX;
+
+public:
+
+    /** Constructor, locks the mutex for reading. **/
+    explicit shared_lock(shared_mutex& mutex)
+    : MUTEX (mutex)
+    {
+        MUTEX.lock_shared();
+    }
+
+
+    /** Destructor, unlocks the mutex. **/
+    ~shared_lock()
+    {
+        MUTEX.unlock_shared();
+    }
+
+
+    shared_lock(const shared_lock&) = delete;
+    shared_lock& operator=(const shared_lock&) = delete;
+};
+
+#endif
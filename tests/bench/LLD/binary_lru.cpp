@@ -3,59 +3,138 @@
 #include <LLC/include/random.h>
 
 #include <LLD/cache/binary_lru.h>
+#include <LLD/cache/binary_lfu.h>
+#include <LLD/cache/shard_lru.h>
 
+#include <LLD/include/enum.h>
 #include <LLD/include/version.h>
+#include <LLD/templates/key.h>
 
 #include <Util/templates/datastream.h>
 
 #include <unit/catch2/catch.hpp>
 
+#include <thread>
 
-TEST_CASE( "Binary LRU Benchmarks", "[LLD]")
+
+//the caches don't share a put signature, BinaryLFU has no sector key
+void CachePut(LLD::BinaryLRU* cache, const LLD::SectorKey& key, const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData)
 {
-    debug::log(0, "===== Begin Binary LRU Benchmarks =====");
+    cache->Put(key, vKey, vData);
+}
+
+void CachePut(LLD::BinaryLFU* cache, const LLD::SectorKey& key, const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData)
+{
+    cache->Put(vKey, vData);
+}
+
+void CachePut(LLD::ShardLRU* cache, const LLD::SectorKey& key, const std::vector<uint8_t>& vKey, const std::vector<uint8_t>& vData)
+{
+    cache->Put(key, vKey, vData);
+}
+
+
+//run a read mostly workload over the cache from 1 to 64 threads
+template<class CacheType>
+void CacheBenchmark(const std::string& strName, CacheType* cache)
+{
+    const uint32_t nRecords = 200000;
+
+    //serialize the keys up front so we only measure the cache
+    std::vector<std::vector<uint8_t>> vKeys(nRecords);
+    std::vector<LLD::SectorKey> vSectorKeys(nRecords);
 
-    //benchmarks
-    LLD::BinaryLRU* cache = new LLD::BinaryLRU();
     uint256_t hash = LLC::GetRand256();
+
+    DataStream ssData(SER_LLD, LLD::DATABASE_VERSION);
+    ssData << uint1024_t(4934943);
+
+    const std::vector<uint8_t> vData = ssData.Bytes();
+    for(uint32_t i = 0; i < nRecords; ++i)
     {
-        runtime::timer timer;
-        timer.Start();
+        DataStream ssKey(SER_LLD, LLD::DATABASE_VERSION);
+        ssKey << std::make_pair(std::string("data"), hash + i);
 
-        for(int i = 0; i < 1000000; i++)
-        {
-            DataStream ssKey(SER_LLD, LLD::DATABASE_VERSION);
-            ssKey << std::make_pair(std::string("data"), hash + i);
+        vKeys[i]       = ssKey.Bytes();
+        vSectorKeys[i] = LLD::SectorKey(LLD::STATE::READY, vKeys[i], 0, i * vData.size(), vData.size());
+    }
 
-            DataStream ssData(SER_LLD, LLD::DATABASE_VERSION);
-            ssData << uint1024_t(4934943);
+    {
+        runtime::timer timer;
+        timer.Start();
 
-            cache->Put(ssKey.Bytes(), ssData.Bytes());
-        }
+        for(uint32_t i = 0; i < nRecords; ++i)
+            CachePut(cache, vSectorKeys[i], vKeys[i], vData);
 
-        uint64_t nTime = timer.ElapsedMicroseconds();
-        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Put::", ANSI_COLOR_RESET, 1000000.0 / nTime, " million records / second");
+        uint64_t nTime = std::max(timer.ElapsedMicroseconds(), uint64_t(1));
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, strName, "::Put::", ANSI_COLOR_RESET, (nRecords * 1000000) / nTime, " records/s");
     }
 
-
+    //nine reads to every write, skewed to a hot set of records
+    const uint32_t nOpsPerThread = 100000;
+    for(uint32_t nThreads = 1; nThreads <= 64; nThreads *= 2)
     {
         runtime::timer timer;
         timer.Start();
 
-        for(int i = 0; i < 1000000; i++)
+        std::vector<std::thread> vThreads;
+        for(uint32_t nThread = 0; nThread < nThreads; ++nThread)
         {
-            DataStream ssKey(SER_LLD, LLD::DATABASE_VERSION);
-            ssKey << std::make_pair(std::string("data"), hash + i);
+            vThreads.push_back(std::thread([&, nThread]()
+            {
+                std::vector<uint8_t> vRecord;
+                for(uint32_t i = 0; i < nOpsPerThread; ++i)
+                {
+                    uint32_t nIndex = (i * 7919 + nThread * 104729) % nRecords;
+                    if(i % 4 != 0)
+                        nIndex %= (nRecords / 10);
+
+                    if(i % 10 == 0)
+                        CachePut(cache, vSectorKeys[nIndex], vKeys[nIndex], vData);
+                    else
+                        cache->Get(vKeys[nIndex], vRecord);
+                }
+            }));
+        }
 
-            std::vector<uint8_t> vBytes;
+        for(auto& thread : vThreads)
+            thread.join();
 
-            cache->Get(ssKey.Bytes(), vBytes);
-        }
+        uint64_t nTime = std::max(timer.ElapsedMicroseconds(), uint64_t(1));
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, strName, "::Mixed::", ANSI_COLOR_RESET, nThreads, " threads ",
+            (uint64_t(nThreads) * nOpsPerThread * 1000000) / nTime, " ops/s");
+    }
+}
+
+
+TEST_CASE( "Binary LRU Benchmarks", "[LLD]")
+{
+    debug::log(0, "===== Begin Binary LRU Benchmarks =====");
+
+    const uint32_t nCacheSize = 1024 * 1024 * 16;
+    {
+        LLD::BinaryLRU* cache = new LLD::BinaryLRU(nCacheSize);
+        CacheBenchmark("BinaryLRU", cache);
 
-        uint64_t nTime = timer.ElapsedMicroseconds();
-        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Get::", ANSI_COLOR_RESET, 1000000.0 / nTime, " million records / second");
+        delete cache;
     }
 
+    {
+        LLD::BinaryLFU* cache = new LLD::BinaryLFU(nCacheSize);
+        CacheBenchmark("BinaryLFU", cache);
+
+        delete cache;
+    }
+
+    {
+        LLD::ShardLRU* cache = new LLD::ShardLRU(nCacheSize);
+        CacheBenchmark("ShardLRU", cache);
+
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "ShardLRU::", ANSI_COLOR_RESET, cache->Hits(), " hits ", cache->Misses(), " misses ",
+            cache->Size(), "/", nCacheSize, " bytes");
+
+        delete cache;
+    }
 
     debug::log(0, "===== End Binary LRU Benchmarks =====\n");
 }
@@ -0,0 +1,94 @@
+#include <Util/include/runtime.h>
+
+#include <LLC/include/random.h>
+
+#include <LLD/templates/sector.h>
+#include <LLD/cache/binary_lru.h>
+#include <LLD/keychain/hashmap.h>
+
+#include <Util/include/filesystem.h>
+#include <Util/templates/datastream.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <fstream>
+#include <iomanip>
+
+
+//get the total bytes of a database's sector files
+uint64_t SectorBytes(const std::string& strName)
+{
+    uint64_t nTotal = 0;
+    for(uint32_t nFile = 0; ; ++nFile)
+    {
+        std::ifstream stream(debug::safe_printstr(config::GetDataDir(), strName, "/datachain/_block.", std::setfill('0'), std::setw(5), nFile),
+            std::ios::in | std::ios::binary | std::ios::ate);
+
+        if(!stream)
+            break;
+
+        nTotal += static_cast<uint64_t>(stream.tellg());
+    }
+
+    return nTotal;
+}
+
+
+//write records shaped like ledger transactions and read them back with a small cache
+void CompressBenchmark(const std::string& strName, const uint8_t nFlags)
+{
+    filesystem::remove_directories(config::GetDataDir() + strName);
+
+    LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU>* db =
+        new LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU>(strName, LLD::FLAGS::CREATE | LLD::FLAGS::FORCE | nFlags, 77773, 1024 * 64);
+
+    const uint32_t nRecords = 50000;
+    uint512_t hash = LLC::GetRand512();
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        for(uint32_t i = 0; i < nRecords; ++i)
+        {
+            //a genesis, a few contracts with repeated addresses, and a signature that doesn't compress
+            std::vector<uint256_t> vContracts(8, uint256_t(i % 16));
+            std::vector<uint8_t> vSignature(72);
+            for(auto& n : vSignature)
+                n = static_cast<uint8_t>(LLC::GetRand());
+
+            db->Write(std::make_pair(std::string("tx"), hash + i), std::make_tuple(uint256_t(i % 64), vContracts, vSignature), "tx");
+        }
+
+        uint64_t nTime = std::max(timer.ElapsedMicroseconds(), uint64_t(1));
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, strName, "::Put::", ANSI_COLOR_RESET, (uint64_t(nRecords) * 1000000) / nTime, " records/s | ",
+            SectorBytes(strName), " bytes on disk");
+    }
+
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        const uint32_t nReads = 100000;
+        for(uint32_t i = 0; i < nReads; ++i)
+        {
+            std::tuple<uint256_t, std::vector<uint256_t>, std::vector<uint8_t>> tx;
+            db->Read(std::make_pair(std::string("tx"), hash + ((i * 7919) % nRecords)), tx);
+        }
+
+        uint64_t nTime = timer.ElapsedMicroseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, strName, "::Get::", ANSI_COLOR_RESET, (nTime * 1000) / nReads, " ns/read");
+    }
+
+    delete db;
+}
+
+
+TEST_CASE( "Sector Compression Benchmarks", "[LLD]")
+{
+    debug::log(0, "===== Begin Sector Compression Benchmarks =====");
+
+    CompressBenchmark("_SECTOR_PLAIN", 0);
+    CompressBenchmark("_SECTOR_LZ4", LLD::FLAGS::COMPRESS);
+
+    debug::log(0, "===== End Sector Compression Benchmarks =====\n");
+}
@@ -0,0 +1,67 @@
+#include <Util/include/runtime.h>
+
+#include <LLC/include/random.h>
+
+#include <LLD/templates/sector.h>
+#include <LLD/cache/binary_lru.h>
+#include <LLD/keychain/hashmap.h>
+
+#include <Util/templates/datastream.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <thread>
+
+
+TEST_CASE( "Sector Concurrent Read Benchmarks", "[LLD]")
+{
+    debug::log(0, "===== Begin Sector Concurrent Read Benchmarks =====");
+
+    //use a small cache so that reads go to the sector files
+    LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU>* db =
+        new LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU>("_SECTOR_BENCH", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE, 77773, 1024 * 64);
+
+    const uint32_t nRecords = 100000;
+    uint256_t hash = LLC::GetRand256();
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        std::vector<uint8_t> vRecord(256, 0xff);
+        for(uint32_t i = 0; i < nRecords; ++i)
+            db->Write(std::make_pair(std::string("bench"), hash + i), vRecord);
+
+        uint64_t nTime = timer.ElapsedMilliseconds();
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Put::", ANSI_COLOR_RESET, nRecords, " records in ", nTime, " ms");
+    }
+
+    //scale readers from 1 to 32 threads
+    const uint32_t nReadsPerThread = 50000;
+    for(uint32_t nThreads = 1; nThreads <= 32; nThreads *= 2)
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        std::vector<std::thread> vThreads;
+        for(uint32_t nThread = 0; nThread < nThreads; ++nThread)
+        {
+            vThreads.push_back(std::thread([&, nThread]()
+            {
+                std::vector<uint8_t> vRecord;
+                for(uint32_t i = 0; i < nReadsPerThread; ++i)
+                    db->Read(std::make_pair(std::string("bench"), hash + ((i * 7919 + nThread * 104729) % nRecords)), vRecord);
+            }));
+        }
+
+        for(auto& thread : vThreads)
+            thread.join();
+
+        uint64_t nTime = std::max(timer.ElapsedMicroseconds(), uint64_t(1));
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Get::", ANSI_COLOR_RESET, nThreads, " threads ",
+            (uint64_t(nThreads) * nReadsPerThread * 1000000) / nTime, " reads/s");
+    }
+
+    delete db;
+
+    debug::log(0, "===== End Sector Concurrent Read Benchmarks =====\n");
+}
@@ -0,0 +1,143 @@
+#include <Util/include/runtime.h>
+#include <Util/include/args.h>
+
+#include <LLP/include/base_address.h>
+#include <LLP/templates/data.h>
+#include <LLP/types/time.h>
+
+#include <unit/catch2/catch.hpp>
+
+#ifndef WIN32
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <map>
+
+
+namespace LLP
+{
+    //the time samples, an incoming time node is rejected until the server has some
+    extern std::map<std::string, int32_t> MAP_TIME_DATA;
+}
+
+
+#ifndef WIN32
+
+//get the cpu time used by the process in milliseconds
+uint64_t CpuMilliseconds()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000 + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000;
+}
+
+
+//run a data thread with idle connections and a few busy ones sending time requests
+void DataThreadBenchmark(const std::string& strBackend, const uint32_t nIdle, const uint32_t nBusy)
+{
+    config::mapArgs["-llpbackend"] = strBackend;
+
+    LLP::DataThread<LLP::TimeNode>* pthread = new LLP::DataThread<LLP::TimeNode>(0, false, 0, 0, 600);
+
+    //connect the server end of each socket pair to the data thread
+    std::vector<int32_t> vClients;
+    for(uint32_t i = 0; i < nIdle + nBusy; ++i)
+    {
+        int32_t fds[2];
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            break;
+
+        pthread->AddConnection(LLP::Socket(fds[0], LLP::BaseAddress()), nullptr);
+        vClients.push_back(fds[1]);
+    }
+
+    //let the connections settle before measuring the idle cost
+    runtime::sleep(500);
+    {
+        uint64_t nCpu = CpuMilliseconds();
+        runtime::sleep(2000);
+
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, strBackend, "::Idle::", ANSI_COLOR_RESET, pthread->GetConnectionCount(), " connections | ",
+            (CpuMilliseconds() - nCpu) / 2, " ms cpu / second");
+    }
+
+    //the busy connections are the last ones added
+    const uint32_t nFirst = static_cast<uint32_t>(vClients.size()) - std::min(nBusy, static_cast<uint32_t>(vClients.size()));
+    {
+        const std::vector<uint8_t> vRequest = { 64, 0, 0, 0, 4, 0, 0, 0, 0 };
+        std::vector<uint8_t> vResponse(9, 0);
+
+        runtime::timer timer;
+        timer.Start();
+
+        uint64_t nCpu = CpuMilliseconds();
+
+        const uint32_t nRounds = 200;
+        uint32_t nRequests = 0;
+        for(uint32_t nRound = 0; nRound < nRounds; ++nRound)
+        {
+            for(uint32_t i = nFirst; i < vClients.size(); ++i)
+                send(vClients[i], &vRequest[0], vRequest.size(), 0);
+
+            for(uint32_t i = nFirst; i < vClients.size(); ++i)
+                if(recv(vClients[i], &vResponse[0], vResponse.size(), MSG_WAITALL) == static_cast<int32_t>(vResponse.size()))
+                    ++nRequests;
+        }
+
+        uint64_t nTime = std::max(timer.ElapsedMicroseconds(), uint64_t(1));
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, strBackend, "::Busy::", ANSI_COLOR_RESET, (uint64_t(nRequests) * 1000000) / nTime, " requests/s | ",
+            nTime / nRounds, " us/round | ", CpuMilliseconds() - nCpu, " ms cpu");
+    }
+
+    //close the clients and wait for the data thread to drop them
+    for(const auto& fd : vClients)
+        close(fd);
+
+    runtime::timer timer;
+    timer.Start();
+    while(pthread->GetConnectionCount() > 0 && timer.ElapsedMilliseconds() < 10000)
+        runtime::sleep(10);
+
+    debug::log(0, ANSI_COLOR_BRIGHT_CYAN, strBackend, "::Close::", ANSI_COLOR_RESET, timer.ElapsedMilliseconds(), " ms | ",
+        pthread->GetConnectionCount(), " remaining");
+
+    delete pthread;
+}
+
+
+TEST_CASE( "Data Thread Benchmarks", "[LLP]")
+{
+    debug::log(0, "===== Begin Data Thread Benchmarks =====");
+
+    //each connection uses two descriptors, so raise the limit as far as allowed
+    uint32_t nIdle = 10000;
+    const uint32_t nBusy = 100;
+    {
+        struct rlimit limit;
+        getrlimit(RLIMIT_NOFILE, &limit);
+
+        limit.rlim_cur = std::max<rlim_t>(limit.rlim_cur, std::min<rlim_t>(limit.rlim_max, (nIdle + nBusy) * 2 + 256));
+        setrlimit(RLIMIT_NOFILE, &limit);
+
+        if(limit.rlim_cur < (nIdle + nBusy) * 2 + 256)
+            nIdle = static_cast<uint32_t>(limit.rlim_cur > (nBusy * 2 + 256) ? (limit.rlim_cur - nBusy * 2 - 256) / 2 : 0);
+    }
+
+    LLP::MAP_TIME_DATA["127.0.0.1"] = 0;
+    LLP::MAP_TIME_DATA["127.0.0.2"] = 0;
+
+    DataThreadBenchmark("poll", nIdle, nBusy);
+#if defined(__linux__)
+    DataThreadBenchmark("epoll", nIdle, nBusy);
+#endif
+
+    LLP::MAP_TIME_DATA.clear();
+    config::mapArgs.erase("-llpbackend");
+
+    debug::log(0, "===== End Data Thread Benchmarks =====\n");
+}
+
+#endif
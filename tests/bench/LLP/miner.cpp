@@ -0,0 +1,241 @@
+#include <Util/include/runtime.h>
+#include <Util/include/args.h>
+#include <Util/include/convert.h>
+
+#include <LLP/include/base_address.h>
+#include <LLP/templates/data.h>
+#include <LLP/types/miner.h>
+
+#include <TAO/API/include/global.h>
+#include <TAO/API/include/sessionmanager.h>
+
+#include <TAO/Ledger/include/chainstate.h>
+#include <TAO/Ledger/include/create.h>
+#include <TAO/Ledger/types/pinunlock.h>
+
+#include <unit/catch2/catch.hpp>
+
+#ifndef WIN32
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+
+#ifndef WIN32
+
+namespace
+{
+    //send a mining packet, data packets are headers below 128 and carry a length
+    void SendPacket(const int32_t fd, const uint8_t nHeader, const std::vector<uint8_t>& vData = std::vector<uint8_t>())
+    {
+        std::vector<uint8_t> vBytes(1, nHeader);
+        if(nHeader < 128)
+        {
+            const std::vector<uint8_t> vLength = convert::uint2bytes(static_cast<uint32_t>(vData.size()));
+            vBytes.insert(vBytes.end(), vLength.begin(), vLength.end());
+            vBytes.insert(vBytes.end(), vData.begin(), vData.end());
+        }
+
+        send(fd, &vBytes[0], vBytes.size(), 0);
+    }
+
+
+    //read a mining packet, returning its header or -1 if nothing arrived in time
+    int32_t ReadPacket(const int32_t fd)
+    {
+        uint8_t nHeader = 0;
+        if(recv(fd, &nHeader, 1, MSG_WAITALL) != 1)
+            return -1;
+
+        if(nHeader < 128)
+        {
+            std::vector<uint8_t> vLength(4, 0);
+            if(recv(fd, &vLength[0], 4, MSG_WAITALL) != 4)
+                return -1;
+
+            const uint32_t nLength = convert::bytes2uint(vLength);
+            if(nLength > 0)
+            {
+                std::vector<uint8_t> vData(nLength, 0);
+                if(recv(fd, &vData[0], nLength, MSG_WAITALL) != static_cast<int32_t>(nLength))
+                    return -1;
+            }
+        }
+
+        return nHeader;
+    }
+
+
+    //wait for every miner to receive a new round followed by its subscribed block
+    uint32_t ReadRounds(const std::vector<int32_t>& vClients)
+    {
+        uint32_t nRounds = 0;
+        for(const auto& fd : vClients)
+            if(ReadPacket(fd) == 204 && ReadPacket(fd) == 0)
+                ++nRounds;
+
+        return nRounds;
+    }
+}
+
+
+TEST_CASE( "Mining Server Benchmarks", "[miner]")
+{
+    debug::log(0, "===== Begin Mining Server Benchmarks =====");
+
+    //each miner uses two descriptors, so raise the limit as far as allowed
+    uint32_t nMiners = 1000;
+    {
+        struct rlimit limit;
+        getrlimit(RLIMIT_NOFILE, &limit);
+
+        limit.rlim_cur = std::max<rlim_t>(limit.rlim_cur, std::min<rlim_t>(limit.rlim_max, nMiners * 2 + 256));
+        setrlimit(RLIMIT_NOFILE, &limit);
+
+        if(limit.rlim_cur < nMiners * 2 + 256)
+            nMiners = static_cast<uint32_t>(limit.rlim_cur > 256 ? (limit.rlim_cur - 256) / 2 : 0);
+    }
+
+    //mine on a local testnet without peers, with a recent best block so the ledger isn't synchronizing
+    config::fTestNet = true;
+    config::mapArgs["-dns"] = "0";
+
+    const TAO::Ledger::BlockState stateOld = TAO::Ledger::ChainState::stateBest.load();
+    const uint32_t nHeightOld = TAO::Ledger::ChainState::nBestHeight.load();
+    {
+        //mine on top of the genesis block when no other benchmark set up a chain
+        if(stateOld.IsNull())
+            REQUIRE(TAO::Ledger::CreateGenesis());
+
+        TAO::Ledger::BlockState stateRecent = (stateOld.IsNull() ? TAO::Ledger::ChainState::stateGenesis : stateOld);
+        stateRecent.nTime   = runtime::unifiedtimestamp();
+        stateRecent.nHeight = nHeightOld + 1;
+
+        TAO::Ledger::ChainState::stateBest.store(stateRecent);
+        TAO::Ledger::ChainState::hashBestChain.store(stateRecent.GetHash());
+        TAO::Ledger::ChainState::nBestHeight.store(stateRecent.nHeight);
+    }
+
+    REQUIRE_FALSE(TAO::Ledger::ChainState::Synchronizing());
+
+    //log in the mining account
+    if(!TAO::API::users)
+        TAO::API::Initialize();
+
+    {
+        TAO::API::Session& session = TAO::API::GetSessionManager().Add("miner", "password", "1234");
+        session.UpdatePIN("1234", TAO::Ledger::PinUnlock::UnlockActions::MINING);
+    }
+
+    //spread the miners over a few data threads like the mining server
+    std::vector<LLP::DataThread<LLP::Miner>*> vThreads;
+    for(uint32_t n = 0; n < 4; ++n)
+        vThreads.push_back(new LLP::DataThread<LLP::Miner>(n, false, 0, 0, 600));
+
+    std::vector<int32_t> vClients;
+    for(uint32_t i = 0; i < nMiners; ++i)
+    {
+        int32_t fds[2];
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+            break;
+
+        //don't wait forever on a miner that gets no work
+        struct timeval timeout;
+        timeout.tv_sec  = 10;
+        timeout.tv_usec = 0;
+        setsockopt(fds[1], SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        vThreads[i % vThreads.size()]->AddConnection(LLP::Socket(fds[0], LLP::BaseAddress()), nullptr);
+        vClients.push_back(fds[1]);
+    }
+
+    //subscribe every miner to one hash channel block, which pushes the first round
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        for(const auto& fd : vClients)
+        {
+            SendPacket(fd, 3, convert::uint2bytes(2));
+            SendPacket(fd, 65, convert::uint2bytes(1));
+        }
+
+        const uint32_t nRounds = ReadRounds(vClients);
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Miner::Subscribe::", ANSI_COLOR_RESET, nRounds, "/", vClients.size(), " miners | ",
+            timer.ElapsedMilliseconds(), " ms");
+
+        REQUIRE(nRounds == vClients.size());
+    }
+
+    //every miner requests more work in the same round
+    {
+        runtime::timer timer;
+        timer.Start();
+
+        const uint32_t nRequests = 5;
+        uint32_t nBlocks = 0;
+        for(uint32_t nRequest = 0; nRequest < nRequests; ++nRequest)
+        {
+            for(const auto& fd : vClients)
+                SendPacket(fd, 129);
+
+            for(const auto& fd : vClients)
+                if(ReadPacket(fd) == 0)
+                    ++nBlocks;
+        }
+
+        uint64_t nTime = std::max(timer.ElapsedMicroseconds(), uint64_t(1));
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Miner::GetBlock::", ANSI_COLOR_RESET, (uint64_t(nBlocks) * 1000000) / nTime, " blocks/s | ",
+            nTime / (nRequests * std::max<size_t>(vClients.size(), 1)), " us/block");
+
+        REQUIRE(nBlocks == nRequests * vClients.size());
+    }
+
+    //a new best block pushes a new round to every subscribed miner
+    {
+        TAO::Ledger::BlockState stateNext = TAO::Ledger::ChainState::stateBest.load();
+        stateNext.nTime   = runtime::unifiedtimestamp() + 1;
+        stateNext.nHeight = stateNext.nHeight + 1;
+
+        runtime::timer timer;
+        timer.Start();
+
+        TAO::Ledger::ChainState::stateBest.store(stateNext);
+        TAO::Ledger::ChainState::hashBestChain.store(stateNext.GetHash());
+        TAO::Ledger::ChainState::nBestHeight.store(stateNext.nHeight);
+
+        const uint32_t nRounds = ReadRounds(vClients);
+        debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Miner::NewRound::", ANSI_COLOR_RESET, nRounds, "/", vClients.size(), " miners | ",
+            timer.ElapsedMilliseconds(), " ms");
+
+        REQUIRE(nRounds == vClients.size());
+    }
+
+    //close the miners and restore the chain
+    for(const auto& fd : vClients)
+        close(fd);
+
+    runtime::timer timer;
+    timer.Start();
+    for(const auto& pthread : vThreads)
+    {
+        while(pthread->GetConnectionCount() > 0 && timer.ElapsedMilliseconds() < 10000)
+            runtime::sleep(10);
+
+        delete pthread;
+    }
+
+    TAO::API::GetSessionManager().Remove(0);
+
+    TAO::Ledger::ChainState::stateBest.store(stateOld);
+    TAO::Ledger::ChainState::hashBestChain.store(stateOld.GetHash());
+    TAO::Ledger::ChainState::nBestHeight.store(nHeightOld);
+
+    config::mapArgs.erase("-dns");
+
+    debug::log(0, "===== End Mining Server Benchmarks =====\n");
+}
+
+#endif
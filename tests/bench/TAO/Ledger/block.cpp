@@ -0,0 +1,126 @@
+#include <LLC/include/eckey.h>
+#include <LLC/include/flkey.h>
+#include <LLC/include/random.h>
+
+#include <TAO/Operation/include/enum.h>
+
+#include <TAO/Ledger/include/chainstate.h>
+#include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/include/validation.h>
+#include <TAO/Ledger/types/block.h>
+#include <TAO/Ledger/types/transaction.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <Util/include/debug.h>
+
+#include <functional>
+
+TEST_CASE( "Block Validation Benchmarks", "[block]")
+{
+
+    debug::log(0, "===== Begin Block Validation Benchmarks =====");
+
+    //signatures are only checked once synchronized, so give the chain a recent best block
+    TAO::Ledger::BlockState stateOld = TAO::Ledger::ChainState::stateBest.load();
+    {
+        TAO::Ledger::BlockState stateRecent;
+        stateRecent.nBits = 1;
+        stateRecent.nTime = runtime::unifiedtimestamp();
+
+        TAO::Ledger::ChainState::stateBest.store(stateRecent);
+    }
+
+    REQUIRE_FALSE(TAO::Ledger::ChainState::Synchronizing());
+
+    //build a full block worth of signed transactions, half of them falcon and half brainpool
+    const uint32_t nTransactions = 1000;
+
+    runtime::timer bench;
+    bench.Reset();
+
+    //one key of each type signs every transaction, as key generation would dominate the setup
+    std::vector<uint8_t> vBytes = LLC::GetRand512().GetBytes();
+    LLC::CSecret vchSecret(vBytes.begin(), vBytes.end());
+
+    LLC::FLKey keyFalcon;
+    REQUIRE(keyFalcon.SetSecret(vchSecret));
+
+    LLC::ECKey keyBrainpool = LLC::ECKey(LLC::BRAINPOOL_P512_T1, 64);
+    REQUIRE(keyBrainpool.SetSecret(vchSecret, true));
+
+    TAO::Ledger::Block block;
+
+    std::vector<TAO::Ledger::Transaction> vtx(nTransactions);
+    std::vector<uint512_t> vHashes;
+    for(uint32_t n = 0; n < nTransactions; ++n)
+    {
+        const bool fFalcon = (n % 2 == 0);
+
+        TAO::Ledger::Transaction& tx = vtx[n];
+        tx.hashGenesis = LLC::GetRand256();
+        tx.hashGenesis.SetType(TAO::Ledger::GenesisType());
+        tx.nSequence   = 1;
+        tx.hashPrevTx  = LLC::GetRand512();
+        tx.nTimestamp  = runtime::unifiedtimestamp();
+        tx.nKeyType    = (fFalcon ? TAO::Ledger::SIGNATURE::FALCON : TAO::Ledger::SIGNATURE::BRAINPOOL);
+        tx.nNextType   = tx.nKeyType;
+        tx.hashNext    = LLC::GetRand256();
+
+        tx[0] << uint8_t(TAO::Operation::OP::DEBIT) << LLC::GetRand256() << LLC::GetRand256() << uint64_t(100) << uint64_t(0);
+
+        //sign the transaction hash
+        if(fFalcon)
+        {
+            tx.vchPubKey = keyFalcon.GetPubKey();
+            REQUIRE(keyFalcon.Sign(tx.GetHash().GetBytes(), tx.vchSig));
+        }
+        else
+        {
+            tx.vchPubKey = keyBrainpool.GetPubKey();
+            REQUIRE(keyBrainpool.Sign(tx.GetHash().GetBytes(), tx.vchSig));
+        }
+
+        vHashes.push_back(tx.GetHash());
+    }
+
+    //time output
+    uint64_t nTime = bench.ElapsedMilliseconds();
+    debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Block::", ANSI_COLOR_RESET, "Signed ", nTransactions, " transactions in ", nTime, " ms");
+
+    //check the transactions one after another, as blocks were checked before the validation threads
+    bench.Reset();
+    for(const auto& tx : vtx)
+    {
+        REQUIRE(tx.Check());
+    }
+
+    REQUIRE(block.BuildMerkleTree(vHashes) != 0);
+
+    //time output
+    uint64_t nSerial = bench.ElapsedMilliseconds();
+    debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Block::", ANSI_COLOR_RESET, "Checked serially in ", nSerial, " ms");
+
+    //check the transactions and the merkle root on the validation threads
+    std::vector<std::function<bool()>> vChecks;
+    for(const auto& tx : vtx)
+        vChecks.push_back([&tx]() -> bool { return tx.Check(); });
+
+    vChecks.push_back([&block, &vHashes]() -> bool { return block.BuildMerkleTree(vHashes) != 0; });
+
+    bench.Reset();
+    REQUIRE(TAO::Ledger::CheckParallel(vChecks));
+
+    //time output
+    uint64_t nParallel = bench.ElapsedMilliseconds();
+    debug::log(0, ANSI_COLOR_BRIGHT_CYAN, "Block::", ANSI_COLOR_RESET, "Checked on ", TAO::Ledger::ValidationThreads() + 1,
+        " threads in ", nParallel, " ms (", std::fixed, double(nSerial) / std::max(uint64_t(1), nParallel), "x)");
+
+    //a bad signature fails the block
+    vtx[nTransactions / 2].vchSig[0] ^= 0xff;
+    REQUIRE_FALSE(TAO::Ledger::CheckParallel(vChecks));
+
+    TAO::Ledger::ChainState::stateBest.store(stateOld);
+
+    debug::log(0, "===== End Block Validation Benchmarks =====\n");
+}
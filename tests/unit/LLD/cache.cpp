@@ -0,0 +1,101 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/cache/shard_lru.h>
+#include <LLD/templates/key.h>
+
+#include <unit/catch2/catch.hpp>
+
+namespace
+{
+    /* Get a binary key from a number. */
+    std::vector<uint8_t> Key(const uint32_t n)
+    {
+        return std::vector<uint8_t>((uint8_t*)&n, (uint8_t*)&n + sizeof(n));
+    }
+}
+
+
+TEST_CASE( "Sharded Cache Tests", "[LLD]")
+{
+    /* A quarter of the cache is kept for records too large for the shards. */
+    LLD::ShardLRU cache(1024 * 1024);
+    const LLD::SectorKey key;
+
+    //small records are found, and counted as hits and misses
+    {
+        cache.Put(key, Key(1), std::vector<uint8_t>(100, 1));
+
+        std::vector<uint8_t> vData;
+        REQUIRE(cache.Get(Key(1), vData));
+        REQUIRE(vData == std::vector<uint8_t>(100, 1));
+        REQUIRE_FALSE(cache.Get(Key(2), vData));
+
+        REQUIRE(cache.Hits() == 1);
+        REQUIRE(cache.Misses() == 1);
+    }
+
+    //records larger than a shard are kept in the overflow shard
+    {
+        cache.Put(key, Key(3), std::vector<uint8_t>(100 * 1024, 3));
+        REQUIRE(cache.Has(Key(3)));
+
+        std::vector<uint8_t> vData;
+        REQUIRE(cache.Get(Key(3), vData));
+        REQUIRE(vData.size() == 100 * 1024);
+        REQUIRE(cache.Size() > 100 * 1024);
+
+        //records that would take up the whole overflow shard aren't cached
+        cache.Put(key, Key(4), std::vector<uint8_t>(200 * 1024, 4));
+        REQUIRE_FALSE(cache.Has(Key(4)));
+    }
+
+    //a record that changes size is only found with its latest data
+    {
+        cache.Put(key, Key(3), std::vector<uint8_t>(10, 5));
+
+        std::vector<uint8_t> vData;
+        REQUIRE(cache.Get(Key(3), vData));
+        REQUIRE(vData == std::vector<uint8_t>(10, 5));
+
+        cache.Put(key, Key(1), std::vector<uint8_t>(100 * 1024, 6));
+        REQUIRE(cache.Get(Key(1), vData));
+        REQUIRE(vData.size() == 100 * 1024);
+
+        REQUIRE(cache.Remove(Key(1)));
+        REQUIRE_FALSE(cache.Has(Key(1)));
+        REQUIRE(cache.Remove(Key(3)));
+        REQUIRE_FALSE(cache.Has(Key(3)));
+    }
+
+    //reserved records are kept until they are released
+    {
+        cache.Put(key, Key(10), std::vector<uint8_t>(100 * 1024, 10), true);
+        for(uint32_t n = 11; n < 20; ++n)
+        {
+            cache.Put(key, Key(n), std::vector<uint8_t>(100 * 1024, n));
+        }
+
+        REQUIRE(cache.Has(Key(10)));
+        REQUIRE_FALSE(cache.Has(Key(11)));
+
+        cache.Reserve(Key(10), false);
+        for(uint32_t n = 20; n < 30; ++n)
+        {
+            cache.Put(key, Key(n), std::vector<uint8_t>(100 * 1024, n));
+        }
+
+        REQUIRE_FALSE(cache.Has(Key(10)));
+        REQUIRE(cache.Size() <= 1024 * 1024);
+    }
+}
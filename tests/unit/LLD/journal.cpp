@@ -0,0 +1,255 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/templates/sector.h>
+#include <LLD/templates/journal.h>
+#include <LLD/keychain/hashmap.h>
+#include <LLD/cache/binary_lru.h>
+
+#include <Util/include/args.h>
+#include <Util/include/filesystem.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <fstream>
+
+namespace
+{
+    /* Sector database over a hashmap keychain, like the ledger databases. */
+    typedef LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU> TestDB;
+
+
+    /* Get the position of the record after the one at a position in the journal file. */
+    uint64_t NextRecord(const std::string& strFile, const uint64_t nPosition)
+    {
+        std::ifstream stream(strFile, std::ios::in | std::ios::binary);
+        stream.seekg(nPosition + 4, std::ios::beg);
+
+        uint32_t nLength = 0;
+        stream.read((char*)&nLength, 4);
+
+        return nPosition + LLD::JOURNAL_HEADER_SIZE + nLength;
+    }
+
+
+    /* Overwrite a byte in the journal file. */
+    void WriteByte(const std::string& strFile, const uint64_t nPosition, const uint8_t nByte)
+    {
+        std::fstream stream(strFile, std::ios::in | std::ios::out | std::ios::binary);
+        stream.seekp(nPosition, std::ios::beg);
+        stream.write((char*)&nByte, 1);
+    }
+}
+
+
+TEST_CASE( "Transaction Journal Recovery Tests", "[LLD]")
+{
+    const std::string strFile = config::GetDataDir() + "_journal.test";
+    filesystem::remove(strFile);
+
+    const std::vector<uint8_t> vData(100, 0x5a);
+
+    //a committed group is recovered until it is released
+    {
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+        journal.Append("first", vData);
+        journal.Append("second", vData);
+        REQUIRE(journal.Commit());
+
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        REQUIRE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.size() == 2);
+        REQUIRE(mapJournals["first"] == vData);
+        REQUIRE(mapJournals["second"] == vData);
+
+        journal.Release();
+
+        mapJournals.clear();
+        REQUIRE_FALSE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.empty());
+    }
+
+    //a group that was reset without being released is still recovered on restart
+    {
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+        journal.Append("first", vData);
+        REQUIRE(journal.Commit());
+        journal.Reset();
+    }
+
+    {
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        REQUIRE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.size() == 1);
+
+        journal.Release();
+    }
+
+    //a group committed after a reset is appended, so both groups are recovered in order
+    {
+        const std::vector<uint8_t> vNext(50, 0x3c);
+        {
+            LLD::TxnJournal journal(strFile, 1024 * 1024);
+            journal.Append("first", vData);
+            REQUIRE(journal.Commit());
+            journal.Reset();
+
+            journal.Append("first", vNext);
+            journal.Append("second", vNext);
+            REQUIRE(journal.Commit());
+        }
+
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+
+        std::vector<uint8_t> vFirst = vData;
+        vFirst.insert(vFirst.end(), vNext.begin(), vNext.end());
+
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        REQUIRE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.size() == 2);
+        REQUIRE(mapJournals["first"] == vFirst);
+        REQUIRE(mapJournals["second"] == vNext);
+
+        journal.Release();
+
+        //a stale group left after the released ones is never chained to a new group
+        journal.Append("first", vData);
+        REQUIRE(journal.Commit());
+
+        mapJournals.clear();
+        REQUIRE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.size() == 1);
+        REQUIRE(mapJournals["first"] == vData);
+
+        journal.Release();
+    }
+
+    //a group with a missing commit record is discarded as a whole
+    {
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+        journal.Append("first", vData);
+        REQUIRE(journal.Commit());
+
+        //clear the magic of the commit record
+        const uint64_t nCommit = NextRecord(strFile, 0);
+        WriteByte(strFile, nCommit, 0);
+
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        REQUIRE_FALSE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.empty());
+
+        journal.Release();
+    }
+
+    //a torn record fails its checksum, so the group is discarded
+    {
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+        journal.Append("first", vData);
+        journal.Append("second", vData);
+        REQUIRE(journal.Commit());
+
+        //flip a byte in the data of the second record
+        const uint64_t nSecond = NextRecord(strFile, 0);
+        WriteByte(strFile, nSecond + LLD::JOURNAL_HEADER_SIZE + 20, 0xa5);
+
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        REQUIRE_FALSE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.empty());
+
+        journal.Release();
+    }
+
+    //a torn commit record fails its checksum, so the group is discarded
+    {
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+        journal.Append("first", vData);
+        REQUIRE(journal.Commit());
+
+        const uint64_t nCommit = NextRecord(strFile, 0);
+        WriteByte(strFile, nCommit + LLD::JOURNAL_HEADER_SIZE, 0xff);
+
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        REQUIRE_FALSE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.empty());
+
+        journal.Release();
+    }
+
+    filesystem::remove(strFile);
+}
+
+
+TEST_CASE( "Transaction Journal Replay Tests", "[LLD]")
+{
+    const std::string strFile = config::GetDataDir() + "_journal.test";
+    filesystem::remove(strFile);
+    filesystem::remove_directories(config::GetDataDir() + "_JOURNAL");
+
+    //the node stops after the journal is synced but before the records are applied
+    {
+        TestDB* pdb = new TestDB("_JOURNAL", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE, 1024, 1024 * 1024);
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+
+        pdb->TxnBegin();
+        for(uint64_t n = 0; n < 50; ++n)
+        {
+            REQUIRE(pdb->Write(std::make_pair(std::string("replay"), n), n * 7));
+        }
+
+        REQUIRE(pdb->TxnCheckpoint(journal));
+        REQUIRE(journal.Commit());
+
+        //the records only exist in the journal
+        uint64_t nValue = 0;
+        pdb->TxnRelease();
+        REQUIRE_FALSE(pdb->Read(std::make_pair(std::string("replay"), uint64_t(0)), nValue));
+
+        delete pdb;
+    }
+
+    //the group is replayed on restart, then synced and released
+    {
+        TestDB* pdb = new TestDB("_JOURNAL", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE, 1024, 1024 * 1024);
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        REQUIRE(journal.Recover(mapJournals));
+        REQUIRE(mapJournals.count(pdb->GetName()));
+
+        REQUIRE(pdb->TxnRecovery(mapJournals[pdb->GetName()]));
+        REQUIRE(pdb->TxnCommit());
+        REQUIRE(pdb->TxnSync());
+        journal.Release();
+
+        for(uint64_t n = 0; n < 50; ++n)
+        {
+            uint64_t nValue = 0;
+            REQUIRE(pdb->Read(std::make_pair(std::string("replay"), n), nValue));
+            REQUIRE(nValue == n * 7);
+        }
+
+        delete pdb;
+    }
+
+    //nothing is replayed once the group was released
+    {
+        LLD::TxnJournal journal(strFile, 1024 * 1024);
+
+        std::map<std::string, std::vector<uint8_t>> mapJournals;
+        REQUIRE_FALSE(journal.Recover(mapJournals));
+    }
+
+    filesystem::remove(strFile);
+}
@@ -0,0 +1,147 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/keychain/hashmap.h>
+#include <LLD/keychain/hashtree.h>
+#include <LLD/keychain/shard_hashmap.h>
+
+#include <Util/include/args.h>
+#include <Util/include/filesystem.h>
+#include <Util/include/runtime.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <fstream>
+
+namespace
+{
+    /* Get a key longer than the compressed key size. */
+    std::vector<uint8_t> Key(const uint32_t n)
+    {
+        std::vector<uint8_t> vKey(40, 0);
+        for(uint32_t i = 0; i < vKey.size(); ++i)
+            vKey[i] = static_cast<uint8_t>(n * 31 + i);
+
+        return vKey;
+    }
+
+
+    /* Get the size of a file. */
+    uint64_t FileSize(const std::string& strFile)
+    {
+        std::ifstream stream(strFile, std::ios::in | std::ios::binary | std::ios::ate);
+        return static_cast<uint64_t>(stream.tellg());
+    }
+}
+
+
+TEST_CASE( "Shard Keychain Tests", "[LLD]")
+{
+    const std::string strBase = config::GetDataDir() + "_SHARDS/";
+    filesystem::remove_directories(strBase);
+
+    //keys written to a binary hashmap keychain
+    {
+        LLD::BinaryHashMap hashmap(strBase, LLD::FLAGS::CREATE, 1024);
+        for(uint32_t n = 0; n < 100; ++n)
+        {
+            REQUIRE(hashmap.Put(LLD::SectorKey(LLD::STATE::READY, Key(n), 0, n * 64, 64)));
+        }
+    }
+
+    //are all moved into the shards when they are first opened
+    {
+        LLD::ShardHashMap shards(strBase, LLD::FLAGS::CREATE, 1024, 4);
+        REQUIRE_FALSE(filesystem::exists(strBase + "_hashmap.index"));
+        REQUIRE_FALSE(filesystem::exists(strBase + "_hashmap.00000"));
+
+        for(uint32_t n = 0; n < 100; ++n)
+        {
+            LLD::SectorKey cKey;
+            REQUIRE(shards.Get(Key(n), cKey));
+            REQUIRE(cKey.nSectorStart == n * 64);
+        }
+
+        REQUIRE(shards.Erase(Key(0)));
+        REQUIRE(shards.Put(LLD::SectorKey(LLD::STATE::READY, Key(100), 0, 100 * 64, 64)));
+    }
+
+    //the keys are found again with the same split
+    {
+        LLD::ShardHashMap shards(strBase, LLD::FLAGS::CREATE, 1024, 4);
+
+        LLD::SectorKey cKey;
+        REQUIRE_FALSE(shards.Get(Key(0), cKey));
+        REQUIRE(shards.Get(Key(1), cKey));
+        REQUIRE(shards.Get(Key(100), cKey));
+    }
+
+    //the keychain refuses to open with another split
+    {
+        REQUIRE_THROWS(LLD::ShardHashMap(strBase, LLD::FLAGS::CREATE, 1024, 8));
+        REQUIRE_THROWS(LLD::ShardHashMap(strBase, LLD::FLAGS::CREATE, 2048, 4));
+    }
+
+    filesystem::remove_directories(strBase);
+}
+
+
+TEST_CASE( "Tree Keychain Rewrite Tests", "[LLD]")
+{
+    const std::string strBase = config::GetDataDir() + "_TREE/";
+    const std::string strLog  = strBase + "_hashtree.log";
+    filesystem::remove_directories(strBase);
+
+    //superseding most of the log rewrites it in the background
+    {
+        LLD::BinaryHashTree tree(strBase, LLD::FLAGS::CREATE);
+        REQUIRE(tree.Put(LLD::SectorKey(LLD::STATE::READY, Key(0), 0, 0, 64)));
+
+        //every entry has the same size
+        const uint64_t nFull = FileSize(strLog) * 70000;
+        for(uint32_t n = 1; n < 70000; ++n)
+        {
+            REQUIRE(tree.Put(LLD::SectorKey(LLD::STATE::READY, Key(n % 100), 0, n * 64, 64)));
+        }
+
+        //wait for the rewrite, keys are still read while it runs
+        for(uint32_t nWait = 0; nWait < 200 && FileSize(strLog) >= nFull; ++nWait)
+        {
+            LLD::SectorKey cKey;
+            REQUIRE(tree.Get(Key(0), cKey));
+
+            runtime::sleep(50);
+        }
+
+        REQUIRE(FileSize(strLog) < nFull / 10);
+        REQUIRE_FALSE(filesystem::exists(strBase + "_hashtree.tmp"));
+
+        REQUIRE(tree.Erase(Key(0)));
+    }
+
+    //the rewritten log replays to the last state of every key
+    {
+        LLD::BinaryHashTree tree(strBase, LLD::FLAGS::CREATE);
+
+        LLD::SectorKey cKey;
+        REQUIRE_FALSE(tree.Get(Key(0), cKey));
+
+        for(uint32_t n = 1; n < 100; ++n)
+        {
+            REQUIRE(tree.Get(Key(n), cKey));
+            REQUIRE(cKey.nSectorStart == (69900 + n) * 64);
+        }
+    }
+
+    filesystem::remove_directories(strBase);
+}
@@ -0,0 +1,197 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLC/include/random.h>
+
+#include <LLD/include/global.h>
+
+#include <TAO/Register/include/create.h>
+#include <TAO/Register/include/enum.h>
+#include <TAO/Register/types/address.h>
+#include <TAO/Register/types/object.h>
+
+#include <Util/include/filesystem.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <algorithm>
+
+namespace
+{
+    /* Check if a register is in a list from an index. */
+    bool Listed(const std::vector<uint256_t>& vRegisters, const uint256_t& hashRegister)
+    {
+        return std::find(vRegisters.begin(), vRegisters.end(), hashRegister) != vRegisters.end();
+    }
+
+
+    /* Write an account of a token owned by a genesis. */
+    uint256_t WriteAccount(const uint256_t& hashGenesis, const uint256_t& hashToken)
+    {
+        const uint256_t hashAccount = TAO::Register::Address(TAO::Register::Address::ACCOUNT);
+
+        TAO::Register::Object account = TAO::Register::CreateAccount(hashToken);
+        account.hashOwner = hashGenesis;
+
+        REQUIRE(LLD::Register->WriteState(hashAccount, account));
+
+        return hashAccount;
+    }
+}
+
+
+TEST_CASE( "Register Index Tests", "[LLD]")
+{
+    const std::string strRegister = config::GetDataDir() + "_REGISTER";
+    const std::string strHashmap  = config::GetDataDir() + "_REGISTER.hashmap";
+
+    //the default hashmap keychain has no indexes, so queries fail
+    {
+        REQUIRE_FALSE(LLD::Register->InitializeIndexes(false));
+        REQUIRE_FALSE(LLD::Register->InitializeIndexes(true));
+
+        std::vector<uint256_t> vRegisters;
+        REQUIRE_FALSE(LLD::Register->ListOwner(LLC::GetRand256(), vRegisters));
+        REQUIRE_FALSE(LLD::Register->ListToken(LLC::GetRand256(), vRegisters));
+    }
+
+    //keep the hashmap register database aside, the ordered keychain refuses to open over it
+    delete LLD::Register;
+    REQUIRE(filesystem::rename(strRegister, strHashmap));
+
+    LLD::Register = new LLD::RegisterDB(LLD::FLAGS::CREATE | LLD::FLAGS::FORCE | LLD::FLAGS::ORDERED);
+    REQUIRE(LLD::Register->InitializeIndexes(false));
+
+    const uint256_t hashGenesis  = LLC::GetRand256();
+    const uint256_t hashGenesis2 = hashGenesis + 1;
+    const uint256_t hashToken    = TAO::Register::Address(TAO::Register::Address::TOKEN);
+    const uint256_t hashToken2   = hashToken + 1;
+
+    const uint256_t hashAccount  = WriteAccount(hashGenesis, hashToken);
+    const uint256_t hashAccount2 = WriteAccount(hashGenesis, hashToken);
+    const uint256_t hashAccount3 = WriteAccount(hashGenesis2, hashToken2);
+
+    const uint256_t hashRaw = TAO::Register::Address(TAO::Register::Address::RAW);
+    {
+        TAO::Register::State state;
+        state.nType     = TAO::Register::REGISTER::RAW;
+        state.hashOwner = hashGenesis;
+        state << std::string("data");
+
+        REQUIRE(LLD::Register->WriteState(hashRaw, state));
+    }
+
+    //written states are indexed by owner, standard and token
+    {
+        std::vector<uint256_t> vRegisters;
+        REQUIRE(LLD::Register->ListOwner(hashGenesis, vRegisters));
+        REQUIRE(vRegisters.size() == 3);
+        REQUIRE(Listed(vRegisters, hashAccount));
+        REQUIRE(Listed(vRegisters, hashAccount2));
+        REQUIRE(Listed(vRegisters, hashRaw));
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListToken(hashToken, vRegisters));
+        REQUIRE(vRegisters.size() == 2);
+        REQUIRE(Listed(vRegisters, hashAccount));
+        REQUIRE(Listed(vRegisters, hashAccount2));
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListStandard(TAO::Register::OBJECTS::ACCOUNT, vRegisters));
+        REQUIRE(vRegisters.size() == 3);
+        REQUIRE_FALSE(Listed(vRegisters, hashRaw));
+    }
+
+    //a prefix query doesn't run into the keys of the next value
+    {
+        std::vector<uint256_t> vRegisters;
+        REQUIRE(LLD::Register->ListOwner(hashGenesis2, vRegisters));
+        REQUIRE(vRegisters.size() == 1);
+        REQUIRE(vRegisters[0] == hashAccount3);
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListToken(hashToken2, vRegisters));
+        REQUIRE(vRegisters.size() == 1);
+        REQUIRE(vRegisters[0] == hashAccount3);
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListOwner(hashGenesis - 1, vRegisters));
+        REQUIRE(vRegisters.empty());
+    }
+
+    //a transfer moves the owner index, the token index is unchanged
+    {
+        TAO::Register::State state;
+        REQUIRE(LLD::Register->ReadState(hashAccount, state));
+
+        state.hashOwner = hashGenesis2;
+        REQUIRE(LLD::Register->WriteState(hashAccount, state));
+
+        std::vector<uint256_t> vRegisters;
+        REQUIRE(LLD::Register->ListOwner(hashGenesis, vRegisters));
+        REQUIRE(vRegisters.size() == 2);
+        REQUIRE_FALSE(Listed(vRegisters, hashAccount));
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListOwner(hashGenesis2, vRegisters));
+        REQUIRE(vRegisters.size() == 2);
+        REQUIRE(Listed(vRegisters, hashAccount));
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListToken(hashToken, vRegisters));
+        REQUIRE(vRegisters.size() == 2);
+    }
+
+    //an erased state loses all of its indexes
+    {
+        REQUIRE(LLD::Register->EraseState(hashAccount2));
+
+        std::vector<uint256_t> vRegisters;
+        REQUIRE(LLD::Register->ListOwner(hashGenesis, vRegisters));
+        REQUIRE(vRegisters.size() == 1);
+        REQUIRE(vRegisters[0] == hashRaw);
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListToken(hashToken, vRegisters));
+        REQUIRE(vRegisters.size() == 1);
+        REQUIRE(vRegisters[0] == hashAccount);
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListStandard(TAO::Register::OBJECTS::ACCOUNT, vRegisters));
+        REQUIRE(vRegisters.size() == 2);
+        REQUIRE_FALSE(Listed(vRegisters, hashAccount2));
+    }
+
+    //rebuilding the indexes gives the same results
+    {
+        REQUIRE(LLD::Register->InitializeIndexes(true));
+
+        std::vector<uint256_t> vRegisters;
+        REQUIRE(LLD::Register->ListOwner(hashGenesis2, vRegisters));
+        REQUIRE(vRegisters.size() == 2);
+        REQUIRE(Listed(vRegisters, hashAccount));
+        REQUIRE(Listed(vRegisters, hashAccount3));
+
+        vRegisters.clear();
+        REQUIRE(LLD::Register->ListToken(hashToken, vRegisters));
+        REQUIRE(vRegisters.size() == 1);
+        REQUIRE(vRegisters[0] == hashAccount);
+    }
+
+    //restore the hashmap register database for the other tests
+    delete LLD::Register;
+    REQUIRE(filesystem::remove_directories(strRegister));
+    REQUIRE(filesystem::rename(strHashmap, strRegister));
+
+    LLD::Register = new LLD::RegisterDB(LLD::FLAGS::CREATE | LLD::FLAGS::FORCE);
+}
@@ -0,0 +1,218 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLD/templates/sector.h>
+#include <LLD/keychain/hashmap.h>
+#include <LLD/cache/binary_lru.h>
+
+#include <Util/include/args.h>
+#include <Util/include/filesystem.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+namespace
+{
+    /* Sector database over a hashmap keychain, like the ledger databases. */
+    typedef LLD::SectorDatabase<LLD::BinaryHashMap, LLD::BinaryLRU> TestDB;
+}
+
+
+TEST_CASE( "Sector Mapped Read Tests", "[LLD]")
+{
+    TestDB* pdb = new TestDB("_MMAP", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE | LLD::FLAGS::MMAP, 1024, 1024 * 1024);
+
+    //records appended after the file was mapped are read back
+    for(uint64_t n = 0; n < 100; ++n)
+    {
+        REQUIRE(pdb->Write(std::make_pair(std::string("record"), n), n * 3));
+    }
+
+    for(uint64_t n = 0; n < 100; ++n)
+    {
+        uint64_t nValue = 0;
+        REQUIRE(pdb->Read(std::make_pair(std::string("record"), n), nValue));
+        REQUIRE(nValue == n * 3);
+    }
+
+    //a stale key past the end of the file fails instead of faulting on the map
+    {
+        const std::vector<uint8_t> vKey = { 's', 't', 'a', 'l', 'e' };
+
+        std::vector<uint8_t> vData;
+        REQUIRE_FALSE(pdb->Get(LLD::SectorKey(LLD::STATE::READY, vKey, 0, 64 * 1024 * 1024, 64), vData));
+        REQUIRE_FALSE(pdb->Get(LLD::SectorKey(LLD::STATE::READY, vKey, 0, 0, 512 * 1024), vData));
+    }
+
+    delete pdb;
+}
+
+
+TEST_CASE( "Sector Compaction Tests", "[LLD]")
+{
+    //compact with both file and memory mapped reads
+    const std::vector<uint16_t> vFlags = { 0, LLD::FLAGS::MMAP };
+    for(const auto& nMapFlags : vFlags)
+    {
+        const std::string strDB = config::GetDataDir() + "_COMPACT";
+        filesystem::remove_directories(strDB);
+
+        //fill the first file, then erase every odd record so half of it is dead space
+        {
+            TestDB* pdb = new TestDB("_COMPACT", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE | nMapFlags, 1024, 1024);
+            for(uint64_t n = 0; n < 1000; ++n)
+            {
+                REQUIRE(pdb->Write(std::make_pair(std::string("compact"), n), std::vector<uint8_t>(100, uint8_t(n))));
+            }
+
+            for(uint64_t n = 1; n < 1000; n += 2)
+            {
+                REQUIRE(pdb->Erase(std::make_pair(std::string("compact"), n)));
+            }
+
+            delete pdb;
+        }
+
+        //start a new append file so the first one is behind the tail
+        std::ofstream(strDB + "/datachain/_block.00001", std::ios::out | std::ios::binary | std::ios::trunc).close();
+
+        TestDB* pdb = new TestDB("_COMPACT", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE | nMapFlags, 1024, 1024);
+
+        //read the live records from other threads while they are moved
+        std::atomic<bool> fDone(false);
+        std::atomic<uint64_t> nReads(0);
+        std::atomic<uint64_t> nFailed(0);
+
+        std::vector<std::thread> vReaders;
+        for(uint32_t nThread = 0; nThread < 4; ++nThread)
+        {
+            vReaders.push_back(std::thread([&, nThread]()
+            {
+                while(!fDone.load())
+                {
+                    for(uint64_t n = nThread * 2; n < 1000; n += 2)
+                    {
+                        std::vector<uint8_t> vData;
+                        if(!pdb->Read(std::make_pair(std::string("compact"), n), vData) || vData != std::vector<uint8_t>(100, uint8_t(n)))
+                            ++nFailed;
+
+                        ++nReads;
+                    }
+                }
+            }));
+        }
+
+        //wait for the readers to start
+        while(nReads.load() < 1000)
+            std::this_thread::yield();
+
+        const uint64_t nReclaimed = pdb->Compact(25);
+
+        //keep reading from the new positions for a while
+        const uint64_t nCompacted = nReads.load();
+        while(nReads.load() < nCompacted + 1000)
+            std::this_thread::yield();
+
+        fDone.store(true);
+        for(auto& thread : vReaders)
+        {
+            thread.join();
+        }
+
+        REQUIRE(nReclaimed > 0);
+        REQUIRE(nFailed.load() == 0);
+
+        //the live records are in the current file, the erased ones are gone
+        for(uint64_t n = 0; n < 1000; ++n)
+        {
+            std::vector<uint8_t> vData;
+            if(n % 2 == 0)
+            {
+                REQUIRE(pdb->Read(std::make_pair(std::string("compact"), n), vData));
+                REQUIRE(vData == std::vector<uint8_t>(100, uint8_t(n)));
+            }
+            else
+            {
+                REQUIRE_FALSE(pdb->Read(std::make_pair(std::string("compact"), n), vData));
+            }
+        }
+
+        //the retired file is truncated
+        {
+            std::ifstream stream(strDB + "/datachain/_block.00000", std::ios::in | std::ios::binary | std::ios::ate);
+            REQUIRE(stream.tellg() == 0);
+        }
+
+        delete pdb;
+        filesystem::remove_directories(strDB);
+    }
+}
+
+
+TEST_CASE( "Sector Compaction Sync Tests", "[LLD]")
+{
+    const std::string strDB = config::GetDataDir() + "_COMPACT";
+    filesystem::remove_directories(strDB);
+
+    //fill the first file, then erase every odd record so half of it is dead space
+    {
+        TestDB* pdb = new TestDB("_COMPACT", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE, 1024, 1024);
+        for(uint64_t n = 0; n < 1000; ++n)
+        {
+            REQUIRE(pdb->Write(std::make_pair(std::string("compact"), n), std::vector<uint8_t>(100, uint8_t(n))));
+        }
+
+        for(uint64_t n = 1; n < 1000; n += 2)
+        {
+            REQUIRE(pdb->Erase(std::make_pair(std::string("compact"), n)));
+        }
+
+        delete pdb;
+    }
+
+    //start a new append file so the first one is behind the tail
+    std::ofstream(strDB + "/datachain/_block.00001", std::ios::out | std::ios::binary | std::ios::trunc).close();
+
+    TestDB* pdb = new TestDB("_COMPACT", LLD::FLAGS::CREATE | LLD::FLAGS::FORCE, 1024, 1024);
+
+    //open the keychain file for reads before it is unlinked
+    for(uint64_t n = 0; n < 1000; n += 2)
+    {
+        std::vector<uint8_t> vData;
+        REQUIRE(pdb->Read(std::make_pair(std::string("compact"), n), vData));
+    }
+
+    //the keychain can't be synced once its file is gone from the directory
+    REQUIRE(filesystem::remove(strDB + "/keychain/_hashmap.00000"));
+
+    //so the old file is never truncated
+    REQUIRE(pdb->Compact(25) == 0);
+    {
+        std::ifstream stream(strDB + "/datachain/_block.00000", std::ios::in | std::ios::binary | std::ios::ate);
+        REQUIRE(stream.tellg() > 0);
+    }
+
+    //and the live records are still found
+    for(uint64_t n = 0; n < 1000; n += 2)
+    {
+        std::vector<uint8_t> vData;
+        REQUIRE(pdb->Read(std::make_pair(std::string("compact"), n), vData));
+        REQUIRE(vData == std::vector<uint8_t>(100, uint8_t(n)));
+    }
+
+    delete pdb;
+    filesystem::remove_directories(strDB);
+}
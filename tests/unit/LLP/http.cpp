@@ -0,0 +1,155 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <unit/catch2/catch.hpp>
+
+#include <LLP/include/base_address.h>
+#include <LLP/types/httpnode.h>
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifndef WIN32
+namespace
+{
+    /* HTTP node that leaves the packets for the test to check. */
+    class TestNode : public LLP::HTTPNode
+    {
+    public:
+
+        TestNode(const LLP::Socket& SOCKET_IN)
+        : LLP::HTTPNode(SOCKET_IN, nullptr, false)
+        {
+        }
+
+        void Event(uint8_t EVENT, uint32_t LENGTH = 0) override
+        {
+        }
+
+        bool ProcessPacket() override
+        {
+            return true;
+        }
+    };
+
+
+    /* Send a string to the other end of the socket pair. */
+    void send_string(const int32_t fd, const std::string& strData)
+    {
+        REQUIRE(send(fd, strData.data(), strData.size(), 0) == static_cast<ssize_t>(strData.size()));
+    }
+}
+
+
+TEST_CASE( "LLP::HTTPNode pipelined requests", "[http]")
+{
+    int32_t fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    TestNode node(LLP::Socket(fds[0], LLP::BaseAddress()));
+
+    /* Two requests and the start of a third arrive together. */
+    send_string(fds[1],
+        "POST /system/get/info HTTP/1.1\r\nContent-Type: application/json\r\nContent-Length: 7\r\n\r\n{\"a\":1}"
+        "GET /ledger/get/blockhash?height=1 HTTP/1.1\r\nConnection: close\r\n\r\n"
+        "POST /users/list/accounts HTTP/1.0\r\nConnection: keep-alive\r\nContent-Le");
+
+    /* The first request only takes its own content. */
+    node.ReadPacket();
+    REQUIRE(node.PacketComplete());
+    REQUIRE(node.INCOMING.strType == "POST");
+    REQUIRE(node.INCOMING.strRequest == "/system/get/info");
+    REQUIRE(node.INCOMING.strVersion == "HTTP/1.1");
+    REQUIRE(node.INCOMING.mapHeaders["content-type"] == "application/json");
+    REQUIRE(node.INCOMING.strContent == "{\"a\":1}");
+    REQUIRE(node.INCOMING.KeepAlive());
+    REQUIRE(node.PacketBuffered());
+
+    /* The second request is parsed from the buffer. */
+    node.ResetPacket();
+    node.ReadPacket();
+    REQUIRE(node.PacketComplete());
+    REQUIRE(node.INCOMING.strType == "GET");
+    REQUIRE(node.INCOMING.strRequest == "/ledger/get/blockhash?height=1");
+    REQUIRE(node.INCOMING.strContent == "");
+    REQUIRE_FALSE(node.INCOMING.KeepAlive());
+    REQUIRE(node.PacketBuffered());
+
+    /* The third waits for the rest of its header, and nothing is left to parse until it arrives. */
+    node.ResetPacket();
+    node.ReadPacket();
+    REQUIRE_FALSE(node.PacketComplete());
+    REQUIRE_FALSE(node.PacketBuffered());
+
+    /* The content arrives in pieces. */
+    send_string(fds[1], "ngth: 10\r\n\r\n{\"b\":");
+    node.ReadPacket();
+    REQUIRE_FALSE(node.PacketComplete());
+
+    send_string(fds[1], "\"xy\"}\r\n");
+    node.ReadPacket();
+    REQUIRE(node.PacketComplete());
+    REQUIRE(node.INCOMING.strRequest == "/users/list/accounts");
+    REQUIRE(node.INCOMING.strContent == "{\"b\":\"xy\"}");
+    REQUIRE(node.INCOMING.KeepAlive());
+
+    /* The trailing line break is skipped before the next request. */
+    node.ResetPacket();
+    REQUIRE(node.PacketBuffered());
+    node.ReadPacket();
+    REQUIRE_FALSE(node.PacketComplete());
+    REQUIRE_FALSE(node.PacketBuffered());
+
+    close(fds[1]);
+}
+
+
+TEST_CASE( "LLP::HTTPNode json response", "[http]")
+{
+    int32_t fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    TestNode node(LLP::Socket(fds[0], LLP::BaseAddress()));
+
+    /* Write a response with json content. */
+    LLP::HTTPPacket RESPONSE(200);
+    RESPONSE.mapHeaders["Connection"] = "keep-alive";
+
+    const json::json jsonContent = { {"result", { {"height", 1}, {"name", "café"} } } };
+    node.WriteResponse(RESPONSE, jsonContent);
+
+    /* Read the response from the other end. */
+    std::string strResponse;
+    char vBuffer[4096];
+
+    ssize_t nRead = 0;
+    while((nRead = recv(fds[1], vBuffer, sizeof(vBuffer), MSG_DONTWAIT)) > 0)
+        strResponse.append(vBuffer, nRead);
+
+    /* The content is the same as a dump, and its length is in the header. */
+    const std::string strContent = jsonContent.dump();
+    const std::string::size_type nHeader = strResponse.find("\r\n\r\n");
+    REQUIRE(nHeader != std::string::npos);
+    REQUIRE(strResponse.substr(nHeader + 4) == strContent);
+
+    const std::string strHeader = strResponse.substr(0, nHeader);
+    REQUIRE(strHeader.find("HTTP/1.1 200 OK") == 0);
+    REQUIRE(strHeader.find("Content-Length: " + std::to_string(strContent.size())) != std::string::npos);
+    REQUIRE(strHeader.find("Content-Type: application/json") != std::string::npos);
+    REQUIRE(strHeader.find("Connection: keep-alive") != std::string::npos);
+
+    close(fds[1]);
+}
+#endif
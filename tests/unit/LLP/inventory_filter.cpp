@@ -0,0 +1,86 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <unit/catch2/catch.hpp>
+
+#include <LLC/include/random.h>
+#include <LLC/types/uint1024.h>
+
+#include <LLP/include/inventory_filter.h>
+
+TEST_CASE( "LLP::InventoryFilter insert and roll", "[inventory]")
+{
+    LLP::InventoryFilter filter(1000);
+
+    /* Items are only new the first time. */
+    std::vector<uint512_t> vFirst;
+    for(uint32_t n = 0; n < 1000; ++n)
+        vFirst.push_back(LLC::GetRand512());
+
+    for(const auto& hash : vFirst)
+    {
+        REQUIRE(filter.Insert(hash));
+    }
+
+    for(const auto& hash : vFirst)
+    {
+        REQUIRE(filter.Has(hash));
+        REQUIRE_FALSE(filter.Insert(hash));
+    }
+
+    /* Blocks use the same filter. */
+    const uint1024_t hashBlock = LLC::GetRand1024();
+    REQUIRE_FALSE(filter.Has(hashBlock));
+    REQUIRE(filter.Insert(hashBlock));
+    REQUIRE(filter.Has(hashBlock));
+
+    /* The first items are kept for one more generation. */
+    for(uint32_t n = 0; n < 999; ++n)
+        filter.Insert(LLC::GetRand512());
+
+    for(const auto& hash : vFirst)
+    {
+        REQUIRE(filter.Has(hash));
+    }
+
+    /* Another generation drops them, apart from false positives. */
+    for(uint32_t n = 0; n < 2000; ++n)
+        filter.Insert(LLC::GetRand512());
+
+    uint32_t nKept = 0;
+    for(const auto& hash : vFirst)
+        nKept += filter.Has(hash) ? 1 : 0;
+
+    REQUIRE(nKept < 10);
+
+    /* Clear forgets everything. */
+    filter.Clear();
+    REQUIRE_FALSE(filter.Has(hashBlock));
+}
+
+
+TEST_CASE( "LLP::InventoryFilter false positives", "[inventory]")
+{
+    LLP::InventoryFilter filter(10000);
+
+    /* Fill both generations. */
+    for(uint32_t n = 0; n < 20000; ++n)
+        filter.Insert(LLC::GetRand512());
+
+    /* Items that were never added are rarely reported. */
+    uint32_t nFalse = 0;
+    for(uint32_t n = 0; n < 100000; ++n)
+        nFalse += filter.Has(LLC::GetRand512()) ? 1 : 0;
+
+    REQUIRE(nFalse < 500);
+}
@@ -0,0 +1,108 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <unit/catch2/catch.hpp>
+
+#include <LLP/packets/message.h>
+
+#include <LLC/include/random.h>
+
+TEST_CASE( "LLP::MessagePacket compression", "[message]")
+{
+    /* Serialized chain data repeats a lot, so build a payload that compresses. */
+    std::vector<uint8_t> vPayload;
+    for(uint32_t n = 0; n < 4096; ++n)
+        vPayload.push_back(static_cast<uint8_t>(n % 64));
+
+    LLP::MessagePacket PACKET(0x31);
+    PACKET.DATA   = vPayload;
+    PACKET.LENGTH = static_cast<uint32_t>(vPayload.size());
+
+    /* The compressed packet is smaller and flagged. */
+    LLP::MessagePacket COMPRESSED;
+    REQUIRE(PACKET.Compress(COMPRESSED));
+    REQUIRE(COMPRESSED.MESSAGE == 0x31);
+    REQUIRE((COMPRESSED.FLAGS & LLP::MessagePacket::COMPRESSED));
+    REQUIRE(COMPRESSED.LENGTH == COMPRESSED.DATA.size());
+    REQUIRE(COMPRESSED.LENGTH < PACKET.LENGTH);
+
+    /* A compressed packet isn't compressed again. */
+    LLP::MessagePacket TWICE;
+    REQUIRE_FALSE(COMPRESSED.Compress(TWICE));
+
+    /* The header and payload read back to the original packet. */
+    LLP::MessagePacket READ;
+    {
+        DataStream ssHeader(COMPRESSED.GetHeader(COMPRESSED.LENGTH), SER_NETWORK, LLP::MIN_PROTO_VERSION);
+        ssHeader >> READ;
+        READ.DATA = COMPRESSED.DATA;
+    }
+
+    REQUIRE(READ.Complete());
+    REQUIRE(READ.Decompress());
+    REQUIRE(READ.FLAGS == 0);
+    REQUIRE(READ.LENGTH == vPayload.size());
+    REQUIRE(READ.DATA == vPayload);
+
+    /* Uncompressed packets are left as they are. */
+    REQUIRE(PACKET.Decompress());
+    REQUIRE(PACKET.DATA == vPayload);
+
+    /* Random data doesn't get smaller, so it is sent uncompressed. */
+    LLP::MessagePacket RANDOM(0x31);
+    RANDOM.DATA = LLC::GetRand256().GetBytes();
+    RANDOM.LENGTH = static_cast<uint32_t>(RANDOM.DATA.size());
+
+    LLP::MessagePacket RANDOM_COMPRESSED;
+    REQUIRE_FALSE(RANDOM.Compress(RANDOM_COMPRESSED));
+}
+
+
+TEST_CASE( "LLP::MessagePacket decompression limits", "[message]")
+{
+    /* Compress a payload of the largest size allowed. */
+    LLP::MessagePacket PACKET(0x31);
+    PACKET.DATA.resize(LLP::MessagePacket::MAX_SIZE, 0);
+    PACKET.LENGTH = LLP::MessagePacket::MAX_SIZE;
+
+    LLP::MessagePacket COMPRESSED;
+    REQUIRE(PACKET.Compress(COMPRESSED));
+    REQUIRE(COMPRESSED.IsValid());
+
+    /* A size over the limit is rejected before decompressing. */
+    LLP::MessagePacket LARGE = COMPRESSED;
+    const uint32_t nLarge = LLP::MessagePacket::MAX_SIZE + 1;
+    for(uint32_t i = 0; i < 4; ++i)
+        LARGE.DATA[i] = static_cast<uint8_t>(nLarge >> (i * 8));
+
+    REQUIRE_FALSE(LARGE.Decompress());
+
+    /* A size that doesn't match the compressed payload is rejected. */
+    LLP::MessagePacket SHORT = COMPRESSED;
+    SHORT.DATA[0] = static_cast<uint8_t>(SHORT.DATA[0] - 1);
+    REQUIRE_FALSE(SHORT.Decompress());
+
+    /* Truncated and empty payloads are rejected. */
+    LLP::MessagePacket TRUNCATED = COMPRESSED;
+    TRUNCATED.DATA.resize(TRUNCATED.DATA.size() / 2);
+    TRUNCATED.LENGTH = static_cast<uint32_t>(TRUNCATED.DATA.size());
+    REQUIRE_FALSE(TRUNCATED.Decompress());
+
+    LLP::MessagePacket EMPTY = COMPRESSED;
+    EMPTY.DATA.resize(4);
+    REQUIRE_FALSE(EMPTY.Decompress());
+
+    /* The packet at the limit decompresses. */
+    REQUIRE(COMPRESSED.Decompress());
+    REQUIRE(COMPRESSED.LENGTH == uint32_t(LLP::MessagePacket::MAX_SIZE));
+}
@@ -0,0 +1,107 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <unit/catch2/catch.hpp>
+
+#include <LLP/include/metrics.h>
+
+#include <limits>
+
+TEST_CASE( "LLP::Histogram percentiles", "[metrics]")
+{
+    LLP::Histogram hist;
+    REQUIRE(hist.Percentile(0.5) == 0);
+
+    /* Small values are counted exactly. */
+    for(uint64_t n = 1; n <= 10; ++n)
+        hist.Add(n);
+
+    REQUIRE(hist.Count() == 10);
+    REQUIRE(hist.Sum() == 55);
+    REQUIRE(hist.Percentile(0.5)  == 5);
+    REQUIRE(hist.Percentile(0.99) == 10);
+    REQUIRE(hist.Percentile(0.0)  == 1);
+
+    /* Larger values are within an eighth of the true value, and never below it. */
+    LLP::Histogram histLarge;
+    for(uint64_t n = 1; n <= 100000; ++n)
+        histLarge.Add(n);
+
+    const double dFractions[] = { 0.5, 0.9, 0.99, 0.999 };
+    for(const double dFraction : dFractions)
+    {
+        const uint64_t nTrue = static_cast<uint64_t>(dFraction * 100000);
+        const uint64_t nPercentile = histLarge.Percentile(dFraction);
+
+        REQUIRE(nPercentile >= nTrue);
+        REQUIRE(nPercentile <= nTrue + nTrue / 8);
+    }
+
+    /* Huge values fall in the last bucket. */
+    LLP::Histogram histHuge;
+    histHuge.Add(std::numeric_limits<uint64_t>::max());
+    REQUIRE(histHuge.Percentile(1.0) >= (uint64_t(1) << 39));
+}
+
+
+TEST_CASE( "LLP::Metrics record and format", "[metrics]")
+{
+    LLP::Metrics metrics;
+    metrics.Record("GET:BLOCK", 100, 1000, 50);
+    metrics.Record("GET:BLOCK", 100, 2000, 150);
+    metrics.Record("PING", 8, 8, 3);
+
+    std::map<std::string, LLP::MessageMetrics> mapMessages = metrics.Messages();
+    REQUIRE(mapMessages.size() == 2);
+    REQUIRE(mapMessages["GET:BLOCK"].nCount    == 2);
+    REQUIRE(mapMessages["GET:BLOCK"].nBytesIn  == 200);
+    REQUIRE(mapMessages["GET:BLOCK"].nBytesOut == 3000);
+    REQUIRE(mapMessages["GET:BLOCK"].histTime.Sum() == 200);
+    REQUIRE(mapMessages["PING"].nCount == 1);
+
+    /* Message types past the limit are counted together. */
+    for(uint32_t n = 0; n < 1000; ++n)
+        metrics.Record("method" + std::to_string(n), 1, 1, 1);
+
+    mapMessages = metrics.Messages();
+    REQUIRE(mapMessages.size() <= 257);
+    REQUIRE(mapMessages.count("other") == 1);
+
+    /* The Prometheus output has a sample for each message type, with escaped labels. */
+    metrics.Clear();
+    metrics.Record("a\"b", 1, 2, 1000000);
+
+    LLP::ServerMetrics server;
+    server.strName     = "Tritium";
+    server.nRelayQueue = 4;
+    server.mapMessages = metrics.Messages();
+
+    const std::string strText = LLP::Prometheus({ server });
+    REQUIRE(strText.find("nexus_llp_relay_queue{server=\"Tritium\"} 4\n") != std::string::npos);
+    REQUIRE(strText.find("nexus_llp_messages_total{server=\"Tritium\",message=\"a\\\"b\"} 1\n") != std::string::npos);
+    REQUIRE(strText.find("nexus_llp_processing_seconds_count{server=\"Tritium\",message=\"a\\\"b\"} 1\n") != std::string::npos);
+    REQUIRE(strText.find("# TYPE nexus_llp_processing_seconds summary\n") != std::string::npos);
+
+    /* The database caches are exported with the servers. */
+    LLP::CacheMetrics cache;
+    cache.strName = "_LEDGER";
+    cache.nHits   = 7;
+    cache.nMisses = 3;
+    cache.nBytes  = 1024;
+
+    const std::string strCache = LLP::Prometheus({ server }, { cache });
+    REQUIRE(strCache.find("nexus_lld_cache_reads_total{database=\"_LEDGER\",result=\"hit\"} 7\n") != std::string::npos);
+    REQUIRE(strCache.find("nexus_lld_cache_reads_total{database=\"_LEDGER\",result=\"miss\"} 3\n") != std::string::npos);
+    REQUIRE(strCache.find("nexus_lld_cache_bytes{database=\"_LEDGER\"} 1024\n") != std::string::npos);
+    REQUIRE(strText.find("nexus_lld_cache") == std::string::npos);
+}
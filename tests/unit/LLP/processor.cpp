@@ -0,0 +1,106 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <unit/catch2/catch.hpp>
+
+#include <LLP/include/processor.h>
+
+#include <Util/include/runtime.h>
+
+#include <atomic>
+
+TEST_CASE( "LLP::ProcessorPool work stealing", "[processor]")
+{
+    LLP::ProcessorPool pool(2);
+    REQUIRE(pool.Size() == 2);
+
+    /* Hold up one worker with a slow task. */
+    std::atomic<bool> fRelease(false);
+    std::atomic<bool> fStarted(false);
+    REQUIRE(pool.Submit([&]()
+    {
+        fStarted = true;
+        while(!fRelease.load())
+            runtime::sleep(1);
+    }));
+
+    while(!fStarted.load())
+        runtime::sleep(1);
+
+    /* Tasks are spread over both queues, so the free worker has to steal from the busy one. */
+    std::atomic<uint32_t> nCount(0);
+    for(uint32_t n = 0; n < 100; ++n)
+    {
+        REQUIRE(pool.Submit([&]() { ++nCount; }));
+    }
+
+    for(uint32_t n = 0; n < 5000 && nCount.load() < 100; ++n)
+        runtime::sleep(1);
+
+    fRelease = true;
+
+    REQUIRE(nCount.load() == 100);
+    REQUIRE(pool.Stolen() > 0);
+    REQUIRE(pool.Pending() == 0);
+}
+
+
+TEST_CASE( "LLP::ProcessorPool ordering and stop", "[processor]")
+{
+    LLP::ProcessorPool pool(4);
+
+    /* Each connection hands over its next packet once the last one is done, as the data threads do. */
+    const uint32_t nConnections = 8;
+    const uint32_t nPackets     = 200;
+
+    std::vector<std::vector<uint32_t>> vProcessed(nConnections);
+    std::atomic<uint32_t> nDone(0);
+
+    std::function<void(uint32_t, uint32_t)> dispatch = [&](const uint32_t nConnection, const uint32_t nPacket)
+    {
+        pool.Submit([&, nConnection, nPacket]()
+        {
+            vProcessed[nConnection].push_back(nPacket);
+
+            if(nPacket + 1 < nPackets)
+                dispatch(nConnection, nPacket + 1);
+            else
+                ++nDone;
+        });
+    };
+
+    for(uint32_t n = 0; n < nConnections; ++n)
+        dispatch(n, 0);
+
+    for(uint32_t n = 0; n < 5000 && nDone.load() < nConnections; ++n)
+        runtime::sleep(1);
+
+    REQUIRE(nDone.load() == nConnections);
+
+    /* The packets of every connection were processed in order. */
+    for(const auto& vPackets : vProcessed)
+    {
+        REQUIRE(vPackets.size() == nPackets);
+        for(uint32_t n = 0; n < nPackets; ++n)
+        {
+            REQUIRE(vPackets[n] == n);
+        }
+    }
+
+    /* A stopped pool turns tasks away, so the data threads process them themselves. */
+    pool.Stop();
+    REQUIRE_FALSE(pool.Submit([]() { }));
+
+    LLP::ProcessorPool empty(0);
+    REQUIRE_FALSE(empty.Submit([]() { }));
+}
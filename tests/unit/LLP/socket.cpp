@@ -0,0 +1,134 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <unit/catch2/catch.hpp>
+
+#include <LLP/include/base_address.h>
+#include <LLP/templates/socket.h>
+
+#ifndef WIN32
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#ifndef WIN32
+TEST_CASE( "LLP::Socket shared writes", "[socket]")
+{
+    int32_t fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    /* Keep the send buffer small so that writes are only partly sent. */
+    int32_t nSize = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &nSize, sizeof(nSize));
+
+    LLP::Socket socket(fds[0], LLP::BaseAddress());
+
+    /* Build a shared header and payload. */
+    std::vector<uint8_t> vPayload(256 * 1024);
+    for(uint32_t i = 0; i < vPayload.size(); ++i)
+        vPayload[i] = static_cast<uint8_t>(i * 7);
+
+    LLP::shared_buffer_t pHeader = std::make_shared<const std::vector<uint8_t>>(std::vector<uint8_t>{ 1, 2, 3, 4, 5 });
+    LLP::shared_buffer_t pData   = std::make_shared<const std::vector<uint8_t>>(vPayload);
+
+    /* Write the shared buffers twice with a copied write in between. */
+    const std::vector<uint8_t> vSmall = { 9, 8, 7 };
+    socket.Write(pHeader, pData);
+    socket.Write(vSmall, vSmall.size());
+    socket.Write(pHeader, pData);
+
+    /* Unsent bytes are queued by reference, not copied. */
+    REQUIRE(socket.Buffered() > 0);
+    REQUIRE(pData.use_count() > 1);
+
+    /* The expected stream. */
+    std::vector<uint8_t> vExpected;
+    for(uint32_t n = 0; n < 2; ++n)
+    {
+        vExpected.insert(vExpected.end(), pHeader->begin(), pHeader->end());
+        vExpected.insert(vExpected.end(), pData->begin(), pData->end());
+
+        if(n == 0)
+            vExpected.insert(vExpected.end(), vSmall.begin(), vSmall.end());
+    }
+
+    /* Read everything while flushing. */
+    std::vector<uint8_t> vReceived;
+    std::vector<uint8_t> vRead(65536);
+    while(vReceived.size() < vExpected.size())
+    {
+        socket.Flush();
+
+        int32_t nRead = static_cast<int32_t>(recv(fds[1], &vRead[0], vRead.size(), MSG_DONTWAIT));
+        if(nRead > 0)
+            vReceived.insert(vReceived.end(), vRead.begin(), vRead.begin() + nRead);
+    }
+
+    /* The stream arrives in order, and the queue releases the shared buffers. */
+    REQUIRE(vReceived == vExpected);
+    REQUIRE(socket.Buffered() == 0);
+    REQUIRE(pData.use_count() == 1);
+
+    close(fds[1]);
+    socket.Close();
+}
+
+
+TEST_CASE( "LLP::Socket queued small writes", "[socket]")
+{
+    int32_t fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    /* Keep the send buffer small so that most writes are queued. */
+    int32_t nSize = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &nSize, sizeof(nSize));
+
+    LLP::Socket socket(fds[0], LLP::BaseAddress());
+
+    /* Write many small packets of different sizes. */
+    std::vector<uint8_t> vExpected;
+    for(uint32_t n = 0; n < 4096; ++n)
+    {
+        std::vector<uint8_t> vPacket(1 + (n % 200), static_cast<uint8_t>(n));
+        socket.Write(vPacket, vPacket.size());
+
+        vExpected.insert(vExpected.end(), vPacket.begin(), vPacket.end());
+    }
+
+    /* Most of the packets are waiting in the queue. */
+    REQUIRE(socket.Buffered() > 0);
+    REQUIRE(socket.MaxFlushLatency() == 0);
+
+    /* Read everything while flushing. */
+    std::vector<uint8_t> vReceived;
+    std::vector<uint8_t> vRead(65536);
+    while(vReceived.size() < vExpected.size())
+    {
+        socket.Flush();
+        REQUIRE_FALSE(socket.Errors());
+
+        int32_t nRead = static_cast<int32_t>(recv(fds[1], &vRead[0], vRead.size(), MSG_DONTWAIT));
+        if(nRead > 0)
+            vReceived.insert(vReceived.end(), vRead.begin(), vRead.begin() + nRead);
+    }
+
+    /* The stream arrives in order, and the time the queue waited was recorded. */
+    REQUIRE(vReceived == vExpected);
+    REQUIRE(socket.Buffered() == 0);
+    REQUIRE(socket.MaxFlushLatency() > 0);
+    REQUIRE(socket.MaxFlushLatency() >= socket.FlushLatency());
+
+    close(fds[1]);
+    socket.Close();
+}
+#endif
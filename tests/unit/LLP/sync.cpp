@@ -0,0 +1,172 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <unit/catch2/catch.hpp>
+
+#include <LLP/include/sync.h>
+
+TEST_CASE( "LLP::SyncManager range assignment", "[sync]")
+{
+    LLP::SyncManager sync;
+
+    /* The sync node lists the block hashes first. */
+    sync.Start(1);
+    REQUIRE(sync.Active());
+    REQUIRE(sync.HasPeer(1));
+
+    std::vector<LLP::SyncRequest> vRequests = sync.Requests(1, 1000);
+    REQUIRE(vRequests.size() == 1);
+    REQUIRE(vRequests[0].fHeaders);
+    REQUIRE(vRequests[0].hashStart == 0);
+
+    /* List 1000 blocks after height 100, which is four ranges. */
+    std::vector<uint1024_t> vHashes;
+    for(uint32_t n = 1; n <= 1000; ++n)
+        vHashes.push_back(uint1024_t(1000 + n));
+
+    REQUIRE(sync.Headers(1, uint1024_t(1000), 100, vHashes));
+    REQUIRE(sync.Target() == 1100);
+    REQUIRE_FALSE(sync.Headers(2, uint1024_t(2000), 1100, vHashes));
+
+    /* Nothing is assigned until the nodes report their height. */
+    sync.AddPeer(2);
+    REQUIRE(sync.Requests(2, 1000).empty());
+
+    sync.SetHeight(1, 2000);
+    sync.SetHeight(2, 2000);
+
+    /* The ranges are shared between the nodes, in chain order. */
+    std::vector<LLP::SyncRequest> vFirst  = sync.Requests(1, 1000);
+    std::vector<LLP::SyncRequest> vSecond = sync.Requests(2, 1000);
+
+    REQUIRE(vSecond.size() == 2);
+    REQUIRE(vSecond[0].hashStart == uint1024_t(1250));
+    REQUIRE(vSecond[0].hashStop  == uint1024_t(1500));
+    REQUIRE(vSecond[1].hashStart == uint1024_t(1750));
+
+    /* The sync node was also asked for the next block hashes while the queue was low. */
+    REQUIRE(vFirst.size() == 3);
+    REQUIRE(vFirst[0].fHeaders);
+    REQUIRE(vFirst[0].hashStart == uint1024_t(2000));
+    REQUIRE(vFirst[1].hashStart == uint1024_t(1000));
+    REQUIRE(vFirst[1].hashStop  == uint1024_t(1250));
+    REQUIRE(vFirst[2].hashStart == uint1024_t(1500));
+
+    /* A node that leaves returns its ranges, and they go to the next free node. */
+    REQUIRE(sync.RemovePeer(2) == 1);
+    REQUIRE_FALSE(sync.HasPeer(2));
+
+    sync.AddPeer(3);
+    sync.SetHeight(3, 2000);
+
+    vRequests = sync.Requests(3, 1001);
+    REQUIRE(vRequests.size() == 2);
+    REQUIRE(vRequests[0].hashStart == uint1024_t(1250));
+    REQUIRE(vRequests[1].hashStart == uint1024_t(1750));
+
+    /* The end of the chain completes the listing, but not the sync. */
+    REQUIRE(sync.Headers(1, uint1024_t(2000), 1100, std::vector<uint1024_t>()));
+    REQUIRE_FALSE(sync.Complete());
+
+    sync.Stop();
+    REQUIRE_FALSE(sync.Active());
+    REQUIRE_FALSE(sync.HasPeer(1));
+}
+
+
+TEST_CASE( "LLP::SyncManager stalled ranges", "[sync]")
+{
+    LLP::SyncManager sync;
+    sync.Start(1);
+    sync.AddPeer(2);
+
+    std::vector<uint1024_t> vHashes;
+    for(uint32_t n = 1; n <= 250; ++n)
+        vHashes.push_back(uint1024_t(n));
+
+    REQUIRE(sync.Requests(1, 1000).size() == 1);
+    REQUIRE(sync.Headers(1, uint1024_t(0), 0, vHashes));
+    REQUIRE(sync.Headers(1, uint1024_t(250), 250, std::vector<uint1024_t>()));
+
+    /* Only the second node has the range. */
+    sync.SetHeight(2, 250);
+
+    std::vector<LLP::SyncRequest> vRequests = sync.Requests(2, 1000);
+    REQUIRE(vRequests.size() == 1);
+    REQUIRE(vRequests[0].hashStop == uint1024_t(250));
+
+    /* The range is reassigned once it makes no progress within the timeout. */
+    REQUIRE(sync.Requests(2, 1010).empty());
+    sync.SetHeight(1, 250);
+
+    vRequests = sync.Requests(1, 1016);
+    REQUIRE(vRequests.size() == 1);
+    REQUIRE(vRequests[0].hashStart == uint1024_t(0));
+    REQUIRE(vRequests[0].hashStop  == uint1024_t(250));
+
+    /* A node that stalls too often isn't given any more ranges. */
+    sync.RemovePeer(1);
+    for(uint32_t n = 0; n < LLP::SyncManager::MAX_STALLS; ++n)
+        sync.Requests(2, 1032 + n * 16);
+
+    REQUIRE(sync.Requests(2, 2000).empty());
+}
+
+
+TEST_CASE( "LLP::SyncManager stalled block hashes", "[sync]")
+{
+    LLP::SyncManager sync;
+    sync.Start(1);
+    sync.AddPeer(2);
+
+    sync.SetHeight(1, 500);
+    sync.SetHeight(2, 500);
+
+    /* The target is the best height of the nodes, not the last height listed. */
+    REQUIRE(sync.Target() == 0);
+    REQUIRE(sync.BestHeight() == 500);
+
+    std::vector<LLP::SyncRequest> vRequests = sync.Requests(1, 1000);
+    REQUIRE(vRequests.size() == 1);
+    REQUIRE(vRequests[0].fHeaders);
+
+    /* Another node lists the block hashes once the sync node stalls. */
+    vRequests = sync.Requests(2, 1016);
+    REQUIRE(vRequests.size() == 1);
+    REQUIRE(vRequests[0].fHeaders);
+    REQUIRE(vRequests[0].hashStart == 0);
+
+    std::vector<uint1024_t> vHashes;
+    for(uint32_t n = 1; n <= 250; ++n)
+        vHashes.push_back(uint1024_t(n));
+
+    REQUIRE_FALSE(sync.Headers(1, uint1024_t(0), 0, vHashes));
+    REQUIRE(sync.Headers(2, uint1024_t(0), 0, vHashes));
+    REQUIRE(sync.Target() == 250);
+    REQUIRE(sync.BestHeight() == 500);
+
+    /* A node that stops short of the height of the others hands the listing back. */
+    REQUIRE(sync.Headers(2, uint1024_t(250), 250, std::vector<uint1024_t>()));
+
+    bool fHeaders = false;
+    for(const auto& request : sync.Requests(1, 1017))
+    {
+        if(request.fHeaders)
+        {
+            REQUIRE(request.hashStart == uint1024_t(250));
+            fHeaders = true;
+        }
+    }
+
+    REQUIRE(fHeaders);
+}
@@ -11,10 +11,19 @@
 
 ____________________________________________________________________________________________*/
 
+#include <LLC/include/random.h>
+
+#include <LLP/include/version.h>
+
+#include <TAO/Ledger/include/enum.h>
 #include <TAO/Ledger/types/block.h>
+#include <TAO/Ledger/types/compactblock.h>
+#include <TAO/Ledger/types/mempool.h>
 #include <TAO/Ledger/types/tritium.h>
 #include <TAO/Ledger/types/state.h>
 
+#include <Util/templates/datastream.h>
+
 #include <unit/catch2/catch.hpp>
 
 TEST_CASE( "Block primitive values", "[ledger]")
@@ -117,3 +126,95 @@ TEST_CASE( "Block primitive values", "[ledger]")
 
 
 }
+
+
+TEST_CASE( "Compact block reconstruction", "[ledger]")
+{
+    //a transaction for the memory pool and a producer
+    TAO::Ledger::Transaction tx;
+    tx.nSequence   = 7;
+    tx.hashGenesis = LLC::GetRand256();
+
+    TAO::Ledger::Transaction producer;
+    producer.nSequence   = 3;
+    producer.hashGenesis = LLC::GetRand256();
+
+    REQUIRE(TAO::Ledger::mempool.AddUnchecked(tx));
+
+    //build a block with the pool transaction and one unknown legacy transaction
+    TAO::Ledger::TritiumBlock block;
+    block.nVersion  = 7;
+    block.nHeight   = 5;
+    block.producer  = producer;
+    block.vtx.push_back(std::make_pair(uint8_t(TAO::Ledger::TRANSACTION::TRITIUM), tx.GetHash()));
+    block.vtx.push_back(std::make_pair(uint8_t(TAO::Ledger::TRANSACTION::LEGACY), LLC::GetRand512()));
+
+    std::vector<uint512_t> vHashes = { block.vtx[0].second, block.vtx[1].second, producer.GetHash() };
+    block.hashMerkleRoot = block.BuildMerkleTree(vHashes);
+
+    //test the compact block round trip
+    TAO::Ledger::CompactBlock compact(block, 12345);
+    REQUIRE(compact.block.vtx.empty());
+    REQUIRE(compact.vShortIDs.size() == 2);
+    REQUIRE((compact.vShortIDs[1] >> 56) == TAO::Ledger::TRANSACTION::LEGACY);
+
+    DataStream ssCompact(SER_NETWORK, LLP::PROTOCOL_VERSION);
+    ssCompact << compact;
+
+    TAO::Ledger::CompactBlock compact2;
+    ssCompact >> compact2;
+    REQUIRE(compact2.nSalt == 12345);
+    REQUIRE(compact2.vShortIDs == compact.vShortIDs);
+    REQUIRE(compact2.block.GetHash() == block.GetHash());
+
+    //the short ids change with the salt
+    REQUIRE(TAO::Ledger::CompactBlock(block, 54321).vShortIDs != compact.vShortIDs);
+
+    //the unknown transaction is missing
+    TAO::Ledger::TritiumBlock rebuilt;
+    std::vector<uint32_t> vMissing;
+    REQUIRE(compact2.Reconstruct(rebuilt, vMissing));
+    REQUIRE(vMissing.size() == 1);
+    REQUIRE(vMissing[0] == 1);
+    REQUIRE(rebuilt.vtx[0] == block.vtx[0]);
+
+    //a block with only pool transactions is rebuilt in full
+    block.vtx.pop_back();
+    vHashes = { block.vtx[0].second, producer.GetHash() };
+    block.hashMerkleRoot = block.BuildMerkleTree(vHashes);
+
+    REQUIRE(TAO::Ledger::CompactBlock(block, 999).Reconstruct(rebuilt, vMissing));
+    REQUIRE(vMissing.empty());
+    REQUIRE(rebuilt.vtx == block.vtx);
+    REQUIRE(rebuilt.GetHash() == block.GetHash());
+
+    //a merkle root that doesn't match the rebuilt transactions needs the full block
+    block.hashMerkleRoot = 555;
+    REQUIRE_FALSE(TAO::Ledger::CompactBlock(block, 999).Reconstruct(rebuilt, vMissing));
+
+    REQUIRE(TAO::Ledger::mempool.Remove(tx.GetHash()));
+}
+
+
+TEST_CASE( "Merkle tail tests", "[ledger]")
+{
+    //the tail root matches the full tree for every size, including the odd levels
+    for(uint32_t nSize = 1; nSize <= 40; ++nSize)
+    {
+        std::vector<uint512_t> vHashes;
+        for(uint32_t n = 0; n < nSize; ++n)
+            vHashes.push_back(LLC::GetRand512());
+
+        //get the branch with a placeholder for the last transaction
+        TAO::Ledger::Block block;
+        vHashes.back() = 0;
+        std::vector<uint512_t> vBranch = block.GetMerkleBranch(vHashes, nSize - 1);
+
+        //any last transaction gives the same root as building the tree
+        for(uint32_t n = 0; n < 2; ++n)
+        {
+            vHashes.back() = LLC::GetRand512();
+            REQUIRE(TAO::Ledger::Block::CheckMerkleTail(vHashes.back(), vBranch, nSize - 1) == block.BuildMerkleTree(vHashes));
+        }
+    }
+}
@@ -0,0 +1,157 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLC/include/random.h>
+
+#include <TAO/Operation/include/enum.h>
+
+#include <TAO/Register/include/enum.h>
+#include <TAO/Register/types/address.h>
+
+#include <TAO/Ledger/include/constants.h>
+#include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/types/block_template.h>
+#include <TAO/Ledger/types/genesis.h>
+#include <TAO/Ledger/types/mempool.h>
+
+#include <unit/catch2/catch.hpp>
+
+namespace
+{
+    /* Build a signed transaction creating a raw register. */
+    TAO::Ledger::Transaction CreateRaw(const uint256_t& hashGenesis, const uint32_t nSequence, const uint512_t& hashPrevTx,
+                                       const uint512_t& hashPrivKey1, const uint512_t& hashPrivKey2)
+    {
+        using namespace TAO::Register;
+        using namespace TAO::Operation;
+
+        //create the transaction object
+        TAO::Ledger::Transaction tx;
+        tx.hashGenesis = hashGenesis;
+        tx.nSequence   = nSequence;
+        tx.hashPrevTx  = hashPrevTx;
+        tx.nTimestamp  = runtime::timestamp();
+        tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+        tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+        tx.NextHash(hashPrivKey2, TAO::Ledger::SIGNATURE::BRAINPOOL);
+
+        //payload
+        tx[0] << uint8_t(OP::CREATE) << TAO::Register::Address(TAO::Register::Address::RAW)
+              << uint8_t(REGISTER::RAW) << std::vector<uint8_t>(10, 0xff);
+
+        //generate the prestates and poststates
+        REQUIRE(tx.Build());
+
+        //sign
+        tx.Sign(hashPrivKey1);
+
+        return tx;
+    }
+}
+
+
+TEST_CASE( "Block template tests", "[blocktemplate]")
+{
+    /* Clear the mempool so the template only holds this test's transactions. */
+    std::vector<uint512_t> vExistingHashes;
+    TAO::Ledger::mempool.List(vExistingHashes);
+
+    for(auto& hash : vExistingHashes)
+    {
+        REQUIRE(TAO::Ledger::mempool.Remove(hash));
+    }
+
+    TAO::Ledger::blocktemplate.Clear();
+
+    //two new signature chains are added to the template
+    const uint512_t hashPrivKey1 = LLC::GetRand512();
+    const uint512_t hashPrivKey2 = LLC::GetRand512();
+
+    std::vector<TAO::Ledger::Transaction> vtx;
+    for(uint32_t n = 0; n < 2; ++n)
+    {
+        vtx.push_back(CreateRaw(TAO::Ledger::Genesis(LLC::GetRand256(), true), 0, 0, hashPrivKey1, hashPrivKey2));
+        REQUIRE(TAO::Ledger::mempool.Accept(vtx.back()));
+    }
+
+    std::vector<std::pair<uint8_t, uint512_t>> vTemplate;
+    TAO::Ledger::blocktemplate.Get(vTemplate, 1024);
+
+    REQUIRE(vTemplate.size() == 2);
+    for(const auto& entry : vTemplate)
+    {
+        REQUIRE(entry.first == TAO::Ledger::TRANSACTION::TRITIUM);
+        REQUIRE((entry.second == vtx[0].GetHash() || entry.second == vtx[1].GetHash()));
+    }
+
+    //a new transaction is added behind the ones already in the template
+    {
+        vtx.push_back(CreateRaw(TAO::Ledger::Genesis(LLC::GetRand256(), true), 0, 0, hashPrivKey1, hashPrivKey2));
+        REQUIRE(TAO::Ledger::mempool.Accept(vtx.back()));
+
+        std::vector<std::pair<uint8_t, uint512_t>> vUpdated;
+        TAO::Ledger::blocktemplate.Get(vUpdated, 1024);
+
+        REQUIRE(vUpdated.size() == 3);
+        REQUIRE(vUpdated[0] == vTemplate[0]);
+        REQUIRE(vUpdated[1] == vTemplate[1]);
+        REQUIRE(vUpdated[2].second == vtx[2].GetHash());
+
+        vTemplate = vUpdated;
+    }
+
+    //only the transactions that fit beside the reserved size are handed out
+    {
+        const uint64_t nReserved = TAO::Ledger::MAX_BLOCK_SIZE - 256 - 2 * TAO::Ledger::BlockTemplate::EntrySize();
+
+        std::vector<std::pair<uint8_t, uint512_t>> vLimited;
+        TAO::Ledger::blocktemplate.Get(vLimited, nReserved);
+
+        REQUIRE(vLimited.size() == 2);
+        REQUIRE(vLimited[0] == vTemplate[0]);
+        REQUIRE(vLimited[1] == vTemplate[1]);
+    }
+
+    //a transaction whose signature chain isn't on disk waits for a later block
+    {
+        TAO::Ledger::Transaction tx = CreateRaw(vtx[0].hashGenesis, 1, vtx[0].GetHash(), hashPrivKey2, LLC::GetRand512());
+        REQUIRE(TAO::Ledger::mempool.Accept(tx));
+
+        std::vector<std::pair<uint8_t, uint512_t>> vUpdated;
+        TAO::Ledger::blocktemplate.Get(vUpdated, 1024);
+
+        REQUIRE(vUpdated == vTemplate);
+
+        REQUIRE(TAO::Ledger::mempool.Remove(tx.GetHash()));
+    }
+
+    //the template is rebuilt once transactions leave the memory pool
+    {
+        REQUIRE(TAO::Ledger::mempool.Remove(vtx[1].GetHash()));
+
+        std::vector<std::pair<uint8_t, uint512_t>> vUpdated;
+        TAO::Ledger::blocktemplate.Get(vUpdated, 1024);
+
+        REQUIRE(vUpdated.size() == 2);
+        for(const auto& entry : vUpdated)
+        {
+            REQUIRE(entry.second != vtx[1].GetHash());
+        }
+    }
+
+    //clean up
+    REQUIRE(TAO::Ledger::mempool.Remove(vtx[0].GetHash()));
+    REQUIRE(TAO::Ledger::mempool.Remove(vtx[2].GetHash()));
+
+    TAO::Ledger::blocktemplate.Clear();
+}
@@ -27,6 +27,7 @@ ________________________________________________________________________________
 
 #include <TAO/Ledger/types/mempool.h>
 #include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/types/genesis.h>
 #include <TAO/Ledger/types/sigchain.h>
 
 #include <unit/catch2/catch.hpp>
@@ -1676,3 +1677,278 @@ TEST_CASE( "Mempool and memory sequencing tests", "[mempool]")
         TAO::Ledger::mempool.Check();
     }
 }
+
+
+TEST_CASE( "Mempool index and eviction tests", "[mempool]")
+{
+    using namespace TAO::Register;
+    using namespace TAO::Operation;
+
+    /* Clear the mempool so the counts below only see this test's transactions. */
+    std::vector<uint512_t> vExistingHashes;
+    TAO::Ledger::mempool.List(vExistingHashes);
+
+    for(auto& hash : vExistingHashes)
+    {
+        REQUIRE(TAO::Ledger::mempool.Remove(hash));
+    }
+
+    REQUIRE(TAO::Ledger::mempool.GetInfo().nTransactions == 0);
+
+    //build a signature chain of transactions
+    uint256_t hashGenesis  = TAO::Ledger::Genesis(LLC::GetRand256(), true);
+    uint512_t hashPrivKey1 = LLC::GetRand512();
+    uint512_t hashPrivKey2 = LLC::GetRand512();
+
+    std::vector<TAO::Ledger::Transaction> vtx;
+    for(uint32_t n = 0; n < 4; ++n)
+    {
+        //create the transaction object
+        TAO::Ledger::Transaction tx;
+        tx.hashGenesis = hashGenesis;
+        tx.nSequence   = n;
+        tx.hashPrevTx  = (n == 0 ? uint512_t(0) : vtx.back().GetHash());
+        tx.nTimestamp  = runtime::timestamp();
+        tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+        tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+        tx.NextHash(hashPrivKey2, TAO::Ledger::SIGNATURE::BRAINPOOL);
+
+        //payload
+        tx[0] << uint8_t(OP::CREATE) << TAO::Register::Address(TAO::Register::Address::RAW)
+              << uint8_t(REGISTER::RAW) << std::vector<uint8_t>(10, 0xff);
+
+        //generate the prestates and poststates
+        REQUIRE(tx.Build());
+
+        //sign
+        tx.Sign(hashPrivKey1);
+
+        //set private keys
+        hashPrivKey1 = hashPrivKey2;
+        hashPrivKey2 = LLC::GetRand512();
+
+        vtx.push_back(tx);
+    }
+
+    //the first three are indexed by their signature chain
+    {
+        for(uint32_t n = 0; n < 3; ++n)
+        {
+            REQUIRE(TAO::Ledger::mempool.Accept(vtx[n]));
+        }
+
+        REQUIRE(TAO::Ledger::mempool.Has(hashGenesis));
+        REQUIRE_FALSE(TAO::Ledger::mempool.Has(LLC::GetRand256()));
+
+        //get the chain in sequence order
+        std::vector<TAO::Ledger::Transaction> vChain;
+        REQUIRE(TAO::Ledger::mempool.Get(hashGenesis, vChain));
+        REQUIRE(vChain.size() == 3);
+
+        for(uint32_t n = 0; n < 3; ++n)
+        {
+            REQUIRE(vChain[n].GetHash() == vtx[n].GetHash());
+        }
+
+        //get the newest
+        TAO::Ledger::Transaction txLast;
+        REQUIRE(TAO::Ledger::mempool.Get(hashGenesis, txLast));
+        REQUIRE(txLast.GetHash() == vtx[2].GetHash());
+
+        //list in sequence order
+        std::vector<uint512_t> vHashes;
+        REQUIRE(TAO::Ledger::mempool.List(vHashes));
+        REQUIRE(vHashes.size() == 3);
+
+        for(uint32_t n = 0; n < 3; ++n)
+        {
+            REQUIRE(vHashes[n] == vtx[n].GetHash());
+        }
+
+        //check the statistics
+        TAO::Ledger::Mempool::Info info = TAO::Ledger::mempool.GetInfo();
+        REQUIRE(info.nTransactions == 3);
+        REQUIRE(info.nGenesis == 1);
+        REQUIRE(info.nBytes > 0);
+        REQUIRE(info.nEvicted == 0);
+    }
+
+
+    //a full pool evicts the chain, newest first, but never transactions added unchecked from a block
+    {
+        config::mapArgs["-maxmempool"] = "1";
+
+        //add a block transaction bigger than the limit
+        TAO::Ledger::Transaction txBlock;
+        txBlock.hashGenesis = TAO::Ledger::Genesis(LLC::GetRand256(), true);
+        txBlock.nTimestamp  = runtime::timestamp();
+        txBlock[0] << uint8_t(OP::CREATE) << TAO::Register::Address(TAO::Register::Address::RAW)
+                   << uint8_t(REGISTER::RAW) << std::vector<uint8_t>(1100000, 0xff);
+
+        REQUIRE(TAO::Ledger::mempool.AddUnchecked(txBlock));
+
+        //the next transaction takes the pool over its limit
+        REQUIRE_FALSE(TAO::Ledger::mempool.Accept(vtx[3]));
+
+        TAO::Ledger::Mempool::Info info = TAO::Ledger::mempool.GetInfo();
+        REQUIRE(info.nTransactions == 1);
+        REQUIRE(info.nGenesis == 1);
+        REQUIRE(info.nEvicted == 4);
+
+        REQUIRE(TAO::Ledger::mempool.Has(txBlock.GetHash()));
+        REQUIRE_FALSE(TAO::Ledger::mempool.Has(hashGenesis));
+
+        //the evicted transactions were disconnected from memory
+        for(const auto& tx : vtx)
+        {
+            REQUIRE_FALSE(TAO::Ledger::mempool.Has(tx.GetHash()));
+            REQUIRE_FALSE(LLD::Ledger->HasTx(tx.GetHash(), TAO::Ledger::FLAGS::MEMPOOL));
+        }
+
+        //the chain is accepted again once there is room
+        config::mapArgs.erase("-maxmempool");
+        REQUIRE(TAO::Ledger::mempool.Remove(txBlock.GetHash()));
+
+        for(const auto& tx : vtx)
+        {
+            REQUIRE(TAO::Ledger::mempool.Accept(tx));
+        }
+
+        REQUIRE(TAO::Ledger::mempool.GetInfo().nTransactions == 4);
+    }
+
+
+    //a debit is never evicted while another signature chain credits it
+    {
+        for(const auto& tx : vtx)
+        {
+            REQUIRE(TAO::Ledger::mempool.Remove(tx.GetHash()));
+        }
+
+        //build the next transaction of a signature chain
+        auto Next = [](const uint256_t& hashGenesisIn, std::vector<TAO::Ledger::Transaction>& vChain, const uint512_t& hashNext)
+        {
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashGenesisIn;
+            tx.nSequence   = static_cast<uint32_t>(vChain.size());
+            tx.hashPrevTx  = (vChain.empty() ? uint512_t(0) : vChain.back().GetHash());
+            tx.nTimestamp  = runtime::timestamp();
+            tx.nKeyType    = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.nNextType   = TAO::Ledger::SIGNATURE::BRAINPOOL;
+            tx.NextHash(hashNext, TAO::Ledger::SIGNATURE::BRAINPOOL);
+
+            vChain.push_back(tx);
+            return &vChain.back();
+        };
+
+        //the token chain debits to an account on the receiving chain
+        const uint256_t hashDebitGenesis  = TAO::Ledger::Genesis(LLC::GetRand256(), true);
+        const uint256_t hashCreditGenesis = TAO::Ledger::Genesis(LLC::GetRand256(), true);
+
+        uint512_t hashDebitKey   = LLC::GetRand512(), hashDebitNext  = LLC::GetRand512();
+        uint512_t hashCreditKey  = LLC::GetRand512(), hashCreditNext = LLC::GetRand512();
+
+        TAO::Register::Address hashToken   = TAO::Register::Address(TAO::Register::Address::TOKEN);
+        TAO::Register::Address hashAccount = TAO::Register::Address(TAO::Register::Address::ACCOUNT);
+
+        std::vector<TAO::Ledger::Transaction> vDebit, vCredit;
+        vDebit.reserve(2);
+        vCredit.reserve(2);
+        {
+            TAO::Ledger::Transaction* ptx = Next(hashDebitGenesis, vDebit, hashDebitNext);
+            (*ptx)[0] << uint8_t(OP::CREATE) << hashToken << uint8_t(REGISTER::OBJECT) << CreateToken(hashToken, 1000, 100).GetState();
+
+            REQUIRE(ptx->Build());
+            ptx->Sign(hashDebitKey);
+            REQUIRE(TAO::Ledger::mempool.Accept(*ptx));
+
+            hashDebitKey  = hashDebitNext;
+            hashDebitNext = LLC::GetRand512();
+        }
+
+        {
+            TAO::Ledger::Transaction* ptx = Next(hashCreditGenesis, vCredit, hashCreditNext);
+            (*ptx)[0] << uint8_t(OP::CREATE) << hashAccount << uint8_t(REGISTER::OBJECT) << CreateAccount(hashToken).GetState();
+
+            REQUIRE(ptx->Build());
+            ptx->Sign(hashCreditKey);
+            REQUIRE(TAO::Ledger::mempool.Accept(*ptx));
+
+            hashCreditKey  = hashCreditNext;
+            hashCreditNext = LLC::GetRand512();
+        }
+
+        {
+            TAO::Ledger::Transaction* ptx = Next(hashDebitGenesis, vDebit, hashDebitNext);
+            (*ptx)[0] << uint8_t(OP::DEBIT) << hashToken << hashAccount << uint64_t(100) << uint64_t(0);
+
+            REQUIRE(ptx->Build());
+            ptx->Sign(hashDebitKey);
+            REQUIRE(TAO::Ledger::mempool.Accept(*ptx));
+        }
+
+        //the credit arrives in a block, so it can't be evicted
+        {
+            TAO::Ledger::Transaction* ptx = Next(hashCreditGenesis, vCredit, hashCreditNext);
+            (*ptx)[0] << uint8_t(OP::CREDIT) << vDebit.back().GetHash() << uint32_t(0) << hashAccount << hashToken << uint64_t(100);
+
+            REQUIRE(ptx->Build());
+            ptx->Sign(hashCreditKey);
+            REQUIRE(TAO::Ledger::mempool.AddUnchecked(*ptx));
+        }
+
+        config::mapArgs["-maxmempool"] = "1";
+
+        //add a block transaction bigger than the limit
+        TAO::Ledger::Transaction txBlock;
+        txBlock.hashGenesis = TAO::Ledger::Genesis(LLC::GetRand256(), true);
+        txBlock.nTimestamp  = runtime::timestamp();
+        txBlock[0] << uint8_t(OP::CREATE) << TAO::Register::Address(TAO::Register::Address::RAW)
+                   << uint8_t(REGISTER::RAW) << std::vector<uint8_t>(1100000, 0xff);
+
+        REQUIRE(TAO::Ledger::mempool.AddUnchecked(txBlock));
+
+        //only a new transaction can be evicted, the debit and the token stay for the credit
+        std::vector<TAO::Ledger::Transaction> vNew;
+        {
+            uint512_t hashNewKey = LLC::GetRand512();
+
+            TAO::Ledger::Transaction* ptx = Next(TAO::Ledger::Genesis(LLC::GetRand256(), true), vNew, LLC::GetRand512());
+            (*ptx)[0] << uint8_t(OP::CREATE) << TAO::Register::Address(TAO::Register::Address::RAW)
+                      << uint8_t(REGISTER::RAW) << std::vector<uint8_t>(10, 0xff);
+
+            REQUIRE(ptx->Build());
+            ptx->Sign(hashNewKey);
+        }
+
+        const uint64_t nEvicted = TAO::Ledger::mempool.GetInfo().nEvicted;
+        REQUIRE_FALSE(TAO::Ledger::mempool.Accept(vNew[0]));
+        REQUIRE_FALSE(TAO::Ledger::mempool.Has(vNew[0].GetHash()));
+        REQUIRE(TAO::Ledger::mempool.GetInfo().nEvicted == nEvicted + 1);
+
+        for(const auto& tx : vDebit)
+        {
+            REQUIRE(TAO::Ledger::mempool.Has(tx.GetHash()));
+            REQUIRE(LLD::Ledger->HasTx(tx.GetHash(), TAO::Ledger::FLAGS::MEMPOOL));
+        }
+
+        for(const auto& tx : vCredit)
+        {
+            REQUIRE(TAO::Ledger::mempool.Has(tx.GetHash()));
+        }
+
+        config::mapArgs.erase("-maxmempool");
+
+        //leave the pool empty
+        REQUIRE(TAO::Ledger::mempool.Remove(txBlock.GetHash()));
+        for(const auto& tx : vCredit)
+        {
+            REQUIRE(TAO::Ledger::mempool.Remove(tx.GetHash()));
+        }
+
+        for(const auto& tx : vDebit)
+        {
+            REQUIRE(TAO::Ledger::mempool.Remove(tx.GetHash()));
+        }
+    }
+}
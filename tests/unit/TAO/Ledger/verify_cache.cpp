@@ -0,0 +1,150 @@
+/*__________________________________________________________________________________________
+
+            (c) Hash(BEGIN(Satoshi[2010]), END(Sunny[2012])) == Videlicet[2014] ++
+
+            (c) Copyright The Nexus Developers 2014 - 2019
+
+            Distributed under the MIT software license, see the accompanying
+            file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+            "ad vocem populi" - To the Voice of the People
+
+____________________________________________________________________________________________*/
+
+#include <LLC/include/random.h>
+
+#include <LLD/include/global.h>
+
+#include <TAO/Operation/include/enum.h>
+#include <TAO/Operation/include/execute.h>
+
+#include <TAO/Register/include/enum.h>
+#include <TAO/Register/types/address.h>
+
+#include <TAO/Ledger/include/enum.h>
+#include <TAO/Ledger/types/genesis.h>
+#include <TAO/Ledger/types/transaction.h>
+#include <TAO/Ledger/types/verify_cache.h>
+
+#include <unit/catch2/catch.hpp>
+
+#include <memory>
+
+TEST_CASE( "Verify cache tests", "[verifycache]")
+{
+    using namespace TAO::Register;
+    using namespace TAO::Operation;
+
+    //checked transactions are remembered until removed
+    {
+        std::unique_ptr<TAO::Ledger::VerifyCache> pCache(new TAO::Ledger::VerifyCache());
+
+        uint512_t hashTx = LLC::GetRand512();
+        REQUIRE_FALSE(pCache->Checked(hashTx));
+        REQUIRE_FALSE(pCache->Verified(hashTx));
+
+        pCache->AddChecked(hashTx);
+        REQUIRE(pCache->Checked(hashTx));
+        REQUIRE_FALSE(pCache->Verified(hashTx));
+
+        pCache->Remove(hashTx);
+        REQUIRE_FALSE(pCache->Checked(hashTx));
+    }
+
+
+    //the oldest generation of a shard is dropped once the newer one fills
+    {
+        std::unique_ptr<TAO::Ledger::VerifyCache> pCache(new TAO::Ledger::VerifyCache());
+
+        //multiples of sixteen all land in the same shard
+        uint64_t nHash = 16;
+        pCache->AddChecked(uint512_t(nHash));
+
+        for(uint32_t n = 0; n < 2048; ++n)
+            pCache->AddChecked(uint512_t(nHash += 16));
+
+        //still in the previous generation
+        REQUIRE(pCache->Checked(uint512_t(16)));
+        REQUIRE(pCache->Checked(uint512_t(nHash)));
+
+        for(uint32_t n = 0; n < 2048; ++n)
+            pCache->AddChecked(uint512_t(nHash += 16));
+
+        //dropped with its generation
+        REQUIRE_FALSE(pCache->Checked(uint512_t(16)));
+        REQUIRE(pCache->Checked(uint512_t(nHash)));
+    }
+
+
+    //pre-states stay verified until their registers are written
+    {
+        uint256_t hashRegister = TAO::Register::Address(TAO::Register::Address::RAW);
+        uint256_t hashGenesis  = TAO::Ledger::Genesis(LLC::GetRand256(), true);
+
+        {
+            //create the transaction object
+            TAO::Ledger::Transaction tx;
+            tx.hashGenesis = hashGenesis;
+            tx.nSequence   = 0;
+            tx.nTimestamp  = runtime::timestamp();
+
+            //payload
+            tx[0] << uint8_t(OP::CREATE) << hashRegister << uint8_t(REGISTER::RAW) << std::vector<uint8_t>(10, 0xff);
+
+            //generate the prestates and poststates
+            REQUIRE(tx.Build());
+
+            //commit to disk
+            REQUIRE(Execute(tx[0], TAO::Ledger::FLAGS::BLOCK));
+        }
+
+        //create the transaction object
+        TAO::Ledger::Transaction tx;
+        tx.hashGenesis = hashGenesis;
+        tx.nSequence   = 1;
+        tx.nTimestamp  = runtime::timestamp();
+
+        //payload
+        tx[0] << uint8_t(OP::WRITE) << hashRegister << std::vector<uint8_t>(10, 0x1f);
+
+        //generate the prestates and poststates
+        REQUIRE(tx.Build());
+
+        //the pre-state matches the disk
+        std::unique_ptr<TAO::Ledger::VerifyCache> pCache(new TAO::Ledger::VerifyCache());
+        REQUIRE(pCache->AddVerified(tx));
+        REQUIRE(pCache->Verified(tx.GetHash()));
+
+        //writes to other registers leave it verified
+        pCache->Written(LLC::GetRand256());
+        REQUIRE(pCache->Verified(tx.GetHash()));
+
+        //a write to its register does not
+        pCache->Written(hashRegister);
+        REQUIRE_FALSE(pCache->Verified(tx.GetHash()));
+
+        //verify it again, then clear everything
+        REQUIRE(pCache->AddVerified(tx));
+        REQUIRE(pCache->Verified(tx.GetHash()));
+
+        pCache->Clear();
+        REQUIRE_FALSE(pCache->Verified(tx.GetHash()));
+
+        //the register database notes its writes in the shared cache
+        REQUIRE(TAO::Ledger::verifycache.AddVerified(tx));
+        REQUIRE(TAO::Ledger::verifycache.Verified(tx.GetHash()));
+
+        State state;
+        REQUIRE(LLD::Register->ReadState(hashRegister, state));
+        REQUIRE(LLD::Register->WriteState(hashRegister, state));
+        REQUIRE_FALSE(TAO::Ledger::verifycache.Verified(tx.GetHash()));
+
+        //a pre-state that no longer matches the disk fails quietly
+        state.SetState(std::vector<uint8_t>(10, 0x2f));
+        REQUIRE(LLD::Register->WriteState(hashRegister, state));
+        REQUIRE_FALSE(pCache->AddVerified(tx));
+        REQUIRE_FALSE(pCache->Verified(tx.GetHash()));
+
+        TAO::Ledger::verifycache.Remove(tx.GetHash());
+    }
+}